@@ -1163,6 +1163,7 @@ rm -rf %{buildroot}
 %_sbindir/condor_credmon_krb
 %_sbindir/condor_c-gahp
 %_sbindir/condor_c-gahp_worker_thread
+%_sbindir/condor_ccb_server
 %_sbindir/condor_collector
 %_sbindir/condor_credd
 %_sbindir/condor_fetchlog
@@ -38,6 +38,7 @@ struct CCBStats {
 	stats_entry_recent<int> CCBRequestsNotFound;
 	stats_entry_recent<int> CCBRequestsSucceeded;
 	stats_entry_recent<int> CCBRequestsFailed;
+	stats_entry_recent<Probe> CCBRequestLatency;
 
 	void AddStatsToPool(StatisticsPool& pool, int publevel)
 	{
@@ -48,11 +49,20 @@ struct CCBStats {
 		STATS_POOL_ADD(pool, "", CCBRequestsNotFound, publevel);
 		STATS_POOL_ADD(pool, "", CCBRequestsSucceeded, publevel);
 		STATS_POOL_ADD(pool, "", CCBRequestsFailed, publevel);
+		STATS_POOL_ADD(pool, "", CCBRequestLatency, publevel);
 	}
 };
 
 static CCBStats ccb_stats;
 
+// Only requests that succeeded are timed, so that requests which sit
+// until their target goes away do not swamp the latency statistics.
+static void
+RecordRequestLatency( CCBServerRequest *request )
+{
+	ccb_stats.CCBRequestLatency += _condor_debug_get_time_double() - request->getStartTime();
+}
+
 void AddCCBStatsToPool(StatisticsPool& pool, int publevel)
 {
 	ccb_stats.AddStatsToPool(pool, publevel);
@@ -695,6 +705,9 @@ CCBServer::HandleRequestResultsMsg( CCBTarget *target )
 	if( request && request->getSock()->readReady() ) {
 		// Request socket must have just closed.  To avoid noise in
 		// logs when we fail to write to it, delete the request now.
+		if (success) {
+			RecordRequestLatency( request );
+		}
 		RemoveRequest( request );
 		request = NULL;
 		if (success) {
@@ -868,6 +881,9 @@ CCBServer::RequestFinished( CCBServerRequest *request, bool success, char const
 		request->getRequestID(),
 		request->getTargetCCBID() );
 
+	if (success) {
+		RecordRequestLatency( request );
+	}
 	RemoveRequest( request );
 	if (success) {
 		ccb_stats.CCBRequestsSucceeded += 1;
@@ -1096,6 +1112,7 @@ int
 CCBServer::HandleRequestDisconnect( Stream * /*stream*/ )
 {
 	CCBServerRequest *request = (CCBServerRequest *)daemonCore->GetDataPtr();
+	RecordRequestLatency( request );
 	RemoveRequest( request );
 	ccb_stats.CCBRequestsSucceeded += 1;
 	return KEEP_STREAM;
@@ -1225,7 +1242,8 @@ CCBServerRequest::CCBServerRequest(Sock *sock,CCBID target_ccbid,char const *ret
 	m_target_ccbid(target_ccbid),
 	m_request_id(-1),
 	m_return_addr(return_addr),
-	m_connect_id(connect_id)
+	m_connect_id(connect_id),
+	m_start_time(_condor_debug_get_time_double())
 {
 }
 
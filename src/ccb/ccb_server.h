@@ -164,6 +164,7 @@ class CCBServerRequest {
 	CCBID getTargetCCBID() const { return m_target_ccbid; }
 	char const *getReturnAddr() { return m_return_addr.c_str(); }
 	char const *getConnectID() { return m_connect_id.c_str(); }
+	double getStartTime() const { return m_start_time; }
 
  private:
 	Sock *m_sock;
@@ -171,6 +172,7 @@ class CCBServerRequest {
 	CCBID m_request_id;      // CCBServer-assigned identifier for this request
 	std::string m_return_addr;
 	std::string m_connect_id;
+	double m_start_time;     // when the client's request arrived
 };
 
 class CCBReconnectInfo {
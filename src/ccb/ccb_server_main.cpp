@@ -0,0 +1,156 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2007, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ * 
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// condor_ccb_server runs the CCB broker outside of the collector, so that
+// a pool with a very large number of CCB targets can take their persistent
+// connections and reconnect storms off the collector.  Clients point
+// CCB_ADDRESS at this daemon exactly as they would at a collector.
+
+#include "condor_common.h"
+#include "condor_daemon_core.h"
+#include "condor_debug.h"
+#include "condor_config.h"
+#include "condor_adtypes.h"
+#include "get_daemon_name.h"
+#include "subsystem_info.h"
+#include "ccb_server.h"
+
+static CCBServer *ccb_server = NULL;
+static char *ccb_server_name = NULL;
+static int update_collector_tid = -1;
+static int update_collector_interval = 5 * MINUTE;
+
+//-------------------------------------------------------------
+
+static void
+InitializeClassAd(ClassAd &ad)
+{
+	SetMyTypeName(ad, CCB_SERVER_ADTYPE);
+	ad.Assign(ATTR_NAME, ccb_server_name);
+
+		// Publish all DaemonCore-specific attributes, including the
+		// CCB statistics that were added to the DaemonCore stats pool.
+	daemonCore->publish(&ad);
+	daemonCore->dc_stats.Publish(ad);
+}
+
+static void
+UpdateCollector(int /* timerID */)
+{
+	ClassAd ad;
+	InitializeClassAd(ad);
+	daemonCore->sendUpdates(UPDATE_AD_GENERIC, &ad, NULL, true);
+}
+
+static void
+InvalidateAd()
+{
+	ClassAd query_ad;
+	SetMyTypeName(query_ad, QUERY_ADTYPE);
+	query_ad.Assign(ATTR_TARGET_TYPE, CCB_SERVER_ADTYPE);
+
+	std::string line;
+	formatstr(line, "TARGET.%s == \"%s\"", ATTR_NAME, ccb_server_name);
+	query_ad.AssignExpr(ATTR_REQUIREMENTS, line.c_str());
+	query_ad.Assign(ATTR_NAME, ccb_server_name);
+
+	daemonCore->sendUpdates(INVALIDATE_ADS_GENERIC, &query_ad, NULL, true);
+}
+
+static void
+Reconfig()
+{
+	free(ccb_server_name);
+	ccb_server_name = default_daemon_name();
+	if (ccb_server_name == NULL) {
+		EXCEPT("default_daemon_name() returned NULL");
+	}
+
+	ccb_server->InitAndReconfig();
+
+	update_collector_interval = param_integer("CCB_SERVER_UPDATE_INTERVAL", 5 * MINUTE);
+	if (update_collector_tid == -1) {
+		update_collector_tid = daemonCore->Register_Timer(0, update_collector_interval,
+			UpdateCollector, "UpdateCollector");
+	} else {
+		daemonCore->Reset_Timer(update_collector_tid, 0, update_collector_interval);
+	}
+}
+
+static void CleanUp()
+{
+	if (ccb_server_name) {
+		InvalidateAd();
+	}
+	delete ccb_server;
+	ccb_server = NULL;
+	free(ccb_server_name);
+	ccb_server_name = NULL;
+}
+
+//-------------------------------------------------------------
+
+void main_init(int /* argc */, char * /* argv */ [])
+{
+	dprintf(D_ALWAYS, "main_init() called\n");
+	AddCCBStatsToPool(daemonCore->dc_stats.Pool, IF_BASICPUB);
+	ccb_server = new CCBServer();
+	Reconfig();
+}
+
+//-------------------------------------------------------------
+
+void 
+main_config()
+{
+	dprintf(D_ALWAYS, "main_config() called\n");
+	Reconfig();
+}
+
+//-------------------------------------------------------------
+
+void main_shutdown_fast()
+{
+	dprintf(D_ALWAYS, "main_shutdown_fast() called\n");
+	CleanUp();
+	DC_Exit(0);
+}
+
+//-------------------------------------------------------------
+
+void main_shutdown_graceful()
+{
+	dprintf(D_ALWAYS, "main_shutdown_graceful() called\n");
+	CleanUp();
+	DC_Exit(0);
+}
+
+//-------------------------------------------------------------
+
+int
+main( int argc, char **argv )
+{
+	set_mySubSystem("CCB_SERVER", true, SUBSYSTEM_TYPE_DAEMON );	// used by Daemon Core
+
+	dc_main_init = main_init;
+	dc_main_config = main_config;
+	dc_main_shutdown_fast = main_shutdown_fast;
+	dc_main_shutdown_graceful = main_shutdown_graceful;
+	return dc_main( argc, argv );
+}
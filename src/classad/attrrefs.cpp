@@ -20,6 +20,7 @@
 
 #include "classad/common.h"
 #include "classad/classad.h"
+#include "classad/evalCache.h"
 
 using std::string;
 using std::vector;
@@ -204,8 +205,21 @@ _Evaluate (EvalState &state, Value &val) const
 			}
 			state.depth_remaining--;
 
+			// state.curAd is now the ad the expression was found in
+			const ClassAd *foundAd = state.curAd;
+			EvalCache *cache = foundAd ? state.evalCache : nullptr;
+			if( cache && cache->Lookup( foundAd, tree, val ) ) {
+				state.depth_remaining++;
+				state.curAd = curAd;
+				return true;
+			}
+
 			rval = tree->Evaluate( state, val );
 
+			if( cache && rval ) {
+				cache->Store( foundAd, tree, val );
+			}
+
 			state.depth_remaining++;
 
 			state.curAd = curAd;
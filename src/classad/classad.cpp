@@ -23,6 +23,8 @@
 #include "classad/sink.h"
 #include "classad/classadCache.h"
 
+#include <atomic>
+
 using std::string;
 using std::vector;
 using std::pair;
@@ -113,6 +115,13 @@ void SetOldClassAdSemantics(bool enable)
 	}
 }
 
+unsigned int ClassAd::
+NextVersion()
+{
+	static std::atomic<unsigned int> next_version(1);
+	return next_version.fetch_add(1, std::memory_order_relaxed);
+}
+
 ClassAd::
 ClassAd (const ClassAd &ad)
 {
@@ -780,6 +789,7 @@ Delete( const string &name )
 		delete itr->second;
 #endif
 		attrList.erase( itr );
+		Modified();
 		deleted_attribute = true;
 	}
 	// If the attribute is in the chained parent, we delete define it
@@ -829,6 +839,7 @@ Remove( const string &name )
 		tree = itr->second;
 		itr->second = nullptr;
 		attrList.erase( itr );
+		Modified();
 		tree->SetParentScope( NULL );
 	}
 
@@ -2088,6 +2099,7 @@ void ClassAd::ChainToAd(ClassAd *new_chain_parent_ad)
 {
 	if (new_chain_parent_ad != NULL) {
 		chained_parent_ad = new_chain_parent_ad;
+		Modified();
 	}
 	return;
 }
@@ -2112,6 +2124,7 @@ bool ClassAd::PruneChildAttr(const std::string & attrName, bool if_child_matches
 		delete itr->second;
 #endif
 		attrList.erase(itr);
+		Modified();
 		return true;
 	}
 	return false;
@@ -2151,6 +2164,7 @@ int ClassAd::PruneChildAd()
 				attrList.erase( itr );
 			}
 		}
+		Modified();
 	}
 	
 	return iRet;
@@ -2159,6 +2173,7 @@ int ClassAd::PruneChildAd()
 void ClassAd::Unchain(void)
 {
 	chained_parent_ad = NULL;
+	Modified();
 	return;
 }
 
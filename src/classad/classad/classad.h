@@ -83,7 +83,7 @@ class ClassAd : public ExprTree
 		/**@name Constructors/Destructor */
 		//@{
 		/// Default constructor 
-		ClassAd () : alternateScope(nullptr), do_dirty_tracking(false), chained_parent_ad(nullptr), parentScope(nullptr) {}
+		ClassAd () : alternateScope(nullptr), do_dirty_tracking(false), m_version(0), chained_parent_ad(nullptr), parentScope(nullptr) {}
 
 		/** Copy constructor
             @param ad The ClassAd to copy
@@ -599,6 +599,7 @@ class ClassAd : public ExprTree
 #ifndef USE_CLASSAD_FLAT_MAP
 			delete i->second;
 #endif
+			Modified();
 			return attrList.erase(i);
 		}
 		/** Deconstructor to get the components of a classad
@@ -642,6 +643,8 @@ class ClassAd : public ExprTree
 
 			this->dirtyAttrList = std::move(rhs.dirtyAttrList);
 			this->attrList = std::move(rhs.attrList);
+			Modified();
+			rhs.Modified();
 
 			return *this;
 		}
@@ -787,6 +790,7 @@ class ClassAd : public ExprTree
          */
 
 		void        MarkAttributeDirty(const std::string &name) {
+			Modified();
 			if (do_dirty_tracking) dirtyAttrList.insert(name);
 		}
 
@@ -815,6 +819,27 @@ class ClassAd : public ExprTree
 		dirtyIterator dirtyEnd() { return dirtyAttrList.end(); }
         //@}
 
+		/**@name Versioning */
+        //@{
+		/** Return the version of this ClassAd's contents. Inserting,
+		 *  deleting or replacing an attribute, or chaining or unchaining
+		 *  the ad, forgets the version, and the next call takes a new one
+		 *  from a process-wide counter, so a (ClassAd, version) pair names
+		 *  one state of one ad while modifications stay cheap.
+		 *  Expressions replaced by assigning through an iterator are not
+		 *  noticed.
+		 */
+		unsigned int GetVersion() const {
+			while ( ! m_version) { m_version = NextVersion(); }
+			return m_version;
+		}
+
+		/** Return the evaluation cache to use when this ad is the root
+		 *  scope of an evaluation, if any. See MatchClassAd::SetEvalCache().
+		 */
+		virtual EvalCache *GetEvalCache() const { return nullptr; }
+        //@}
+
 		/* This data member is intended for transitioning Condor from
 		 * old to new ClassAds. It allows unscoped attribute references
 		 * in expressions that can't be found in the local scope to be
@@ -854,9 +879,14 @@ class ClassAd : public ExprTree
 		virtual bool _Flatten( EvalState&, Value&, ExprTree*&, int* ) const;
 	
 		int LookupInScope( const std::string&, ExprTree*&, EvalState& ) const;
+
+		static unsigned int NextVersion();
+		void Modified() { m_version = 0; }
+
 		AttrList	  attrList;
 		DirtyAttrList dirtyAttrList;
 		bool          do_dirty_tracking;
+		mutable unsigned int m_version; // 0 until GetVersion() is called after a change
 		ClassAd       *chained_parent_ad;
 		const ClassAd *parentScope;
 };
@@ -0,0 +1,101 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef __CLASSAD_EVAL_CACHE_H__
+#define __CLASSAD_EVAL_CACHE_H__
+
+#include "classad/classad.h"
+#include <string>
+#include <unordered_map>
+
+namespace classad {
+
+/** Remembers the values of attribute expressions whose every reference
+	resolves within the ad the expression lives in, such as a machine's
+	START expression when it only looks at MY attributes.  Such a value
+	doesn't depend on the ad it is matched against, so it can be reused
+	for every other candidate, until the ad is modified (see
+	ClassAd::GetVersion()).
+
+	Expressions that refer to another ad (TARGET, or an attribute the ad
+	doesn't define), to parent or absolute scopes, to nested ads, or that
+	call time(), random(), eval() and the like, are never cached.  Nor
+	are list or ClassAd values, since those point into the evaluation.
+
+	An EvalCache is used by attribute references evaluated in an
+	EvalState whose root scope hands one out, which normally means a
+	MatchClassAd given one with MatchClassAd::SetEvalCache().  Entries
+	are keyed by ad pointer, so an EvalCache should not outlive the ads
+	it was used with by very long; call Clear() when they are deleted.
+	It is not thread-safe.
+*/
+class EvalCache
+{
+public:
+	struct Stats {
+		long hits{0};        // evaluations answered from the cache
+		long misses{0};      // cacheable evaluations that had to be done
+		long uncacheable{0}; // evaluations of expressions that depend on other ads
+	};
+
+	/** Look for the value of tree, an attribute expression of ad.
+		@return true and sets val if it is known
+	*/
+	bool Lookup( const ClassAd *ad, const ExprTree *tree, Value &val );
+
+	/** Remember the value of tree, an attribute expression of ad, if it
+		depends on nothing but the ad.
+	*/
+	void Store( const ClassAd *ad, const ExprTree *tree, const Value &val );
+
+	void Clear() { m_entries.clear(); }
+
+	size_t size() const { return m_entries.size(); }
+	const Stats & stats() const { return m_stats; }
+	void ClearStats() { m_stats = Stats(); }
+
+private:
+	struct Key {
+		const ClassAd *ad;
+		const ExprTree *tree;
+		bool operator==( const Key &rhs ) const { return ad == rhs.ad && tree == rhs.tree; }
+	};
+	struct KeyHash {
+		size_t operator()( const Key &key ) const {
+			return std::hash<const void*>()(key.ad) * 31 + std::hash<const void*>()(key.tree);
+		}
+	};
+	struct Entry {
+		unsigned int version{0};        // of the ad when this entry was made
+		unsigned int parent_version{0}; // of the ad's chained parent, if any
+		bool cacheable{false};
+		bool has_value{false};
+		Value val;
+	};
+
+	bool IsCurrent( const ClassAd *ad, const Entry &entry ) const;
+	bool IsSelfContained( const ClassAd *ad, const ExprTree *tree, References &seen, int depth ) const;
+
+	std::unordered_map<Key, Entry, KeyHash> m_entries;
+	Stats m_stats;
+};
+
+} // classad
+
+#endif//__CLASSAD_EVAL_CACHE_H__
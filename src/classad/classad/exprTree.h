@@ -33,6 +33,7 @@ namespace classad {
 class ExprTree;
 class ClassAd;
 class MatchClassAd;
+class EvalCache;
 
 
 class EvalState {
@@ -46,6 +47,7 @@ class EvalState {
 			, flattenAndInline(false)
 			, debug(false)
 			, inAttrRefScope(false)
+			, evalCache(nullptr)
 		{}
 
 		~EvalState( );
@@ -68,6 +70,10 @@ class EvalState {
 		bool		debug;
 		bool		inAttrRefScope;
 
+		// Results of attribute evaluations that can be reused, taken from
+		// the root scope by SetRootScope(). See EvalCache.
+		EvalCache	*evalCache;
+
 		// Cache_to_free are the things in the cache that must be
 		// freed when this gets deleted.
 		std::vector<ExprTree*> cache_to_delete;
@@ -93,6 +93,13 @@ class FunctionCall : public ExprTree
 
 	static bool RegisterSharedLibraryFunctions(const char *shared_library_path);
 
+	/** Returns true if the named function can return a different value
+	 *  when its arguments haven't changed (e.g. time() or random()), or is
+	 *  called for its side effects, so that a call to it can't be
+	 *  evaluated once and the value reused.
+	 */
+	static bool IsVolatileFunction(const std::string &functionName);
+
 	/** Returns true if the function expression points to a valid
 	 *  function in the ClassAd library.
 	 */
@@ -195,11 +195,21 @@ class MatchClassAd : public ClassAd
 		*/
 		static bool UnoptimizeAdForMatchmaking( ClassAd *ad );
 
+		/** Remember the values of attributes of the left and right ads
+			that depend only on the ad they are in, and reuse them in later
+			evaluations done in this match ad, for as long as the ad is not
+			modified. The cache is not owned by the match ad.
+			@param cache The cache to use, or NULL to stop caching.
+		*/
+		void SetEvalCache( EvalCache *cache ) { evalCache = cache; }
+		virtual EvalCache *GetEvalCache() const { return evalCache; }
+
 	protected:
 		const ClassAd *ladParent, *radParent;
 		ClassAd *lCtx, *rCtx, *lad, *rad;
 		ExprTree *symmetric_match, *right_matches_left, *left_matches_right;
 		std::string lAlias, rAlias;
+		EvalCache *evalCache;
 
     private:
         // The copy constructor and assignment operator are defined
@@ -69,6 +69,7 @@ public:
     bool  check_operator;
     bool  check_collection;
     bool  check_utils;
+    bool  check_eval_cache;
 	void  ParseCommandLine(int argc, char **argv);
 };
 
@@ -101,6 +102,7 @@ static void test_exprlist(const Parameters &parameters, Results &results);
 static void test_value(const Parameters &parameters, Results &results);
 static void test_collection(const Parameters &parameters, Results &results);
 static void test_utils(const Parameters &parameters, Results &results);
+static void test_eval_cache(const Parameters &parameters, Results &results);
 static bool check_in_view(ClassAdCollection *collection, string view_name, string classad_name);
 static void print_version(void);
 
@@ -133,6 +135,7 @@ void Parameters::ParseCommandLine(
     check_operator      = false;
     check_collection    = false;
     check_utils         = false;
+    check_eval_cache    = false;
 
 	// Then we parse to see what the user wants. 
 	for (int arg_index = 1; arg_index < argc; arg_index++) {
@@ -179,6 +182,9 @@ void Parameters::ParseCommandLine(
             selected_test       = true;
 		} else if (!strcasecmp(argv[arg_index], "-utils")){
             check_utils         = true;
+            selected_test       = true;
+		} else if (!strcasecmp(argv[arg_index], "-evalcache")){
+            check_eval_cache    = true;
             selected_test       = true;
 		} else {
             cout << "Unknown argument: " << argv[arg_index] << endl;
@@ -206,6 +212,7 @@ void Parameters::ParseCommandLine(
         cout << "    -operator:   test the Operator class.\n";
         cout << "    -collection: test the Collection class.\n";
         cout << "    -utils:      test little utilities.\n";
+        cout << "    -evalcache:  test the EvalCache class.\n";
         exit(1);
     }
     if (!selected_test) {
@@ -302,6 +309,9 @@ int main(
     if (parameters.check_all || parameters.check_utils) {
         test_utils(parameters, results);
     }
+    if (parameters.check_all || parameters.check_eval_cache) {
+        test_eval_cache(parameters, results);
+    }
 
     /* ----- Report ----- */
     cout << endl;
@@ -1036,6 +1046,91 @@ static void test_utils(const Parameters &, Results &results)
     return;
 }
 
+/*********************************************************************
+ *
+ * Function: test_eval_cache
+ * Purpose:  Test that values remembered by an EvalCache are reused,
+ *           and are forgotten when the ads they depend on change.
+ *
+ *********************************************************************/
+static void test_eval_cache(const Parameters &, Results &results)
+{
+    ClassAdParser parser;
+    EvalCache     cache;
+    Value         v;
+    int           i;
+    long          hits;
+
+    cout << "Testing the EvalCache class...\n";
+
+    TEST("time() is volatile", FunctionCall::IsVolatileFunction("time"));
+    TEST("splitTime() is volatile", FunctionCall::IsVolatileFunction("SPLITTIME"));
+    TEST("random() is volatile", FunctionCall::IsVolatileFunction("random"));
+    TEST("strcat() is not volatile", !FunctionCall::IsVolatileFunction("strcat"));
+
+    ClassAd *parent  = parser.ParseClassAd("[ Disk = 100; ]");
+    ClassAd *machine = parser.ParseClassAd(
+        "[ Memory = 1024; A = Memory * 2; B = Disk * 3; "
+        "  Now = time(); R = random(1000000); U = TARGET.X + 1; ]");
+    ClassAd *job     = parser.ParseClassAd("[ X = 1; ]");
+    machine->ChainToAd(parent);
+
+    /* ----- Versions ----- */
+    unsigned int version = machine->GetVersion();
+    TEST("Version is stable", machine->GetVersion() == version);
+    machine->InsertAttr("Unused", 1);
+    TEST("Insert changes the version", machine->GetVersion() != version);
+
+    MatchClassAd match(job, machine);
+    match.SetEvalCache(&cache);
+
+    /* ----- Reuse ----- */
+    TEST("A is 2048", machine->EvaluateExpr("A", v) && v.IsIntegerValue(i) && i == 2048);
+    hits = cache.stats().hits;
+    TEST("A is still 2048", machine->EvaluateExpr("A", v) && v.IsIntegerValue(i) && i == 2048);
+    TEST("A came from the cache", cache.stats().hits == hits + 1);
+
+    /* ----- Insert ----- */
+    machine->InsertAttr("Memory", 4096);
+    hits = cache.stats().hits;
+    TEST("A follows an inserted Memory", machine->EvaluateExpr("A", v) && v.IsIntegerValue(i) && i == 8192);
+    TEST("A was not reused after Insert", cache.stats().hits == hits);
+
+    /* ----- Delete ----- */
+    machine->Delete("Memory");
+    TEST("A is undefined after Delete", machine->EvaluateExpr("A", v) && v.IsUndefinedValue());
+
+    /* ----- Chained parent ----- */
+    TEST("B is 300", machine->EvaluateExpr("B", v) && v.IsIntegerValue(i) && i == 300);
+    parent->InsertAttr("Disk", 200);
+    TEST("B follows the chained parent", machine->EvaluateExpr("B", v) && v.IsIntegerValue(i) && i == 600);
+    machine->Unchain();
+    TEST("B is undefined once unchained", machine->EvaluateExpr("B", v) && v.IsUndefinedValue());
+
+    /* ----- Other ad ----- */
+    TEST("U is 2", machine->EvaluateExpr("U", v) && v.IsIntegerValue(i) && i == 2);
+    job->InsertAttr("X", 5);
+    TEST("U follows the target", machine->EvaluateExpr("U", v) && v.IsIntegerValue(i) && i == 6);
+
+    /* ----- Volatile functions ----- */
+    machine->EvaluateExpr("Now", v);
+    machine->EvaluateExpr("R", v);
+    hits = cache.stats().hits;
+    long uncacheable = cache.stats().uncacheable;
+    machine->EvaluateExpr("Now", v);
+    machine->EvaluateExpr("R", v);
+    TEST("time() and random() are not reused", cache.stats().hits == hits);
+    TEST("time() and random() are uncacheable", cache.stats().uncacheable == uncacheable + 2);
+
+    match.SetEvalCache(NULL);
+    match.RemoveLeftAd();
+    match.RemoveRightAd();
+    delete job;
+    delete machine;
+    delete parent;
+    return;
+}
+
 /*********************************************************************
  *
  * Function: print_version
@@ -0,0 +1,193 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "classad/common.h"
+#include "classad/evalCache.h"
+#include "classad/classadCache.h"
+
+using std::string;
+using std::vector;
+
+namespace classad {
+
+bool EvalCache::
+IsCurrent( const ClassAd *ad, const Entry &entry ) const
+{
+	if ( entry.version != ad->GetVersion() ) {
+		return false;
+	}
+	const ClassAd *parent = ad->GetChainedParentAd();
+	return entry.parent_version == ( parent ? parent->GetVersion() : 0 );
+}
+
+// Does every attribute reference in tree resolve within ad, following
+// references to other attributes of ad?  This mirrors the lookups done by
+// AttributeReference::FindExpr(): an unscoped name that ad doesn't define
+// would be looked for in the parent scopes and the alternate (TARGET) scope.
+bool EvalCache::
+IsSelfContained( const ClassAd *ad, const ExprTree *tree, References &seen, int depth ) const
+{
+	if ( ! tree || depth <= 0 ) {
+		return false;
+	}
+
+	switch ( tree->GetKind() ) {
+		case ExprTree::ERROR_LITERAL:
+		case ExprTree::UNDEFINED_LITERAL:
+		case ExprTree::BOOLEAN_LITERAL:
+		case ExprTree::INTEGER_LITERAL:
+		case ExprTree::REAL_LITERAL:
+		case ExprTree::RELTIME_LITERAL:
+		case ExprTree::ABSTIME_LITERAL:
+		case ExprTree::STRING_LITERAL:
+			return true;
+
+		case ExprTree::ATTRREF_NODE: {
+			ExprTree *scope;
+			string attr;
+			bool absolute;
+			((const AttributeReference*)tree)->GetComponents( scope, attr, absolute );
+			if ( absolute ) {
+				return false;
+			}
+			if ( scope ) {
+				// only SELF.attr and (with old ClassAd semantics) MY.attr
+				// are sure to refer to this ad
+				ExprTree *scope_scope;
+				string scope_attr;
+				bool scope_absolute;
+				if ( scope->GetKind() != ExprTree::ATTRREF_NODE ) {
+					return false;
+				}
+				((const AttributeReference*)scope)->GetComponents( scope_scope, scope_attr, scope_absolute );
+				if ( scope_scope || scope_absolute || ad->Lookup( scope_attr ) ) {
+					return false;
+				}
+				if ( strcasecmp( scope_attr.c_str(), "self" ) != 0 &&
+					 ! ( _useOldClassAdSemantics && strcasecmp( scope_attr.c_str(), "my" ) == 0 ) ) {
+					return false;
+				}
+			}
+			if ( ! seen.insert( attr ).second ) {
+				// already checked, or being checked further up
+				return true;
+			}
+			return IsSelfContained( ad, ad->Lookup( attr ), seen, depth - 1 );
+		}
+
+		case ExprTree::OP_NODE: {
+			Operation::OpKind op;
+			ExprTree *t1, *t2, *t3;
+			((const Operation*)tree)->GetComponents( op, t1, t2, t3 );
+			return ( ! t1 || IsSelfContained( ad, t1, seen, depth - 1 ) ) &&
+				   ( ! t2 || IsSelfContained( ad, t2, seen, depth - 1 ) ) &&
+				   ( ! t3 || IsSelfContained( ad, t3, seen, depth - 1 ) );
+		}
+
+		case ExprTree::FN_CALL_NODE: {
+			string fnName;
+			vector<ExprTree*> args;
+			((const FunctionCall*)tree)->GetComponents( fnName, args );
+			if ( FunctionCall::IsVolatileFunction( fnName ) ) {
+				return false;
+			}
+			for ( const ExprTree *arg : args ) {
+				if ( ! IsSelfContained( ad, arg, seen, depth - 1 ) ) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		case ExprTree::EXPR_LIST_NODE: {
+			vector<ExprTree*> exprs;
+			((const ExprList*)tree)->GetComponents( exprs );
+			for ( const ExprTree *expr : exprs ) {
+				if ( ! IsSelfContained( ad, expr, seen, depth - 1 ) ) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		case ExprTree::EXPR_ENVELOPE:
+			return IsSelfContained( ad, ((const CachedExprEnvelope*)tree)->get(), seen, depth - 1 );
+
+		default:
+			// nested ads can refer to their parent scopes
+			return false;
+	}
+}
+
+bool EvalCache::
+Lookup( const ClassAd *ad, const ExprTree *tree, Value &val )
+{
+	auto found = m_entries.find( Key{ad, tree} );
+	if ( found == m_entries.end() ) {
+		return false;
+	}
+	const Entry &entry = found->second;
+	if ( ! entry.has_value || ! IsCurrent( ad, entry ) ) {
+		return false;
+	}
+	val.CopyFrom( entry.val );
+	m_stats.hits++;
+	return true;
+}
+
+void EvalCache::
+Store( const ClassAd *ad, const ExprTree *tree, const Value &val )
+{
+	Entry &entry = m_entries[Key{ad, tree}];
+	if ( ! IsCurrent( ad, entry ) ) {
+		const ClassAd *parent = ad->GetChainedParentAd();
+		References seen;
+		entry.version = ad->GetVersion();
+		entry.parent_version = parent ? parent->GetVersion() : 0;
+		entry.cacheable = IsSelfContained( ad, tree, seen, 100 );
+		entry.has_value = false;
+		entry.val.Clear();
+	}
+	if ( ! entry.cacheable ) {
+		m_stats.uncacheable++;
+		return;
+	}
+
+	switch ( val.GetType() ) {
+		case Value::ERROR_VALUE:
+		case Value::UNDEFINED_VALUE:
+		case Value::BOOLEAN_VALUE:
+		case Value::INTEGER_VALUE:
+		case Value::REAL_VALUE:
+		case Value::RELATIVE_TIME_VALUE:
+		case Value::ABSOLUTE_TIME_VALUE:
+		case Value::STRING_VALUE:
+			entry.val.CopyFrom( val );
+			entry.has_value = true;
+			m_stats.misses++;
+			break;
+		default:
+			// lists and ads point into the evaluation that made them
+			entry.cacheable = false;
+			m_stats.uncacheable++;
+			break;
+	}
+}
+
+} // classad
@@ -329,6 +329,7 @@ SetRootScope( )
         
         rootAd = prevScope;
     }
+    evalCache = rootAd ? rootAd->GetEvalCache() : nullptr;
     return;
 }
 
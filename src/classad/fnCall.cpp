@@ -333,6 +333,25 @@ void FunctionCall::RegisterFunctions(
 	return;
 }
 
+// functions whose result can change when none of their arguments do,
+// or that are called for their side effects.  Some of these are only
+// registered by HTCondor.
+static const char * const volatile_functions[] = {
+	"time", "currentTime", "timeZoneOffset", "dayTime", "absTime", "splitTime", "formatTime",
+	"random", "eval", "debug", "unresolved", "SlotEval", "userHome", "userMap",
+};
+
+bool FunctionCall::IsVolatileFunction(
+	const string &functionName)
+{
+	for (const char *fn : volatile_functions) {
+		if (strcasecmp(fn, functionName.c_str()) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool FunctionCall::RegisterSharedLibraryFunctions(
 	const char *shared_library_path)
 {
@@ -40,6 +40,7 @@ MatchClassAd()
 	symmetric_match = NULL;
 	right_matches_left = NULL;
 	left_matches_right = NULL;
+	evalCache = NULL;
 	InitMatchClassAd( NULL, NULL );
 }
 
@@ -49,6 +50,7 @@ MatchClassAd( ClassAd *adl, ClassAd *adr ) : ClassAd()
 {
 	lad = rad = lCtx = rCtx = NULL;
 	ladParent = radParent = NULL;
+	evalCache = NULL;
 	InitMatchClassAd( adl, adr );
 }
 
@@ -1517,6 +1517,18 @@ int CollectorDaemon::receive_update(int command, Stream* sock)
     // process the given command
 	if (!(record = collector.collect (command,(Sock*)sock,from,insert)))
 	{
+		if (insert == 2 || insert == 3)
+		{
+			// a slot base ad, it is kept apart from the ad tables.
+			// view collectors get the slot ads that refer to it in full.
+			// or a slot ad that refers to a base ad we don't have yet, which
+			// is dropped until the startd sends it again after the base ad.
+			if( sock->type() == Stream::reli_sock ) {
+				return stashSocket( (ReliSock *)sock );
+			}
+			return TRUE;
+		}
+
 		if (insert == -2)
 		{
 			// this should never happen assuming we never register QUERY
@@ -2258,6 +2270,9 @@ void CollectorDaemon::Config()
 	time_t garbage_interval = param_integer( "COLLECTOR_STATS_SWEEP", DEFAULT_COLLECTOR_STATS_GARBAGE_INTERVAL );
 	collectorStats.setGarbageCollectionInterval( garbage_interval );
 
+		// include the collector statistics in the metrics endpoint
+	daemonCore->dc_stats.AddMetricsPool( &collectorStats.global.Pool );
+
     max_query_workers = param_integer ("COLLECTOR_QUERY_WORKERS", 4, 0);
 	max_pending_query_workers = param_integer ("COLLECTOR_QUERY_WORKERS_PENDING", 50, 0);
 	max_query_worktime = param_integer("COLLECTOR_QUERY_MAX_WORKTIME",0,0);
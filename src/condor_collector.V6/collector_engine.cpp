@@ -711,6 +711,13 @@ collect (int command,ClassAd *clientAd,const condor_sockaddr& from,int &insert,S
 	{
 	  case UPDATE_STARTD_AD:
 	  case UPDATE_STARTD_AD_WITH_ACK:
+		if (MATCH == strcasecmp(GetMyTypeName(*clientAd), STARTD_SLOT_BASE_ADTYPE)) {
+			// not stored in the ad tables, it is kept for the slot ads that refer to it
+			updateSlotBaseAd(*clientAd);
+			insert = 2;
+			retVal = nullptr;
+			break;
+		}
 		if ( repeatStartdAds > 0 ) {
 			clientAdToRepeat = new ClassAd(*clientAd);
 		}
@@ -731,8 +738,17 @@ collect (int command,ClassAd *clientAd,const condor_sockaddr& from,int &insert,S
 			retVal=updateClassAd (StartdDaemonAds, "StartDaemonAd", "StartD", false,
 				clientAd, hk, hashString, insert, from );
 		} else {
+			std::shared_ptr<ClassAd> baseAd;
+			if ( ! chainToSlotBaseAd(*clientAd, hashString, baseAd)) {
+				// a pruned slot ad whose base ad we don't have; it is not stored
+				// (any previous copy of it stays) until it comes again after its base ad
+				insert = 3;
+				retVal = nullptr;
+				break;
+			}
 			retVal=updateClassAd (StartdSlotAds,   "MachineSlotAd", "Slot", true,
 								  clientAd, hk, hashString, insert, from );
+			if (retVal) { retVal->m_baseAd = baseAd; }
 
 			// For old Startd ads, we want to synthesize a StartDaemon ad from the slot1 ad
 			if (realAdType == STARTD_AD) {
@@ -1338,6 +1354,89 @@ updateClassAd (CollectorHashTable &hashTable,
 	}
 }
 
+void CollectorEngine::
+updateSlotBaseAd(ClassAd & ad)
+{
+	std::string key;
+	long long sequence = 0;
+	if ( ! ad.LookupString(ATTR_SLOT_BASE_AD, key) || ! ad.LookupInteger(ATTR_SLOT_BASE_AD_SEQUENCE, sequence)) {
+		dprintf(D_ALWAYS, "SlotBaseAd: ad has no %s or %s, ignoring it\n",
+				ATTR_SLOT_BASE_AD, ATTR_SLOT_BASE_AD_SEQUENCE);
+		return;
+	}
+
+	SlotBaseAd & base = m_slotBaseAds[key];
+	base.last_heard = time(nullptr);
+	if (base.ad && base.sequence == sequence) {
+		// the startd sends it with each round of d-slot updates, but it rarely changes
+		return;
+	}
+
+	dprintf(D_FULLDEBUG, "SlotBaseAd: %s \"%s\" sequence %lld\n",
+			base.ad ? "Updating" : "Inserting", key.c_str(), sequence);
+
+	// slot ads that were chained to the old base ad keep it until they are replaced
+	base.ad = std::make_shared<ClassAd>(ad);
+	base.sequence = sequence;
+
+	// these identify the base ad itself, the slot ads have their own
+	base.ad->Delete(ATTR_MY_TYPE);
+	base.ad->Delete(ATTR_NAME);
+	base.ad->Delete(ATTR_MY_ADDRESS);
+	base.ad->Delete(ATTR_SLOT_BASE_AD);
+	base.ad->Delete(ATTR_SLOT_BASE_AD_SEQUENCE);
+	base.ad->Delete(ATTR_AUTHENTICATED_IDENTITY);
+	base.ad->Delete(ATTR_AUTHENTICATION_METHOD);
+}
+
+// chain a slot ad that refers to a slot base ad to it, and set baseAd to the base ad.
+// returns false if the slot ad refers to a base ad we don't have, the slot ad is
+// then missing the machine-wide attributes and should not be stored.
+bool CollectorEngine::
+chainToSlotBaseAd(ClassAd & ad, const std::string & hashString, std::shared_ptr<ClassAd> & baseAd)
+{
+	baseAd.reset();
+	std::string key;
+	if ( ! ad.LookupString(ATTR_SLOT_BASE_AD, key)) {
+		return true;
+	}
+	long long sequence = -1;
+	ad.LookupInteger(ATTR_SLOT_BASE_AD_SEQUENCE, sequence);
+
+	auto found = m_slotBaseAds.find(key);
+	if (found == m_slotBaseAds.end() || found->second.sequence != sequence) {
+		// The startd sends the base ad ahead of the slot ads that refer to it in
+		// every round of updates, so this only happens when the base ad update was
+		// lost or we just restarted.  The startd's next round, which always leads
+		// with the base ad, brings the slot ad again.
+		dprintf(D_ALWAYS, "MachineSlotAd: slot base ad \"%s\" sequence %lld for \"%s\" is unknown, ignoring the slot ad until it is resent\n",
+				key.c_str(), sequence, hashString.c_str());
+		return false;
+	}
+
+	// The stored slot ad is complete once chained, so it should no longer refer to
+	// the base ad; that way ads forwarded to a view collector are taken as they are.
+	ad.Delete(ATTR_SLOT_BASE_AD);
+	ad.Delete(ATTR_SLOT_BASE_AD_SEQUENCE);
+	ad.ChainToAd(found->second.ad.get());
+	baseAd = found->second.ad;
+	return true;
+}
+
+// forget base ads that no slot ad refers to, and that the startd has stopped sending
+void CollectorEngine::
+cleanSlotBaseAds(time_t now)
+{
+	for (auto it = m_slotBaseAds.begin(); it != m_slotBaseAds.end(); ) {
+		if (it->second.ad.use_count() <= 1 && now - it->second.last_heard > machineUpdateInterval) {
+			dprintf(D_FULLDEBUG, "\t\tRemoving slot base ad \"%s\"\n", it->first.c_str());
+			it = m_slotBaseAds.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
 CollectorRecord * CollectorEngine::
 mergeClassAd (CollectorHashTable &hashTable,
 			   const char *adType,
@@ -1413,6 +1512,9 @@ housekeeper( int /* timerID */ )
 	dprintf (D_ALWAYS, "\tCleaning StartdDaemonAds ...\n");
 	cleanHashTable (StartdDaemonAds, now, makeStartdAdHashKey);
 
+	dprintf (D_ALWAYS, "\tCleaning SlotBaseAds ...\n");
+	cleanSlotBaseAds(now);
+
 	dprintf (D_ALWAYS, "\tCleaning ScheddAds ...\n");
 	cleanHashTable (ScheddAds, now, makeScheddAdHashKey);
 
@@ -25,6 +25,9 @@
 #include "collector_stats.h"
 #include "hashkey.h"
 
+#include <map>
+#include <memory>
+
 struct CollectorRecord
 {
 	CollectorRecord(ClassAd* public_ad, ClassAd* pvt_ad)
@@ -35,6 +38,7 @@ struct CollectorRecord
 
 	ClassAd* m_publicAd;
 	ClassAd* m_pvtAd;
+	std::shared_ptr<ClassAd> m_baseAd; // slot base ad that m_publicAd is chained to, if any
 };
 
 // type for the hash tables ...
@@ -220,6 +224,19 @@ class CollectorEngine : public Service
 	// support for dynamically created tables
 	CollectorHashTable *findOrCreateTable(const std::string &str);
 
+	// Machine-wide attributes that a startd sends once for all of its dynamic slots,
+	// keyed by the address of the startd.  Slot ads that refer to a base ad are chained
+	// to it, and hold a reference so that it outlives being replaced here.
+	struct SlotBaseAd {
+		std::shared_ptr<ClassAd> ad;
+		long long sequence{0};
+		time_t last_heard{0};
+	};
+	std::map<std::string, SlotBaseAd> m_slotBaseAds;
+	void updateSlotBaseAd(ClassAd & ad);
+	bool chainToSlotBaseAd(ClassAd & ad, const std::string & hashString, std::shared_ptr<ClassAd> & baseAd);
+	void cleanSlotBaseAds(time_t now);
+
 	bool ValidateClassAd(int command,ClassAd *clientAd,Sock *sock);
 
 	void* __self_ad__; // contains address of last Ad for this collector added to the hashtable, do NOT free from here
@@ -0,0 +1,144 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_debug.h"
+#include "condor_config.h"
+#include "condor_daemon_core.h"
+#include "reli_sock.h"
+#include "selector.h"
+#include "command_connection_pool.h"
+
+CommandConnectionPool &
+CommandConnectionPool::global()
+{
+		// never destroyed, closing sockets during static destruction
+		// is asking for trouble
+	static CommandConnectionPool *pool = new CommandConnectionPool;
+	return *pool;
+}
+
+// An idle connection should have nothing to read.  If it does, the
+// server has hung up (or is confused), and the connection is no good.
+static bool
+idleConnectionIsUsable(ReliSock *sock)
+{
+	if ( ! sock->is_connected()) {
+		return false;
+	}
+	Selector selector;
+	selector.add_fd(sock->get_file_desc(), Selector::IO_READ);
+	selector.set_timeout(0);
+	selector.execute();
+	return ! selector.has_ready();
+}
+
+void
+CommandConnectionPool::expire(time_t now)
+{
+	int idle_timeout = param_integer("COMMAND_CONNECTION_POOL_IDLE_TIMEOUT", 50, 0);
+	while ( ! m_idle.empty() && now - m_idle.front().idle_since >= idle_timeout) {
+		dprintf(D_FULLDEBUG, "Closing idle command connection to %s\n", m_idle.front().addr.c_str());
+		delete m_idle.front().sock;
+		m_idle.pop_front();
+		m_stats.expired++;
+	}
+}
+
+ReliSock *
+CommandConnectionPool::checkout(const std::string &addr, const std::string &sess_id)
+{
+	expire(time(nullptr));
+
+	ReliSock *sock = nullptr;
+	if ( ! sess_id.empty()) {
+		for (size_t i = m_idle.size(); i-- > 0; ) {
+			if (m_idle[i].addr != addr || m_idle[i].sess_id != sess_id) {
+				continue;
+			}
+			ReliSock *candidate = m_idle[i].sock;
+			m_idle.erase(m_idle.begin() + i);
+			if (idleConnectionIsUsable(candidate)) {
+				sock = candidate;
+				break;
+			}
+			dprintf(D_FULLDEBUG, "Command connection to %s was closed while idle\n", addr.c_str());
+			delete candidate;
+			m_stats.expired++;
+		}
+	}
+
+	if (sock) {
+		m_stats.hits++;
+		if (daemonCore) { daemonCore->dc_stats.CommandConnectionPoolHits += 1; }
+		dprintf(D_COMMAND, "Reusing command connection to %s (session %s)\n", addr.c_str(), sess_id.c_str());
+	} else {
+		m_stats.misses++;
+		if (daemonCore) { daemonCore->dc_stats.CommandConnectionPoolMisses += 1; }
+	}
+	return sock;
+}
+
+void
+CommandConnectionPool::checkin(Sock *sock)
+{
+	if ( ! sock) {
+		return;
+	}
+
+	int max_idle = param_integer("COMMAND_CONNECTION_POOL_SIZE", 8, 0);
+	ReliSock *rsock = dynamic_cast<ReliSock *>(sock);
+	if (max_idle <= 0 || ! rsock || ! rsock->get_connect_addr() ||
+		rsock->getSessionID().empty() || ! idleConnectionIsUsable(rsock))
+	{
+		delete sock;
+		return;
+	}
+
+		// The server forgets the security state of a kept-alive
+		// connection once its command is done, so we must too.
+		// The next command resumes the session from scratch.
+	rsock->set_MD_mode(MD_OFF);
+	rsock->set_crypto_key(false, NULL);
+	rsock->setFullyQualifiedUser(NULL);
+	rsock->setTriedAuthentication(false);
+
+	m_idle.push_back(Entry{rsock->get_connect_addr(), rsock->getSessionID(), rsock, time(nullptr)});
+	m_stats.returned++;
+
+	while ((int)m_idle.size() > max_idle) {
+		delete m_idle.front().sock;
+		m_idle.pop_front();
+	}
+}
+
+void
+CommandConnectionPool::reuseFailed()
+{
+	m_stats.failed++;
+}
+
+void
+CommandConnectionPool::clear()
+{
+	for (auto &entry : m_idle) {
+		delete entry.sock;
+	}
+	m_idle.clear();
+}
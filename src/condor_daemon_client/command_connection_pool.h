@@ -0,0 +1,95 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _CONDOR_COMMAND_CONNECTION_POOL_H
+#define _CONDOR_COMMAND_CONNECTION_POOL_H
+
+#include <deque>
+#include <string>
+
+class Sock;
+class ReliSock;
+
+/*
+ Idle TCP command connections, kept so that the next command to the same
+ daemon does not have to connect again.  A connection is pooled under the
+ address it was connected to and the security session its last command
+ used, and it is only handed out for a command that will resume that same
+ session.  Each command on a pooled connection still goes through the
+ usual DC_AUTHENTICATE session resumption, so authorization is exactly
+ what it would be on a new connection; what is saved is the connect (and
+ any shared port or CCB routing) and, for the server, the accept.
+
+ The server only holds a connection open if the client asked it to (see
+ SecMan::StartCommandRequest::m_keep_alive) and it is willing to, for at
+ most COMMAND_CONNECTION_IDLE_TIMEOUT seconds.  We give up on idle
+ connections after COMMAND_CONNECTION_POOL_IDLE_TIMEOUT seconds, which
+ should be the shorter of the two, and we throw away any connection that
+ the server has closed or that has unexpected data waiting on it.
+
+ Daemon objects use the process-wide pool when told to with
+ Daemon::setUseConnectionPool().
+*/
+class CommandConnectionPool
+{
+public:
+	struct Stats {
+		long hits{0};     // commands sent on a pooled connection
+		long misses{0};   // commands that had to make a new connection
+		long returned{0}; // connections put back in the pool
+		long expired{0};  // idle connections closed by us or the server
+		long failed{0};   // pooled connections that failed to start a command
+	};
+
+	static CommandConnectionPool & global();
+
+	~CommandConnectionPool() { clear(); }
+
+		// Take an idle connection to addr whose last command used the
+		// session sess_id, or NULL if there isn't one.  The caller owns it.
+	ReliSock *checkout(const std::string &addr, const std::string &sess_id);
+
+		// Give back a connection whose command has completed (the reply
+		// has been read through its end_of_message()).  The connection
+		// is deleted if it can't be kept.
+	void checkin(Sock *sock);
+
+		// A connection from checkout() turned out to be unusable.
+	void reuseFailed();
+
+		// Close all idle connections.
+	void clear();
+
+	const Stats & stats() const { return m_stats; }
+
+private:
+	struct Entry {
+		std::string addr;
+		std::string sess_id;
+		ReliSock *sock;
+		time_t idle_since;
+	};
+
+	void expire(time_t now);
+
+	std::deque<Entry> m_idle; // least recently used first
+	Stats m_stats;
+};
+
+#endif
@@ -41,6 +41,7 @@
 #include "condor_sinful.h"
 #include "condor_claimid_parser.h"
 #include "authentication.h"
+#include "command_connection_pool.h"
 
 #include "ipv6_hostname.h"
 
@@ -216,6 +217,7 @@ Daemon::deepCopy( const Daemon &copy )
 
 	m_owner = copy.m_owner;
 	m_methods = copy.m_methods;
+	m_use_connection_pool = copy.m_use_connection_pool;
 
 		/*
 		  there's nothing to copy for _sec_man... it'll already be
@@ -614,6 +616,14 @@ Daemon::startCommand( int cmd, Stream::stream_type st,Sock **sock,int timeout, C
 	// Also, there's no one to delete the Sock.
 	ASSERT(!nonblocking || callback_fn);
 
+	bool use_pool = m_use_connection_pool && st == Stream::reli_sock && !nonblocking && !callback_fn && !raw_protocol;
+	if( use_pool ) {
+		*sock = startPooledCommand(cmd, timeout, subcmd, cmd_description, sec_session_id);
+		if( *sock ) {
+			return StartCommandSucceeded;
+		}
+	}
+
 	if (IsDebugLevel(D_COMMAND)) {
 		const char * addr = this->addr();
 		dprintf (D_COMMAND, "Daemon::startCommand(%s,...) making connection to %s\n", getCommandStringSafe(cmd), addr ? addr : "NULL");
@@ -644,11 +654,72 @@ Daemon::startCommand( int cmd, Stream::stream_type st,Sock **sock,int timeout, C
 	req.m_sec_session_id = sec_session_id ? sec_session_id : m_sec_session_id.c_str();
 	req.m_owner = m_owner;
 	req.m_methods = m_methods;
+	req.m_keep_alive = use_pool;
 
 	return startCommand_internal( req, timeout, &_sec_man );
 }
 
 
+Sock *
+Daemon::startPooledCommand( int cmd, int timeout, int subcmd, char const *cmd_description, char const *sec_session_id )
+{
+	const char *daemon_addr = addr();
+	if( ! daemon_addr ) {
+		return NULL;
+	}
+
+	std::string sess_id;
+	const char *session_hint = sec_session_id ? sec_session_id : m_sec_session_id.c_str();
+	if( ! _sec_man.findCommandSession(daemon_addr, cmd, session_hint, m_owner, sess_id) ) {
+		sess_id.clear();
+	}
+
+	CommandConnectionPool &pool = CommandConnectionPool::global();
+	ReliSock *rsock = pool.checkout(daemon_addr, sess_id);
+	if( ! rsock ) {
+		return NULL;
+	}
+
+		// Always wait for the server's response to the session
+		// resumption, so that a connection it closed in the meantime
+		// is noticed here, where we can still fall back to a new one.
+	CondorError errstack;
+	SecMan::StartCommandRequest req;
+	req.m_cmd = cmd;
+	req.m_sock = rsock;
+	req.m_resume_response = true;
+	req.m_errstack = &errstack;
+	req.m_subcmd = subcmd;
+	req.m_nonblocking = false;
+	req.m_cmd_description = cmd_description;
+	req.m_sec_session_id = sess_id.c_str();
+	req.m_owner = m_owner;
+	req.m_methods = m_methods;
+	req.m_keep_alive = true;
+
+	if( startCommand_internal(req, timeout, &_sec_man) == StartCommandSucceeded ) {
+		return rsock;
+	}
+
+	dprintf(D_FULLDEBUG, "Failed to start %s on a pooled connection to %s, making a new connection: %s\n",
+			getCommandStringSafe(cmd), daemon_addr, errstack.getFullText().c_str());
+	pool.reuseFailed();
+	delete rsock;
+	return NULL;
+}
+
+
+void
+Daemon::releaseCommandSocket( Sock *sock )
+{
+	if( m_use_connection_pool ) {
+		CommandConnectionPool::global().checkin(sock);
+	} else {
+		delete sock;
+	}
+}
+
+
 bool
 Daemon::startSubCommand( int cmd, int subcmd, Sock* sock, int timeout, CondorError *errstack, char const *cmd_description,bool raw_protocol, char const *sec_session_id, bool resume_response )
 {
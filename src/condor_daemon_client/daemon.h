@@ -412,6 +412,24 @@ public:
 			bool raw_protocol=false, char const *sec_session_id=NULL,
 			bool resume_response=true);
 
+		/** Send blocking TCP commands from startCommand() on idle
+		  connections from the process-wide CommandConnectionPool,
+		  when there is one to this daemon for the security session
+		  the command would use, and ask the daemon to keep new
+		  connections open afterwards.  Hand each socket back with
+		  releaseCommandSocket() once the command's reply has been
+		  read, instead of deleting it.
+		  */
+	void setUseConnectionPool( bool use ) { m_use_connection_pool = use; }
+
+		/** Done with a socket from startCommand().  If this object
+		  uses the connection pool, the connection is kept for the
+		  next command; otherwise it is deleted.  Only call this after
+		  a command completed successfully; delete the socket if it
+		  didn't.
+		  */
+	void releaseCommandSocket( Sock *sock );
+
 		/** Start sending the given command and subcommand to the daemon.  The caller
 		  gives the command they want to send, and a pointer to the
 		  Sock they want us to use to send it over.  This method will
@@ -925,6 +943,14 @@ protected:
 		 */
 	StartCommandResult startCommand( int cmd, Stream::stream_type st,Sock **sock,int timeout, CondorError *errstack, int subcmd, StartCommandCallbackType *callback_fn, void *misc_data, bool nonblocking, char const *cmd_description=NULL, bool raw_protocol=false, char const *sec_session_id=NULL, bool resume_response=true );
 
+		/**
+		   Start a blocking command on an idle connection from the
+		   connection pool, if there is a suitable one.
+		   @return the socket, or NULL if the caller should make a
+		   new connection.
+		 */
+	Sock *startPooledCommand( int cmd, int timeout, int subcmd, char const *cmd_description, char const *sec_session_id );
+
 		/**
 		   Class used internally to handle non-blocking connects for
 		   startCommand().
@@ -958,6 +984,9 @@ private:
 
 		// Authentication method overrides
 	std::vector<std::string> m_methods;
+
+		// Send commands on pooled connections
+	bool m_use_connection_pool{false};
 };
 
 /** This helper class is derived from the Daemon class; it allows
@@ -58,6 +58,7 @@
 #include "generic_stats.h"
 #include "filesystem_remap.h"
 #include "daemon_keep_alive.h"
+#include "metrics_endpoint.h"
 
 #include <vector>
 #include <memory>
@@ -457,6 +458,7 @@ class DaemonCore : public Service
   friend int dc_main(int, char**);
   friend class DaemonCommandProtocol;
   friend class DaemonKeepAlive;
+  friend class MetricsEndpoint;
     
   public:
     
@@ -1418,6 +1420,11 @@ class DaemonCore : public Service
     int Kill_Family(pid_t);
     int Extend_Family_Lifetime(pid_t);
     int Signal_Process(pid_t,int);
+
+	// Have notify called with a mask of ProcFamilyInterface::FAMILY_EVENT_* when the
+	// family of pid has memory or cpu events.  A NULL notify stops monitoring.
+	// Returns false if events are not available for this family.
+	bool Monitor_Family_Events(pid_t pid, void(*notify)(void*me, int pid, int events), void*me);
     
 	// This method should go away in the long term.
 	// Daemon Core should be responsible for unregistering any subfamily
@@ -1707,6 +1714,16 @@ class DaemonCore : public Service
 		*/
 	void HandleReqAsync(Stream *stream);
 
+	/** Hold a TCP command connection open after its command has been
+		handled, so the client can send another command on it.  The
+		next command is handled just like one on a new connection.
+		If none arrives within COMMAND_CONNECTION_IDLE_TIMEOUT seconds,
+		the connection is closed.
+		@return true if DaemonCore now owns sock, false if it is
+		        not being kept (the caller still owns it).
+		*/
+	bool KeepCommandSocketAlive(Sock *sock);
+
 		/** Force a reload of the shared port server address.
 			Called, for example, after the master has started up the
 			shared port server.
@@ -1749,6 +1766,12 @@ class DaemonCore : public Service
 	   stats_entry_recent<int> AsyncPipe;      //  number of times async_pipe was signalled
       #endif
 	   stats_entry_abs<int> UdpQueueDepth;  // Unread bytes for the UDP command port 
+	   stats_entry_recent<int> UdpDatagramsDropped; // datagrams the kernel dropped on the UDP command port
+	   stats_entry_recent<Probe> UdpRecvBatchSize;  // datagrams read per batched receive on the UDP command port
+	   stats_entry_recent<int> CommandConnectionsKeptAlive; // TCP command connections held open for another command
+	   stats_entry_recent<int> CommandConnectionsReused;    // commands received on a kept-alive connection
+	   stats_entry_recent<int> CommandConnectionPoolHits;   // outgoing commands sent on a pooled connection
+	   stats_entry_recent<int> CommandConnectionPoolMisses; // outgoing pooled commands that needed a new connection
 
 		
        stats_entry_recent<Probe> PumpCycle;   // count of pump cycles plus sum of cycle time with min/max/avg/std 
@@ -1757,6 +1780,19 @@ class DaemonCore : public Service
        StatisticsPool          Pool;          // pool of statistics probes and Publish attrib names
 	   std::shared_ptr<stats_ema_config> ema_config;	// Exponential moving average config for this pool.
 
+	   // latency histograms of the command, timer and socket handlers, keyed by the
+	   // same name as the runtime probes.  only kept when the metrics endpoint is
+	   // enabled (ENABLE_METRICS_ENDPOINT), and created the first time a handler runs.
+	   struct LatencyHistogram {
+	      const char * category;
+	      stats_histogram_loglinear hist;
+	   };
+	   std::map<std::string, LatencyHistogram, std::less<>> Latency;
+	   bool   metrics_enabled;
+
+	   // other pools of the daemon to include in the metrics endpoint
+	   std::vector<const StatisticsPool *> MetricsPools;
+
 	   time_t InitTime;            // last time we init'ed the structure
 	   time_t RecentStatsTickTime; // time of the latest recent buffer Advance
 	   int    RecentWindowMax;     // size of the time window over which RecentXXX values are calculated.
@@ -1782,8 +1818,12 @@ class DaemonCore : public Service
        void AddToSumEmaRate(const char * name, int val);
        void AddToAnyProbe(const char * name, int val);
        double AddSample(const char * name, int as, double val);
-       double AddRuntime(const char * name, double before); // returns current time.
+       double AddRuntime(const char * name, double before, const char * category=NULL); // returns current time.
        double AddRuntimeSample(const char * name, int as, double before);
+       void AddLatency(const char * category, const char * name, double sec);
+       void AddMetricsPool(const StatisticsPool * pool);
+       void RemoveMetricsPool(const StatisticsPool * pool);
+       void WriteMetrics(std::string & out) const; // OpenMetrics text exposition
 
 	} dc_stats;
 
@@ -1867,6 +1907,8 @@ class DaemonCore : public Service
 	int m_iMaxReapsPerCycle; // maximum number reapers to invoke per event loop
 	int m_MaxTimeSkip;
 	int m_iMaxUdpMsgsPerCycle;	// max number of udp messages read per loop
+	int m_iUdpRecvBatchSize;	// max number of udp datagrams read per system call
+	int m_iCommandConnectionIdleTimeout;	// seconds to hold an idle kept-alive command connection
 
     void Inherit( void );  // called in main()
 	void InitDCCommandSocket( int command_port );  // called in main()
@@ -1878,6 +1920,7 @@ class DaemonCore : public Service
 	int HandleReqSocketTimerHandler();
 	int HandleReqSocketHandler(Stream *stream);
 	int HandleReqPayloadReady(Stream *stream);
+	int HandleKeptAliveSocket(Stream *stream);
     int HandleSig(int command, int sig);
 
 	bool RegisterSocketForHandleReq(Stream *stream);
@@ -2219,6 +2262,9 @@ class DaemonCore : public Service
 	// in the DaemonKeepAlive helper friend class.
 	DaemonKeepAlive m_DaemonKeepAlive;
 
+	// Serves HTTP GET /metrics when ENABLE_METRICS_ENDPOINT is true.
+	MetricsEndpoint m_MetricsEndpoint;
+
 	// Method to check on and possibly recover from a bad connection
 	// to the procd. Suitable to be registered as a one-shot timer.
 	int CheckProcInterface();
@@ -1900,7 +1900,7 @@ DaemonCommandProtocol::CommandProtocolResult DaemonCommandProtocol::ExecCommand(
 
 		// update dc stats for number of commands handled, the time spent in this command handler
 		daemonCore->dc_stats.Commands += 1;
-		daemonCore->dc_stats.AddRuntime(getCommandStringSafe(m_req), begin_time);
+		daemonCore->dc_stats.AddRuntime(getCommandStringSafe(m_req), begin_time, "Command");
 	}
 
 	return CommandProtocolFinished;
@@ -1920,6 +1920,18 @@ int DaemonCommandProtocol::finalize()
 		if ( m_is_tcp ) {
 			m_sock->encode();	// we wanna "flush" below in the encode direction
 			m_sock->end_of_message();  // make certain data flushed to the wire
+
+				// If the client asked us to, hold the connection open
+				// for its next command.  We can only do that for a
+				// connection that we would otherwise delete.
+			bool keep_alive = false;
+			if ( m_delete_sock && m_result != FALSE &&
+				 m_reqFound && m_perm == USER_AUTH_SUCCESS &&
+				 m_auth_info.LookupBool(ATTR_SEC_KEEP_ALIVE, keep_alive) && keep_alive &&
+				 daemonCore->KeepCommandSocketAlive(m_sock) )
+			{
+				m_sock = NULL;
+			}
 		} else {
 			m_sock->decode();
 			m_sock->end_of_message();
@@ -1932,7 +1944,7 @@ int DaemonCommandProtocol::finalize()
 			m_sock->setFullyQualifiedUser(NULL);
 		}
 
-		if( m_delete_sock ) {
+		if( m_delete_sock && m_sock ) {
 			delete m_sock;
 			m_sock = NULL;
 		}
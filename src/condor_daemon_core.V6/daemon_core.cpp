@@ -374,6 +374,8 @@ DaemonCore::DaemonCore(int ComSize,int SigSize,
 	m_shared_port_endpoint = NULL;
 	nRegisteredSocks = 0;
 	m_iMaxUdpMsgsPerCycle = 1;
+	m_iUdpRecvBatchSize = 0;
+	m_iCommandConnectionIdleTimeout = 0;
 }
 
 // DaemonCore destructor. Delete the all the various handler tables, plus
@@ -2889,6 +2891,11 @@ DaemonCore::reconfig(void) {
 	if( m_iMaxUdpMsgsPerCycle != 1 ) {
 		dprintf(D_FULLDEBUG,"Setting maximum UDP messages per cycle %d.\n", m_iMaxUdpMsgsPerCycle);
 	}
+	m_iUdpRecvBatchSize = param_integer("UDP_RECV_BATCH_SIZE", 0, 0, 1024);
+	if( m_iUdpRecvBatchSize > 1 ) {
+		dprintf(D_FULLDEBUG,"Reading up to %d UDP datagrams per system call.\n", m_iUdpRecvBatchSize);
+	}
+	m_iCommandConnectionIdleTimeout = param_integer("COMMAND_CONNECTION_IDLE_TIMEOUT", 0, 0);
 
 	/*
 		Default value of MAX_REAPS_PER_CYCLE is 0 - a value of 0 means
@@ -2952,6 +2959,7 @@ DaemonCore::reconfig(void) {
 #endif
 
 	m_DaemonKeepAlive.reconfig();
+	m_MetricsEndpoint.reconfig();
 
 	file_descriptor_safety_limit = 0; // 0 indicates: needs to be computed
 
@@ -3908,7 +3916,7 @@ void DaemonCore::Driver()
 
 						// update per-handler runtime statistics
 						if (!handler_desc.empty()) {
-							runtime = dc_stats.AddRuntime(handler_desc.c_str(), runtime);
+							runtime = dc_stats.AddRuntime(handler_desc.c_str(), runtime, "Socket");
 						}
 
 					}	// if call_handler is True
@@ -3980,17 +3988,35 @@ DaemonCore::CallSocketHandler( const size_t i, bool default_to_HandleCommand )
 
 		unsigned msg_cnt = ( m_iMaxUdpMsgsPerCycle > 0 ) ? m_iMaxUdpMsgsPerCycle : -1;
 		unsigned frag_cnt = ( m_iMaxUdpMsgsPerCycle > 0 ) ? ( m_iMaxUdpMsgsPerCycle * 20 ) : -1;
+		SafeSock *ssock = (SafeSock *)sockTable[i].iosock;
 
 		Selector selector;
 		selector.set_timeout( 0, 0 );
 		selector.add_fd( sockTable[i].iosock->get_file_desc(), Selector::IO_READ );
 
 		while ( msg_cnt && frag_cnt ) {
-			selector.execute();
+			if ( !ssock->has_buffered_datagrams() ) {
+				// Drain as many datagrams as we may still handle this cycle
+				// with one system call.  Never read more than that, since
+				// datagrams left in the batch wouldn't wake up select.
+				int batch = -1;
+				if ( m_iUdpRecvBatchSize > 1 ) {
+					unsigned want = MIN( (unsigned)m_iUdpRecvBatchSize, MIN( msg_cnt, frag_cnt ) );
+					batch = ssock->read_datagram_batch( (int)want );
+				}
+				if ( batch == 0 ) {
+					break;
+				}
+				if ( batch > 0 ) {
+					dc_stats.UdpRecvBatchSize += batch;
+				} else {
+					selector.execute();
 
-			if ( !selector.has_ready() ) {
-				// No more data, we're done
-				break;
+					if ( !selector.has_ready() ) {
+						// No more data, we're done
+						break;
+					}
+				}
 			}
 
 			if ( !sockTable[i].iosock->handle_incoming_packet() )
@@ -4006,6 +4032,13 @@ DaemonCore::CallSocketHandler( const size_t i, bool default_to_HandleCommand )
 			// Make sure we didn't leak our priv state
 			CheckPrivState();
 		}
+
+		unsigned int dropped = ssock->take_datagrams_dropped();
+		if ( dropped ) {
+			dc_stats.UdpDatagramsDropped += (int)dropped;
+			dprintf( D_FULLDEBUG, "DaemonCore: %u UDP datagrams were dropped by the kernel on %s\n",
+				dropped, ssock->get_sinful() );
+		}
 		return;
 	}
 
@@ -4534,6 +4567,99 @@ DaemonCore::HandleReqAsync(Stream *stream)
 	}
 }
 
+bool
+DaemonCore::KeepCommandSocketAlive(Sock *sock)
+{
+	if( m_iCommandConnectionIdleTimeout <= 0 ||
+		sock->type() != Stream::reli_sock || !sock->is_connected() )
+	{
+		return false;
+	}
+
+	std::string msg;
+	if( TooManyRegisteredSockets(sock->get_file_desc(),&msg) ) {
+		dprintf(D_FULLDEBUG, "Not keeping command connection from %s open: %s\n",
+				sock->peer_description(), msg.c_str());
+		return false;
+	}
+
+		// The next command on this connection must resume its security
+		// session just like one on a new connection, so forget
+		// everything we learned about the peer from this one.
+	sock->clearSecurityState();
+
+	sock->set_deadline_timeout(m_iCommandConnectionIdleTimeout);
+	int rc = Register_Socket(sock, sock->peer_description(),
+			(SocketHandlercpp)&DaemonCore::HandleKeptAliveSocket,
+			"DaemonCore::HandleKeptAliveSocket", this);
+	if( rc < 0 ) {
+		dprintf(D_ALWAYS, "Failed to register kept-alive command connection from %s: error %d.\n",
+				sock->peer_description(), rc);
+		sock->set_deadline(0);
+		return false;
+	}
+
+	dc_stats.CommandConnectionsKeptAlive += 1;
+	dprintf(D_COMMAND, "Keeping command connection from %s open for %d seconds\n",
+			sock->peer_description(), m_iCommandConnectionIdleTimeout);
+	return true;
+}
+
+int
+DaemonCore::HandleKeptAliveSocket(Stream *stream)
+{
+	ReliSock *sock = static_cast<ReliSock*>(stream);
+
+		// The socket is readable because the client sent another
+		// command, or because it hung up.  Or we got tired of waiting.
+	if( sock->deadline_expired() || sock->bytes_available_to_read() <= 0 ) {
+		dprintf(D_FULLDEBUG, "Closing idle command connection from %s\n",
+				sock->peer_description());
+		return FALSE;
+	}
+
+		// Only a command that establishes its own security session may
+		// follow, so nothing can be handled under the identity of the
+		// command before it.  Peek at the command int, which follows
+		// the CEDAR message header and padding.  Don't wait for it:
+		// if only part of it is here, come back when there is more.
+	char hdr[5+8];
+	int cmd = 0;
+	ssize_t nr = recv(sock->get_file_desc(), hdr, sizeof(hdr), MSG_PEEK | MSG_DONTWAIT);
+	if( nr < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ) {
+		return KEEP_STREAM;
+	}
+	if( nr <= 0 ) {
+		dprintf(D_FULLDEBUG, "Closing command connection from %s, read failed\n",
+				sock->peer_description());
+		return FALSE;
+	}
+	if( nr < (ssize_t)sizeof(hdr) ) {
+			// The socket stays readable until the rest arrives, so
+			// don't give a client that stops part way long to finish.
+		time_t grace = time(nullptr) + 2;
+		if( sock->get_deadline() == 0 || sock->get_deadline() > grace ) {
+			sock->set_deadline(grace);
+		}
+		return KEEP_STREAM;
+	}
+	memcpy(&cmd, hdr + 5 + (8 - sizeof(int)), sizeof(int));
+	cmd = ntohl(cmd);
+	if( cmd != DC_AUTHENTICATE ) {
+		dprintf(D_ALWAYS, "Closing kept-alive command connection from %s: "
+				"command %d does not start a security session\n",
+				sock->peer_description(), cmd);
+		return FALSE;
+	}
+
+		// From here on it is just like a newly accepted connection.
+	Cancel_Socket(stream);
+	sock->set_deadline(0);
+	dc_stats.CommandConnectionsReused += 1;
+	HandleReqAsync(stream);
+	return KEEP_STREAM;
+}
+
 int DaemonCore::HandleReq(size_t socki, Stream* asock)
 {
 	Stream *insock;
@@ -8673,6 +8799,15 @@ DaemonCore::Proc_Family_Cleanup()
 	}
 }
 
+bool
+DaemonCore::Monitor_Family_Events(pid_t pid, void(*notify)(void*me, int pid, int events), void*me)
+{
+	if (m_proc_family) {
+		return m_proc_family->monitor_family_events(pid, notify, me);
+	}
+	return false;
+}
+
 bool
 DaemonCore::Proc_Family_QuitProcd(void(*notify)(void*me, int pid, int status), void*me)
 {
@@ -10800,6 +10935,11 @@ DaemonCore::publish(ClassAd *ad) {
 		assert( s.valid() );
 		ad->Assign( "AddressV1", s.getV1String() );
 	}
+
+		// So scrapers can find our metrics endpoint
+	if( m_MetricsEndpoint.port() > 0 ) {
+		ad->Assign( "MetricsEndpointPort", m_MetricsEndpoint.port() );
+	}
 }
 
 
@@ -0,0 +1,300 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_daemon_core.h"
+#include "condor_config.h"
+#include "condor_rw.h"
+#include "metrics_endpoint.h"
+
+// Limits on what we are willing to do for scrapers, who should send a
+// short request and be gone well within these.
+static const size_t MAX_REQUEST_SIZE = 8192;
+static const size_t MAX_OPEN_REQUESTS = 16;
+static const int REQUEST_TIMEOUT = 10;
+
+MetricsEndpoint::~MetricsEndpoint()
+{
+		// DaemonCore is going away, so there is no need to cancel the
+		// sockets, just delete them.
+	for (auto &[sock, req] : m_requests) {
+		free(req.prev_entry);
+		delete sock;
+	}
+	m_requests.clear();
+	delete m_listener;
+	m_listener = nullptr;
+}
+
+void
+MetricsEndpoint::reconfig()
+{
+	// NOTE: this function is always called on initial startup, as well
+	// as at reconfig time.
+
+	int want_port = param_integer("METRICS_ENDPOINT_PORT", 0, 0, 65535);
+	if ( ! daemonCore->dc_stats.metrics_enabled) {
+		Close();
+		return;
+	}
+	if (m_listener && (want_port == 0 || want_port == m_port)) {
+		return;
+	}
+	Close();
+
+	condor_protocol proto = param_false("ENABLE_IPV4") ? CP_IPV6 : CP_IPV4;
+	m_listener = new ReliSock();
+	if ( ! m_listener->listen(proto, want_port)) {
+		dprintf(D_ALWAYS, "Failed to listen on port %d for metrics requests, metrics endpoint is disabled\n", want_port);
+		delete m_listener;
+		m_listener = nullptr;
+		return;
+	}
+	int rc = daemonCore->Register_Socket(m_listener, "metrics endpoint",
+		(SocketHandlercpp)&MetricsEndpoint::HandleConnect,
+		"MetricsEndpoint::HandleConnect", this);
+	if (rc < 0) {
+		dprintf(D_ALWAYS, "Failed to register metrics endpoint socket\n");
+		delete m_listener;
+		m_listener = nullptr;
+		return;
+	}
+	m_port = m_listener->get_port();
+
+	m_expire_timer = daemonCore->Register_Timer(REQUEST_TIMEOUT, REQUEST_TIMEOUT,
+		(TimerHandlercpp)&MetricsEndpoint::ExpireRequests,
+		"MetricsEndpoint::ExpireRequests", this);
+
+	dprintf(D_ALWAYS, "Serving metrics on port %d\n", m_port);
+}
+
+int
+MetricsEndpoint::port() const
+{
+	return m_listener ? m_port : -1;
+}
+
+void
+MetricsEndpoint::Close()
+{
+	std::vector<ReliSock *> open;
+	for (auto &[sock, req] : m_requests) {
+		open.push_back(sock);
+	}
+	for (ReliSock *sock : open) {
+		DropRequest(sock);
+	}
+	if (m_listener) {
+		daemonCore->Cancel_Socket(m_listener);
+		delete m_listener;
+		m_listener = nullptr;
+		dprintf(D_FULLDEBUG, "Stopped serving metrics on port %d\n", m_port);
+	}
+	m_port = -1;
+	if (m_expire_timer != -1) {
+		daemonCore->Cancel_Timer(m_expire_timer);
+		m_expire_timer = -1;
+	}
+}
+
+int
+MetricsEndpoint::HandleConnect(Stream * /*stream*/)
+{
+	ReliSock *sock = m_listener->accept();
+	if ( ! sock) {
+		return KEEP_STREAM;
+	}
+
+		// Check authorization before reading anything from the peer.
+		// There is no authentication, so only host based authorization
+		// applies.
+	bool authorized = daemonCore->Verify("metrics request", READ, *sock, D_ALWAYS) != USER_AUTH_FAILURE;
+
+	if (m_requests.size() >= MAX_OPEN_REQUESTS) {
+		dprintf(D_ALWAYS, "Too many open metrics requests, dropping connection from %s\n",
+			sock->peer_description());
+		delete sock;
+		return KEEP_STREAM;
+	}
+
+		// An unauthorized peer gets its 403 response without us reading
+		// its request.
+	int rc;
+	if (authorized) {
+		rc = daemonCore->Register_Socket(sock, "metrics request",
+			(SocketHandlercpp)&MetricsEndpoint::HandleRequest,
+			"MetricsEndpoint::HandleRequest", this);
+	} else {
+		rc = daemonCore->Register_Socket(sock, "metrics response",
+			(SocketHandlercpp)&MetricsEndpoint::HandleResponse,
+			"MetricsEndpoint::HandleResponse", this, HANDLE_WRITE);
+	}
+	if (rc < 0) {
+		delete sock;
+		return KEEP_STREAM;
+	}
+	Request &req = m_requests[sock];
+	req.started = time(nullptr);
+	if ( ! authorized) {
+		req.data = FormatResponse("");
+	}
+	return KEEP_STREAM;
+}
+
+// Called when a request connection is readable.  Take whatever has arrived
+// (which never blocks) and queue the answer once the whole request header
+// is here.  Any return other than KEEP_STREAM has DaemonCore delete the socket.
+int
+MetricsEndpoint::HandleRequest(Stream *stream)
+{
+	ReliSock *sock = static_cast<ReliSock *>(stream);
+	auto it = m_requests.find(sock);
+	if (it == m_requests.end()) {
+		return FALSE;
+	}
+	std::string &data = it->second.data;
+
+	char buf[1024];
+	ssize_t len = recv(sock->get_file_desc(), buf, sizeof(buf), 0);
+	if (len < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+		return KEEP_STREAM;
+	}
+	if (len <= 0) {
+		dprintf(D_FULLDEBUG, "Metrics request from %s closed before it was complete\n",
+			sock->peer_description());
+		m_requests.erase(it);
+		return FALSE;
+	}
+	data.append(buf, len);
+
+	if (data.find("\r\n\r\n") == std::string::npos && data.find("\n\n") == std::string::npos) {
+		if (data.size() < MAX_REQUEST_SIZE) {
+			return KEEP_STREAM;
+		}
+		dprintf(D_ALWAYS, "Metrics request from %s is too long, dropping it\n",
+			sock->peer_description());
+		m_requests.erase(it);
+		return FALSE;
+	}
+
+		// Switch the socket over to writing the response as the scraper
+		// takes it.  The read registration is put back when we are done,
+		// so that DaemonCore can clean up the socket as usual.
+	data = FormatResponse(data);
+	int rc = daemonCore->Register_Socket(sock, "metrics response",
+		(SocketHandlercpp)&MetricsEndpoint::HandleResponse,
+		"MetricsEndpoint::HandleResponse", this, HANDLE_WRITE, &it->second.prev_entry);
+	if (rc < 0) {
+		m_requests.erase(it);
+		return FALSE;
+	}
+	return KEEP_STREAM;
+}
+
+// Called when a response connection is writable.  Write as much of the
+// response as the socket will take without blocking.
+int
+MetricsEndpoint::HandleResponse(Stream *stream)
+{
+	ReliSock *sock = static_cast<ReliSock *>(stream);
+	auto it = m_requests.find(sock);
+	if (it == m_requests.end()) {
+		return FALSE;
+	}
+	Request &req = it->second;
+
+	int len = condor_write(sock->peer_description(), sock->get_file_desc(),
+		req.data.c_str() + req.sent, (int)(req.data.size() - req.sent), 0, 0, true);
+	if (len < 0) {
+		dprintf(D_FULLDEBUG, "Failed to send metrics to %s\n", sock->peer_description());
+	} else {
+		req.sent += len;
+		if (req.sent < req.data.size()) {
+			return KEEP_STREAM;
+		}
+		dprintf(D_COMMAND, "Sent metrics to %s (%s)\n", sock->peer_description(),
+			req.data.substr(9, req.data.find('\r') - 9).c_str());
+	}
+
+	if (req.prev_entry) {
+		daemonCore->Cancel_Socket(sock, req.prev_entry);
+	}
+	m_requests.erase(it);
+	return FALSE;
+}
+
+// Returns the whole HTTP response to a request.  An empty request is an
+// unauthorized one.
+std::string
+MetricsEndpoint::FormatResponse(const std::string &request)
+{
+	std::string status;
+	std::string body;
+	if (request.empty()) {
+		status = "403 Forbidden";
+	} else if (request.compare(0, 4, "GET ") != 0) {
+		status = "405 Method Not Allowed";
+	} else {
+		std::string path = request.substr(4, request.find_first_of(" ?\r\n", 4) - 4);
+		if (path != "/metrics") {
+			status = "404 Not Found";
+		} else {
+			status = "200 OK";
+			daemonCore->dc_stats.WriteMetrics(body);
+			body += "# EOF\n";
+		}
+	}
+
+	std::string response;
+	formatstr(response, "HTTP/1.1 %s\r\n"
+		"Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+		"Content-Length: %zu\r\n"
+		"Connection: close\r\n\r\n",
+		status.c_str(), body.size());
+	response += body;
+	return response;
+}
+
+void
+MetricsEndpoint::DropRequest(ReliSock *sock)
+{
+	auto it = m_requests.find(sock);
+	if (it != m_requests.end() && it->second.prev_entry) {
+		daemonCore->Cancel_Socket(sock, it->second.prev_entry);
+	}
+	m_requests.erase(sock);
+	daemonCore->Cancel_Socket(sock);
+	delete sock;
+}
+
+void
+MetricsEndpoint::ExpireRequests(int /* timerID */)
+{
+	time_t cutoff = time(nullptr) - REQUEST_TIMEOUT;
+	std::vector<ReliSock *> expired;
+	for (auto &[sock, req] : m_requests) {
+		if (req.started < cutoff) {
+			expired.push_back(sock);
+		}
+	}
+	for (ReliSock *sock : expired) {
+		dprintf(D_FULLDEBUG, "Metrics request from %s timed out\n", sock->peer_description());
+		DropRequest(sock);
+	}
+}
@@ -0,0 +1,71 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+
+#ifndef _CONDOR_METRICS_ENDPOINT_H_
+#define _CONDOR_METRICS_ENDPOINT_H_
+
+#include <map>
+#include <string>
+
+class ReliSock;
+
+/** Serves the daemon's statistics in the OpenMetrics text format to
+	HTTP GET /metrics requests, on a listen socket of its own that is
+	only opened when ENABLE_METRICS_ENDPOINT is true.
+	The peer's READ authorization is checked as soon as a connection
+	is accepted, before anything is read from it, and requests are
+	read and responses written only as the socket is ready, so a slow
+	or hostile scraper can't block the daemon.
+	Like DaemonKeepAlive, this is a helper class that is only intended
+	to be used by DaemonCore.
+*/
+class MetricsEndpoint: public Service {
+	friend class DaemonCore;
+
+protected:
+	MetricsEndpoint() = default;
+	~MetricsEndpoint();
+
+	void reconfig();
+	int port() const;
+
+private:
+	struct Request {
+		std::string data;         // the request, then the response
+		size_t sent{0};           // how much of the response has been written
+		void *prev_entry{nullptr}; // the read registration, while writing
+		time_t started{0};
+	};
+
+	void Close();
+	int HandleConnect(Stream *stream);
+	int HandleRequest(Stream *stream);
+	int HandleResponse(Stream *stream);
+	void ExpireRequests(int timerID = -1);
+	std::string FormatResponse(const std::string &request);
+	void DropRequest(ReliSock *sock);
+
+	ReliSock *m_listener{nullptr};
+	int m_port{-1};
+	int m_expire_timer{-1};
+	std::map<ReliSock *, Request> m_requests;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include "condor_config.h"   // for param
 #include "../condor_procapi/procapi.h"
 #include <limits>
+#include <algorithm>
 
 int configured_statistics_window_quantum() {
     int quantum = param_integer("STATISTICS_WINDOW_QUANTUM_DAEMONCORE", INT_MAX, 1, INT_MAX);
@@ -193,6 +194,11 @@ void DaemonCore::Stats::Reconfig()
     }
 
     this->Commands.ConfigureEMAHorizons(ema_config);
+
+    this->metrics_enabled = this->enabled && param_boolean("ENABLE_METRICS_ENDPOINT", false);
+    if ( ! this->metrics_enabled) {
+       this->Latency.clear();
+    }
 }
 
 void DaemonCore::Stats::SetWindowSize(int window)
@@ -212,6 +218,7 @@ void DaemonCore::Stats::Init(bool enable)
 { 
    Clear();
    this->enabled = enable;
+   this->metrics_enabled = false;
    this->RecentWindowQuantum = configured_statistics_window_quantum();
    this->RecentWindowMax = this->RecentWindowQuantum; 
    this->PublishFlags    = -1;
@@ -237,6 +244,12 @@ void DaemonCore::Stats::Init(bool enable)
    DC_STATS_ADD_RECENT(Pool, PumpCycle,     IF_VERBOSEPUB);
    STATS_POOL_ADD_VAL(Pool, "DC", UdpQueueDepth,  IF_BASICPUB);
    STATS_POOL_PUB_PEAK(Pool, "DC", UdpQueueDepth,  IF_BASICPUB);
+   DC_STATS_ADD_RECENT(Pool, UdpDatagramsDropped, IF_BASICPUB);
+   DC_STATS_ADD_RECENT(Pool, UdpRecvBatchSize, IF_VERBOSEPUB);
+   DC_STATS_ADD_RECENT(Pool, CommandConnectionsKeptAlive, IF_BASICPUB);
+   DC_STATS_ADD_RECENT(Pool, CommandConnectionsReused, IF_BASICPUB);
+   DC_STATS_ADD_RECENT(Pool, CommandConnectionPoolHits, IF_BASICPUB);
+   DC_STATS_ADD_RECENT(Pool, CommandConnectionPoolMisses, IF_BASICPUB);
    DC_STATS_ADD_DEF(Pool, Commands, IF_BASICPUB);
 
    // insert entries that are stored in helper modules
@@ -451,13 +464,15 @@ void DaemonCore::Stats::AddToSumEmaRate(const char * name, int val) {
 
 #ifdef USE_MIRON_PROBE_FOR_DC_RUNTIME_STATS
 
-double DaemonCore::Stats::AddRuntime(const char * name, double before)
+double DaemonCore::Stats::AddRuntime(const char * name, double before, const char * category)
 {
    double now = _condor_debug_get_time_double();
    if ( ! this->enabled) return now;
    stats_entry_probe<double> * probe = Pool.GetProbe< stats_entry_probe<double> >(name);
    if (probe)
       probe->Add(now - before);
+   if (category)
+      AddLatency(category, name, now - before);
    return now;
 }
 
@@ -488,7 +503,7 @@ double DaemonCore::Stats::AddRuntimeSample(const char * name, int as, double bef
 
 #else
 
-double DaemonCore::Stats::AddRuntime(const char * name, double before)
+double DaemonCore::Stats::AddRuntime(const char * name, double before, const char * category)
 {
    if ( ! this->enabled) return;
 
@@ -496,6 +511,8 @@ double DaemonCore::Stats::AddRuntime(const char * name, double before)
    stats_recent_counter_timer * probe = Pool.GetProbe<stats_recent_counter_timer>(name);
    if (probe)
       probe->Add(now - before);
+   if (category)
+      AddLatency(category, name, now - before);
    return now;
 }
 
@@ -533,6 +550,93 @@ double DaemonCore::Stats::AddRuntimeSample(const char * name, int as, double bef
 
 #endif
 
+// category must be a string literal, the histogram keeps the pointer
+void DaemonCore::Stats::AddLatency(const char * category, const char * name, double sec)
+{
+   if ( ! this->metrics_enabled || ! name) return;
+
+   auto it = Latency.find(name);
+   if (it == Latency.end()) {
+      it = Latency.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple()).first;
+      it->second.category = category;
+   }
+   it->second.hist.Add(sec);
+}
+
+void DaemonCore::Stats::AddMetricsPool(const StatisticsPool * pool)
+{
+   if (std::find(MetricsPools.begin(), MetricsPools.end(), pool) == MetricsPools.end()) {
+      MetricsPools.push_back(pool);
+   }
+}
+
+void DaemonCore::Stats::RemoveMetricsPool(const StatisticsPool * pool)
+{
+   MetricsPools.erase(std::remove(MetricsPools.begin(), MetricsPools.end(), pool), MetricsPools.end());
+}
+
+static void append_metric_label(std::string & out, const char * name, const char * value)
+{
+   out += name;
+   out += "=\"";
+   for (const char * p = value; *p; ++p) {
+      switch (*p) {
+         case '\\': out += "\\\\"; break;
+         case '"':  out += "\\\""; break;
+         case '\n': out += "\\n"; break;
+         default:   out += *p; break;
+      }
+   }
+   out += '"';
+}
+
+// Write the latency histograms as summaries, and every numeric attribute the
+// statistics pools publish as a gauge, in the OpenMetrics text format.
+void DaemonCore::Stats::WriteMetrics(std::string & out) const
+{
+   static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+   if ( ! Latency.empty()) {
+      out += "# TYPE condor_handler_latency_seconds summary\n";
+      out += "# UNIT condor_handler_latency_seconds seconds\n";
+      out += "# HELP condor_handler_latency_seconds Runtime of DaemonCore command, timer and socket handlers.\n";
+   }
+   for (const auto & [name, lat] : Latency) {
+      std::string labels("{");
+      append_metric_label(labels, "kind", lat.category);
+      labels += ',';
+      append_metric_label(labels, "handler", name.c_str());
+
+      for (double q : quantiles) {
+         formatstr_cat(out, "condor_handler_latency_seconds%s,quantile=\"%g\"} %.6f\n",
+                       labels.c_str(), q, lat.hist.Quantile(q));
+      }
+      formatstr_cat(out, "condor_handler_latency_seconds_sum%s} %.6f\n", labels.c_str(), lat.hist.Sum());
+      formatstr_cat(out, "condor_handler_latency_seconds_count%s} %llu\n", labels.c_str(),
+                    (unsigned long long)lat.hist.Count());
+   }
+
+   ClassAd ad;
+   const int flags = IF_VERBOSEPUB | IF_RECENTPUB;
+   this->Publish(ad, flags);
+   for (const StatisticsPool * pool : MetricsPools) {
+      pool->Publish(ad, flags);
+   }
+
+   // sort by name so scrapes are easy to compare
+   std::map<std::string, double, classad::CaseIgnLTStr> gauges;
+   for (const auto & [attr, tree] : ad) {
+      classad::Value val;
+      double num;
+      if (ad.EvaluateAttr(attr, val) && val.IsNumber(num)) {
+         gauges[attr] = num;
+      }
+   }
+   for (const auto & [attr, num] : gauges) {
+      formatstr_cat(out, "# TYPE condor_%s gauge\ncondor_%s %.17g\n", attr.c_str(), attr.c_str(), num);
+   }
+}
+
 void* DaemonCore::Stats::NewProbe(const char * category, const char * name, int as)
 {
    if ( ! this->enabled) return NULL;
@@ -487,7 +487,7 @@ TimerManager::Timeout(int * pNumFired /*= NULL*/, double * pruntime /*=NULL*/)
 		}
 
 		if (pruntime && in_timeout->event_descrip) {
-			*pruntime = daemonCore->dc_stats.AddRuntime(in_timeout->event_descrip, *pruntime);
+			*pruntime = daemonCore->dc_stats.AddRuntime(in_timeout->event_descrip, *pruntime, "Timer");
 		}
 
         // Make sure we didn't leak our priv state
@@ -69,6 +69,8 @@ Dag::Dag(const Dagman& dm, bool isSplice, const std::string &spliceScope) :
 {
 	debug_printf(DEBUG_DEBUG_1, "Dag(%s)::Dag()\n", _spliceScope.c_str());
 
+	_condorLogRdr.setReadBatchSize(dm.m_log_read_batch_size);
+
 	_defaultNodeLog.assign(dm._defaultNodeLog);
 	_checkCondorEvents.SetAllowEvents(dm.allow_events);
 
@@ -1593,6 +1595,10 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 	int maxJobs = dagOpts[shallow::i::MaxJobs];
 	int maxIdle = dagOpts[shallow::i::MaxIdle];
 
+	// Nodes queued in the submit batch, waiting for the batch to be committed
+	std::vector<std::pair<Job*, CondorID>> batchedJobs;
+	_lastSubmitBatchSize = 0;
+
 	while (numSubmitsThisCycle < dm.max_submits_per_interval) {
 
 		// no jobs ready to submit
@@ -1652,15 +1658,36 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 			// Note:  I'm not sure why we don't just use the default
 			// constructor here.  wenger 2015-09-25
 			CondorID condorID(0, 0, 0);
-			submit_result_t submit_result = SubmitNodeJob(dm, job, condorID);
+			bool batched = dm.m_batch_direct_submit && ! job->GetNoop() &&
+			               (in_submit_batch() || begin_submit_batch(dm));
+			submit_result_t submit_result = SubmitNodeJob(dm, job, condorID, batched);
 	
 			// Note: if instead of switch here so we can use break
 			// to break out of while loop.
 			if (submit_result == SUBMIT_RESULT_OK) {
-				ProcessSuccessfulSubmit(job, condorID);
+				if (batched) {
+					// Count the node against the throttles now, it is
+					// processed once the batch is committed.
+					UpdateNodeCounts(job, 1);
+					batchedJobs.emplace_back(job, condorID);
+				} else {
+					ProcessSuccessfulSubmit(job, condorID);
+				}
 				numSubmitsThisCycle++;
 
 			} else if (submit_result == SUBMIT_RESULT_FAILED || submit_result == SUBMIT_RESULT_NO_SUBMIT) {
+				if (batched && submit_result == SUBMIT_RESULT_FAILED) {
+					// The failed node left a partial cluster in the batch
+					// transaction, so throw the whole batch away and submit
+					// the nodes that were queued fine one at a time.
+					end_submit_batch();
+					if ( ! batchedJobs.empty()) {
+						debug_printf(DEBUG_NORMAL, "Node %s failed to queue in the submit batch, submitting the %d node%s queued before it one at a time\n",
+						             job->GetJobName(), (int)batchedJobs.size(), batchedJobs.size() == 1 ? "" : "s");
+					}
+					numSubmitsThisCycle -= (int)batchedJobs.size();
+					numSubmitsThisCycle += SubmitBatchIndividually(dm, batchedJobs, true);
+				}
 				ProcessFailedSubmit(job, dm.max_submit_attempts);
 				break; // break out of while loop
 			} else {
@@ -1669,6 +1696,11 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 		}
 	}
 
+	if (in_submit_batch()) {
+		numSubmitsThisCycle -= (int)batchedJobs.size();
+		numSubmitsThisCycle += CommitSubmitBatch(dm, batchedJobs);
+	}
+
 	// if we didn't actually invoke condor_submit, and we submitted any jobs
 	// we should now send a reschedule command
 	if (numSubmitsThisCycle > 0 && !dagOpts[shallow::b::DryRun]) {
@@ -1684,6 +1716,66 @@ Dag::SubmitReadyJobs(const Dagman &dm)
 	return numSubmitsThisCycle;
 }
 
+//---------------------------------------------------------------------------
+// Commit the nodes queued in this cycle's submit batch and close the batch.
+// If the schedd rejects the transaction the nodes are resubmitted one at a
+// time (see SubmitBatchIndividually()).
+// Returns the number of nodes submitted.
+int
+Dag::CommitSubmitBatch(const Dagman &dm, std::vector<std::pair<Job*, CondorID>> &batchedJobs)
+{
+	if (batchedJobs.empty()) {
+		end_submit_batch();
+		return 0;
+	}
+
+	CondorError errstack;
+	bool committed = commit_submit_batch(errstack);
+	end_submit_batch();
+
+	if ( ! committed) {
+		debug_printf(DEBUG_NORMAL, "Schedd rejected batched submission of %d node%s, resubmitting them one at a time: %s\n",
+		             (int)batchedJobs.size(), batchedJobs.size() == 1 ? "" : "s", errstack.getFullText().c_str());
+		return SubmitBatchIndividually(dm, batchedJobs, true);
+	}
+
+	debug_printf(DEBUG_VERBOSE, "Committed batched submission of %d node%s\n",
+	             (int)batchedJobs.size(), batchedJobs.size() == 1 ? "" : "s");
+	for (auto & [node, condorID] : batchedJobs) {
+		// The node was counted when it was queued, and is counted
+		// again when the submit is processed.
+		UpdateNodeCounts(node, -1);
+		ProcessSuccessfulSubmit(node, condorID);
+	}
+	_lastSubmitBatchSize = (int)batchedJobs.size();
+	return _lastSubmitBatchSize;
+}
+
+//---------------------------------------------------------------------------
+// Submit the nodes of a submit batch that was thrown away one at a time,
+// so that only the node(s) at fault see a submit failure.  The batch must
+// be closed.  Returns the number of nodes submitted.
+int
+Dag::SubmitBatchIndividually(const Dagman &dm, std::vector<std::pair<Job*, CondorID>> &batchedJobs, bool counted)
+{
+	int numSubmitted = 0;
+	for (auto & [node, batchID] : batchedJobs) {
+		if (counted) { UpdateNodeCounts(node, -1); }
+		// The batch doesn't count as a submit attempt
+		node->_submitTries--;
+		node->SetCondorID(_defaultCondorId);
+		CondorID condorID(0, 0, 0);
+		if (SubmitNodeJob(dm, node, condorID) == SUBMIT_RESULT_OK) {
+			ProcessSuccessfulSubmit(node, condorID);
+			numSubmitted++;
+		} else {
+			ProcessFailedSubmit(node, dm.max_submit_attempts);
+		}
+	}
+	batchedJobs.clear();
+	return numSubmitted;
+}
+
 //---------------------------------------------------------------------------
 int
 Dag::PreScriptReaper(Job *job, int status)
@@ -3698,7 +3790,7 @@ Dag::GetEventIDHash(bool isNoop) const
 
 //---------------------------------------------------------------------------
 Dag::submit_result_t
-Dag::SubmitNodeJob(const Dagman &dm, Job *node, CondorID &condorID)
+Dag::SubmitNodeJob(const Dagman &dm, Job *node, CondorID &condorID, bool batched)
 {
 	submit_result_t result = SUBMIT_RESULT_NO_SUBMIT;
 
@@ -3743,7 +3835,7 @@ Dag::SubmitNodeJob(const Dagman &dm, Job *node, CondorID &condorID)
 	if (node->GetNoop()) {
 		submit_success = fake_condor_submit(condorID, 0, node->GetJobName(), node->GetDirectory(), logFile.c_str());
 	} else {
-		submit_success = condor_submit(dm, node, condorID);
+		submit_success = condor_submit(dm, node, condorID, batched);
 	}
 
 	result = submit_success ? SUBMIT_RESULT_OK : SUBMIT_RESULT_FAILED;
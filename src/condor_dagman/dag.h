@@ -204,6 +204,7 @@ public:
 	inline int NumNodesFailed() const { return _numNodesFailed; }
 	inline int NumNodesFutile() const { return _numNodesFutile; }
 	inline int NumNodesReady() const { return _readyQ->size() - NumReadyServiceNodes(); }
+	inline int LastSubmitBatchSize() const { return _lastSubmitBatchSize; }
 	inline int NumNodesUnready(bool includeFinal) const {
 		return (NumNodes(includeFinal) - (NumNodesDone(includeFinal) + PreRunNodeCount() + NumNodesSubmitted() +
 		        PostRunNodeCount() + NumNodesReady() + NumNodesFailed() + NumNodesFutile()));
@@ -353,7 +354,9 @@ private:
 
 	bool StartNode(Job *node, bool isRetry); // Begin executing node (PRE Script -> ready queue -> POST Script)
 	void RestartNode(Job *node, bool recovery); // Restart a failed node w/ retries
-	submit_result_t SubmitNodeJob(const Dagman &dm, Job *node, CondorID &condorID); // Submit a nodes job to Schedd queue
+	submit_result_t SubmitNodeJob(const Dagman &dm, Job *node, CondorID &condorID, bool batched = false); // Submit a nodes job to Schedd queue
+	int CommitSubmitBatch(const Dagman &dm, std::vector<std::pair<Job*, CondorID>> &batchedJobs); // Commit batched direct submission
+	int SubmitBatchIndividually(const Dagman &dm, std::vector<std::pair<Job*, CondorID>> &batchedJobs, bool counted); // Submit thrown away batched nodes one by one
 	void TerminateJob(Job* job, bool recovery, bool bootstrap = false); // Final actions once node is completed successfully
 
 	bool RunPostScript(Job *job, bool ignore_status, int status, bool incrementRunCount = true);
@@ -483,6 +486,7 @@ private:
 	int _maxJobsDeferredCount{0}; // Number of deferred nodes due to MaxJobs Limit
 	int _maxIdleDeferredCount{0}; // Number of deferred nodes due to MaxIdle Limit
 	int _catThrottleDeferredCount{0}; // Number of deferred nodes due to category throttling
+	int _lastSubmitBatchSize{0}; // Number of nodes committed by the last batched direct submission
 
 	int DFS_ORDER{0};
 	int _graph_width{0};
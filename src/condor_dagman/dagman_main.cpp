@@ -126,6 +126,15 @@ bool Dagman::Config() {
 	m_user_log_scan_interval = param_integer("DAGMAN_USER_LOG_SCAN_INTERVAL", m_user_log_scan_interval, 1, INT_MAX);
 	debug_printf(DEBUG_NORMAL, "DAGMAN_USER_LOG_SCAN_INTERVAL setting: %d\n", m_user_log_scan_interval);
 
+	m_log_read_batch_size = param_integer("DAGMAN_LOG_READ_BATCH_SIZE", m_log_read_batch_size, 1, 10000);
+	debug_printf(DEBUG_NORMAL, "DAGMAN_LOG_READ_BATCH_SIZE setting: %d\n", m_log_read_batch_size);
+
+	m_user_log_notify = param_boolean("DAGMAN_USER_LOG_NOTIFY", m_user_log_notify);
+	debug_printf(DEBUG_NORMAL, "DAGMAN_USER_LOG_NOTIFY setting: %s\n", m_user_log_notify ? "True" : "False");
+
+	m_batch_direct_submit = param_boolean("DAGMAN_BATCH_DIRECT_SUBMIT", m_batch_direct_submit);
+	debug_printf(DEBUG_NORMAL, "DAGMAN_BATCH_DIRECT_SUBMIT setting: %s\n", m_batch_direct_submit ? "True" : "False");
+
 	schedd_update_interval = param_integer("DAGMAN_QUEUE_UPDATE_INTERVAL", schedd_update_interval, 1, INT_MAX);
 	debug_printf(DEBUG_NORMAL, "DAGMAN_QUEUE_UPDATE_INTERVAL setting: %d\n", schedd_update_interval);
 
@@ -456,6 +465,9 @@ void ExitSuccess() {
 }
 
 void condor_event_timer(int tid);
+int log_notify_handler(int pipe);
+void start_log_notify();
+void stop_log_notify();
 
 /****** FOR TESTING *******
 int main_testing_stub( Service *, int ) {
@@ -1022,7 +1034,9 @@ void main_init(int argc, char ** const argv) {
 	}
 
 	debug_printf(DEBUG_VERBOSE, "Registering condor_event_timer...\n");
-	daemonCore->Register_Timer(1, dagman.m_user_log_scan_interval, condor_event_timer, "condor_event_timer");
+	dagman.m_event_timer_id = daemonCore->Register_Timer(1, dagman.m_user_log_scan_interval, condor_event_timer, "condor_event_timer");
+
+	if (dagman.m_user_log_notify) { start_log_notify(); }
 
 	dagman.dag->SetPendingNodeReportInterval(dagman.pendingReportInterval);
 }
@@ -1144,6 +1158,69 @@ void jobad_update() {
 	if (dagman._dagmanClassad) { dagman._dagmanClassad->Update(dagman); }
 }
 
+// Register the nodes log's change notification fd with DaemonCore, so that
+// the event timer fires as soon as a node job event is written.  The timer
+// keeps its regular period, so if notification isn't available (e.g. the log
+// is on a network filesystem) we simply keep polling.
+void start_log_notify() {
+	std::string nodesLog = dagman.dag->DefaultNodeLog();
+	dagman.m_log_trigger = new FileModifiedTrigger(nodesLog);
+	int fd = dagman.m_log_trigger->isInitialized() ? dagman.m_log_trigger->getNotifyFd() : -1;
+	if (fd < 0) {
+		debug_printf(DEBUG_NORMAL, "Change notification unavailable for nodes log %s, polling every %d seconds\n",
+		             nodesLog.c_str(), dagman.m_user_log_scan_interval);
+		delete dagman.m_log_trigger;
+		dagman.m_log_trigger = nullptr;
+		return;
+	}
+
+	// DaemonCore closes the fd it is given when we close the pipe, and the
+	// trigger closes its own, so hand DaemonCore a duplicate
+	int pipe_fd = dup(fd);
+	if (pipe_fd >= 0) {
+		dagman.m_log_notify_pipe = daemonCore->Inherit_Pipe(pipe_fd, false, true, true);
+		if (dagman.m_log_notify_pipe == -1) {
+			close(pipe_fd);
+		}
+	}
+	if (dagman.m_log_notify_pipe == -1 ||
+	    daemonCore->Register_Pipe(dagman.m_log_notify_pipe, "nodes log notification",
+	                              log_notify_handler, "log_notify_handler") < 0)
+	{
+		debug_printf(DEBUG_NORMAL, "Failed to register nodes log notification, polling every %d seconds\n",
+		             dagman.m_user_log_scan_interval);
+		stop_log_notify();
+		return;
+	}
+	debug_printf(DEBUG_VERBOSE, "Following nodes log %s with change notification\n", nodesLog.c_str());
+}
+
+// Close the nodes log notification pipe and go back to polling
+void stop_log_notify() {
+	if (dagman.m_log_notify_pipe != -1) {
+		daemonCore->Close_Pipe(dagman.m_log_notify_pipe);
+		dagman.m_log_notify_pipe = -1;
+	}
+	delete dagman.m_log_trigger;
+	dagman.m_log_trigger = nullptr;
+	dagman.m_log_notified = false;
+}
+
+int log_notify_handler(int /* pipe */) {
+	if ( ! dagman.m_log_trigger || dagman.m_log_trigger->drainNotifications() < 0) {
+		debug_printf(DEBUG_NORMAL, "Error reading nodes log notifications, falling back to polling\n");
+		stop_log_notify();
+		return FALSE;
+	}
+	dagman.m_log_notified = true;
+
+	// Run the event timer now; it goes back to its regular period afterwards
+	if (dagman.m_event_timer_id != -1 && ! dagman.paused) {
+		daemonCore->Reset_Timer(dagman.m_event_timer_id, 0, dagman.m_user_log_scan_interval);
+	}
+	return TRUE;
+}
+
 void condor_event_timer (int /* tid */) {
 
 	ASSERT(dagman.dag);
@@ -1206,6 +1283,12 @@ void condor_event_timer (int /* tid */) {
 	justSubmitted = dagman.dag->SubmitReadyJobs(dagman);
 	submitCycleEndTime = condor_gettimestamp_double();
 	dagman._dagmanStats.SubmitCycleTime.Add(submitCycleEndTime - submitCycleStartTime);
+	if (justSubmitted > 0 && submitCycleEndTime > submitCycleStartTime) {
+		dagman._dagmanStats.SubmitRate.Add(justSubmitted / (submitCycleEndTime - submitCycleStartTime));
+	}
+	if (dagman.dag->LastSubmitBatchSize() > 0) {
+		dagman._dagmanStats.SubmitBatchSize.Add(dagman.dag->LastSubmitBatchSize());
+	}
 	debug_printf(DEBUG_DEBUG_1, "Finished submit cycle\n");
 	if (justSubmitted) {
 		// Note: it would be nice to also have the proc submit
@@ -1216,12 +1299,27 @@ void condor_event_timer (int /* tid */) {
 	// Check log status for growth. If it grew, process log events.
 	if (log_status == ReadUserLog::LOG_STATUS_GROWN) {
 		logProcessCycleStartTime = condor_gettimestamp_double();
+
+		// How long the newest event sat in the log before a notification
+		// woke us up to read it
+		struct stat logStat;
+		if (dagman.m_log_notified && stat(dagman.dag->DefaultNodeLog().c_str(), &logStat) == 0) {
+#if defined(LINUX)
+			double modTime = logStat.st_mtim.tv_sec + logStat.st_mtim.tv_nsec / 1e9;
+#else
+			double modTime = (double)logStat.st_mtime;
+#endif
+			if (logProcessCycleStartTime >= modTime) {
+				dagman._dagmanStats.LogNotifyLatency.Add(logProcessCycleStartTime - modTime);
+			}
+		}
 		if (dagman.dag->ProcessLogEvents() == false) {
 			debug_printf(DEBUG_NORMAL, "ProcessLogEvents() returned false\n");
 			dagman.dag->PrintReadyQ(DEBUG_DEBUG_1);
 			main_shutdown_rescue(EXIT_ERROR, DagStatus::DAG_STATUS_ERROR);
 			return;
 		}
+		dagman.m_log_notified = false;
 		logProcessCycleEndTime = condor_gettimestamp_double();
 		dagman._dagmanStats.LogProcessCycleTime.Add(logProcessCycleEndTime - logProcessCycleStartTime);
 	}
@@ -24,6 +24,7 @@
 #include "dagman_classad.h"
 #include "dagman_stats.h"
 #include "utc_time.h"
+#include "file_modified_trigger.h"
 #include "../condor_utils/dagman_utils.h"
 
 // Don't change these values!  Doing so would break some DAGs.
@@ -66,6 +67,10 @@ public:
 			delete _protectedUrlMap;
 			_protectedUrlMap = nullptr;
 		}
+		if (m_log_trigger) {
+			delete m_log_trigger;
+			m_log_trigger = nullptr;
+		}
 	}
 
 	// Resolve macro substitutions in _defaultNodeLog.  Also check
@@ -80,6 +85,7 @@ public:
 	DCSchedd *_schedd{nullptr};
 	MapFile *_protectedUrlMap{nullptr}; // Protected URL Mapfile
 	DagmanClassad *_dagmanClassad{nullptr};
+	FileModifiedTrigger *m_log_trigger{nullptr}; // Wakes the event timer when the nodes log is appended to
 
 	DagmanOptions options{}; // All DAGMan options also set by config for this DAGMan to utilize
 	DagmanOptions inheritOpts{}; // Only Command Line options for passing down to subdags
@@ -102,6 +108,9 @@ public:
 	int allow_events{CheckEvents::ALLOW_NONE}; // What BAD job events to not treat as fatal
 
 	int m_user_log_scan_interval{LOG_SCAN_INT_DEFAULT}; // Interval of time between checking for new log events
+	int m_log_read_batch_size{100}; // Max number of node log events read per read call
+	int m_event_timer_id{-1}; // DaemonCore id of condor_event_timer
+	int m_log_notify_pipe{-1}; // DaemonCore pipe id of the nodes log notification fd
 	int schedd_update_interval{120}; // Time interval between DAGMan job Ad updates to/from Schedd
 	int pendingReportInterval{600}; // Time interval to report pending nodes
 	int check_queue_interval{28'800}; // Time in pending state before querying the schedd queue for verification
@@ -128,6 +137,9 @@ public:
 	bool _generateSubdagSubmits{true}; // Generate the *.condor.sub file for sub-DAGs at run time
 	bool _suppressJobLogs{false}; // Suppress specified job log files (see gittrac #4353)
 	bool _removeNodeJobs{true}; // DAGMan itself will remove managed node jobs when condor_rm'ed
+	bool m_user_log_notify{true}; // Wake up on nodes log appends instead of only polling every scan interval
+	bool m_log_notified{false}; // Nodes log notification fired since the nodes log was last read
+	bool m_batch_direct_submit{false}; // Direct submit all nodes of a submit cycle in one schedd transaction
 	bool enforceNewJobsLimit{false}; // Have DAG enforce the a newly set MaxJobs limit by removing node batch jobs
 	bool produceJobCredentials{true}; // Have DAGMan direct submit run produce_credentials
 };
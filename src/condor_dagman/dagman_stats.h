@@ -34,6 +34,9 @@
 		stats_entry_probe<double> LogProcessCycleTime;
 		stats_entry_probe<double> SleepCycleTime;
 		stats_entry_probe<double> SubmitCycleTime;
+		stats_entry_probe<double> LogNotifyLatency;
+		stats_entry_probe<double> SubmitRate;
+		stats_entry_probe<double> SubmitBatchSize;
 
 		StatisticsPool Pool;
 
@@ -320,7 +320,13 @@ static bool send_jobset_if_allowed(SubmitHash& submitHash, int cluster) {
 }
 
 //-------------------------------------------------------------------------
-static bool direct_condor_submit(const Dagman &dm, Job* node, CondorID& condorID) {
+// The schedd connection held open by a submit batch (see begin_submit_batch())
+static Qmgr_connection *batch_qmgr = nullptr;
+
+//-------------------------------------------------------------------------
+// When batched is true the node's cluster is queued into the transaction
+// of the open submit batch, which the caller commits or aborts.
+static bool direct_condor_submit(const Dagman &dm, Job* node, CondorID& condorID, bool batched) {
 	const char* cmdFile = node->GetCmdFile();
 
 	// TODO: Have inline submits get digested here to allow for prepending of variables
@@ -425,8 +431,8 @@ static bool direct_condor_submit(const Dagman &dm, Job* node, CondorID& condorID
 	submitHash->attachTransferMap(dm._protectedUrlMap);
 	submitHash->init_base_ad(time(nullptr), owner);
 
-	qmgr = ConnectQ(schedd);
-	if (qmgr) {
+	if ( ! batched) { qmgr = ConnectQ(schedd); }
+	if (qmgr || batched) {
 		int cluster_id = NewCluster();
 		if (cluster_id <= 0) {
 			errmsg = "failed to get a ClusterId";
@@ -499,6 +505,12 @@ static bool direct_condor_submit(const Dagman &dm, Job* node, CondorID& condorID
 				goto finis;
 			}
 		}
+		if (batched) {
+			// Committed together with the rest of the batch
+			success = true;
+			node->SetNumSubmitted(proc_id+1);
+			goto finis;
+		}
 		// commit transaction and disconnect queue
 		CondorError errstack;
 		success = DisconnectQ(qmgr, true, &errstack); qmgr = NULL;
@@ -542,7 +554,7 @@ finis:
 	return success;
 }
 
-bool condor_submit(const Dagman &dm, Job* node, CondorID& condorID) {
+bool condor_submit(const Dagman &dm, Job* node, CondorID& condorID, bool batched) {
 	bool success = false;
 	const char* directory = node->GetDirectory();
 	TmpDir tmpDir;
@@ -559,7 +571,7 @@ bool condor_submit(const Dagman &dm, Job* node, CondorID& condorID) {
 			success = shell_condor_submit(dm, node, condorID);
 			break;
 		case DagSubmitMethod::DIRECT: // direct submit
-			success = direct_condor_submit(dm, node, condorID);
+			success = direct_condor_submit(dm, node, condorID, batched && batch_qmgr);
 			break;
 		default:
 			// We have unknown submission method requested so jobs will never be submitted abort
@@ -576,6 +588,41 @@ bool condor_submit(const Dagman &dm, Job* node, CondorID& condorID) {
 	return success;
 }
 
+//-------------------------------------------------------------------------
+bool begin_submit_batch(const Dagman &dm) {
+	DagSubmitMethod method = static_cast<DagSubmitMethod>(dm.options[deep::i::SubmitMethod]);
+	if (method != DagSubmitMethod::DIRECT) { return false; }
+	if (batch_qmgr) { return true; }
+
+	DCSchedd schedd;
+	CondorError errstack;
+	batch_qmgr = ConnectQ(schedd, 0, false, &errstack);
+	if ( ! batch_qmgr) {
+		debug_printf(DEBUG_NORMAL, "Failed to connect to the schedd for batched submission, submitting nodes one at a time: %s\n",
+		             errstack.getFullText().c_str());
+		return false;
+	}
+	return true;
+}
+
+bool in_submit_batch() { return batch_qmgr != nullptr; }
+
+bool commit_submit_batch(CondorError &errstack) {
+	if ( ! batch_qmgr) { return false; }
+	bool success = RemoteCommitTransaction(0, &errstack) >= 0;
+	// Whatever the outcome, the schedd has ended the transaction, so start
+	// a fresh one in case the caller keeps submitting on this connection
+	BeginTransaction();
+	return success;
+}
+
+void end_submit_batch() {
+	if ( ! batch_qmgr) { return; }
+	// Anything not committed by now is thrown away
+	DisconnectQ(batch_qmgr, false);
+	batch_qmgr = nullptr;
+}
+
 bool send_reschedule(const Dagman & dm) {
 	DagSubmitMethod method = static_cast<DagSubmitMethod>(dm.options[deep::i::SubmitMethod]);
 	switch (method) {
@@ -23,7 +23,20 @@
 
 #include "condor_id.h"
 
-bool condor_submit(const Dagman &dm, Job* node, CondorID& condorID);
+class CondorError;
+
+// When batched is true and a submit batch is open the node's jobs are
+// queued in the batch transaction and not visible until it is committed
+bool condor_submit(const Dagman &dm, Job* node, CondorID& condorID, bool batched = false);
+
+// Batched direct submission: the nodes of one submit cycle are sent over a
+// single schedd connection, one cluster per node, in a single transaction.
+// begin_submit_batch() returns false if the batch can't be used (not direct
+// submit, or no connection), in which case nodes are submitted one by one.
+bool begin_submit_batch(const Dagman &dm);
+bool in_submit_batch();
+bool commit_submit_batch(CondorError &errstack);
+void end_submit_batch();
 
 bool send_reschedule(const Dagman &dm);
 
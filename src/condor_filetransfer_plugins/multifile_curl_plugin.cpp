@@ -11,6 +11,7 @@
 #include <chrono>
 #include <thread>
 #include <fstream>
+#include <deque>
 #include <cstdio>
 #include <stdexcept>
 #include <rapidjson/document.h>
@@ -24,9 +25,30 @@ int max_retry_attempts = MAX_RETRY_ATTEMPTS;
 struct xferProgress {
     double lastRunTime;
     CURL *curl;
+    double prevTime; //Previous checks total time
+    double dlprev;   //Previous checks dlnow
+    double ulprev;   //Previous checks ulnow
 };
 struct xferProgress myProgress;
 
+// A single file moving through the curl_multi engine.  Each one has its own
+// easy handle so that several can be in flight at once; the handles share
+// the multi handle's connection cache.
+struct CurlTransfer {
+    std::string url;                // as requested, possibly with a credential name
+    std::string local_file_name;
+    CURL *handle{nullptr};
+    FILE *file{nullptr};
+    struct curl_slist *header_list{nullptr};
+    std::unique_ptr<FileTransferStats> stats;
+    struct xferProgress progress{};
+    char error_buffer[CURL_ERROR_SIZE]{};
+    long partial_bytes{0};
+    int retry_count{0};
+    time_t start_after{0};          // when to start the next try
+    int rval{-1};
+};
+
 #if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 32)
 static int xferInfo(void *p, curl_off_t /* dltotal */, curl_off_t dlnow, curl_off_t /* ultotal */, curl_off_t ulnow)
 #else
@@ -40,14 +62,9 @@ static int xferInfo(void *p, double /* dltotal */, double dlnow, double /* ultot
     struct xferProgress *progress = (struct xferProgress *)p;
     CURL *curl = progress->curl;
     double curTime = 0;
-    static double prevTime = 0; //Previous checks total time
-#if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 32)
-    static double dlprev   = 0; //Previous checks dlnow
-    static double ulprev   = 0; //Previous checks ulnow
-#else
-    static curl_off_t dlprev   = 0; //Previous checks dlnow
-    static curl_off_t ulprev   = 0; //Previous checks ulnow
-#endif
+    double &prevTime = progress->prevTime;
+    double &dlprev = progress->dlprev;
+    double &ulprev = progress->ulprev;
 
     curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &curTime);
 
@@ -202,36 +219,36 @@ MultiFileCurlPlugin::InitializeCurl() {
 }
 
 void
-MultiFileCurlPlugin::InitializeCurlHandle(const std::string &url, const std::string &cred,
-        struct curl_slist *& header_list)
+MultiFileCurlPlugin::InitializeCurlHandle(CURL *handle, char *error_buffer, struct xferProgress *progress,
+        const std::string &url, const std::string &cred, struct curl_slist *& header_list)
 {
 	CURLcode r;
-    r = curl_easy_setopt( _handle, CURLOPT_URL, url.c_str() );
+    r = curl_easy_setopt( handle, CURLOPT_URL, url.c_str() );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt CUROPT_URL\n");
 	}
-    r = curl_easy_setopt( _handle, CURLOPT_CONNECTTIMEOUT, 60 );
+    r = curl_easy_setopt( handle, CURLOPT_CONNECTTIMEOUT, 60 );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt CONNECTIMEOUT\n");
 	}
 
     // Provide default read / write callback functions; note these
     // don't segfault if a nullptr is given as the read/write data.
-    r = curl_easy_setopt( _handle, CURLOPT_READFUNCTION, &CurlReadCallback );
+    r = curl_easy_setopt( handle, CURLOPT_READFUNCTION, &CurlReadCallback );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt READFUNCTION\n");
 	}
-    r = curl_easy_setopt( _handle, CURLOPT_WRITEFUNCTION, &CurlWriteCallback );
+    r = curl_easy_setopt( handle, CURLOPT_WRITEFUNCTION, &CurlWriteCallback );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt WRITEFUNCTION\n");
 	}
 
     // Prevent curl from spewing to stdout / in by default.
-    r = curl_easy_setopt( _handle, CURLOPT_READDATA, NULL );
+    r = curl_easy_setopt( handle, CURLOPT_READDATA, NULL );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt READDATA\n");
 	}
-    r = curl_easy_setopt( _handle, CURLOPT_WRITEDATA, NULL );
+    r = curl_easy_setopt( handle, CURLOPT_WRITEDATA, NULL );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt WRITEDATA\n");
 	}
@@ -239,11 +256,11 @@ MultiFileCurlPlugin::InitializeCurlHandle(const std::string &url, const std::str
     const char* capath = getenv("X509_CERT_DIR");
 
     if (capath != NULL) {
-	        r = curl_easy_setopt( _handle, CURLOPT_SSL_VERIFYPEER, 1L);
+	        r = curl_easy_setopt( handle, CURLOPT_SSL_VERIFYPEER, 1L);
 	        if (r != CURLE_OK) {
 	                fprintf(stderr, "Can't setopt SSL_VERIFYPEER\n");
 	        }
-	        r = curl_easy_setopt( _handle, CURLOPT_CAPATH, capath);
+	        r = curl_easy_setopt( handle, CURLOPT_CAPATH, capath);
 	        if (r != CURLE_OK) {
 	                fprintf(stderr, "Can't setopt CAPATH\n");
 	        }
@@ -255,11 +272,11 @@ MultiFileCurlPlugin::InitializeCurlHandle(const std::string &url, const std::str
     if( !strncasecmp( url.c_str(), "http://", 7 ) ||
             !strncasecmp( url.c_str(), "https://", 8 ) ||
             !strncasecmp( url.c_str(), "file://", 7 ) ) {
-        r = curl_easy_setopt( _handle, CURLOPT_FOLLOWLOCATION, 1 );
+        r = curl_easy_setopt( handle, CURLOPT_FOLLOWLOCATION, 1 );
 		if (r != CURLE_OK) {
 			fprintf(stderr, "Can't setopt FOLLOWLOCATION\n");
 		}
-        r = curl_easy_setopt( _handle, CURLOPT_HEADERFUNCTION, &HeaderCallback );
+        r = curl_easy_setopt( handle, CURLOPT_HEADERFUNCTION, &HeaderCallback );
 		if (r != CURLE_OK) {
 			fprintf(stderr, "Can't setopt HEADERFUNCTION\n");
 		}
@@ -268,7 +285,7 @@ MultiFileCurlPlugin::InitializeCurlHandle(const std::string &url, const std::str
     }
     // Libcurl options for FTP
     else if( !strncasecmp( url.c_str(), "ftp://", 6 ) ) {
-        r = curl_easy_setopt( _handle, CURLOPT_WRITEFUNCTION, &FtpWriteCallback );
+        r = curl_easy_setopt( handle, CURLOPT_WRITEFUNCTION, &FtpWriteCallback );
 		if (r != CURLE_OK) {
 			fprintf(stderr, "Can't setopt WRITEFUNCTION\n");
 		}
@@ -287,42 +304,45 @@ MultiFileCurlPlugin::InitializeCurlHandle(const std::string &url, const std::str
     // happens? 500 errors fail before we see HTTP headers but I don't
     // think that's a big deal.
     // * Let's keep it set to 1 for now.
-    r = curl_easy_setopt( _handle, CURLOPT_FAILONERROR, 1 );
+    r = curl_easy_setopt( handle, CURLOPT_FAILONERROR, 1 );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt FAILONERROR\n");
 	}
 
     if( _diagnostic ) {
-        r = curl_easy_setopt( _handle, CURLOPT_VERBOSE, 1 );
+        r = curl_easy_setopt( handle, CURLOPT_VERBOSE, 1 );
 		if (r != CURLE_OK) {
 			fprintf(stderr, "Can't setopt VERBOSE\n");
 		}
     }
 
     // Setup a buffer to store error messages. For debug use.
-    _error_buffer[0] = '\0';
-    r = curl_easy_setopt( _handle, CURLOPT_ERRORBUFFER, _error_buffer );
+    error_buffer[0] = '\0';
+    r = curl_easy_setopt( handle, CURLOPT_ERRORBUFFER, error_buffer );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt ERRORBUFFER\n");
 	}
 
     // Setup a transfer progress callback. We'll use this to determine if a 
     // transfer is not making progress, and if not then abort it.
-    myProgress.curl = _handle;
-    myProgress.lastRunTime = 0;
+    progress->curl = handle;
+    progress->lastRunTime = 0;
+    progress->prevTime = 0;
+    progress->dlprev = 0;
+    progress->ulprev = 0;
 #if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 32)
-    r = curl_easy_setopt(_handle, CURLOPT_XFERINFOFUNCTION, xferInfo);
+    r = curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, xferInfo);
 #else
-    r = curl_easy_setopt(_handle, CURLOPT_PROGRESSFUNCTION, xferInfo);
+    r = curl_easy_setopt(handle, CURLOPT_PROGRESSFUNCTION, xferInfo);
 #endif
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt PROGRESSFUNCTION\n");
 	}
-    r = curl_easy_setopt(_handle, CURLOPT_PROGRESSDATA, &myProgress);
+    r = curl_easy_setopt(handle, CURLOPT_PROGRESSDATA, progress);
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt PROGRESSDATA\n");
 	}
-    r = curl_easy_setopt(_handle, CURLOPT_NOPROGRESS, 0L);
+    r = curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L);
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt NOPROGRESS\n");
 	}
@@ -352,7 +372,7 @@ MultiFileCurlPlugin::OpenLocalFile(const std::string &local_file, const char *mo
 
 
 void
-MultiFileCurlPlugin::FinishCurlTransfer( int rval, FILE *file ) {
+MultiFileCurlPlugin::FinishCurlTransfer( CURL *handle, FileTransferStats &stats, const char *error_buffer, int rval, FILE *file ) {
 
     // Gather more statistics
 #if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 55)
@@ -367,43 +387,60 @@ MultiFileCurlPlugin::FinishCurlTransfer( int rval, FILE *file ) {
     long return_code;
 
 #if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR > 55)
-    curl_easy_getinfo( _handle, CURLINFO_SIZE_DOWNLOAD_T, &bytes_downloaded );
-    curl_easy_getinfo( _handle, CURLINFO_SIZE_UPLOAD_T, &bytes_uploaded );
+    curl_easy_getinfo( handle, CURLINFO_SIZE_DOWNLOAD_T, &bytes_downloaded );
+    curl_easy_getinfo( handle, CURLINFO_SIZE_UPLOAD_T, &bytes_uploaded );
 #else
-    curl_easy_getinfo( _handle, CURLINFO_SIZE_DOWNLOAD, &bytes_downloaded );
-    curl_easy_getinfo( _handle, CURLINFO_SIZE_UPLOAD, &bytes_uploaded );
+    curl_easy_getinfo( handle, CURLINFO_SIZE_DOWNLOAD, &bytes_downloaded );
+    curl_easy_getinfo( handle, CURLINFO_SIZE_UPLOAD, &bytes_uploaded );
 #endif
-    curl_easy_getinfo( _handle, CURLINFO_CONNECT_TIME, &transfer_connection_time );
-    curl_easy_getinfo( _handle, CURLINFO_TOTAL_TIME, &transfer_total_time );
-    curl_easy_getinfo( _handle, CURLINFO_RESPONSE_CODE, &return_code );
+    curl_easy_getinfo( handle, CURLINFO_CONNECT_TIME, &transfer_connection_time );
+    curl_easy_getinfo( handle, CURLINFO_TOTAL_TIME, &transfer_total_time );
+    curl_easy_getinfo( handle, CURLINFO_RESPONSE_CODE, &return_code );
 
     if(bytes_downloaded > 0) {
-        _this_file_stats->TransferTotalBytes += (int64_t) bytes_downloaded;
+        stats.TransferTotalBytes += (int64_t) bytes_downloaded;
     }
     else {
-        _this_file_stats->TransferTotalBytes += (int64_t) bytes_uploaded;
+        stats.TransferTotalBytes += (int64_t) bytes_uploaded;
     }
 
-    _this_file_stats->ConnectionTimeSeconds +=  ( transfer_total_time - transfer_connection_time );
-    _this_file_stats->TransferHTTPStatusCode = return_code;
-    _this_file_stats->LibcurlReturnCode = rval;
+    stats.ConnectionTimeSeconds +=  ( transfer_total_time - transfer_connection_time );
+    stats.TransferHTTPStatusCode = return_code;
+    stats.LibcurlReturnCode = rval;
+
+    // Whether libcurl had to open a new connection, or found one to reuse
+    // in its connection cache, and which protocol version it ended up speaking.
+    long new_connections = 0;
+    if( curl_easy_getinfo( handle, CURLINFO_NUM_CONNECTS, &new_connections ) == CURLE_OK ) {
+        stats.ConnectionReused = ( new_connections == 0 );
+    }
+#if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 50)
+    long http_version = CURL_HTTP_VERSION_NONE;
+    curl_easy_getinfo( handle, CURLINFO_HTTP_VERSION, &http_version );
+    switch( http_version ) {
+        case CURL_HTTP_VERSION_1_0: stats.HttpVersion = "1.0"; break;
+        case CURL_HTTP_VERSION_1_1: stats.HttpVersion = "1.1"; break;
+        case CURL_HTTP_VERSION_2_0: stats.HttpVersion = "2"; break;
+        default: break;
+    }
+#endif
 
     if( rval == CURLE_OK ) {
             // Transfer successful!
-        _this_file_stats->TransferSuccess = true;
-        _this_file_stats->TransferError = "";
-        _this_file_stats->TransferFileBytes = ftell( file );
+        stats.TransferSuccess = true;
+        stats.TransferError = "";
+        stats.TransferFileBytes = ftell( file );
     }
     else if ( rval == CURLE_ABORTED_BY_CALLBACK ) {
             // Transfer failed because our xferInfo callback above returned abort.
             // The error string returned by libcurl just says "Callback aborted",
             // so lets give something more meaningful.
-        _this_file_stats->TransferSuccess = false;
-        _this_file_stats->TransferError = "Aborted due to lack of progress";
+        stats.TransferSuccess = false;
+        stats.TransferError = "Aborted due to lack of progress";
     }
     else {
-        _this_file_stats->TransferSuccess = false;
-        _this_file_stats->TransferError = _error_buffer;
+        stats.TransferSuccess = false;
+        stats.TransferError = error_buffer;
     }
 }
 
@@ -419,7 +456,7 @@ MultiFileCurlPlugin::UploadFile( const std::string &url, const std::string &loca
     }
     struct curl_slist *header_list = NULL;
     try {
-        InitializeCurlHandle( url, cred, header_list );
+        InitializeCurlHandle( _handle, _error_buffer, &myProgress, url, cred, header_list );
     } catch (const std::exception &exc) {
         _this_file_stats->TransferSuccess = false;
         _this_file_stats->TransferError = exc.what();
@@ -475,7 +512,7 @@ MultiFileCurlPlugin::UploadFile( const std::string &url, const std::string &loca
 
     if (header_list) curl_slist_free_all(header_list);
 
-    FinishCurlTransfer( rval, file );
+    FinishCurlTransfer( _handle, *_this_file_stats, _error_buffer, rval, file );
 
         // Error handling and cleanup
     if( _diagnostic && rval ) {
@@ -501,7 +538,7 @@ MultiFileCurlPlugin::DownloadFile( const std::string &url, const std::string &lo
     }
     struct curl_slist *header_list = NULL;
     try {
-        InitializeCurlHandle( url, cred, header_list );
+        InitializeCurlHandle( _handle, _error_buffer, &myProgress, url, cred, header_list );
     } catch (const std::exception &exc) {
         _this_file_stats->TransferSuccess = false;
         _this_file_stats->TransferError = exc.what();
@@ -549,7 +586,7 @@ MultiFileCurlPlugin::DownloadFile( const std::string &url, const std::string &lo
 
     // Check if the request completed partially. If so, set some
     // variables so we can attempt a resume on the next try.
-    if( ( rval == CURLE_PARTIAL_FILE ) && ServerSupportsResume( url ) && _this_file_stats->HttpCacheHitOrMiss != "HIT" ) {
+    if( ( rval == CURLE_PARTIAL_FILE ) && ServerSupportsResume( _handle, url ) && _this_file_stats->HttpCacheHitOrMiss != "HIT" ) {
         partial_bytes = ftell( file );
     }
 
@@ -568,7 +605,7 @@ MultiFileCurlPlugin::DownloadFile( const std::string &url, const std::string &lo
         strcpy(_error_buffer, "The URL you requested could not be found.");
     }
 
-    FinishCurlTransfer( rval, file );
+    FinishCurlTransfer( _handle, *_this_file_stats, _error_buffer, rval, file );
 
         // Error handling and cleanup
     if( _diagnostic && rval ) {
@@ -649,6 +686,10 @@ MultiFileCurlPlugin::UploadMultipleFiles( const std::string &input_filename ) {
         return TransferPluginResult::Error;
     }
 
+    if ( m_max_concurrent > 1 && requested_files.size() > 1 ) {
+        return TransferMultipleFiles( requested_files, true );
+    }
+
     classad::ClassAdUnParser unparser;
     if ( _diagnostic ) { fprintf( stderr, "Uploading multiple files.\n" ); }
 
@@ -662,7 +703,7 @@ MultiFileCurlPlugin::UploadMultipleFiles( const std::string &input_filename ) {
 
         // Initialize the stats structure for this transfer.
         _this_file_stats.reset(new FileTransferStats());
-        InitializeStats( url );
+        InitializeStats( *_this_file_stats, url );
         _this_file_stats->TransferStartTime = time(NULL);
 	_this_file_stats->TransferFileName = local_file_name;
 
@@ -733,6 +774,9 @@ MultiFileCurlPlugin::DownloadMultipleFiles( const std::string &input_filename )
     if ( rval != 0 ) {
         return TransferPluginResult::Error;
     }
+    if ( m_max_concurrent > 1 && requested_files.size() > 1 ) {
+        return TransferMultipleFiles( requested_files, false );
+    }
     classad::ClassAdUnParser unparser;
 
     // Iterate over the map of files to transfer.
@@ -747,7 +791,7 @@ MultiFileCurlPlugin::DownloadMultipleFiles( const std::string &input_filename )
 
         // Initialize the stats structure for this transfer.
         _this_file_stats.reset( new FileTransferStats() );
-        InitializeStats( url );
+        InitializeStats( *_this_file_stats, url );
         _this_file_stats->TransferStartTime = time(NULL);
 	_this_file_stats->TransferFileName = local_file_name;
 
@@ -807,6 +851,314 @@ MultiFileCurlPlugin::DownloadMultipleFiles( const std::string &input_filename )
     return TransferPluginResult::Success;
 }
 
+// Split the credential name, everything prior to the last '+' in the scheme,
+// off the front of a requested URL.
+static void
+SplitCredentialFromUrl( const std::string &url, std::string &cred, std::string &full_url ) {
+    std::string full_scheme = getURLType(url.c_str(), false);
+    auto offset = full_scheme.find_last_of("+");
+    cred = (offset == std::string::npos) ? "" : full_scheme.substr(0, offset);
+    full_url = url;
+    if (offset != std::string::npos) {
+        full_url = full_url.substr(offset + 1);
+    }
+}
+
+
+bool
+MultiFileCurlPlugin::StartTransfer( CURLM *multi, CurlTransfer &xfer, bool upload ) {
+
+    std::string cred, full_url;
+    SplitCredentialFromUrl( xfer.url, cred, full_url );
+
+    if ( _diagnostic ) {
+        fprintf( stderr, "Starting %s of %s (try #%d).\n", upload ? "upload" : "download",
+            full_url.c_str(), xfer.retry_count + 1 );
+    }
+    xfer.retry_count++;
+    if ( xfer.stats->TransferStartTime == 0 ) {
+        xfer.stats->TransferStartTime = time(NULL);
+    }
+
+    const char *mode = upload ? "r" : ( xfer.partial_bytes ? "a+" : "w" );
+    if ( !(xfer.file = OpenLocalFile(xfer.local_file_name, mode)) ) {
+        return false;
+    }
+
+    if ( xfer.handle ) {
+        curl_easy_reset( xfer.handle );
+    } else if ( (xfer.handle = curl_easy_init()) == NULL ) {
+        fprintf( stderr, "Error: failed to initialize a curl handle\n" );
+        return false;
+    }
+
+    try {
+        InitializeCurlHandle( xfer.handle, xfer.error_buffer, &xfer.progress, full_url, cred, xfer.header_list );
+    } catch (const std::exception &exc) {
+        xfer.stats->TransferSuccess = false;
+        xfer.stats->TransferError = exc.what();
+        fprintf( stderr, "Error: %s.\n", exc.what() );
+        return false;
+    }
+
+    CURLcode r;
+    if ( upload ) {
+        struct stat stat_buf;
+        if (-1 == fstat(fileno(xfer.file), &stat_buf)) {
+            if ( _diagnostic ) { fprintf(stderr, "Failed to stat the local file for upload: %s (errno=%d).\n", strerror(errno), errno); }
+            return false;
+        }
+        r = curl_easy_setopt( xfer.handle, CURLOPT_READDATA, xfer.file );
+        if (r != CURLE_OK) {
+            fprintf(stderr, "Can't setopt CUROPT_READDATA\n");
+            return false;
+        }
+        r = curl_easy_setopt( xfer.handle, CURLOPT_UPLOAD, 1L );
+        if (r != CURLE_OK) {
+            fprintf(stderr, "Can't setopt CUROPT_UPLOAD\n");
+            return false;
+        }
+        r = curl_easy_setopt( xfer.handle, CURLOPT_INFILESIZE_LARGE, (curl_off_t)stat_buf.st_size );
+        if (r != CURLE_OK) {
+            fprintf(stderr, "Can't setopt CUROPT_INFILESIZE_LARGE\n");
+            return false;
+        }
+    } else {
+        r = curl_easy_setopt( xfer.handle, CURLOPT_WRITEDATA, xfer.file );
+        if (r != CURLE_OK) {
+            fprintf(stderr, "Can't setopt CURLOPT_WRITEDATA\n");
+        }
+        if (!full_url.starts_with("ftp://")) {
+            r = curl_easy_setopt( xfer.handle, CURLOPT_HEADERDATA, xfer.stats.get() );
+            if (r != CURLE_OK) {
+                fprintf(stderr, "Can't setopt CURLOPT_HEADERDATA\n");
+            }
+        }
+        if ( xfer.partial_bytes ) {
+            char partial_range[20];
+            snprintf( partial_range, sizeof(partial_range), "%lu-", xfer.partial_bytes );
+            r = curl_easy_setopt( xfer.handle, CURLOPT_RANGE, partial_range );
+            if (r != CURLE_OK) {
+                fprintf(stderr, "Can't setopt CURLOPT_RANGE\n");
+            }
+        }
+    }
+
+    if ( xfer.header_list ) {
+        r = curl_easy_setopt( xfer.handle, CURLOPT_HTTPHEADER, xfer.header_list );
+        if (r != CURLE_OK) {
+            fprintf(stderr, "Can't setopt CURLOPT_HTTPHEADER\n");
+            return false;
+        }
+    }
+
+    // Ask for HTTP/2 over TLS, so that transfers to the same server can be
+    // multiplexed over one connection, and have a transfer that is started
+    // while that connection is still being set up wait for it rather than
+    // opening another.  Servers that don't speak HTTP/2 get HTTP/1.1 over
+    // connections that are kept alive and reused from transfer to transfer.
+#if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 47)
+    curl_easy_setopt( xfer.handle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS );
+#endif
+#if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 43)
+    curl_easy_setopt( xfer.handle, CURLOPT_PIPEWAIT, 1L );
+#endif
+    curl_easy_setopt( xfer.handle, CURLOPT_PRIVATE, &xfer );
+
+    xfer.stats->TransferType = upload ? "upload" : "download";
+    xfer.stats->TransferTries += 1;
+
+    CURLMcode mr = curl_multi_add_handle( multi, xfer.handle );
+    if ( mr != CURLM_OK ) {
+        fprintf( stderr, "Can't add transfer of %s: %s\n", full_url.c_str(), curl_multi_strerror(mr) );
+        return false;
+    }
+    return true;
+}
+
+
+void
+MultiFileCurlPlugin::EndTransfer( CurlTransfer &xfer, int rval, bool upload ) {
+
+    if ( xfer.header_list ) {
+        curl_slist_free_all( xfer.header_list );
+        xfer.header_list = nullptr;
+    }
+
+    if ( !upload ) {
+        // A 301 or 302 without a Location header is an error, see DownloadFile().
+        char* redirect_url = nullptr;
+        long return_code = 0;
+        curl_easy_getinfo( xfer.handle, CURLINFO_REDIRECT_URL, &redirect_url );
+        curl_easy_getinfo( xfer.handle, CURLINFO_RESPONSE_CODE, &return_code );
+        if( ( return_code == 301 || return_code == 302 ) && !redirect_url ) {
+            rval = CURLE_REMOTE_FILE_NOT_FOUND;
+            strcpy(xfer.error_buffer, "The URL you requested could not be found.");
+        }
+    }
+
+    FinishCurlTransfer( xfer.handle, *xfer.stats, xfer.error_buffer, rval, xfer.file );
+    xfer.rval = rval;
+
+    // Check if the request completed partially. If so, remember how much
+    // we have so that the next try can resume.  The probe goes out on this
+    // transfer's handle (after its stats were gathered above), with the
+    // response discarded rather than appended to the file.
+    if ( !upload && rval == CURLE_PARTIAL_FILE && xfer.stats->HttpCacheHitOrMiss != "HIT" ) {
+        long have = ftell( xfer.file );
+        std::string cred, full_url;
+        SplitCredentialFromUrl( xfer.url, cred, full_url );
+        curl_easy_setopt( xfer.handle, CURLOPT_WRITEFUNCTION, &CurlWriteCallback );
+        curl_easy_setopt( xfer.handle, CURLOPT_WRITEDATA, NULL );
+        if ( ServerSupportsResume( xfer.handle, full_url ) ) {
+            xfer.partial_bytes = have;
+        }
+    }
+
+    if( _diagnostic && rval ) {
+        fprintf(stderr, "transfer of %s returned CURLcode %d: %s\n",
+                xfer.url.c_str(), rval, curl_easy_strerror( ( CURLcode ) rval ) );
+    }
+}
+
+
+TransferPluginResult
+MultiFileCurlPlugin::TransferMultipleFiles( const std::vector<std::pair<std::string, transfer_request>> &requested_files, bool upload ) {
+
+    CURLM *multi = curl_multi_init();
+    if ( multi == NULL ) {
+        fprintf( stderr, "Error: failed to initialize a curl multi handle\n" );
+        return TransferPluginResult::Error;
+    }
+#if defined(CURLPIPE_MULTIPLEX)
+    curl_multi_setopt( multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX );
+#endif
+
+    // Only one transfer at a time can write to our stdout.
+    int max_active = m_max_concurrent;
+    for ( const auto &file_pair : requested_files ) {
+        if ( file_pair.second.local_file_name == "-" ) { max_active = 1; }
+    }
+    if ( _diagnostic ) {
+        fprintf( stderr, "%s %zu files, up to %d at a time.\n", upload ? "Uploading" : "Downloading",
+            requested_files.size(), max_active );
+    }
+
+    // The transfers never move once started, libcurl holds pointers into them.
+    std::vector<CurlTransfer> transfers( requested_files.size() );
+    std::deque<size_t> waiting;
+    for ( size_t i = 0; i < requested_files.size(); ++i ) {
+        CurlTransfer &xfer = transfers[i];
+        xfer.url = requested_files[i].first;
+        xfer.local_file_name = requested_files[i].second.local_file_name;
+        xfer.stats.reset( new FileTransferStats() );
+        InitializeStats( *xfer.stats, xfer.url );
+        xfer.stats->TransferFileName = xfer.local_file_name;
+        waiting.push_back( i );
+    }
+
+    int rval = 0;
+    int active = 0;
+    // As in the serial loop, a failed download ends the whole request
+    // (though transfers already in flight are allowed to finish), while
+    // every upload is attempted.
+    bool stop = false;
+
+    auto finish = [&]( CurlTransfer &xfer, int file_rval ) {
+        if ( xfer.file ) {
+            fclose( xfer.file );
+            xfer.file = nullptr;
+        }
+        if ( file_rval != CURLE_OK && xfer.retry_count <= max_retry_attempts && ShouldRetryTransfer(file_rval) ) {
+            if ( _diagnostic ) { fprintf( stderr, "Retry count #%d for %s\n", xfer.retry_count, xfer.url.c_str() ); }
+            xfer.start_after = time(NULL) + xfer.retry_count;
+            waiting.push_back( &xfer - &transfers[0] );
+            return;
+        }
+        xfer.rval = file_rval;
+        xfer.stats->TransferEndTime = time(NULL);
+        if ( file_rval != CURLE_OK && rval == 0 ) {
+            rval = file_rval;
+        }
+        if ( file_rval > 0 && !upload ) {
+            stop = true;
+        }
+    };
+
+    for ( ;; ) {
+        time_t now = time(NULL);
+        for ( size_t n = waiting.size(); n > 0; --n ) {
+            size_t idx = waiting.front();
+            waiting.pop_front();
+            CurlTransfer &xfer = transfers[idx];
+            if ( stop || active >= max_active || xfer.start_after > now ) {
+                waiting.push_back( idx );
+                continue;
+            }
+            if ( StartTransfer( multi, xfer, upload ) ) {
+                ++active;
+            } else {
+                finish( xfer, -1 );
+            }
+        }
+
+        if ( active == 0 ) {
+            if ( stop || waiting.empty() ) {
+                break;
+            }
+            // Nothing in flight, only retries waiting for their turn.
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        int running = 0;
+        curl_multi_perform( multi, &running );
+
+        CURLMsg *msg = nullptr;
+        int msgs_left = 0;
+        while ( (msg = curl_multi_info_read( multi, &msgs_left )) ) {
+            if ( msg->msg != CURLMSG_DONE ) {
+                continue;
+            }
+            CURL *handle = msg->easy_handle;
+            int file_rval = msg->data.result;
+            curl_multi_remove_handle( multi, handle );
+            --active;
+
+            char *priv = nullptr;
+            curl_easy_getinfo( handle, CURLINFO_PRIVATE, &priv );
+            CurlTransfer &xfer = *reinterpret_cast<CurlTransfer *>(priv);
+            EndTransfer( xfer, file_rval, upload );
+            finish( xfer, xfer.rval );
+        }
+
+        if ( running > 0 ) {
+            curl_multi_wait( multi, NULL, 0, 1000, NULL );
+        }
+    }
+
+    // Report on every file we attempted, in the order they were requested.
+    classad::ClassAdUnParser unparser;
+    for ( auto &xfer : transfers ) {
+        if ( xfer.retry_count > 0 ) {
+            classad::ClassAd stats_ad;
+            xfer.stats->Publish( stats_ad );
+            std::string stats_string;
+            unparser.Unparse( stats_string, &stats_ad );
+            _all_files_stats += stats_string;
+        }
+        if ( xfer.header_list ) { curl_slist_free_all( xfer.header_list ); }
+        if ( xfer.file ) { fclose( xfer.file ); }
+        if ( xfer.handle ) { curl_easy_cleanup( xfer.handle ); }
+    }
+    curl_multi_cleanup( multi );
+
+    if ( rval != 0 ) return TransferPluginResult::Error;
+
+    return TransferPluginResult::Success;
+}
+
+
 /*
     Check if this server supports resume requests using the HTTP "Range" header
     by sending a Range request and checking the return code. Code 206 means
@@ -814,39 +1166,39 @@ MultiFileCurlPlugin::DownloadMultipleFiles( const std::string &input_filename )
     Return: 1 if resume is supported, 0 if not.
 */
 int 
-MultiFileCurlPlugin::ServerSupportsResume( const std::string &url ) {
+MultiFileCurlPlugin::ServerSupportsResume( CURL *handle, const std::string &url ) {
 
     int rval = -1;
 
     // Send a basic request, with Range set to a null range
 	CURLcode r;
-    r = curl_easy_setopt( _handle, CURLOPT_URL, url.c_str() );
+    r = curl_easy_setopt( handle, CURLOPT_URL, url.c_str() );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt CURLOPT_URL\n");
 		return 0;
 	}
-    r = curl_easy_setopt( _handle, CURLOPT_CONNECTTIMEOUT, 60 );
+    r = curl_easy_setopt( handle, CURLOPT_CONNECTTIMEOUT, 60 );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt CURLOPT_CONNECTTIMEOUT\n");
 		return 0;
 	}
-    r = curl_easy_setopt( _handle, CURLOPT_RANGE, "0-0" );
+    r = curl_easy_setopt( handle, CURLOPT_RANGE, "0-0" );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt CURLOPT_RANGE\n");
 		return 0;
 	}
 
-    rval = curl_easy_perform(_handle);
+    rval = curl_easy_perform(handle);
 
     // Check the HTTP status code that was returned
     if( rval == 0 ) {
         char* finalURL = NULL;
-        rval = curl_easy_getinfo( _handle, CURLINFO_EFFECTIVE_URL, &finalURL );
+        rval = curl_easy_getinfo( handle, CURLINFO_EFFECTIVE_URL, &finalURL );
 
         if( rval == 0 ) {
             if( strstr( finalURL, "http" ) == finalURL ) {
                 long httpCode = 0;
-                rval = curl_easy_getinfo( _handle, CURLINFO_RESPONSE_CODE, &httpCode );
+                rval = curl_easy_getinfo( handle, CURLINFO_RESPONSE_CODE, &httpCode );
 
                 // A 206 status code indicates resume is supported. Return true!
                 if( httpCode == 206 ) {
@@ -858,7 +1210,7 @@ MultiFileCurlPlugin::ServerSupportsResume( const std::string &url ) {
 
     // If we've gotten this far the server does not support resume. Clear the
     // HTTP "Range" header and return false.
-    r = curl_easy_setopt( _handle, CURLOPT_RANGE, NULL );
+    r = curl_easy_setopt( handle, CURLOPT_RANGE, NULL );
 	if (r != CURLE_OK) {
 		fprintf(stderr, "Can't setopt CURLOPT_RANGE\n");
 		return 0;
@@ -867,7 +1219,7 @@ MultiFileCurlPlugin::ServerSupportsResume( const std::string &url ) {
 }
 
 void
-MultiFileCurlPlugin::InitializeStats( std::string request_url ) {
+MultiFileCurlPlugin::InitializeStats( FileTransferStats &stats, std::string request_url ) {
 
     char* url = strdup( request_url.c_str() );
     char* url_token;
@@ -875,23 +1227,23 @@ MultiFileCurlPlugin::InitializeStats( std::string request_url ) {
     // Set the transfer protocol. If it's not http, ftp and file, then just
     // leave it blank because this transfer will fail quickly.
     if ( !strncasecmp( url, "http://", 7 ) ) {
-        _this_file_stats->TransferProtocol = "http";
+        stats.TransferProtocol = "http";
     }
     else if ( !strncasecmp( url, "https://", 8 ) ) {
-        _this_file_stats->TransferProtocol = "https";
+        stats.TransferProtocol = "https";
     }
     else if ( !strncasecmp( url, "ftp://", 6 ) ) {
-        _this_file_stats->TransferProtocol = "ftp";
+        stats.TransferProtocol = "ftp";
     }
     else if ( !strncasecmp( url, "file://", 7 ) ) {
-        _this_file_stats->TransferProtocol = "file";
+        stats.TransferProtocol = "file";
     }
 
     // Set the request host name by parsing it out of the URL
-    _this_file_stats->TransferUrl = url;
+    stats.TransferUrl = url;
     url_token = strtok( url, ":/" );
     url_token = strtok( NULL, "/" );
-    _this_file_stats->TransferHostName = url_token;
+    stats.TransferHostName = url_token;
 
     // Set the host name of the local machine using getaddrinfo().
     struct addrinfo hints, *info;
@@ -909,7 +1261,7 @@ MultiFileCurlPlugin::InitializeStats( std::string request_url ) {
     // Look up the host name. If this fails for any reason, do not include
     // it with the stats.
     if ( ( addrinfo_result = getaddrinfo( hostname, "http", &hints, &info ) ) == 0 ) {
-        _this_file_stats->TransferLocalMachineName = info->ai_canonname;
+        stats.TransferLocalMachineName = info->ai_canonname;
     }
 
     // Cleanup and exit
@@ -1014,6 +1366,10 @@ MultiFileCurlPlugin::ParseAds() {
     if (job_ad.EvaluateAttrInt("LowSpeedTime", speed_time)) {
         m_speed_time = speed_time;
     }
+    int max_concurrent;
+    if (job_ad.EvaluateAttrInt("CurlMaxConcurrentTransfers", max_concurrent)) {
+        m_max_concurrent = max_concurrent;
+    }
 }
 
 
@@ -1105,6 +1461,14 @@ main( int argc, char **argv ) {
         return (int)TransferPluginResult::Error;
     }
 
+	// How many files to move at once; 1 transfers them one after the other
+	const char *concurrent_str = getenv("CONDOR_CURL_MAX_CONCURRENT_TRANSFERS");
+	if (concurrent_str) {
+		if (atoi(concurrent_str) > 0) {
+			curl_plugin.SetMaxConcurrentTransfers(atoi(concurrent_str));
+		}
+	}
+
     // Do the transfer(s)
     result = upload ?
              curl_plugin.UploadMultipleFiles( input_filename )
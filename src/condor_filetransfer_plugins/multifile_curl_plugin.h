@@ -11,6 +11,8 @@ struct transfer_request {
 };
 
 class FileTransferStats;
+struct CurlTransfer;
+struct xferProgress;
 
 class MultiFileCurlPlugin {
 
@@ -24,16 +26,24 @@ class MultiFileCurlPlugin {
     TransferPluginResult UploadMultipleFiles( const std::string &input_filename );
 
     std::string GetStats() const { return _all_files_stats; }
+    void SetMaxConcurrentTransfers( int max_concurrent ) { m_max_concurrent = max_concurrent; }
 
   private:
 
-    void InitializeStats( std::string request_url );
-    void InitializeCurlHandle( const std::string &request_url, const std::string &cred, struct curl_slist *& );
-    void FinishCurlTransfer( int rval, FILE *file );
+    void InitializeStats( FileTransferStats &stats, std::string request_url );
+    void InitializeCurlHandle( CURL *handle, char *error_buffer, struct xferProgress *progress,
+            const std::string &request_url, const std::string &cred, struct curl_slist *& );
+    void FinishCurlTransfer( CURL *handle, FileTransferStats &stats, const char *error_buffer, int rval, FILE *file );
+
+        // Transfer the requested files through a curl_multi handle, with up to
+        // m_max_concurrent transfers in flight sharing its connection cache.
+    TransferPluginResult TransferMultipleFiles( const std::vector<std::pair<std::string, transfer_request>> &requested_files, bool upload );
+    bool StartTransfer( CURLM *multi, CurlTransfer &xfer, bool upload );
+    void EndTransfer( CurlTransfer &xfer, int rval, bool upload );
 
     static size_t HeaderCallback( char* buffer, size_t size, size_t nitems, void *userdata );
     static size_t FtpWriteCallback( void* buffer, size_t size, size_t nmemb, void* stream );
-    int ServerSupportsResume( const std::string &url );
+    int ServerSupportsResume( CURL *handle, const std::string &url );
     int UploadFile( const std::string &url, const std::string &local_file_name, const std::string &cred );
     int DownloadFile( const std::string &url, const std::string &local_file_name, const std::string &cred, long &partial_bytes );
     int BuildTransferRequests (const std::string & input_filename, std::vector<std::pair<std::string, transfer_request>> &requested_files) const;
@@ -51,4 +61,5 @@ class MultiFileCurlPlugin {
     char _error_buffer[CURL_ERROR_SIZE];
     int m_speed_limit{1024};
     int m_speed_time{30};
+    int m_max_concurrent{4};
 };
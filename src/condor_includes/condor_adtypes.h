@@ -27,6 +27,7 @@
 #define STARTD_OLD_ADTYPE		"Machine"
 #define STARTD_SLOT_ADTYPE		"Machine"  // can't make this "Slot" without breaking GANGLIAD for now....
 #define STARTD_DAEMON_ADTYPE	"StartD"
+#define STARTD_SLOT_BASE_ADTYPE	"Slot.Base" // machine-wide attributes shared by the dynamic slot ads of a startd
 #define STARTD_PVT_ADTYPE		"MachinePrivate"
 #define SCHEDD_ADTYPE			"Scheduler"
 #define MASTER_ADTYPE			"DaemonMaster"
@@ -47,6 +48,7 @@
 #define XFER_SERVICE_ADTYPE		"XferService"		/* No longer used */
 #define LEASE_MANAGER_ADTYPE		"LeaseManager"	/* No longer used */
 #define CREDD_ADTYPE			"CredD"
+#define CCB_SERVER_ADTYPE		"CCBServer"
 #define JOB_ROUTER_ADTYPE		"Job_Router"
 #define ANY_ADTYPE			"Any"
 #define GENERIC_ADTYPE			"Generic"
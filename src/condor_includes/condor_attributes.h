@@ -683,6 +683,8 @@
 #define ATTR_SLOT_PARTITIONABLE  "PartitionableSlot"
 #define ATTR_SLOT_BACKFILL  "BackfillSlot"
 #define ATTR_SLOT_DYNAMIC  "DynamicSlot"
+#define ATTR_SLOT_BASE_AD  "SlotBaseAd"
+#define ATTR_SLOT_BASE_AD_SEQUENCE  "SlotBaseAdSequence"
 #define ATTR_SOURCE  "Source"
 #define ATTR_STAGE_IN_START  "StageInStart"
 #define ATTR_STAGE_IN_FINISH  "StageInFinish"
@@ -983,6 +985,7 @@ extern const char ATTR_SEC_AUTHENTICATED_USER [];
 #define ATTR_SEC_ECDH_PUBLIC_KEY "ECDHPublicKey"
 #define ATTR_SEC_RESUME_RESPONSE "ResumeResponse"
 #define ATTR_SEC_NEGOTIATED_SESSION "NegotiatedSession"
+#define ATTR_SEC_KEEP_ALIVE "KeepAlive"
 
 #define ATTR_MULTIPLE_TASKS_PER_PVMD  "MultipleTasksPerPvmd"
 
@@ -1176,6 +1179,11 @@ extern const char ATTR_SEC_AUTHENTICATED_USER [];
 #define ATTR_TRANSFER_QUEUE_NUM_WAITING_TO_DOWNLOAD  "TransferQueueNumWaitingToDownload"
 #define ATTR_TRANSFER_QUEUE_UPLOAD_WAIT_TIME  "TransferQueueUploadWaitTime"
 #define ATTR_TRANSFER_QUEUE_DOWNLOAD_WAIT_TIME  "TransferQueueDownloadWaitTime"
+#define ATTR_TRANSFER_QUEUE_UPLOAD_WAIT_TIMES  "TransferQueueUploadWaitTimes"
+#define ATTR_TRANSFER_QUEUE_DOWNLOAD_WAIT_TIMES  "TransferQueueDownloadWaitTimes"
+#define ATTR_TRANSFER_QUEUE_WAIT_TIMES_BUCKETS  "TransferQueueWaitTimesHistogramBuckets"
+#define ATTR_TRANSFER_QUEUE_NUM_FAST_LANE_UPLOADING  "TransferQueueNumFastLaneUploading"
+#define ATTR_TRANSFER_QUEUE_NUM_FAST_LANE_DOWNLOADING  "TransferQueueNumFastLaneDownloading"
 #define ATTR_SANDBOX_SIZE "SandboxSize"
 #define ATTR_FILE_TRANSFER_UPLOAD_BYTES_PER_SECOND "FileTransferUploadBytesPerSecond"
 #define ATTR_FILE_TRANSFER_DOWNLOAD_BYTES_PER_SECOND "FileTransferDownloadBytesPerSecond"
@@ -67,7 +67,7 @@ const int REQUEST_CLAIM_SLOT_AD          = 7;
 
 
 constexpr const
-std::array<std::pair<int, const char *>, 197> makeCommandTable() {
+std::array<std::pair<int, const char *>, 198> makeCommandTable() {
 	return {{ // Yes, we need two...
 
 /****
@@ -373,6 +373,8 @@ std::array<std::pair<int, const char *>, 197> makeCommandTable() {
 		{SET_FLOOR, "SET_FLOOR"},
 #define DIRECT_ATTACH (SCHED_VERS+131) // Provide slot ads to the schedd (not from the negotiator)
 		{DIRECT_ATTACH, "DIRECT_ATTACH"},
+#define SHADOW_JOB_UPDATE (SCHED_VERS+132) // Shadow: long-lived stream of periodic job ad updates
+		{SHADOW_JOB_UPDATE, "SHADOW_JOB_UPDATE"},
 // command ids from +140 to +149 reserved for Schedd UserRec commands
 #define QUERY_USERREC_ADS (SCHED_VERS+140)
 		{QUERY_USERREC_ADS, "QUERY_USERREC_ADS"},
@@ -126,6 +126,9 @@ public:
 		bool m_nonblocking{false};
 		const char *m_cmd_description{nullptr};
 		const char *m_sec_session_id{nullptr};
+			// Ask the server to keep a TCP connection open for another
+			// command once this one is done.
+		bool m_keep_alive{false};
 			// Do the start command on behalf of a specific owner;
 			// empty tag is the default (`condor` for daemons...).
 		std::string m_owner;
@@ -155,6 +158,11 @@ public:
 
 	bool getSessionPolicy(const char *sess_id, classad::ClassAd &policy);
 
+		// Find the cached session that a command to addr would resume,
+		// the same way startCommand() chooses one.  owner is as in
+		// StartCommandRequest.  Returns false if there is no such session.
+	bool findCommandSession(const char *addr, int cmd, const char *sec_session_id_hint, const std::string &owner, std::string &sess_id);
+
 	bool getSessionStringAttribute(const char *sess_id, const char *attr_name, std::string &attr_value);
 
     //------------------------------------------
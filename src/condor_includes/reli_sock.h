@@ -179,6 +179,9 @@ public:
     /// returns <0 on failure, 0 for ok
 	//  See put_file() for the meaning of specific return codes.
 	int put_file_with_permissions( filesize_t *size, const char *source, filesize_t max_bytes=-1, class DCTransferQueue *xfer_q=NULL);
+	// As above, but sends the file already open on fd, which the caller
+	// closes.  source is only used in messages.
+	int put_file_with_permissions( filesize_t *size, int fd, const char *source, filesize_t max_bytes=-1, class DCTransferQueue *xfer_q=NULL);
 	// xfer_q (if not NULL) is used to report i/o stats
     /// returns <0 on failure, 0 for ok
 	//  failure codes: PUT_FILE_OPEN_FAILED  (errno contains specific error)
@@ -299,6 +302,8 @@ public:
 //
 protected:
 
+	int put_file_permissions( filesize_t *size, const char *source, int fd );
+
 	bool set_non_blocking(bool val) {bool state = m_non_blocking; m_non_blocking = val; return state;}
 	bool is_non_blocking() const {return m_non_blocking;}
 
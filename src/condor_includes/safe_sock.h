@@ -115,6 +115,20 @@ public:
 	int attach_to_file_desc(int);
 #endif
 	static int recvQueueDepth(int port);
+
+	/** Read up to max_datagrams waiting datagrams with one system call
+		(recvmmsg), without blocking.  handle_incoming_packet() hands them
+		out before it reads from the socket again.
+		@return the number of datagrams read, 0 if none were waiting,
+		        or -1 if batched reads failed or aren't supported here
+	*/
+	int read_datagram_batch(int max_datagrams);
+	/// true if datagrams read by read_datagram_batch() are still waiting
+	bool has_buffered_datagrams() const;
+	/// number of datagrams the kernel dropped on this socket because its
+	/// receive buffer was full, since the last call.  only counted
+	/// once read_datagram_batch() has been used.
+	unsigned int take_datagrams_dropped();
 	
 
 	//	byte operations
@@ -145,6 +159,9 @@ protected:
 
 	static _condorMsgID _outMsgID;
 
+	struct DatagramBatch;
+	int take_buffered_datagram(void *buf, int buf_size);
+
 	enum safesock_state { safesock_none, safesock_listen };
 
 	inline bool same(const _condorMsgID msgA,
@@ -168,6 +185,7 @@ protected:
 	int _tOutBtwPkts;
 	int m_udp_network_mtu;
 	int m_udp_loopback_mtu;
+	DatagramBatch *_recvBatch;
 
 	// statistics variables
 	static unsigned long _noMsgs;
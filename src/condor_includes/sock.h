@@ -425,6 +425,11 @@ public:
 	void setTrustDomain(const std::string &trust_domain) { _trust_domain = trust_domain; }
 	const std::string &getTrustDomain() const { return _trust_domain; }
 
+		/// Forget the peer's identity, authorization limits, security
+		/// session and keys, so that the connection can carry another
+		/// command that must establish its own.
+	void clearSecurityState();
+
 		/// Returns true if the fully qualified user name is
 		/// a non-anonymous user name (i.e. something not from
 		/// the unmapped domain)
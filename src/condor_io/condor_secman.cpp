@@ -1030,6 +1030,8 @@ class SecManStartCommand: Service, public ClassyCountedPtr {
 		// correct cleanup (e.g. calling callback etc.)
 	StartCommandResult startCommand();
 
+	void setKeepAlive(bool keep_alive) { m_keep_alive = keep_alive; }
+
 	void incrementPendingSockets() {
 			// This is called to let daemonCore know that we are holding
 			// onto a socket which is waiting for some callback other than
@@ -1069,6 +1071,7 @@ class SecManStartCommand: Service, public ClassyCountedPtr {
 	bool m_already_logged_startcommand;
 	bool m_sock_had_no_deadline;
 	bool m_want_resume_response;
+	bool m_keep_alive{false};
 	ClassAd m_auth_info;
 	SecMan::sec_req m_negotiation;
 	std::string m_remote_version;
@@ -1168,6 +1171,7 @@ SecMan::startCommand(const StartCommandRequest &req)
 		this);
 
 	ASSERT(sc.get());
+	sc->setKeepAlive(req.m_keep_alive);
 
 	return sc->startCommand();
 }
@@ -1471,6 +1475,7 @@ SecManStartCommand::sendAuthInfo_inner()
 	// otherwise, get our security policy and work it out with the server.
 	if (m_have_session) {
 		MergeClassAds( &m_auth_info, session_entry->policy(), true );
+		m_sock->setSessionID(session_entry->id());
 
 		if (IsDebugVerbose(D_SECURITY)) {
 			dprintf (D_SECURITY, "SECMAN: found cached session id %s for %s.\n",
@@ -1744,6 +1749,10 @@ SecManStartCommand::sendAuthInfo_inner()
 	// fill in command
 	m_auth_info.Assign(ATTR_SEC_COMMAND, m_cmd);
 
+	if (m_keep_alive && m_is_tcp) {
+		m_auth_info.Assign(ATTR_SEC_KEEP_ALIVE, true);
+	}
+
 	if ((m_cmd == DC_AUTHENTICATE) || (m_cmd == DC_SEC_QUERY)) {
 		// fill in sub-command
 		m_auth_info.Assign(ATTR_SEC_AUTH_COMMAND, m_subcmd);
@@ -3272,6 +3281,7 @@ SecMan::SecMan() :
 		m_resume_proj.insert(ATTR_SEC_NONCE);
 		m_resume_proj.insert(ATTR_SEC_RESUME_RESPONSE);
 		m_resume_proj.insert(ATTR_SEC_REMOTE_VERSION);
+		m_resume_proj.insert(ATTR_SEC_KEEP_ALIVE);
 	}
 
 	if ( NULL == m_ipverify ) {
@@ -4006,6 +4016,39 @@ SecMan::getSessionPolicy(const char *session_id, classad::ClassAd &policy_ad)
 	return true;
 }
 
+bool
+SecMan::findCommandSession(const char *addr, int cmd, const char *sec_session_id_hint, const std::string &owner, std::string &sess_id)
+{
+	KeyCacheEntry *session_entry = nullptr;
+
+	if (sec_session_id_hint && sec_session_id_hint[0]) {
+		if (strcmp(sec_session_id_hint, USE_TMP_SEC_SESSION) == 0) {
+			return false;
+		}
+		if (LookupNonExpiredSession(sec_session_id_hint, session_entry)) {
+			sess_id = sec_session_id_hint;
+			return true;
+		}
+	}
+
+	// this must match the key that SecManStartCommand uses
+	const std::string &tag = owner.empty() ? getTag() : owner;
+	std::string keybuf;
+	if (tag.size()) {
+		formatstr(keybuf, "{%s,%s,<%i>}", tag.c_str(), addr, cmd);
+	} else {
+		formatstr(keybuf, "{%s,<%i>}", addr, cmd);
+	}
+	auto command_pair = command_map.find(keybuf);
+	if (command_pair == command_map.end() ||
+		! LookupNonExpiredSession(command_pair->second.c_str(), session_entry))
+	{
+		return false;
+	}
+	sess_id = command_pair->second;
+	return true;
+}
+
 bool
 SecMan::getSessionStringAttribute(const char *session_id, const char *attr_name, std::string &attr_value)
 {
@@ -2270,6 +2270,14 @@ ReliSock::put_file( filesize_t *size, int fd, filesize_t offset, filesize_t max_
 		lseek( fd, offset, SEEK_SET );
 	}
 
+#if defined(POSIX_FADV_SEQUENTIAL)
+	// we read the file front to back exactly once, so a larger readahead
+	// window keeps the disk ahead of the network
+	if ( bytes_to_send > 0 ) {
+		(void)posix_fadvise( fd, offset, bytes_to_send, POSIX_FADV_SEQUENTIAL );
+	}
+#endif
+
 	// Log what's going on
 	dprintf(D_FULLDEBUG,
 			"put_file: sending " FILESIZE_T_FORMAT " bytes\n", bytes_to_send );
@@ -2486,18 +2494,41 @@ ReliSock::get_file_with_permissions( filesize_t *size,
 int
 ReliSock::put_file_with_permissions( filesize_t *size, const char *source, filesize_t max_bytes, DCTransferQueue *xfer_q )
 {
-	int result;
+	int result = put_file_permissions( size, source, -1 );
+	if ( result != 0 ) {
+		return result;
+	}
+
+	return put_file( size, source, 0, max_bytes, xfer_q );
+}
+
+int
+ReliSock::put_file_with_permissions( filesize_t *size, int fd, const char *source, filesize_t max_bytes, DCTransferQueue *xfer_q )
+{
+	int result = put_file_permissions( size, source, fd );
+	if ( result != 0 ) {
+		return result;
+	}
+
+	return put_file( size, fd, 0, max_bytes, xfer_q );
+}
+
+// Sends the permissions of the file open on fd, or of source if fd is -1,
+// ahead of the file itself.  Returns 0 if the file should be sent next.
+int
+ReliSock::put_file_permissions( filesize_t *size, const char *source, int fd )
+{
 	condor_mode_t file_mode;
 
 #ifndef WIN32
 	// Stat the file
-	StatInfo stat_info( source );
+	std::unique_ptr<StatInfo> stat_info( fd >= 0 ? new StatInfo( fd ) : new StatInfo( source ) );
 
-	if ( stat_info.Error() ) {
+	if ( stat_info->Error() ) {
 		dprintf( D_ALWAYS, "ReliSock::put_file_with_permissions(): "
 				 "Failed to stat file '%s': %s (errno: %d, si_error: %d)\n",
-				 source, strerror(stat_info.Errno()), stat_info.Errno(),
-				 stat_info.Error() );
+				 source, strerror(stat_info->Errno()), stat_info->Errno(),
+				 stat_info->Error() );
 
 		// Now send an empty file in order to recover sanity on this
 		// stream.
@@ -2515,11 +2546,12 @@ ReliSock::put_file_with_permissions( filesize_t *size, const char *source, files
 		}
 		return PUT_FILE_OPEN_FAILED;
 	}
-	file_mode = (condor_mode_t)stat_info.GetMode();
+	file_mode = (condor_mode_t)stat_info->GetMode();
 #else
 		// We don't know what unix permissions a windows file should have,
 		// so tell the other side to ignore permissions from us (act like
 		// get/put_file() ).
+	(void)size; (void)fd;
 	file_mode = NULL_FILE_PERMISSIONS;
 #endif
 
@@ -2535,9 +2567,7 @@ ReliSock::put_file_with_permissions( filesize_t *size, const char *source, files
 		return -1;
 	}
 
-	result = put_file( size, source, 0, max_bytes, xfer_q );
-
-	return result;
+	return 0;
 }
 
 ReliSock::x509_delegation_result
@@ -41,6 +41,39 @@ unsigned long SafeSock::_deleted = 0;
 unsigned long SafeSock::_avgSwhole = 0;
 unsigned long SafeSock::_avgSdeleted = 0;
 
+// Datagrams read from the socket ahead of handle_incoming_packet() by
+// read_datagram_batch().  Each slot is big enough for the largest packet.
+#if defined(LINUX)
+struct SafeSock::DatagramBatch {
+	explicit DatagramBatch(int size)
+		: buffers((size_t)size * SAFE_MSG_MAX_PACKET_SIZE)
+		, addrs(size), iovs(size), hdrs(size), cmsgs(size)
+	{}
+
+	union CmsgBuf {
+		char buf[CMSG_SPACE(sizeof(uint32_t))];
+		struct cmsghdr align;
+	};
+
+	std::vector<char> buffers;
+	std::vector<sockaddr_storage> addrs;
+	std::vector<struct iovec> iovs;
+	std::vector<struct mmsghdr> hdrs;
+	std::vector<CmsgBuf> cmsgs;
+	int count{0};	// datagrams read by the last recvmmsg()
+	int next{0};	// next one to hand to handle_incoming_packet()
+	bool want_drops{false};
+	bool drops_seen{false};		// have we been told the drop count yet?
+	uint32_t drops{0};			// the kernel's drop count for the socket
+	uint32_t drops_taken{0};	// drops as of the last take_datagrams_dropped()
+};
+#else
+struct SafeSock::DatagramBatch {
+	int count{0};
+	int next{0};
+};
+#endif
+
 
 /* 
    NOTE: All SafeSock constructors initialize with this, so you can
@@ -71,6 +104,7 @@ void SafeSock::init()
 
 	m_udp_network_mtu = -1;
 	m_udp_loopback_mtu = -1;
+	_recvBatch = NULL;
 }
 
 
@@ -111,11 +145,15 @@ SafeSock::~SafeSock()
 	}
 	close();
 
+	delete _recvBatch;
     delete mdChecker_;
 }
 
 int SafeSock::close()
 {
+	if (_recvBatch) {
+		_recvBatch->count = _recvBatch->next = 0;
+	}
 	return Sock::close();
 }
 
@@ -396,7 +434,8 @@ int SafeSock::get_bytes(void *dta, int size)
 {
 	ASSERT( size > 0 );
 	while(!_msgReady) {
-		if(_timeout > 0) {
+			// a datagram we already read in a batch won't wake select()
+		if(_timeout > 0 && !has_buffered_datagrams()) {
 			Selector selector;
 			selector.set_timeout( _timeout );
 			selector.add_fd( _sock, Selector::IO_READ );
@@ -475,7 +514,8 @@ int SafeSock::get_ptr(void *&ptr, char delim)
 	int size;
 
 	while(!_msgReady) {
-		if(_timeout > 0) {
+			// a datagram we already read in a batch won't wake select()
+		if(_timeout > 0 && !has_buffered_datagrams()) {
 			Selector selector;
 			selector.set_timeout( _timeout );
 			selector.add_fd( _sock, Selector::IO_READ );
@@ -507,7 +547,8 @@ int SafeSock::get_ptr(void *&ptr, char delim)
 int SafeSock::peek(char &c)
 {
 	while(!_msgReady) {
-		if(_timeout > 0) {
+			// a datagram we already read in a batch won't wake select()
+		if(_timeout > 0 && !has_buffered_datagrams()) {
 			Selector selector;
 			selector.set_timeout( _timeout );
 			selector.add_fd( _sock, Selector::IO_READ );
@@ -582,8 +623,12 @@ int SafeSock::handle_incoming_packet()
 	}
 
 
-	received = condor_recvfrom(_sock, _shortMsg.dataGram, 
-							   SAFE_MSG_MAX_PACKET_SIZE, 0, _who);
+	if( has_buffered_datagrams() ) {
+		received = take_buffered_datagram(_shortMsg.dataGram, SAFE_MSG_MAX_PACKET_SIZE);
+	} else {
+		received = condor_recvfrom(_sock, _shortMsg.dataGram, 
+								   SAFE_MSG_MAX_PACKET_SIZE, 0, _who);
+	}
 
 	if(received < 0) {
 		dprintf(D_NETWORK, "recvfrom failed: errno = %d\n", errno);
@@ -698,6 +743,134 @@ int SafeSock::handle_incoming_packet()
 }
 
 
+int SafeSock::read_datagram_batch(int max_datagrams)
+{
+#if defined(LINUX)
+	if (max_datagrams <= 0 || _sock == INVALID_SOCKET) {
+		return -1;
+	}
+	if (has_buffered_datagrams()) {
+		return _recvBatch->count - _recvBatch->next;
+	}
+	if ( ! _recvBatch || (int)_recvBatch->hdrs.size() < max_datagrams) {
+		DatagramBatch *batch = new DatagramBatch(max_datagrams);
+		if (_recvBatch) {
+			batch->want_drops = _recvBatch->want_drops;
+			batch->drops_seen = _recvBatch->drops_seen;
+			batch->drops = _recvBatch->drops;
+			batch->drops_taken = _recvBatch->drops_taken;
+			delete _recvBatch;
+		}
+		_recvBatch = batch;
+	}
+	DatagramBatch &batch = *_recvBatch;
+	batch.count = batch.next = 0;
+
+#ifdef SO_RXQ_OVFL
+	// have the kernel tell us how many datagrams it dropped for want of buffer space
+	if ( ! batch.want_drops) {
+		int on = 1;
+		if (::setsockopt(_sock, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)) != 0) {
+			dprintf(D_NETWORK, "setsockopt(SO_RXQ_OVFL) failed: errno = %d\n", errno);
+		}
+		batch.want_drops = true;
+	}
+#endif
+
+	for (int i = 0; i < max_datagrams; ++i) {
+		batch.iovs[i].iov_base = &batch.buffers[(size_t)i * SAFE_MSG_MAX_PACKET_SIZE];
+		batch.iovs[i].iov_len = SAFE_MSG_MAX_PACKET_SIZE;
+		struct msghdr &hdr = batch.hdrs[i].msg_hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.msg_name = &batch.addrs[i];
+		hdr.msg_namelen = sizeof(sockaddr_storage);
+		hdr.msg_iov = &batch.iovs[i];
+		hdr.msg_iovlen = 1;
+		hdr.msg_control = batch.cmsgs[i].buf;
+		hdr.msg_controllen = sizeof(batch.cmsgs[i].buf);
+		batch.hdrs[i].msg_len = 0;
+	}
+
+	int received = recvmmsg(_sock, batch.hdrs.data(), max_datagrams, MSG_DONTWAIT, NULL);
+	if (received < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+			return 0;
+		}
+		dprintf(D_NETWORK, "recvmmsg failed: errno = %d\n", errno);
+		return -1;
+	}
+
+#ifdef SO_RXQ_OVFL
+	for (int i = 0; i < received; ++i) {
+		struct msghdr &hdr = batch.hdrs[i].msg_hdr;
+		for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+			if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+				memcpy(&batch.drops, CMSG_DATA(cmsg), sizeof(batch.drops));
+				if ( ! batch.drops_seen) {
+						// the count covers the life of the socket, so
+						// only report drops from here on
+					batch.drops_taken = batch.drops;
+					batch.drops_seen = true;
+				}
+			}
+		}
+	}
+#endif
+
+	if (IsDebugLevel(D_NETWORK)) {
+		dprintf(D_NETWORK, "RECV batch of %d datagrams at %s\n", received, sock_to_string(_sock));
+	}
+	batch.count = received;
+	return received;
+#else
+	(void)max_datagrams;
+	return -1;
+#endif
+}
+
+bool SafeSock::has_buffered_datagrams() const
+{
+	return _recvBatch && _recvBatch->next < _recvBatch->count;
+}
+
+// Copy the next datagram from the batch into buf, and set _who to its sender.
+int SafeSock::take_buffered_datagram(void *buf, int buf_size)
+{
+#if defined(LINUX)
+	if ( ! has_buffered_datagrams()) {
+		return -1;
+	}
+	int n = _recvBatch->next++;
+	int len = (int)_recvBatch->hdrs[n].msg_len;
+	if (len > buf_size) {
+		len = buf_size;
+	}
+	memcpy(buf, _recvBatch->iovs[n].iov_base, len);
+	_who = condor_sockaddr((sockaddr *)&_recvBatch->addrs[n]);
+	return len;
+#else
+	(void)buf;
+	(void)buf_size;
+	return -1;
+#endif
+}
+
+unsigned int SafeSock::take_datagrams_dropped()
+{
+#if defined(LINUX)
+	if ( ! _recvBatch) {
+		return 0;
+	}
+	// the kernel's counter is cumulative and wraps
+	unsigned int dropped = _recvBatch->drops - _recvBatch->drops_taken;
+	_recvBatch->drops_taken = _recvBatch->drops;
+	return dropped;
+#else
+	return 0;
+#endif
+}
+
+
 void SafeSock::getStat(unsigned long &noMsgs,
 			     unsigned long &noWhole,
 			     unsigned long &noDeleted,
@@ -856,7 +1029,8 @@ int SafeSock::getMsgSize()
 	int result;
 
 	while(!_msgReady) {
-		if(_timeout > 0) {
+			// a datagram we already read in a batch won't wake select()
+		if(_timeout > 0 && !has_buffered_datagrams()) {
 			Selector selector;
 			selector.set_timeout( _timeout );
 			selector.add_fd( _sock, Selector::IO_READ );
@@ -2615,6 +2615,31 @@ const char* Sock :: getCryptoMethodUsed() const {
 	return _crypto_method;
 }
 
+void Sock :: clearSecurityState()
+{
+	set_MD_mode(MD_OFF);
+	set_crypto_key(false, NULL);
+	setFullyQualifiedUser(NULL);
+
+	free(_auth_method);
+	_auth_method = NULL;
+	free(_auth_methods);
+	_auth_methods = NULL;
+	free(_auth_name);
+	_auth_name = NULL;
+	free(_crypto_method);
+	_crypto_method = NULL;
+
+	delete _policy_ad;
+	_policy_ad = NULL;
+	m_authz_bound.clear();
+
+	_session.clear();
+	_trust_domain.clear();
+	_tried_authentication = false;
+	_should_try_token_request = false;
+}
+
 
 
 void Sock :: setFullyQualifiedUser(char const *fqu)
@@ -70,6 +70,7 @@ JobRouter::JobRouter(unsigned int as_tool)
 	, m_schedd1_name(NULL)
 	, m_schedd1_pool(NULL)
 	, m_round_robin_selection(true)
+	, m_use_route_index(true)
 	, m_operate_as_tool(as_tool)
 {
 	m_scheduler = NULL;
@@ -580,6 +581,7 @@ JobRouter::config( int /* timerID */ ) {
 	m_release_on_hold = param_boolean("JOB_ROUTER_RELEASE_ON_HOLD", true);
 
 	m_round_robin_selection = param_boolean("JOB_ROUTER_ROUND_ROBIN_SELECTION", false);
+	m_use_route_index = param_boolean("JOB_ROUTER_USE_ROUTE_INDEX", true);
 
 		// default is no maximum (-1)
 	m_max_jobs = param_integer("JOB_ROUTER_MAX_JOBS",-1);
@@ -1329,6 +1331,7 @@ void JobRouter::SetRoutingTable(RoutingTable *new_routes, HashTable<std::string,
 		}
 	}
 	m_route_order.clear();
+	m_route_index.Clear();
 	DeallocateRoutingTable(m_routes);
 	m_routes = new_routes;
 
@@ -1424,6 +1427,13 @@ void JobRouter::SetRoutingTable(RoutingTable *new_routes, HashTable<std::string,
 		dprintf(D_ALWAYS, "Routes will be matched in this order: %s\n", tmp.c_str());
 	}
 
+	std::vector<JobRoute *> ordered_routes;
+	for (auto rn = m_route_order.begin(); rn != m_route_order.end(); ++rn) {
+		route = safe_lookup_route(*rn);
+		if (route) { ordered_routes.push_back(route); }
+	}
+	m_route_index.Build(ordered_routes);
+
 	UpdateRouteStats();
 }
 
@@ -1771,6 +1781,9 @@ void
 JobRouter::GetCandidateJobs() {
 	if(!m_enable_job_routing) return;
 
+	double pass_start = _condor_debug_get_time_double();
+	m_route_index.ClearStats();
+
     classad::LocalCollectionQuery query;
 	classad::ClassAdParser parser;
 	classad::ExprTree *constraint_tree;
@@ -1853,15 +1866,22 @@ JobRouter::GetCandidateJobs() {
 		return; // No routes are accepting jobs.
 	}
 
-	if(!umbrella_constraint.empty()) {
-		umbrella_constraint += " && ";
+	// When the route index is in use, ChooseRoute() is much quicker to
+	// reject a job than the umbrella constraint would be.
+	if (!m_use_route_index || m_operate_as_tool) {
+		if(!umbrella_constraint.empty()) {
+			umbrella_constraint += " && ";
+		}
+		umbrella_constraint += "( ";
+		umbrella_constraint += route_constraints;
+		umbrella_constraint += " )";
 	}
-	umbrella_constraint += "( ";
-	umbrella_constraint += route_constraints;
-	umbrella_constraint += " )";
 
 	//Add on basic requirements to keep things sane.
-	umbrella_constraint += " && (target.ProcId >= 0 && target.JobStatus == 1 && (target.StageInStart is undefined || target.StageInFinish isnt undefined) && target.Managed isnt \"ScheddDone\" && target.Managed isnt \"External\" && target.Owner isnt Undefined && target.";
+	if(!umbrella_constraint.empty()) {
+		umbrella_constraint += " && ";
+	}
+	umbrella_constraint += "(target.ProcId >= 0 && target.JobStatus == 1 && (target.StageInStart is undefined || target.StageInFinish isnt undefined) && target.Managed isnt \"ScheddDone\" && target.Managed isnt \"External\" && target.Owner isnt Undefined && target.";
 	umbrella_constraint += JR_ATTR_ROUTED_BY;
 	umbrella_constraint += " isnt \"";
 	umbrella_constraint += m_job_router_name;
@@ -1919,7 +1939,7 @@ JobRouter::GetCandidateJobs() {
     if( query.Current(key) ) do {
 		if(!AcceptingMoreJobs()) {
 			dprintf(D_FULLDEBUG,"JobRouter: Reached maximum managed jobs (%d).  Skipping further searches for candidate jobs.\n",m_max_jobs);
-			return; //router is full
+			break; //router is full
 		}
 
 		if(LookupJobWithSrcKey(key)) {
@@ -1939,7 +1959,9 @@ JobRouter::GetCandidateJobs() {
 				dprintf(D_FULLDEBUG,"JobRouter: all routes are full (%d managed jobs).  Skipping further searches for candidate jobs.\n",NumManagedJobs());
 				break;
 			}
-			dprintf(D_FULLDEBUG,"JobRouter: no route found for src=%s\n",key.c_str());
+			if (!m_use_route_index || m_operate_as_tool) {
+				dprintf(D_FULLDEBUG,"JobRouter: no route found for src=%s\n",key.c_str());
+			}
 			continue;
 		}
 
@@ -1971,6 +1993,18 @@ JobRouter::GetCandidateJobs() {
 	if (m_operate_as_tool) {
 		dprintf(D_ALWAYS, "JobRouter: %d candidate jobs found\n", cJobsAdded);
 	}
+
+	double pass_duration = _condor_debug_get_time_double() - pass_start;
+	const RouteMatchIndex::Stats &stats = m_route_index.stats();
+	dprintf(D_FULLDEBUG, "JobRouter: routing pass took %.3f seconds: %d jobs added, %ld jobs tested, "
+		"%ld with known route decisions, %ld route evaluations, %ld routes ruled out by the index, %d kinds of jobs cached\n",
+		pass_duration, cJobsAdded, stats.jobs, stats.cache_hits, stats.routes_evaluated, stats.routes_skipped,
+		(int)m_route_index.CachedDecisions());
+
+	m_public_ad.Assign("RoutingPassDuration", pass_duration);
+	m_public_ad.Assign("RoutingPassJobsTested", stats.jobs);
+	m_public_ad.Assign("RoutingPassCacheHits", stats.cache_hits);
+	m_public_ad.Assign("RoutingPassRouteEvaluations", stats.routes_evaluated);
 }
 
 JobRoute *
@@ -1978,12 +2012,15 @@ JobRouter::ChooseRoute(classad::ClassAd *job_ad,bool *all_routes_full) {
 	std::vector<JobRoute *> matches;
 	JobRoute *route=NULL;
 	*all_routes_full = true;
+	if (m_use_route_index) {
+		m_route_index.SetJob(job_ad);
+	}
 	for (auto it = m_route_order.begin(); it != m_route_order.end(); ++it) {
 		route = safe_lookup_route(*it);
 		if ( ! route) continue;
 		if(!route->AcceptingMoreJobs()) continue;
 		*all_routes_full = false;
-		if (route->Matches(job_ad)) {
+		if (m_use_route_index ? m_route_index.Matches(route) : route->Matches(job_ad)) {
 			matches.push_back(route);
 			if (m_operate_as_tool) { dprintf(D_FULLDEBUG, "JobRouter: \tRoute Matches: %s\n", route->Name()); }
 		}
@@ -24,6 +24,7 @@
 #include "condor_daemon_core.h"
 #include "HashTable.h"
 #include "RoutedJob.h"
+#include "RouteMatchIndex.h"
 
 #include "classad/classad_distribution.h"
 #include <vector>
@@ -168,6 +169,8 @@ class JobRouter: public Service {
 	bool m_enable_job_routing;
 	bool m_release_on_hold;
 	bool m_round_robin_selection;
+	bool m_use_route_index;
+	RouteMatchIndex m_route_index; // of the routes in m_route_order
 
 	int m_job_router_idtoken_refresh;
 	int m_job_router_idtoken_refresh_timer_id;
@@ -0,0 +1,339 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_debug.h"
+#include "condor_classad.h"
+#include "compat_classad_util.h"
+#include "stl_string_utils.h"
+#include "RoutedJob.h"
+#include "RouteMatchIndex.h"
+
+// when there are more distinct jobs than this, forget them all and start over
+static const size_t MAX_CACHED_DECISIONS = 20000;
+
+// Is tree a reference to an attribute of the job: Attr, MY.Attr, SELF.Attr
+// or TARGET.Attr?  The job is both MY and TARGET in the umbrella query.
+static bool IsJobAttrRef(classad::ExprTree * tree, std::string & attr)
+{
+	if ( ! tree || tree->GetKind() != classad::ExprTree::ATTRREF_NODE) return false;
+	classad::ExprTree * scope = nullptr;
+	std::string scope_attr;
+	bool absolute = false;
+	((const classad::AttributeReference*)tree)->GetComponents(scope, attr, absolute);
+	if (absolute) return false;
+	if ( ! scope) return true;
+	return ExprTreeIsAttrRef(scope, scope_attr, &absolute) && ! absolute &&
+		(MATCH == strcasecmp(scope_attr.c_str(), "MY") ||
+		 MATCH == strcasecmp(scope_attr.c_str(), "TARGET") ||
+		 MATCH == strcasecmp(scope_attr.c_str(), "SELF"));
+}
+
+// Add the job attributes that a route's Requirements refer to to refs.
+// Returns false if the Requirements might not give the same answer for two
+// jobs with the same values for those attributes.
+static bool CollectRouteReferences(classad::ExprTree * tree, classad::References & refs)
+{
+	if ( ! tree) return true;
+	switch (tree->GetKind()) {
+
+	case classad::ExprTree::ERROR_LITERAL:
+	case classad::ExprTree::UNDEFINED_LITERAL:
+	case classad::ExprTree::BOOLEAN_LITERAL:
+	case classad::ExprTree::INTEGER_LITERAL:
+	case classad::ExprTree::REAL_LITERAL:
+	case classad::ExprTree::RELTIME_LITERAL:
+	case classad::ExprTree::ABSTIME_LITERAL:
+	case classad::ExprTree::STRING_LITERAL:
+		return true;
+
+	case classad::ExprTree::ATTRREF_NODE: {
+		classad::ExprTree * scope = nullptr;
+		std::string attr;
+		bool absolute = false;
+		((const classad::AttributeReference*)tree)->GetComponents(scope, attr, absolute);
+		if (absolute || MATCH == strcasecmp(attr.c_str(), "CurrentTime")) {
+			return false;
+		}
+		if (IsJobAttrRef(tree, attr)) {
+			refs.insert(attr);
+			return true;
+		}
+		// an attribute of a nested ad, which is covered by the value of the nested ad
+		return CollectRouteReferences(scope, refs);
+	}
+
+	case classad::ExprTree::OP_NODE: {
+		classad::Operation::OpKind op;
+		classad::ExprTree *t1, *t2, *t3;
+		((const classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+		bool ok = CollectRouteReferences(t1, refs);
+		ok = CollectRouteReferences(t2, refs) && ok;
+		return CollectRouteReferences(t3, refs) && ok;
+	}
+
+	case classad::ExprTree::FN_CALL_NODE: {
+		std::string fnName;
+		std::vector<classad::ExprTree*> args;
+		((const classad::FunctionCall*)tree)->GetComponents(fnName, args);
+		bool ok = ! classad::FunctionCall::IsVolatileFunction(fnName);
+		for (auto * arg : args) { ok = CollectRouteReferences(arg, refs) && ok; }
+		return ok;
+	}
+
+	case classad::ExprTree::EXPR_LIST_NODE: {
+		std::vector<classad::ExprTree*> exprs;
+		((const classad::ExprList*)tree)->GetComponents(exprs);
+		bool ok = true;
+		for (auto * expr : exprs) { ok = CollectRouteReferences(expr, refs) && ok; }
+		return ok;
+	}
+
+	case classad::ExprTree::EXPR_ENVELOPE:
+		return CollectRouteReferences(const_cast<classad::ExprTree*>(SkipExprEnvelope(tree)), refs);
+
+	default:
+		// nested ads (and anything we don't know about) can refer to their parent scopes
+		return false;
+	}
+}
+
+// The keys for the conjuncts that a job's value for an attribute satisfies.
+// Returns false when the value is of a type we don't index, in which case
+// no conjunct on the attribute can be ruled out.
+static bool JobValueKeys(const classad::Value & val, std::vector<std::string> & keys)
+{
+	keys.clear();
+	std::string str;
+	bool bval = false;
+	switch (val.GetType()) {
+	case classad::Value::STRING_VALUE:
+		val.IsStringValue(str);
+		keys.emplace_back("S" + str); // =?= is case-sensitive
+		lower_case(str);
+		keys.emplace_back("s" + str); // == is not
+		return true;
+	case classad::Value::BOOLEAN_VALUE:
+		val.IsBooleanValue(bval);
+		keys.emplace_back(bval ? "b1" : "b0");
+		return true;
+	case classad::Value::UNDEFINED_VALUE:
+	case classad::Value::ERROR_VALUE:
+		// nothing compares equal to these
+		return true;
+	default:
+		return false;
+	}
+}
+
+RouteMatchIndex::IndexedAttr &
+RouteMatchIndex::GetIndexedAttr(const std::string & attr)
+{
+	for (auto & ia : m_attrs) {
+		if (MATCH == strcasecmp(ia.name.c_str(), attr.c_str())) return ia;
+	}
+	m_attrs.emplace_back();
+	m_attrs.back().name = attr;
+	return m_attrs.back();
+}
+
+// Requirements can only be true if every one of their && conjuncts is, so
+// a job that fails one of the conjuncts we index is not a match.
+void
+RouteMatchIndex::IndexConjunct(size_t route_ix, classad::ExprTree * conjunct)
+{
+	conjunct = SkipExprParens(conjunct);
+	if ( ! conjunct) return;
+
+	classad::Operation::OpKind op = classad::Operation::__NO_OP__;
+	classad::ExprTree *t1 = nullptr, *t2 = nullptr, *t3 = nullptr;
+	if (conjunct->GetKind() == classad::ExprTree::OP_NODE) {
+		((const classad::Operation*)conjunct)->GetComponents(op, t1, t2, t3);
+		if (op == classad::Operation::LOGICAL_AND_OP) {
+			IndexConjunct(route_ix, t1);
+			IndexConjunct(route_ix, t2);
+			return;
+		}
+		t1 = SkipExprParens(t1);
+		t2 = SkipExprParens(t2);
+	}
+
+	std::string attr, key;
+	classad::Value value;
+	if (op == classad::Operation::EQUAL_OP || op == classad::Operation::META_EQUAL_OP) {
+		std::string str;
+		bool bval = false;
+		if ( ! (IsJobAttrRef(t1, attr) && ExprTreeIsLiteral(t2, value)) &&
+			 ! (ExprTreeIsLiteral(t1, value) && IsJobAttrRef(t2, attr))) {
+			return;
+		}
+		if (value.IsStringValue(str)) {
+			if (op == classad::Operation::EQUAL_OP) {
+				lower_case(str);
+				key = "s" + str;
+			} else {
+				key = "S" + str;
+			}
+		} else if (value.IsBooleanValue(bval)) {
+			key = bval ? "b1" : "b0";
+		} else {
+			return;
+		}
+	} else if (IsJobAttrRef(conjunct, attr)) {
+		key = "b1";
+	} else {
+		return;
+	}
+
+	IndexedAttr & ia = GetIndexedAttr(attr);
+	ia.buckets[key].push_back(route_ix);
+	if (ia.constrained.empty() || ia.constrained.back().first != route_ix) {
+		ia.constrained.emplace_back(route_ix, 0);
+	}
+	ia.constrained.back().second++;
+	m_needed[route_ix]++;
+}
+
+void
+RouteMatchIndex::Clear()
+{
+	m_routes.clear();
+	m_route_ix.clear();
+	m_cacheable.clear();
+	m_needed.clear();
+	m_attrs.clear();
+	m_references.clear();
+	m_decisions.clear();
+	m_job = nullptr;
+	m_job_decisions = nullptr;
+}
+
+void
+RouteMatchIndex::Build(const std::vector<JobRoute *> & routes)
+{
+	Clear();
+	for (JobRoute * route : routes) {
+		size_t ix = m_routes.size();
+		m_routes.push_back(route);
+		m_route_ix[route] = ix;
+		m_needed.push_back(0);
+
+		classad::ExprTree * requirements = route->RouteRequirementExpr();
+		m_cacheable.push_back(CollectRouteReferences(requirements, m_references));
+		IndexConjunct(ix, requirements);
+	}
+	for (const auto & ia : m_attrs) {
+		m_references.insert(ia.name);
+	}
+
+	int indexed = 0;
+	for (int needed : m_needed) { if (needed) ++indexed; }
+	dprintf(D_FULLDEBUG, "JobRouter: indexed %d of %d routes on %d attributes, routes refer to %d job attributes\n",
+		indexed, (int)m_routes.size(), (int)m_attrs.size(), (int)m_references.size());
+}
+
+void
+RouteMatchIndex::ApplyIndex(std::vector<signed char> & decisions)
+{
+	if (m_attrs.empty()) return;
+
+	std::vector<int> hits(m_routes.size(), 0);
+	std::vector<std::string> keys;
+	for (const auto & ia : m_attrs) {
+		classad::Value val;
+		if ( ! m_job->EvaluateAttr(ia.name, val)) {
+			val.SetUndefinedValue();
+		}
+		if ( ! JobValueKeys(val, keys)) {
+			for (const auto & rc : ia.constrained) { hits[rc.first] += rc.second; }
+			continue;
+		}
+		for (const auto & key : keys) {
+			auto found = ia.buckets.find(key);
+			if (found == ia.buckets.end()) continue;
+			for (size_t ix : found->second) { hits[ix]++; }
+		}
+	}
+
+	for (size_t ix = 0; ix < m_routes.size(); ++ix) {
+		if (hits[ix] < m_needed[ix]) {
+			decisions[ix] = NO_MATCH;
+			m_stats.routes_skipped++;
+		}
+	}
+}
+
+void
+RouteMatchIndex::SetJob(classad::ClassAd * job_ad)
+{
+	m_job = job_ad;
+	m_stats.jobs++;
+
+	// the job's values for the attributes the routes refer to
+	std::string signature;
+	classad::ClassAdUnParser unparser;
+	for (const auto & attr : m_references) {
+		classad::Value val;
+		if ( ! job_ad->EvaluateAttr(attr, val)) {
+			val.SetUndefinedValue();
+		}
+		unparser.Unparse(signature, val);
+		signature += '\n';
+	}
+
+	auto found = m_decisions.find(signature);
+	if (found != m_decisions.end()) {
+		m_job_decisions = &found->second;
+		m_stats.cache_hits++;
+		return;
+	}
+
+	if (m_decisions.size() >= MAX_CACHED_DECISIONS) {
+		dprintf(D_FULLDEBUG, "JobRouter: forgetting route decisions for %d kinds of jobs\n", (int)m_decisions.size());
+		m_decisions.clear();
+	}
+	m_job_decisions = &m_decisions[signature];
+	m_job_decisions->assign(m_routes.size(), UNKNOWN);
+	ApplyIndex(*m_job_decisions);
+}
+
+bool
+RouteMatchIndex::Matches(JobRoute * route)
+{
+	ASSERT(m_job && m_job_decisions);
+
+	auto found = m_route_ix.find(route);
+	if (found == m_route_ix.end()) {
+		m_stats.routes_evaluated++;
+		return route->Matches(m_job);
+	}
+
+	size_t ix = found->second;
+	signed char & decision = (*m_job_decisions)[ix];
+	if (decision != UNKNOWN) {
+		return decision == MATCH;
+	}
+
+	m_stats.routes_evaluated++;
+	bool matches = route->Matches(m_job);
+	if (m_cacheable[ix]) {
+		decision = matches ? MATCH : NO_MATCH;
+	}
+	return matches;
+}
@@ -0,0 +1,102 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _ROUTE_MATCH_INDEX_H
+#define _ROUTE_MATCH_INDEX_H
+
+#include "classad/classad_distribution.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class JobRoute;
+
+/*
+ Speeds up testing jobs against the Requirements of every route.
+
+ Conjuncts of a route's Requirements of the form Attr == "literal",
+ Attr =?= "literal", Attr == true or just Attr, where Attr may also be
+ written MY.Attr or TARGET.Attr, are indexed by attribute and value, so a job whose Owner, AcctGroup, WantJobRouter and so on rule
+ a route out never has that route's Requirements evaluated.
+
+ Jobs that have the same values for every attribute the routes refer to
+ (an autocluster, as far as the routes are concerned) match the same
+ routes, so the decision for each route is remembered under those values
+ and reused for the next such job.  Routes whose Requirements call time(),
+ random() and the like are evaluated for every job.
+*/
+class RouteMatchIndex
+{
+public:
+	struct Stats {
+		long jobs{0};             // jobs tested
+		long cache_hits{0};       // jobs whose route decisions were already known
+		long routes_evaluated{0}; // route Requirements evaluated
+		long routes_skipped{0};   // routes ruled out by the index
+	};
+
+		// Index the Requirements of the given routes, throwing away
+		// what we knew about the previous set.  The routes must
+		// outlive the index, or the next call to Build() or Clear().
+	void Build(const std::vector<JobRoute *> &routes);
+	void Clear();
+
+		// Start testing routes against a job.
+	void SetJob(classad::ClassAd *job_ad);
+
+		// Do the Requirements of the route match the job given to SetJob()?
+	bool Matches(JobRoute *route);
+
+	const Stats & stats() const { return m_stats; }
+	void ClearStats() { m_stats = Stats(); }
+	size_t CachedDecisions() const { return m_decisions.size(); }
+
+private:
+	struct IndexedAttr {
+		std::string name;
+			// keys (see JobValueKeys()) to the routes with a conjunct
+			// that a job having that value satisfies
+		std::unordered_map<std::string, std::vector<size_t>> buckets;
+			// routes with conjuncts on this attribute, and how many
+		std::vector<std::pair<size_t, int>> constrained;
+	};
+
+	enum Decision : signed char { UNKNOWN = -1, NO_MATCH = 0, MATCH = 1 };
+
+	void IndexConjunct(size_t route_ix, classad::ExprTree *conjunct);
+	IndexedAttr & GetIndexedAttr(const std::string &attr);
+	void ApplyIndex(std::vector<signed char> &decisions);
+
+	std::vector<JobRoute *> m_routes;
+	std::unordered_map<const JobRoute *, size_t> m_route_ix;
+	std::vector<bool> m_cacheable;      // per route
+	std::vector<int> m_needed;          // per route, indexed conjuncts
+	std::vector<IndexedAttr> m_attrs;
+	classad::References m_references;   // job attributes the routes refer to
+
+		// route decisions by the values of m_references
+	std::unordered_map<std::string, std::vector<signed char>> m_decisions;
+
+	classad::ClassAd *m_job{nullptr};
+	std::vector<signed char> *m_job_decisions{nullptr};
+
+	Stats m_stats;
+};
+
+#endif
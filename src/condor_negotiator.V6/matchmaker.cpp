@@ -67,6 +67,25 @@ char const *RESOURCES_IN_USE_BY_USERS_GROUP_FN_NAME = "ResourcesInUseByUsersGrou
 
 GCC_DIAG_OFF(float-equal)
 
+// Times a part of the negotiation cycle if we are keeping a CycleProfile.
+// Like StopwatchSentry, it leaves a watch that is already running alone.
+class CycleProfileSentry
+{
+public:
+	CycleProfileSentry(Matchmaker::CycleProfile *profile, Stopwatch Matchmaker::CycleProfile::*watch)
+		: m_watch(nullptr)
+	{
+		if (profile && !(profile->*watch).is_running()) {
+			m_watch = &(profile->*watch);
+			m_watch->start();
+		}
+	}
+	~CycleProfileSentry() { if (m_watch) { m_watch->stop(); } }
+
+private:
+	Stopwatch *m_watch;
+};
+
 class NegotiationCycleStats
 {
 public:
@@ -434,6 +453,7 @@ Matchmaker ()
 
 	want_globaljobprio = false;
 	want_matchlist_caching = false;
+	want_eval_cache = false;
 	PublishCrossSlotPrios = false;
 	ConsiderPreemption = true;
 	ConsiderEarlyPreemption = false;
@@ -499,6 +519,8 @@ Matchmaker ()
 	slotWeightStr = 0;
 	m_staticRanks = false;
 	m_dryrun = false;
+	m_ad_source = nullptr;
+	m_cycle_profile = nullptr;
 }
 
 Matchmaker::
@@ -810,6 +832,7 @@ reinitialize ()
 
 	want_globaljobprio = param_boolean("USE_GLOBAL_JOB_PRIOS",false);
 	want_matchlist_caching = param_boolean("NEGOTIATOR_MATCHLIST_CACHING",true);
+	want_eval_cache = param_boolean("NEGOTIATOR_EVAL_CACHE",true);
 	PublishCrossSlotPrios = param_boolean("NEGOTIATOR_CROSS_SLOT_PRIOS", false);
 	ConsiderPreemption = param_boolean("NEGOTIATOR_CONSIDER_PREEMPTION",true);
 	ConsiderEarlyPreemption = param_boolean("NEGOTIATOR_CONSIDER_EARLY_PREEMPTION",false);
@@ -1682,6 +1705,7 @@ Matchmaker::negotiationTime( int /* timerID */ )
 
 	dprintf( D_ALWAYS, "---------- Started Negotiation Cycle ----------\n" );
 
+	CycleProfileSentry cycle_sentry(m_cycle_profile, &CycleProfile::cycle);
 	time_t start_time = time(NULL);
 
 	GotRescheduleCmd=false;  // Reset the reschedule cmd flag
@@ -1697,8 +1721,12 @@ Matchmaker::negotiationTime( int /* timerID */ )
     time_t start_time_phase1 = time(NULL);
 	double start_usage_phase1 = get_rusage_utime();
 	dprintf( D_ALWAYS, "Phase 1:  Obtaining ads from collector ...\n" );
-	if( !obtainAdsFromCollector( allAds, startdAds, submitterAds, accountingNames,
-		claimIds ) )
+	bool got_ads;
+	{
+		CycleProfileSentry sentry(m_cycle_profile, &CycleProfile::fetch);
+		got_ads = obtainAdsFromCollector(allAds, startdAds, submitterAds, accountingNames, claimIds);
+	}
+	if( !got_ads )
 	{
 		dprintf( D_ALWAYS, "Aborting negotiation cycle\n" );
 		// should send email here
@@ -1741,8 +1769,11 @@ Matchmaker::negotiationTime( int /* timerID */ )
 	job_attr_references = compute_significant_attrs(startdAds);
 
 	// ----- Recalculate priorities for schedds
-	accountant.UpdatePriorities();
-	accountant.CheckMatches( startdAds );
+	{
+		CycleProfileSentry sentry(m_cycle_profile, &CycleProfile::accounting);
+		accountant.UpdatePriorities();
+		accountant.CheckMatches( startdAds );
+	}
 
 	if ( !groupQuotasHash ) {
 		groupQuotasHash = new groupQuotasHashType(hashFunction);
@@ -1777,6 +1808,7 @@ Matchmaker::negotiationTime( int /* timerID */ )
 	trimStartdAds(startdAds);
 
 	if (m_staticRanks) {
+		CycleProfileSentry sentry(m_cycle_profile, &CycleProfile::sort);
 		dprintf(D_FULLDEBUG, "About to sort machine ads by rank\n");
 		startdAds.Sort(rankSorter, this);
 		dprintf(D_FULLDEBUG, "Done sorting machine ads by rank\n");
@@ -1799,6 +1831,13 @@ Matchmaker::negotiationTime( int /* timerID */ )
 
 	SetupMatchSecurity(submitterAds);
 
+		// Expressions that only look at the ad they live in, such as a
+		// START that only refers to MY attributes, give the same value
+		// against every job, so remember them for the rest of the cycle.
+	if (want_eval_cache) {
+		setTheMatchAdEvalCache(&m_evalCache);
+	}
+
     if (hgq_groups.size() <= 1) {
         // If there is only one group (the root group) we are in traditional non-HGQ mode.
         // It seems cleanest to take the traditional case separately for maximum backward-compatible behavior.
@@ -1872,6 +1911,15 @@ Matchmaker::negotiationTime( int /* timerID */ )
 
     }
 
+	if (want_eval_cache) {
+		const classad::EvalCache::Stats &stats = m_evalCache.stats();
+		dprintf(D_FULLDEBUG, "Expression value cache: %ld hits, %ld misses, %ld uncacheable, %zu entries\n",
+				stats.hits, stats.misses, stats.uncacheable, m_evalCache.size());
+		setTheMatchAdEvalCache(NULL);
+		m_evalCache.Clear();
+		m_evalCache.ClearStats();
+	}
+
     // Leave this in as an easter egg for dev/testing purposes.
     // Like NEG_SLEEP, but this one is not dependent on getting into the
     // negotiation loops to take effect.
@@ -2295,6 +2343,7 @@ negotiateWithGroup ( bool isFloorRound,
 			// if want_globaljobprio is true.
             time_t start_time_phase3 = time(NULL);
 			double start_usage_phase3 = get_rusage_utime();
+			CycleProfileSentry sentry(m_cycle_profile, &CycleProfile::sort);
             dprintf(D_ALWAYS, "Phase 3:  Sorting submitter ads by priority ...\n");
 
 			std::sort(submitterAds.begin(), submitterAds.end(), submitterLessThan(this));
@@ -2989,22 +3038,30 @@ obtainAdsFromCollector (
 	}
 #endif
 
-	dprintf(D_ALWAYS,"  Getting startd private ads ...\n");
 	ClassAdList startdPvtAdList;
-	result = collects->query (privateQuery, startdPvtAdList);
-	if( result!=Q_OK ) {
-		dprintf(D_ALWAYS, "Couldn't fetch ads: %s\n", getStrQueryResult(result));
-		return false;
-	}
+	if (m_ad_source) {
+		dprintf(D_ALWAYS, "  Getting Submitter, Machine and startd private ads from the replay snapshot ...\n");
+		if ( ! m_ad_source->fetchAds(allAds, startdPvtAdList)) {
+			dprintf(D_ALWAYS, "Couldn't fetch ads from the replay snapshot\n");
+			return false;
+		}
+	} else {
+		dprintf(D_ALWAYS,"  Getting startd private ads ...\n");
+		result = collects->query (privateQuery, startdPvtAdList);
+		if( result!=Q_OK ) {
+			dprintf(D_ALWAYS, "Couldn't fetch ads: %s\n", getStrQueryResult(result));
+			return false;
+		}
 
-    CondorError errstack;
-	dprintf(D_ALWAYS, "  Getting Scheduler, Submitter and Machine ads ...\n");
-	result = collects->query (publicQuery, allAds, &errstack);
-	if( result!=Q_OK ) {
-		dprintf(D_ALWAYS, "Couldn't fetch ads: %s\n",
-           errstack.code() ? errstack.getFullText(false).c_str() : getStrQueryResult(result)
-           );
-		return false;
+	    CondorError errstack;
+		dprintf(D_ALWAYS, "  Getting Scheduler, Submitter and Machine ads ...\n");
+		result = collects->query (publicQuery, allAds, &errstack);
+		if( result!=Q_OK ) {
+			dprintf(D_ALWAYS, "Couldn't fetch ads: %s\n",
+	           errstack.code() ? errstack.getFullText(false).c_str() : getStrQueryResult(result)
+	           );
+			return false;
+		}
 	}
 
 	dprintf(D_ALWAYS, "  Sorting %d ads ...\n",allAds.MyLength());
@@ -3521,6 +3578,9 @@ Matchmaker::prefetchResourceRequestLists(std::vector<ClassAd *> &submitterAds)
 	
 	CurrentWorkMap currentWork;
 	ScheddWork negotiations;
+		// when each schedd we are waiting on must next be heard from; this
+		// is pushed back every time the schedd sends us more of its list.
+	std::map<std::string, double> sessionDeadlines;
 	typedef std::map<int, std::pair<ClassAd*, RRLPtr> > FDToRRLMap;
 	FDToRRLMap fdToRRL;
 	unsigned attemptedPrefetches = 0, successfulPrefetches = 0;
@@ -3566,6 +3626,7 @@ Matchmaker::prefetchResourceRequestLists(std::vector<ClassAd *> &submitterAds)
 				case ResourceRequestList::RRL_CONTINUE:
 					dprintf(D_FULLDEBUG, "Prefetch negotiation would block.\n");
 					currentWork[scheddAddr] = std::make_pair(*it, rrl);
+					sessionDeadlines[scheddAddr] = _condor_debug_get_time_double() + prefetchTimeout;
 					success = true;
 					break;
 				}
@@ -3587,10 +3648,13 @@ Matchmaker::prefetchResourceRequestLists(std::vector<ClassAd *> &submitterAds)
 
 		// Non-blocking reads of RRLs
 		selector.reset();
-		selector.set_timeout(prefetchTimeout);
 
-			// Put together the selector.
+			// Put together the selector.  Each session may be idle for at
+			// most prefetchTimeout seconds, so we only wait until the first
+			// of them is due.
 		unsigned workCount = 0;
+		double now = _condor_debug_get_time_double();
+		double firstDue = now + prefetchTimeout;
 		fdToRRL.clear();
 		for (CurrentWorkMap::const_iterator it=currentWork.begin(); it!=currentWork.end(); it++)
 		{
@@ -3600,15 +3664,27 @@ Matchmaker::prefetchResourceRequestLists(std::vector<ClassAd *> &submitterAds)
 			selector.add_fd(fd, Selector::IO_READ);
 			fdToRRL[fd] = it->second;
 			workCount++;
+			auto due = sessionDeadlines.find(it->first);
+			if (due != sessionDeadlines.end() && due->second < firstDue) {firstDue = due->second;}
 		}
 		if (!workCount) {continue;}
+		if ((deadline >= 0) && (deadline < firstDue)) {firstDue = deadline;}
+		double wait = (firstDue > now) ? (firstDue - now) : 0;
+		selector.set_timeout((time_t)wait, (long)((wait - (time_t)wait) * 1000000));
 		dprintf(D_FULLDEBUG, "Waiting on the results of %u negotiation sessions.\n", workCount);
 		selector.execute();
 		if (selector.timed_out() || selector.failed())
 		{
+				// On a timeout, give up only on the schedds that are past due;
+				// the others keep their sessions and the rest of their work.
+			now = _condor_debug_get_time_double();
 			for (FDToRRLMap::const_iterator it = fdToRRL.begin(); it != fdToRRL.end(); it++)
 			{
 				std::string scheddAddr; getScheddAddr(*(it->second.first), scheddAddr);
+				if (selector.timed_out()) {
+					auto due = sessionDeadlines.find(scheddAddr);
+					if (due != sessionDeadlines.end() && due->second > now) {continue;}
+				}
 				scheddWorkQueues[scheddAddr]->clear();
 				ReliSock *sock = sockCache->findReliSock(scheddAddr);
 				if (!sock) {continue;}
@@ -3652,7 +3728,9 @@ Matchmaker::prefetchResourceRequestLists(std::vector<ClassAd *> &submitterAds)
 				break;
 			}
 			case ResourceRequestList::RRL_CONTINUE:
-				// Nothing to do.
+					// The schedd is still sending; it gets another full
+					// prefetchTimeout to send the next request.
+				sessionDeadlines[scheddAddr] = _condor_debug_get_time_double() + prefetchTimeout;
 				break;
 			}
 		}
@@ -3679,6 +3757,16 @@ Matchmaker::prefetchResourceRequestLists(std::vector<ClassAd *> &submitterAds)
 }
 
 
+void
+Matchmaker::addScheddConnection(const std::string &scheddAddr, ReliSock *sock)
+{
+	sockCache->invalidateSock(scheddAddr);
+	if (sockCache->isFull()) {
+		sockCache->resize(sockCache->size() + 1);
+	}
+	sockCache->addReliSock(scheddAddr, sock);
+}
+
 void
 Matchmaker::endNegotiate(const std::string &scheddAddr)
 {
@@ -4464,6 +4552,8 @@ matchmakingAlgorithm(const char *submitterName, const char *scheddAddr, const ch
 		// request attributes
 	int				requestAutoCluster = -1;
 
+	CycleProfileSentry match_sentry(m_cycle_profile, &CycleProfile::match);
+
 	dprintf(D_FULLDEBUG, "matchmakingAlgorithm: limit %f used %f pieLeft %f\n", submitterLimit, limitUsed, pieLeft);
 
 		// Check resource constraints requested by request
@@ -4827,7 +4917,10 @@ matchmakingAlgorithm(const char *submitterName, const char *scheddAddr, const ch
 			}
 		}
 
-		calculateRanks(request, candidate, candidatePreemptState, candidateRankValue, candidatePreJobRankValue, candidatePostJobRankValue, candidatePreemptRankValue);
+		{
+			CycleProfileSentry sentry(m_cycle_profile, &CycleProfile::rank);
+			calculateRanks(request, candidate, candidatePreemptState, candidateRankValue, candidatePreJobRankValue, candidatePostJobRankValue, candidatePreemptRankValue);
+		}
 
 		if ( MatchList ) {
 			MatchList->add_candidate(
@@ -4915,6 +5008,7 @@ matchmakingAlgorithm(const char *submitterName, const char *scheddAddr, const ch
 
 			// only bother sorting if there is more than one entry
 		if ( MatchList->length() > 1 ) {
+			CycleProfileSentry sentry(m_cycle_profile, &CycleProfile::rank);
 			dprintf(D_FULLDEBUG,"Start of sorting MatchList (len=%d)\n",
 				MatchList->length());
 			MatchList->sort();
@@ -5253,7 +5347,13 @@ matchmakingProtocol (ClassAd &request, ClassAd *offer,
 
     // 4. notifiy the accountant
 	dprintf(D_FULLDEBUG,"      Notifying the accountant\n");
-	accountant.AddMatch(submitterName, offer);
+	{
+		CycleProfileSentry sentry(m_cycle_profile, &CycleProfile::accounting);
+		accountant.AddMatch(submitterName, offer);
+	}
+	if (m_cycle_profile) {
+		m_cycle_profile->matches++;
+	}
 
 	// done
 	dprintf (D_ALWAYS, "      Successfully matched with %s%s\n",
@@ -29,6 +29,7 @@
 #include "condor_ver_info.h"
 #include "matchmaker_negotiate.h"
 #include "GroupEntry.h"
+#include "stopwatch.h"
 
 #include <vector>
 #include <string>
@@ -99,6 +100,38 @@ class Matchmaker : public Service
 		void setDryRun(bool d) {m_dryrun = d;}
 		bool getDryRun() const {return m_dryrun;}
 
+			// Where a negotiation cycle gets its ads when not from the
+			// collector, e.g. a snapshot being replayed offline.
+		class AdSource {
+		public:
+			virtual ~AdSource() {}
+				// Fill in the submitter and slot ads, and the private slot
+				// ads, just as the two collector queries would have.
+			virtual bool fetchAds(ClassAdList &publicAds, ClassAdList &startdPvtAds) = 0;
+		};
+		void setAdSource(AdSource *source) { m_ad_source = source; }
+
+			// Negotiate with the schedd at scheddAddr (its ScheddIpAddr)
+			// over sock, as if it were a connection left from an earlier
+			// cycle.  We own sock from here on.
+		void addScheddConnection(const std::string &scheddAddr, ReliSock *sock);
+		void clearScheddConnections() { sockCache->clearCache(); }
+
+			// Wall clock time spent in each part of the negotiation
+			// cycle, accumulated over cycles.  Only kept when asked for,
+			// since the match and rank timers run once per candidate slot.
+			// match includes rank, the rest don't overlap.
+		struct CycleProfile {
+			Stopwatch cycle;      // all of negotiationTime()
+			Stopwatch fetch;      // getting ads (phase 1)
+			Stopwatch accounting; // updating priorities and usage, and recording matches
+			Stopwatch sort;       // sorting slots by rank and submitters by priority (phase 3)
+			Stopwatch match;      // matchmakingAlgorithm(), looking for the best slot for a request
+			Stopwatch rank;       // evaluating and sorting candidate ranks
+			long matches{0};      // matches sent to schedds
+		};
+		void setCycleProfile(CycleProfile *profile) { m_cycle_profile = profile; }
+
     protected:
 		char * NegotiatorName;
 		bool NegotiatorNameInConfig;
@@ -332,6 +365,8 @@ class Matchmaker : public Service
 		ExprTree *NegotiatorPostJobRank; // rank applied after job rank
 		bool want_globaljobprio;	// cached value of config knob USE_GLOBAL_JOB_PRIOS
 		bool want_matchlist_caching;	// should we cache matches per autocluster?
+		bool want_eval_cache;	// reuse one-sided expression values within a cycle?
+		classad::EvalCache m_evalCache;
 		bool PublishCrossSlotPrios; // value of knob NEGOTIATOR_CROSS_SLOT_PRIOS, default of false
 		bool ConsiderPreemption; // if false, negotiation is faster (default=true)
 		bool ConsiderEarlyPreemption; // if false, do not preempt slots that still have retirement time
@@ -396,6 +431,8 @@ class Matchmaker : public Service
 	std::set<std::string> rejectedConcurrencyLimits;
 	std::string lastRejectedConcurrencyString;
 		bool m_dryrun;
+		AdSource *m_ad_source;
+		CycleProfile *m_cycle_profile;
 
 
 		// Class used to store each individual entry in the
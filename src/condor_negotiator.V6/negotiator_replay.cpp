@@ -0,0 +1,573 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+/*
+  condor_negotiator_replay: run negotiation cycles against a snapshot of a
+  pool, without the pool, and report where the time went.
+
+  Usage: condor_negotiator_replay [-t] <snapshot-dir> [<cycles>]
+
+  The snapshot directory (give a full path, daemons run in the LOG
+  directory) holds ad files in any format condor_status -l, -json or -xml
+  writes:
+
+	startd.ads          condor_status -l
+	startd_private.ads  the private slot ads (optional; fake claim ids are
+	                    made up for every slot if there isn't one)
+	submitter.ads       condor_status -submitters -l
+	accounting.ads      condor_status -accounting -l (optional)
+	jobs.ads            condor_q -global -l, or resource request ads
+
+  Each cycle gets fresh copies of the ads, and each schedd named by a
+  submitter ad is played by a child process that hands out the idle jobs
+  in jobs.ads.  Jobs are matched to a schedd by the schedd name in their
+  GlobalJobId, and to a submitter by AccountingGroup (or User); the jobs
+  of an autocluster are sent as one request, the way the schedd does.
+  The accountant starts each run from accounting.ads and carries usage
+  over from cycle to cycle as the negotiator would.
+
+  Ads are used as they are, so NEGOTIATOR_SLOT_CONSTRAINT and friends
+  should be applied when the snapshot is taken.  Matches are never sent
+  to the startds.
+*/
+
+#include "condor_common.h"
+#include "condor_config.h"
+#include "condor_debug.h"
+#include "condor_attributes.h"
+#include "condor_commands.h"
+#include "condor_daemon_core.h"
+#include "subsystem_info.h"
+#include "directory_util.h"
+#include "classad_oldnew.h"
+#include "reli_sock.h"
+#include "matchmaker.h"
+
+#include <algorithm>
+#include <tuple>
+
+struct ReplayRequest {
+	ClassAd ad;
+	int cluster{-1};
+	int proc{-1};
+	int count{0}; // resources still wanted
+};
+
+// a schedd in the snapshot, and the requests of each of its submitters
+struct ReplaySchedd {
+	std::string addr; // its ScheddIpAddr, what the negotiator knows it by
+	std::map<std::string, std::vector<ReplayRequest>> requests;
+};
+
+class NegotiatorSnapshot : public Matchmaker::AdSource
+{
+public:
+	bool load(const std::string &dir);
+	bool fetchAds(ClassAdList &publicAds, ClassAdList &startdPvtAds) override;
+	void primeAccountant(Accountant &accountant) const;
+
+	std::vector<ReplaySchedd> schedds;
+
+private:
+	std::vector<ClassAd> m_slots;
+	std::vector<ClassAd> m_pvt_slots;
+	std::vector<ClassAd> m_submitters;
+	std::vector<ClassAd> m_accounting;
+};
+
+static bool
+readAdFile(const std::string &dir, const char *name, bool required, std::vector<ClassAd> &ads)
+{
+	std::string path;
+	dircat(dir.c_str(), name, path);
+	FILE *fp = safe_fopen_wrapper_follow(path.c_str(), "r");
+	if ( ! fp) {
+		if (required) {
+			fprintf(stderr, "Can't open %s: %s\n", path.c_str(), strerror(errno));
+		}
+		return ! required;
+	}
+
+	CondorClassAdFileIterator iter;
+	if ( ! iter.begin(fp, true, CondorClassAdFileParseHelper::Parse_auto)) {
+		fprintf(stderr, "Can't read ads from %s\n", path.c_str());
+		return false;
+	}
+	ClassAd *ad;
+	while ((ad = iter.next(nullptr))) {
+		ads.emplace_back(*ad);
+		delete ad;
+	}
+	printf("Read %zu ads from %s\n", ads.size(), path.c_str());
+	return true;
+}
+
+// The submitter name the schedd would negotiate the job under.
+static bool
+jobSubmitterName(const ClassAd &job, std::string &submitter)
+{
+	std::string user;
+	if ( ! job.LookupString(ATTR_USER, user)) {
+		return false;
+	}
+	std::string group;
+	size_t at = user.find('@');
+	if (job.LookupString(ATTR_ACCOUNTING_GROUP, group) && ! group.empty() && at != std::string::npos) {
+		submitter = group + user.substr(at);
+	} else {
+		submitter = user;
+	}
+	return true;
+}
+
+bool
+NegotiatorSnapshot::load(const std::string &dir)
+{
+	std::vector<ClassAd> jobs;
+	if ( ! readAdFile(dir, "startd.ads", true, m_slots) ||
+		 ! readAdFile(dir, "startd_private.ads", false, m_pvt_slots) ||
+		 ! readAdFile(dir, "submitter.ads", true, m_submitters) ||
+		 ! readAdFile(dir, "accounting.ads", false, m_accounting) ||
+		 ! readAdFile(dir, "jobs.ads", true, jobs))
+	{
+		return false;
+	}
+
+	if (m_pvt_slots.empty()) {
+		int n = 0;
+		for (const auto &slot : m_slots) {
+			std::string name, addr;
+			if ( ! slot.LookupString(ATTR_NAME, name) || ! slot.LookupString(ATTR_STARTD_IP_ADDR, addr)) {
+				continue;
+			}
+			ClassAd pvt;
+			SetMyTypeName(pvt, STARTD_PVT_ADTYPE);
+			pvt.Assign(ATTR_NAME, name);
+			pvt.Assign(ATTR_MY_ADDRESS, addr);
+			std::string claim_id;
+			formatstr(claim_id, "%s#0#%d#...", addr.c_str(), ++n);
+			pvt.Assign(ATTR_CLAIM_ID, claim_id);
+			m_pvt_slots.push_back(pvt);
+		}
+	}
+
+	std::map<std::string, size_t> schedd_by_name;
+	for (const auto &submitter : m_submitters) {
+		std::string name, addr;
+		if ( ! submitter.LookupString(ATTR_SCHEDD_NAME, name) || ! submitter.LookupString(ATTR_SCHEDD_IP_ADDR, addr)) {
+			continue;
+		}
+		if (schedd_by_name.count(name)) {
+			continue;
+		}
+		schedd_by_name[name] = schedds.size();
+		schedds.emplace_back();
+		schedds.back().addr = addr;
+	}
+
+	// schedd, submitter and autocluster -> index of its request
+	std::map<std::tuple<size_t, std::string, int>, size_t> autoclusters;
+	size_t num_requests = 0;
+	for (auto &job : jobs) {
+		int status = IDLE;
+		if (job.LookupInteger(ATTR_JOB_STATUS, status) && status != IDLE) {
+			continue;
+		}
+		std::string global_id, submitter;
+		if ( ! job.LookupString(ATTR_GLOBAL_JOB_ID, global_id) || ! jobSubmitterName(job, submitter)) {
+			continue;
+		}
+		auto schedd = schedd_by_name.find(global_id.substr(0, global_id.find('#')));
+		if (schedd == schedd_by_name.end()) {
+			continue;
+		}
+		std::vector<ReplayRequest> &requests = schedds[schedd->second].requests[submitter];
+
+		int count = 1;
+		job.LookupInteger(ATTR_RESOURCE_REQUEST_COUNT, count);
+		int autocluster = -1;
+		if (job.LookupInteger(ATTR_AUTO_CLUSTER_ID, autocluster) && autocluster >= 0) {
+			auto key = std::make_tuple(schedd->second, submitter, autocluster);
+			auto found = autoclusters.find(key);
+			if (found != autoclusters.end()) {
+				requests[found->second].count += count;
+				continue;
+			}
+			autoclusters[key] = requests.size();
+		}
+
+		ReplayRequest request;
+		request.ad = job;
+		request.ad.LookupInteger(ATTR_CLUSTER_ID, request.cluster);
+		request.ad.LookupInteger(ATTR_PROC_ID, request.proc);
+		request.ad.Assign(ATTR_WANT_PSLOT_PREEMPTION, true);
+		request.ad.Assign(ATTR_WANT_MATCH_DIAGNOSTICS, 2);
+		request.count = count;
+		requests.push_back(std::move(request));
+		num_requests++;
+	}
+
+	printf("Replaying %zu slots, %zu submitters, %zu schedds and %zu resource requests\n",
+	       m_slots.size(), m_submitters.size(), schedds.size(), num_requests);
+	return true;
+}
+
+bool
+NegotiatorSnapshot::fetchAds(ClassAdList &publicAds, ClassAdList &startdPvtAds)
+{
+	for (const auto &ad : m_submitters) { publicAds.Insert(new ClassAd(ad)); }
+	for (const auto &ad : m_slots) { publicAds.Insert(new ClassAd(ad)); }
+	for (const auto &ad : m_pvt_slots) { startdPvtAds.Insert(new ClassAd(ad)); }
+	return true;
+}
+
+void
+NegotiatorSnapshot::primeAccountant(Accountant &accountant) const
+{
+	for (const auto &ad : m_accounting) {
+		std::string name;
+		if ( ! ad.LookupString(ATTR_NAME, name)) {
+			continue;
+		}
+		double factor = 0, prio = 0, usage = 0;
+		int t = 0;
+		if (ad.LookupFloat("PriorityFactor", factor) && factor > 0) {
+			accountant.SetPriorityFactor(name, factor);
+				// the published priority is the effective one
+			if (ad.LookupFloat("Priority", prio)) {
+				accountant.SetPriority(name, prio / factor);
+			}
+		}
+		if (ad.LookupFloat("WeightedAccumulatedUsage", usage)) { accountant.SetAccumUsage(name, usage); }
+		if (ad.LookupInteger("BeginUsageTime", t)) { accountant.SetBeginTime(name, t); }
+		if (ad.LookupInteger("LastUsageTime", t)) { accountant.SetLastTime(name, t); }
+		if (ad.LookupInteger("Ceiling", t)) { accountant.SetCeiling(name, t); }
+		if (ad.LookupInteger("Floor", t)) { accountant.SetFloor(name, t); }
+	}
+}
+
+//
+// The stub schedd, run in a child process for each schedd in each cycle.
+// It answers the negotiator the way ScheddNegotiate does, until the
+// negotiator hangs up at the end of the cycle.
+//
+
+struct StubScheddArgs {
+	const ReplaySchedd *schedd;
+	std::vector<int> close_fds; // the negotiator's end of every schedd connection
+};
+
+static bool
+sendRequests(ReliSock *sock, std::vector<ReplayRequest> *requests, size_t &next, int num)
+{
+	for (int sent = 0; sent < num; ++sent) {
+		while (requests && next < requests->size() && (*requests)[next].count <= 0) {
+			next++;
+		}
+		sock->encode();
+		if ( ! requests || next >= requests->size()) {
+			return sock->snd_int(NO_MORE_JOBS, TRUE);
+		}
+		ReplayRequest &request = (*requests)[next++];
+		request.ad.Assign(ATTR_RESOURCE_REQUEST_COUNT, request.count);
+		if ( ! sock->put(JOB_INFO) || ! putClassAd(sock, request.ad) || ! sock->end_of_message()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int
+stubScheddMain(void *arg, Stream *stream)
+{
+	StubScheddArgs *args = (StubScheddArgs *)arg;
+	ReliSock *sock = (ReliSock *)stream;
+	for (int fd : args->close_fds) {
+		close(fd);
+	}
+
+	auto requests = args->schedd->requests;
+	std::map<std::pair<int, int>, ReplayRequest *> by_job;
+	for (auto &[submitter, list] : requests) {
+		for (auto &request : list) {
+			by_job[std::make_pair(request.cluster, request.proc)] = &request;
+		}
+	}
+
+	std::vector<ReplayRequest> *current = nullptr;
+	size_t next = 0;
+	sock->timeout(0);
+	for (;;) {
+		int op = 0;
+		sock->decode();
+		if ( ! sock->get(op)) {
+			return 0; // the cycle is over
+		}
+		switch (op) {
+		case NEGOTIATE: {
+			ClassAd negotiate_ad;
+			std::string owner;
+			if ( ! getClassAd(sock, negotiate_ad) || ! sock->end_of_message()) {
+				return 1;
+			}
+			negotiate_ad.LookupString(ATTR_OWNER, owner);
+			auto found = requests.find(owner);
+			current = (found == requests.end()) ? nullptr : &found->second;
+			next = 0;
+			break;
+		}
+		case SEND_JOB_INFO:
+			if ( ! sock->end_of_message() || ! sendRequests(sock, current, next, 1)) {
+				return 1;
+			}
+			break;
+		case SEND_RESOURCE_REQUEST_LIST: {
+			int num = 0;
+			if ( ! sock->get(num) || ! sock->end_of_message() || ! sendRequests(sock, current, next, num)) {
+				return 1;
+			}
+			break;
+		}
+		case PERMISSION_AND_AD: {
+			char *claim_ids = nullptr;
+			ClassAd match_ad;
+			if ( ! sock->get_secret(claim_ids) || ! getClassAd(sock, match_ad) || ! sock->end_of_message()) {
+				free(claim_ids);
+				return 1;
+			}
+			free(claim_ids);
+			int cluster = -1, proc = -1;
+			match_ad.LookupInteger(ATTR_RESOURCE_REQUEST_CLUSTER, cluster);
+			match_ad.LookupInteger(ATTR_RESOURCE_REQUEST_PROC, proc);
+			auto found = by_job.find(std::make_pair(cluster, proc));
+			if (found != by_job.end()) {
+				found->second->count--;
+			}
+			break;
+		}
+		case REJECTED_WITH_REASON: {
+			std::string reason;
+			if ( ! sock->get(reason) || ! sock->end_of_message()) {
+				return 1;
+			}
+			break;
+		}
+		case REJECTED:
+		case END_NEGOTIATE:
+			if ( ! sock->end_of_message()) {
+				return 1;
+			}
+			break;
+		default:
+			dprintf(D_ALWAYS, "Stub schedd %s got unexpected request %d\n", args->schedd->addr.c_str(), op);
+			return 1;
+		}
+	}
+}
+
+//
+// The benchmark itself.
+//
+
+static Matchmaker matchMaker;
+static NegotiatorSnapshot snapshot;
+static Matchmaker::CycleProfile profile;
+static int cycles_wanted = 5;
+
+struct CycleTimes {
+	double cycle, fetch, accounting, sort, match, rank;
+	long matches;
+};
+static std::vector<CycleTimes> cycle_times;
+
+static CycleTimes
+profileNow()
+{
+	return CycleTimes{ profile.cycle.get_ms(), profile.fetch.get_ms(), profile.accounting.get_ms(),
+	                   profile.sort.get_ms(), profile.match.get_ms(), profile.rank.get_ms(), profile.matches };
+}
+
+static int
+reapStubSchedd(int pid, int exit_status)
+{
+	if (exit_status != 0) {
+		dprintf(D_ALWAYS, "Stub schedd (pid %d) failed with status %d\n", pid, exit_status);
+	}
+	return TRUE;
+}
+
+static void
+printReport()
+{
+	const char *names[] = { "cycle", "fetch", "accounting", "sort", "match", "rank", "schedd+other" };
+	const int num_phases = sizeof(names) / sizeof(names[0]);
+	std::vector<std::vector<double>> phases(num_phases);
+	for (const auto &t : cycle_times) {
+		double values[] = { t.cycle, t.fetch, t.accounting, t.sort, t.match - t.rank, t.rank,
+		                    t.cycle - t.fetch - t.accounting - t.sort - t.match };
+		for (int i = 0; i < num_phases; ++i) {
+			phases[i].push_back(values[i]);
+		}
+	}
+
+	printf("\n%-14s %10s %10s %10s %10s\n", "phase (ms)", "min", "median", "mean", "max");
+	for (int i = 0; i < num_phases; ++i) {
+		std::vector<double> &v = phases[i];
+		std::sort(v.begin(), v.end());
+		double sum = 0;
+		for (double d : v) { sum += d; }
+		printf("%-14s %10.1f %10.1f %10.1f %10.1f\n", names[i],
+		       v.front(), v[v.size() / 2], sum / v.size(), v.back());
+	}
+}
+
+static void
+runCycle(int /* timerID */)
+{
+		// Hang up on the stub schedds of the last cycle, and start new ones.
+		// Every connection is made before any stub is forked, so that each
+		// stub can close the negotiator's end of all of them; otherwise the
+		// stubs would never see the negotiator hang up.
+	matchMaker.clearScheddConnections();
+	static int reaper_id = daemonCore->Register_Reaper("stub schedd", reapStubSchedd, "reapStubSchedd");
+
+	std::vector<ReliSock *> negotiator_socks;
+	std::vector<ReliSock *> stub_socks;
+	StubScheddArgs args;
+	for (size_t i = 0; i < snapshot.schedds.size(); ++i) {
+		ReliSock *ours = new ReliSock;
+		ReliSock *theirs = new ReliSock;
+		if ( ! ours->connect_socketpair(*theirs)) {
+			EXCEPT("Failed to connect to a stub schedd");
+		}
+		args.close_fds.push_back(ours->get_file_desc());
+		negotiator_socks.push_back(ours);
+		stub_socks.push_back(theirs);
+	}
+	for (size_t i = 0; i < snapshot.schedds.size(); ++i) {
+		args.schedd = &snapshot.schedds[i];
+		if ( ! daemonCore->Create_Thread(stubScheddMain, &args, stub_socks[i], reaper_id)) {
+			EXCEPT("Failed to start a stub schedd");
+		}
+		delete stub_socks[i];
+		matchMaker.addScheddConnection(snapshot.schedds[i].addr, negotiator_socks[i]);
+	}
+
+	CycleTimes before = profileNow();
+	matchMaker.negotiationTime();
+	CycleTimes after = profileNow();
+
+	CycleTimes t{ after.cycle - before.cycle, after.fetch - before.fetch, after.accounting - before.accounting,
+	              after.sort - before.sort, after.match - before.match, after.rank - before.rank,
+	              after.matches - before.matches };
+	cycle_times.push_back(t);
+	printf("cycle %zu: %.1f ms (fetch %.1f, accounting %.1f, sort %.1f, match %.1f, rank %.1f), %ld matches\n",
+	       cycle_times.size(), t.cycle, t.fetch, t.accounting, t.sort, t.match - t.rank, t.rank, t.matches);
+	fflush(stdout);
+
+	if ((int)cycle_times.size() < cycles_wanted) {
+		daemonCore->Register_Timer(0, runCycle, "runCycle");
+		return;
+	}
+	matchMaker.clearScheddConnections();
+	printReport();
+	DC_Exit(0);
+}
+
+static void
+usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t] <snapshot-dir> [<cycles>]\n", name);
+	DC_Exit(1);
+}
+
+void
+main_init(int argc, char *argv[])
+{
+	if (argc < 2 || argc > 3 || argv[1][0] == '-') {
+		usage(argv[0]);
+	}
+	if (argc == 3) {
+		cycles_wanted = atoi(argv[2]);
+		if (cycles_wanted < 1) {
+			usage(argv[0]);
+		}
+	}
+	if (daemonCore->DoFakeCreateThread()) {
+		fprintf(stderr, "The stub schedds need real threads (FAKE_CREATE_THREAD is set)\n");
+		DC_Exit(1);
+	}
+
+	std::string dir = argv[1];
+	if ( ! snapshot.load(dir)) {
+		DC_Exit(1);
+	}
+
+		// Cycle back to back, leave the collector and the startds alone,
+		// and keep the accountant's database out of the real negotiator's way.
+	std::string acct_log;
+	dircat(dir.c_str(), "Accountant.replay.log", acct_log);
+	unlink(acct_log.c_str());
+	config_insert("ACCOUNTANT_DATABASE_FILE", acct_log.c_str());
+	config_insert("NEGOTIATOR_CYCLE_DELAY", "0");
+	config_insert("NEGOTIATOR_MIN_INTERVAL", "0");
+	config_insert("NEGOTIATOR_READ_CONFIG_BEFORE_CYCLE", "false");
+	config_insert("NEGOTIATOR_UPDATE_AFTER_CYCLE", "false");
+	config_insert("NEGOTIATOR_ADVERTISE_ACCOUNTING", "false");
+	config_insert("NEGOTIATOR_INFORM_STARTD", "false");
+
+		// Not initialize(), we don't want its command handlers or timers.
+	matchMaker.setAdSource(&snapshot);
+	matchMaker.setCycleProfile(&profile);
+	matchMaker.reinitialize();
+	snapshot.primeAccountant(matchMaker.getAccountant());
+
+	daemonCore->Register_Timer(0, runCycle, "runCycle");
+}
+
+void
+main_config()
+{
+}
+
+void
+main_shutdown_fast()
+{
+	DC_Exit(0);
+}
+
+void
+main_shutdown_graceful()
+{
+	DC_Exit(0);
+}
+
+int
+main(int argc, char **argv)
+{
+		// Not NEGOTIATOR, so that we don't write over a real negotiator's
+		// log or address file.
+	set_mySubSystem("NEGOTIATOR_REPLAY", true, SUBSYSTEM_TYPE_NEGOTIATOR);
+
+	dc_main_init = main_init;
+	dc_main_config = main_config;
+	dc_main_shutdown_fast = main_shutdown_fast;
+	dc_main_shutdown_graceful = main_shutdown_graceful;
+	return dc_main(argc, argv);
+}
@@ -981,3 +981,51 @@ ProcFamily::dump(ProcFamilyDump& fam)
 		member = member->m_next;
 	}
 }
+
+void
+ProcFamily::get_member_pids(std::vector<pid_t>& pids)
+{
+	ProcFamilyMember* member = m_member_list;
+	while (member != NULL) {
+		pids.push_back(member->m_proc_info->pid);
+		member = member->m_next;
+	}
+}
+
+#if defined(HAVE_EXT_LIBCGROUP)
+bool
+ProcFamily::get_cgroup_pids(std::vector<pid_t>& pids)
+{
+	if (!m_cm.isMounted(CgroupManager::CPUACCT_CONTROLLER) || !m_cgroup.isValid()) {
+		return false;
+	}
+
+	char *mount_point = NULL;
+	int err = cgroup_get_subsys_mount_point(CPUACCT_CONTROLLER_STR, &mount_point);
+	if (err) {
+		dprintf(D_PROCFAMILY,
+			"Unable to find mount point for cgroup %s (ProcFamily %u): %u %s\n",
+			m_cgroup_string.c_str(), m_root_pid, err, cgroup_strerror(err));
+		return false;
+	}
+	std::string path = mount_point;
+	free(mount_point);
+	path += "/";
+	path += m_cgroup_string;
+	path += "/cgroup.procs";
+
+	FILE* fp = safe_fopen_wrapper(path.c_str(), "r");
+	if (fp == NULL) {
+		dprintf(D_PROCFAMILY,
+			"Unable to open %s (ProcFamily %u): %s (%d)\n",
+			path.c_str(), m_root_pid, strerror(errno), errno);
+		return false;
+	}
+	unsigned long pid;
+	while (fscanf(fp, "%lu", &pid) == 1) {
+		pids.push_back((pid_t)pid);
+	}
+	fclose(fp);
+	return true;
+}
+#endif
@@ -123,6 +123,18 @@ public:
 	//
 	void dump(ProcFamilyDump& fam);
 
+	// append the pids of all our members to the given list
+	//
+	void get_member_pids(std::vector<pid_t>& pids);
+
+#if defined(HAVE_EXT_LIBCGROUP)
+	// append the pids of all processes in our cgroup to the given list.
+	// returns false if we aren't tracked via a cgroup or if its
+	// cgroup.procs file could not be read
+	//
+	bool get_cgroup_pids(std::vector<pid_t>& pids);
+#endif
+
 private:
 	// we need a pointer to the monitor that's tracking us since we
 	// help maintain its hash table
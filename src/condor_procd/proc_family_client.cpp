@@ -793,3 +793,38 @@ ProcFamilyClient::dump(pid_t pid,
 	log_exit("dump", err);
 	return true;
 }
+
+bool
+ProcFamilyClient::get_snapshot_stats(ProcFamilySnapshotStats& stats, bool& response)
+{
+	assert(m_initialized);
+
+	dprintf(D_PROCFAMILY, "About to retrieve snapshot statistics from ProcD\n");
+
+	proc_family_command_t command = PROC_FAMILY_GET_SNAPSHOT_STATS;
+
+	if (!m_client->start_connection(&command, sizeof(proc_family_command_t))) {
+		dprintf(D_ALWAYS,
+		        "ProcFamilyClient: failed to start connection with ProcD\n");
+		return false;
+	}
+	proc_family_error_t err;
+	if (!m_client->read_data(&err, sizeof(proc_family_error_t))) {
+		dprintf(D_ALWAYS,
+		        "ProcFamilyClient: failed to read response from ProcD\n");
+		return false;
+	}
+	response = (err == PROC_FAMILY_ERROR_SUCCESS);
+	if (response &&
+	    !m_client->read_data(&stats, sizeof(ProcFamilySnapshotStats)))
+	{
+		dprintf(D_ALWAYS,
+		        "ProcFamilyClient: "
+		            "failed to read snapshot statistics from ProcD\n");
+		return false;
+	}
+	m_client->end_connection();
+
+	log_exit("get_snapshot_stats", err);
+	return true;
+}
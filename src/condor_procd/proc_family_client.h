@@ -114,6 +114,10 @@ public:
 	//
 	bool dump(pid_t, bool&, std::vector<ProcFamilyDump>&);
 
+	// get statistics about the snapshots the procd has taken
+	//
+	bool get_snapshot_stats(ProcFamilySnapshotStats&, bool&);
+
 private:
 
 	// common code to send a signal to a process
@@ -43,7 +43,8 @@ enum proc_family_command_t {
 	PROC_FAMILY_TAKE_SNAPSHOT,
 	PROC_FAMILY_DUMP,
 	PROC_FAMILY_QUIT,
-	PROC_FAMILY_TRACK_FAMILY_VIA_CGROUP
+	PROC_FAMILY_TRACK_FAMILY_VIA_CGROUP,
+	PROC_FAMILY_GET_SNAPSHOT_STATS
 };
 
 // return codes for ProcD operations
@@ -173,4 +174,22 @@ struct ProcFamilyDump {
 	std::vector<ProcFamilyProcessDump> procs;
 };
 
+// structure for retrieving statistics about the snapshots the ProcD
+// has taken. a full snapshot looks at every process on the system, an
+// incremental one only at the processes in the families being tracked
+//
+struct ProcFamilySnapshotStats {
+	int    full_snapshots;
+	int    incremental_snapshots;
+	double full_snapshot_time;         // total seconds spent taking full snapshots
+	double incremental_snapshot_time;  // total seconds spent taking incremental snapshots
+	double last_snapshot_time;         // seconds taken by the most recent snapshot
+	double max_snapshot_time;          // seconds taken by the slowest snapshot
+	int    last_snapshot_procs;        // processes looked at by the most recent snapshot
+	bool   last_snapshot_incremental;
+	bool   pad1;
+	bool   pad2;
+	bool   pad3;
+};
+
 #endif
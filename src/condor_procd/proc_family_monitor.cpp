@@ -33,6 +33,8 @@
 #include "cgroup_tracker.linux.h"
 #endif
 
+#include <chrono>
+
 ProcFamilyMonitor::ProcFamilyMonitor(pid_t pid,
                                      birthday_t birthday,
                                      int snapshot_interval,
@@ -47,6 +49,13 @@ ProcFamilyMonitor::ProcFamilyMonitor(pid_t pid,
 	//
 	ASSERT(snapshot_interval >= -1);
 
+	// every snapshot is a full one unless we're told otherwise
+	//
+	m_full_scan_interval = -1;
+	m_last_full_scan = 0;
+	m_full_scan_needed = false;
+	memset(&m_snapshot_stats, 0, sizeof(m_snapshot_stats));
+
 	// create our "tracker" objects that provide the various methods
 	// for tracking process families
 	//
@@ -293,6 +302,7 @@ ProcFamilyMonitor::track_family_via_environment(pid_t pid, PidEnvID* penvid)
 	// add this association to the tracker
 	//
 	m_environment_tracker->add_mapping(tree->get_data(), penvid);
+	m_full_scan_needed = true;
 	return PROC_FAMILY_ERROR_SUCCESS;
 }
 
@@ -313,6 +323,7 @@ ProcFamilyMonitor::track_family_via_login(pid_t pid, char* login)
 	// add this association to the tracker
 	//
 	m_login_tracker->add_mapping(tree->get_data(), login);
+	m_full_scan_needed = true;
 	return PROC_FAMILY_ERROR_SUCCESS;
 }
 
@@ -341,6 +352,7 @@ ProcFamilyMonitor::track_family_via_supplementary_group(pid_t pid, gid_t& gid)
 	if (!ok) {
 		return PROC_FAMILY_ERROR_NO_GROUP_ID_AVAILABLE;
 	}
+	m_full_scan_needed = true;
 
 	return PROC_FAMILY_ERROR_SUCCESS;
 }
@@ -431,9 +443,10 @@ ProcFamilyMonitor::signal_process(pid_t pid, int sig)
 proc_family_error_t
 ProcFamilyMonitor::signal_family(pid_t pid, int sig)
 {
-	// get as up to date as possible
+	// get as up to date as possible. this has to be a full snapshot,
+	// so that we don't miss any process that has left its parent's tree
 	//
-	snapshot();
+	snapshot(0, true);
 
 	// find the family
 	//
@@ -496,16 +509,47 @@ ProcFamilyMonitor::get_family_usage(pid_t pid, ProcFamilyUsage* usage)
 }
 
 void
-ProcFamilyMonitor::snapshot(pid_t BOLOpid)
+ProcFamilyMonitor::snapshot(pid_t BOLOpid, bool full)
 {
 	dprintf(D_ALWAYS, "taking a snapshot...\n");
 
-	// get a snapshot of all processes on the system
+	auto snapshot_begin = std::chrono::steady_clock::now();
+
+	// if we can, only look at the processes in our families. we always
+	// take a full snapshot for register_subfamily, since the new family's
+	// root process may not be a child of anything we're tracking, and
+	// after a family is registered for tracking by environment, login, or
+	// group ID, since only a full snapshot can find its processes that
+	// have already left their parents' tree
+	//
+	procInfo* pi_list = NULL;
+	bool incremental = false;
+#if defined(LINUX)
+	if ((m_full_scan_interval > 0) &&
+	    !full &&
+	    (BOLOpid == 0) &&
+	    !m_full_scan_needed &&
+	    (time(NULL) - m_last_full_scan < m_full_scan_interval))
+	{
+		incremental = get_tracked_proc_info_list(pi_list);
+	}
+#endif
+
+	// otherwise, get a snapshot of all processes on the system
 	// TODO: should we do something here if ProcAPI returns a NULL result?
 	// (the algorithm below will handle it just fine, but its probably an
 	// indication that something is wrong)
 	//
-	procInfo* pi_list = ProcAPI::getProcInfoList(BOLOpid);
+	if (!incremental) {
+		m_last_full_scan = time(NULL);
+		m_full_scan_needed = false;
+		pi_list = ProcAPI::getProcInfoList(BOLOpid);
+	}
+
+	int procs_examined = 0;
+	for (procInfo* pi = pi_list; pi != NULL; pi = pi->next) {
+		procs_examined++;
+	}
 
 	// print info about all procInfo allocations
 	//
@@ -574,8 +618,14 @@ ProcFamilyMonitor::snapshot(pid_t BOLOpid)
 	// that are no longer on the system (i.e. those that did not get the
 	// still_alive method of ProcFamilyMember called in the loop above)
 	//
+	// an incremental snapshot doesn't look at processes outside our
+	// families, so we can't tell which of those have exited; they are
+	// kept until the next full snapshot
+	//
 	remove_exited_processes(m_tree);
-	m_everybody_else->remove_exited_processes();
+	if (!incremental) {
+		m_everybody_else->remove_exited_processes();
+	}
 
 	// we've now handled all processes that we've seen
 	// in previous calls to snapshot(). now we have to handle the
@@ -633,8 +683,197 @@ ProcFamilyMonitor::snapshot(pid_t BOLOpid)
 	//
 	update_max_image_sizes(m_tree);
 
-	dprintf(D_ALWAYS, "...snapshot complete\n");
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - snapshot_begin;
+	if (incremental) {
+		m_snapshot_stats.incremental_snapshots++;
+		m_snapshot_stats.incremental_snapshot_time += elapsed.count();
+	}
+	else {
+		m_snapshot_stats.full_snapshots++;
+		m_snapshot_stats.full_snapshot_time += elapsed.count();
+	}
+	m_snapshot_stats.last_snapshot_time = elapsed.count();
+	m_snapshot_stats.last_snapshot_procs = procs_examined;
+	m_snapshot_stats.last_snapshot_incremental = incremental;
+	if (elapsed.count() > m_snapshot_stats.max_snapshot_time) {
+		m_snapshot_stats.max_snapshot_time = elapsed.count();
+	}
+
+	dprintf(D_ALWAYS,
+	        "...%s snapshot complete (%d processes, %.3f seconds)\n",
+	        incremental ? "incremental" : "full",
+	        procs_examined,
+	        elapsed.count());
+}
+
+void
+ProcFamilyMonitor::get_snapshot_stats(ProcFamilySnapshotStats& stats)
+{
+	stats = m_snapshot_stats;
+}
+
+#if defined(LINUX)
+void
+ProcFamilyMonitor::enable_incremental_snapshots(int full_scan_interval)
+{
+	ASSERT(full_scan_interval > 0);
+	m_full_scan_interval = full_scan_interval;
+}
+
+// append the pids of all children of the given process to the given set,
+// using the /proc/<pid>/task/<tid>/children files. returns false if these
+// files are not available (they need a kernel built with CONFIG_PROC_CHILDREN)
+//
+static bool
+get_child_pids(pid_t pid, std::set<pid_t>& pids)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%u/task", pid);
+	DIR* dir = opendir(path);
+	if (dir == NULL) {
+		// the process has exited; the snapshot will notice
+		//
+		return true;
+	}
+
+	bool ok = true;
+	struct dirent* ent;
+	while ((ent = readdir(dir)) != NULL) {
+		if (ent->d_name[0] == '.') {
+			continue;
+		}
+		snprintf(path, sizeof(path), "/proc/%u/task/%s/children", pid, ent->d_name);
+		FILE* fp = safe_fopen_wrapper(path, "r");
+		if (fp == NULL) {
+			if (errno == ENOENT) {
+				// either this thread just exited or the kernel doesn't
+				// have children files; only the latter is a problem
+				//
+				snprintf(path, sizeof(path), "/proc/%u/task/%s", pid, ent->d_name);
+				struct stat sb;
+				if (stat(path, &sb) == 0) {
+					ok = false;
+					break;
+				}
+			}
+			continue;
+		}
+		unsigned long child;
+		while (fscanf(fp, "%lu", &child) == 1) {
+			pids.insert((pid_t)child);
+		}
+		fclose(fp);
+	}
+	closedir(dir);
+	return ok;
+}
+
+bool
+ProcFamilyMonitor::collect_tracked_pids(Tree<ProcFamily*>* tree, std::set<pid_t>& pids)
+{
+	ProcFamily* family = tree->get_data();
+
+	// we always look at the members we know about, so that a member is
+	// only dropped once its process is really gone. the processes in a
+	// cgroup-tracked family (including any that have escaped their
+	// parents) are all listed in its cgroup. for any other family, we
+	// look at the children the members have started since the last
+	// snapshot
+	//
+	std::vector<pid_t> family_pids;
+	family->get_member_pids(family_pids);
+	pids.insert(family_pids.begin(), family_pids.end());
+#if defined(HAVE_EXT_LIBCGROUP)
+	std::vector<pid_t> cgroup_pids;
+	if (family->get_cgroup_pids(cgroup_pids)) {
+		pids.insert(cgroup_pids.begin(), cgroup_pids.end());
+	}
+	else
+#endif
+	{
+		for (pid_t pid : family_pids) {
+			if (!get_child_pids(pid, pids)) {
+				return false;
+			}
+		}
+	}
+
+	Tree<ProcFamily*>* child = tree->get_child();
+	while (child != NULL) {
+		if (!collect_tracked_pids(child, pids)) {
+			return false;
+		}
+		child = child->get_sibling();
+	}
+	return true;
+}
+
+static void
+free_proc_info_list(procInfo*& pi_list)
+{
+	while (pi_list != NULL) {
+		procInfo* next = pi_list->next;
+		delete pi_list;
+		pi_list = next;
+	}
+}
+
+bool
+ProcFamilyMonitor::get_tracked_proc_info_list(procInfo*& pi_list)
+{
+	std::set<pid_t> pids;
+	if (!collect_tracked_pids(m_tree, pids)) {
+		dprintf(D_ALWAYS,
+		        "unable to read the children of tracked processes; "
+		            "falling back to full snapshots\n");
+		m_full_scan_interval = -1;
+		return false;
+	}
+
+	pi_list = NULL;
+	for (pid_t pid : pids) {
+		procInfo* pi = NULL;
+		int status;
+		if (ProcAPI::getProcInfo(pid, pi, status) != PROCAPI_SUCCESS) {
+			delete pi;
+			if (status == PROCAPI_NOPID) {
+				// the process has exited
+				//
+				continue;
+			}
+			// we can't tell whether it's still there, and leaving it
+			// out would have the snapshot drop it from its family
+			//
+			dprintf(D_ALWAYS,
+			        "unable to read process %u (status %d); "
+			            "taking a full snapshot\n",
+			        pid, status);
+			free_proc_info_list(pi_list);
+			return false;
+		}
+
+		// processes that we've already decided aren't in any of our
+		// families stay that way, just as they would in a full snapshot.
+		// if the pid has been reused, though, we won't know that the old
+		// process is gone until we take a full snapshot, so take one now
+		//
+		ProcFamilyMember* pm = lookup_member(pid);
+		if ((pm != NULL) && (pm->get_proc_family() == m_everybody_else)) {
+			bool reused = (pm->get_proc_info()->birthday != pi->birthday);
+			delete pi;
+			if (reused) {
+				free_proc_info_list(pi_list);
+				return false;
+			}
+			continue;
+		}
+
+		pi->next = pi_list;
+		pi_list = pi;
+	}
+	return true;
 }
+#endif
 
 void
 ProcFamilyMonitor::add_member(ProcFamilyMember* member)
@@ -28,6 +28,8 @@
 #include "proc_family_io.h"
 #include "procd_common.h"
 
+#include <set>
+
 class PIDTracker;
 #if defined(LINUX)
 class GroupTracker;
@@ -123,7 +125,23 @@ public:
 	// use a snapshot of all processes on the system (from ProcAPI)
 	// to update the families we are tracking
 	//
-	void snapshot(pid_t BOLOpid = 0);
+	void snapshot(pid_t BOLOpid = 0, bool full = false);
+
+#if defined(LINUX)
+	// between full snapshots, only look at the processes in the families
+	// we're tracking (and the children they've started), reading the
+	// membership of cgroup-tracked families from their cgroup.procs file.
+	// a full snapshot is still taken at least every full_scan_interval
+	// seconds, so that processes which have escaped their parents (and
+	// that we can only find via environment, login, or group ID) are
+	// picked up
+	//
+	void enable_incremental_snapshots(int full_scan_interval);
+#endif
+
+	// fill in statistics about the snapshots we've taken
+	//
+	void get_snapshot_stats(ProcFamilySnapshotStats&);
 
 	// used to access the pid_t to ProcFamilyMember hash table
 	// (these need to be public since they are called from the
@@ -178,6 +196,33 @@ private:
 	EnvironmentTracker* m_environment_tracker;
 	ParentTracker*      m_parent_tracker;
 
+	// if positive, the maximum number of seconds between full snapshots;
+	// snapshots in between are incremental. -1 means every snapshot
+	// is a full one
+	//
+	int m_full_scan_interval;
+	time_t m_last_full_scan;
+
+	// set when a family is registered for tracking by environment,
+	// login, or group ID, whose processes may already be outside the
+	// tree of the family's members; the next snapshot is a full one
+	//
+	bool m_full_scan_needed;
+
+	ProcFamilySnapshotStats m_snapshot_stats;
+
+#if defined(LINUX)
+	// build the procInfo list for an incremental snapshot. returns false
+	// if a full snapshot needs to be taken instead
+	//
+	bool get_tracked_proc_info_list(procInfo*& pi_list);
+
+	// gather the pids of all processes in the given family and its
+	// subfamilies, along with the children of those processes
+	//
+	bool collect_tracked_pids(Tree<ProcFamily*>*, std::set<pid_t>&);
+#endif
+
 	// find the minimum of all the ProcFamilys' requested "maximum
 	// snapshot intervals"
 	//
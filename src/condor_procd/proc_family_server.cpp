@@ -316,6 +316,17 @@ ProcFamilyServer::dump()
 	}
 }
 
+void
+ProcFamilyServer::get_snapshot_stats()
+{
+	ProcFamilySnapshotStats stats;
+	m_monitor.get_snapshot_stats(stats);
+
+	proc_family_error_t err = PROC_FAMILY_ERROR_SUCCESS;
+	write_to_client(&err, sizeof(proc_family_error_t));
+	write_to_client(&stats, sizeof(ProcFamilySnapshotStats));
+}
+
 void
 ProcFamilyServer::snapshot()
 {
@@ -493,6 +504,11 @@ ProcFamilyServer::wait_loop()
 				dump();
 				break;
 
+			case PROC_FAMILY_GET_SNAPSHOT_STATS:
+				dprintf(D_ALWAYS, "PROC_FAMILY_GET_SNAPSHOT_STATS\n");
+				get_snapshot_stats();
+				break;
+
 			case PROC_FAMILY_QUIT:
 				dprintf(D_ALWAYS, "PROC_FAMILY_QUIT\n");
 				quit();
@@ -77,6 +77,7 @@ private:
 	void snapshot();
 	void quit();
 	void dump();
+	void get_snapshot_stats();
 
 	// our monitor
 	//
@@ -40,6 +40,7 @@ static int continue_family(ProcFamilyClient& pfc, int argc, char* argv[]);
 static int kill_family(ProcFamilyClient& pfc, int argc, char* argv[]);
 static int unregister_family(ProcFamilyClient& pfc, int argc, char* argv[]);
 static int snapshot(ProcFamilyClient& pfc, int argc, char* argv[]);
+static int snapshot_stats(ProcFamilyClient& pfc, int argc, char* argv[]);
 static int quit(ProcFamilyClient& pfc, int argc, char* argv[]);
 
 static void
@@ -66,6 +67,7 @@ list_commands()
 	fprintf(stderr, "    KILL_FAMILY [<pid>]\n");
 	fprintf(stderr, "    UNREGISTER_FAMILY <pid>\n");
 	fprintf(stderr, "    SNAPSHOT\n");
+	fprintf(stderr, "    SNAPSHOT_STATS\n");
 	fprintf(stderr, "    QUIT\n");
 }
 
@@ -184,6 +186,9 @@ main(int argc, char* argv[])
 	else if (strcasecmp(cmd_argv[0], "SNAPSHOT") == 0) {
 		return snapshot(pfc, cmd_argc, cmd_argv);
 	}
+	else if (strcasecmp(cmd_argv[0], "SNAPSHOT_STATS") == 0) {
+		return snapshot_stats(pfc, cmd_argc, cmd_argv);
+	}
 	else if (strcasecmp(cmd_argv[0], "QUIT") == 0) {
 		return quit(pfc, cmd_argc, cmd_argv);
 	}
@@ -617,6 +622,41 @@ snapshot(ProcFamilyClient& pfc, int argc, char* argv[])
 	return 0;
 }
 
+int
+snapshot_stats(ProcFamilyClient& pfc, int argc, char* argv[])
+{
+	if (argc != 1) {
+		fprintf(stderr,
+		        "error: no arguments required for %s\n",
+		        argv[0]);
+		return 1;
+	}
+	bool success;
+	ProcFamilySnapshotStats stats;
+	if (!pfc.get_snapshot_stats(stats, success)) {
+		fprintf(stderr, "error: communication error with ProcD\n");
+		return 1;
+	}
+	if (!success) {
+		fprintf(stderr,
+		        "error: %s command failed with ProcD\n",
+		        argv[0]);
+		return 1;
+	}
+	printf("Full snapshots: %d (%.3f seconds)\n",
+	       stats.full_snapshots,
+	       stats.full_snapshot_time);
+	printf("Incremental snapshots: %d (%.3f seconds)\n",
+	       stats.incremental_snapshots,
+	       stats.incremental_snapshot_time);
+	printf("Last snapshot: %s, %d processes, %.3f seconds\n",
+	       stats.last_snapshot_incremental ? "incremental" : "full",
+	       stats.last_snapshot_procs,
+	       stats.last_snapshot_time);
+	printf("Slowest snapshot: %.3f seconds\n", stats.max_snapshot_time);
+	return 0;
+}
+
 int
 quit(ProcFamilyClient& pfc, int argc, char* argv[])
 {
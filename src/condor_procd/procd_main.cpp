@@ -56,6 +56,12 @@ static char* log_file_name = NULL;
 //
 static int max_snapshot_interval = 60;
 
+// the maximum time in between full snapshots, if snapshots in between
+// should only look at the processes in our families (-1 means every
+// snapshot is a full one)
+//
+static int full_snapshot_interval = -1;
+
 #if defined(LINUX)
 // a range of group IDs that can be used to track process
 // families by placing them in their supplementary group
@@ -106,6 +112,10 @@ usage(void)
 	"                         the parent process dies, the condor_procd will\n"
 	"                         exit.\n"
 	"  -S <seconds>           Process snapshot interval.\n"
+	"  -I <seconds>           Take incremental snapshots, which only look\n"
+	"                         at the processes in tracked families, doing\n"
+	"                         a full scan of all processes at most this\n"
+	"                         many seconds apart.\n"
 	"  -G <min-gid> <max-gid> If -E is not specified, then self-allocate gids\n"
 	"                         out of this range for process family tracking.\n"
 	"                         If -E is specified then procd_ctl must be used\n"
@@ -211,6 +221,16 @@ parse_command_line(int argc, char* argv[])
 				index++;
 				max_snapshot_interval = atoi(argv[index]);
 				break;
+
+			// maximum time between full snapshots
+			//
+			case 'I':
+				if (index + 1 >= argc) {
+					fail_option_args("-I", 1);
+				}
+				index++;
+				full_snapshot_interval = atoi(argv[index]);
+				break;
 			
 			// Should the procd utilize an externel protocol for assigning
 			// gids to families, or an internal protocol where the procd
@@ -455,6 +475,12 @@ main(int argc, char* argv[])
 	monitor.enable_cgroup_tracking();
 #endif
 
+#if defined(LINUX)
+	if (full_snapshot_interval > 0) {
+		monitor.enable_incremental_snapshots(full_snapshot_interval);
+	}
+#endif
+
 	// initialize the server for accepting requests from clients
 	//
 	ProcFamilyServer server(monitor, local_server_address);
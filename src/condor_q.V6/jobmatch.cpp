@@ -62,6 +62,7 @@
 #endif
 #include "classad_helpers.h"
 #include "../condor_procapi/procapi.h" // for getting cpu time & process memory
+#include <thread>
 
 static	const char	*fixSubmittorName( const char*, int );
 static	ExprTree	*stdRankCondition;
@@ -1097,6 +1098,19 @@ const char * appendJobRunAnalysisToBuffer(std::string & out, ClassAd *job, anaCo
 	return out.c_str();
 }
 
+// number of threads to use when evaluating expressions against all of the slots or jobs
+static int analysisThreads()
+{
+	static int num_threads = -1;
+	if (num_threads < 0) {
+		num_threads = param_integer("CONDOR_Q_ANALYZE_THREADS", 0, 0);
+		if (num_threads == 0) {
+			num_threads = MIN(8, (int)std::thread::hardware_concurrency());
+		}
+	}
+	return num_threads;
+}
+
 const char * doJobMatchAnalysisToBuffer(std::string & return_buf, ClassAd *request, int details)
 {
 	bool	analEachReqClause = (details & detail_analyze_each_sub_expr) != 0;
@@ -1183,7 +1197,7 @@ const char * doJobMatchAnalysisToBuffer(std::string & return_buf, ClassAd *reque
 		if (analEachReqClause) {
 #endif
 			std::string subexpr_detail;
-			anaFormattingOptions fmt = { widescreen ? getDisplayWidth() : 80, details, "Requirements", "Job", "Slot" };
+			anaFormattingOptions fmt = { widescreen ? getDisplayWidth() : 80, details, "Requirements", "Job", "Slot", analysisThreads() };
 
 			// the common analyis code wants a vector of startd ads, not a map
 			std::vector<ClassAd*> ads;
@@ -1290,7 +1304,7 @@ const char * doSlotRunAnalysisToBuffer(ClassAd *slot, JobClusterMap & clusters,
 	bool analStartExpr = /*(better_analyze == 2) ||*/ (analyze_detail_level > 0);
 	bool showSlotAttrs = ! (analyze_detail_level & detail_dont_show_job_attrs);
 	bool rawReferencedValues = true;
-	anaFormattingOptions fmt = { console_width, analyze_detail_level, "START", "Slot", "Cluster" };
+	anaFormattingOptions fmt = { console_width, analyze_detail_level, "START", "Slot", "Cluster", analysisThreads() };
 
 	return_buff[0] = 0;
 
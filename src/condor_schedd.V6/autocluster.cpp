@@ -64,6 +64,8 @@ JobCluster::~JobCluster()
 void JobCluster::clear()
 {
 	cluster_map.clear();
+	sig_hash_map.clear();
+	sig_hash_of.clear();
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
 	cluster_use.clear();
 	cluster_gone.clear();
@@ -137,6 +139,23 @@ bool JobCluster::setSigAttrs(const char* new_sig_attrs, bool free_input_attrs, b
 	return sig_attrs_changed;
 }
 
+// remove a cluster that is going away from the signature hash cache
+void JobCluster::forget_sig_hash(int id)
+{
+	auto hit = sig_hash_of.find(id);
+	if (hit == sig_hash_of.end()) {
+		return;
+	}
+	auto range = sig_hash_map.equal_range(hit->second);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second.id == id) {
+			sig_hash_map.erase(it);
+			break;
+		}
+	}
+	sig_hash_of.erase(hit);
+}
+
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
 
 // lookup the autocluster for a job (assumes job.autocluster_id is valid)
@@ -199,7 +218,10 @@ void JobCluster::collect_garbage(bool brute_force) // free the deleted clusters
 		}
 		// advance here so that we can erase the previous entry if needed.
 		auto last = it++;
-		if (gone) { cluster_map.erase(last); }
+		if (gone) {
+			forget_sig_hash(last->second);
+			cluster_map.erase(last);
+		}
 	}
 	cluster_gone.clear();
 }
@@ -207,6 +229,106 @@ void JobCluster::collect_garbage(bool brute_force) // free the deleted clusters
 #endif
 
 extern int    last_autocluster_classad_cache_hit;
+extern bool   last_autocluster_sig_hash_hit;
+
+static inline size_t sig_hash_combine(size_t seed, size_t val)
+{
+	return seed ^ (val + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+// Hash an expression by its structure.  Trees that are SameAs() each other
+// always hash the same, the converse need not be true since hash matches are
+// checked with SameAs() before they are used.
+static size_t sig_hash_expr(classad::ExprTree * tree)
+{
+	if ( ! tree) return 0;
+	tree = SkipExprEnvelope(tree);
+	if ( ! tree) return 0;
+
+	size_t hash = std::hash<int>()((int)tree->GetKind());
+	switch (tree->GetKind()) {
+	case classad::ExprTree::INTEGER_LITERAL: {
+		long long ival = 0;
+		ExprTreeIsLiteralNumber(tree, ival);
+		hash = sig_hash_combine(hash, std::hash<long long>()(ival));
+	}
+	break;
+
+	case classad::ExprTree::REAL_LITERAL: {
+		double rval = 0;
+		ExprTreeIsLiteralNumber(tree, rval);
+		hash = sig_hash_combine(hash, std::hash<double>()(rval));
+	}
+	break;
+
+	case classad::ExprTree::BOOLEAN_LITERAL: {
+		bool bval = false;
+		ExprTreeIsLiteralBool(tree, bval);
+		hash = sig_hash_combine(hash, bval ? 1 : 2);
+	}
+	break;
+
+	case classad::ExprTree::STRING_LITERAL: {
+		const char * cstr = nullptr;
+		if (ExprTreeIsLiteralString(tree, cstr) && cstr) {
+			hash = sig_hash_combine(hash, std::hash<std::string_view>()(cstr));
+		}
+	}
+	break;
+
+	case classad::ExprTree::ATTRREF_NODE: {
+		classad::ExprTree * expr = nullptr;
+		std::string attr;
+		bool absolute = false;
+		((classad::AttributeReference*)tree)->GetComponents(expr, attr, absolute);
+		hash = sig_hash_combine(hash, std::hash<std::string>()(attr));
+		hash = sig_hash_combine(hash, absolute ? 1 : 2);
+		hash = sig_hash_combine(hash, sig_hash_expr(expr));
+	}
+	break;
+
+	case classad::ExprTree::OP_NODE: {
+		classad::Operation::OpKind op;
+		classad::ExprTree *t1, *t2, *t3;
+		((classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+		hash = sig_hash_combine(hash, std::hash<int>()((int)op));
+		hash = sig_hash_combine(hash, sig_hash_expr(t1));
+		hash = sig_hash_combine(hash, sig_hash_expr(t2));
+		hash = sig_hash_combine(hash, sig_hash_expr(t3));
+	}
+	break;
+
+	case classad::ExprTree::FN_CALL_NODE: {
+		std::string fnName;
+		std::vector<classad::ExprTree*> args;
+		((classad::FunctionCall*)tree)->GetComponents(fnName, args);
+		hash = sig_hash_combine(hash, std::hash<std::string>()(fnName));
+		for (auto * arg : args) { hash = sig_hash_combine(hash, sig_hash_expr(arg)); }
+	}
+	break;
+
+	case classad::ExprTree::EXPR_LIST_NODE: {
+		std::vector<classad::ExprTree*> exprs;
+		((classad::ExprList*)tree)->GetComponents(exprs);
+		for (auto * expr : exprs) { hash = sig_hash_combine(hash, sig_hash_expr(expr)); }
+	}
+	break;
+
+	default:
+		// undefined and error literals, times and nested ads are rare enough
+		// in job ads that they can share a hash, SameAs() tells them apart.
+		break;
+	}
+	return hash;
+}
+
+static bool same_sig_value(classad::ExprTree * a, classad::ExprTree * b)
+{
+	if ( ! a || ! b) return a == b;
+	a = SkipExprEnvelope(a);
+	b = SkipExprEnvelope(b);
+	return a == b || a->SameAs(b);
+}
 
 int JobCluster::getClusterid(JobQueueJob & job, bool expand_refs, std::string * final_list)
 {
@@ -268,58 +390,121 @@ int JobCluster::getClusterid(JobQueueJob & job, bool expand_refs, std::string *
 	}
 
 	// sigset now contains the values of all the attributes we need,
-	// significant attibutes are first, followed by expanded attributes
-	// we build a signature essentially by printing it all out in one big string
+	// significant attibutes are first, followed by expanded attributes.
+	// before building the signature string, check whether these same values
+	// already belong to a cluster.
 	//
-	bool need_sep = false; // true after the first item, (when we need to print separators)
-	std::string signature;
-	signature.reserve(strlen(significant_attrs) + exattrs.size()*20 + sigset.size()*20); // make a guess as to how much space the signature will take.
-
-	classad::ClassAdUnParser unp;
-	unp.SetOldClassAd( true, true );
+	size_t sig_hash = 0;
+	for (const auto & exattr : exattrs) {
+		sig_hash = sig_hash_combine(sig_hash, std::hash<std::string>()(exattr));
+	}
+	for (ExprTree * tree : sigset) {
+		sig_hash = sig_hash_combine(sig_hash, sig_hash_expr(tree));
+	}
 
-	// first put the pre-defined significant attrs in the sig
-	list.rewind();
-	int ix = 0;
-	while ((attr = list.next_string())) {
-		ExprTree * tree = sigset[ix];
-		signature += *attr;
-		signature += " = ";
-		if (tree) { unp.Unparse(signature, tree); }
-		signature += '\n';
-		if (final_list) {
-			if (need_sep) { (*final_list) += ','; }
-			final_list->append(*attr);
-			need_sep = true;
+	last_autocluster_sig_hash_hit = false;
+	auto range = sig_hash_map.equal_range(sig_hash);
+	for (auto hit = range.first; hit != range.second; ++hit) {
+		const SigHashEntry & entry = hit->second;
+		if (entry.values.size() != sigset.size() || entry.exattrs.size() != exattrs.size()) {
+			continue;
+		}
+		if ( ! std::equal(exattrs.begin(), exattrs.end(), entry.exattrs.begin())) {
+			continue;
+		}
+		size_t ix = 0;
+		while (ix < sigset.size() && same_sig_value(sigset[ix], entry.values[ix].get())) { ++ix; }
+		if (ix == sigset.size()) {
+			cur_id = entry.id;
+			last_autocluster_sig_hash_hit = true;
+			break;
 		}
-		++ix;
 	}
 
-	// now put out the expanded attribs (if any)
-	for (const auto & exattr : exattrs) {
-		ExprTree * tree = sigset[ix];
-		signature += exattr;
-		signature += " = ";
-		if (tree) { unp.Unparse(signature, tree); }
-		signature += '\n';
+	if (cur_id >= 0) {
 		if (final_list) {
-			if (need_sep) { (*final_list) += ','; }
-			final_list->append(exattr);
-			need_sep = true;
+			list.rewind();
+			bool need_sep = false;
+			while ((attr = list.next_string())) {
+				if (need_sep) { (*final_list) += ','; }
+				final_list->append(*attr);
+				need_sep = true;
+			}
+			for (const auto & exattr : exattrs) {
+				if (need_sep) { (*final_list) += ','; }
+				final_list->append(exattr);
+				need_sep = true;
+			}
 		}
-		++ix;
-	}
+	} else {
 
-	// now check the signature against the current cluster map
-	// and either return the matching cluster id, or a new cluster id.
-	JobSigidMap::iterator it;
-	it = cluster_map.find(signature);
-	if (it != cluster_map.end()) {
-		cur_id = it->second;
-	}
-	else {
-		cur_id = next_id++;
-		cluster_map.insert(JobSigidMap::value_type(signature,cur_id));
+		// no cached cluster has these values,
+		// we build a signature essentially by printing it all out in one big string
+		//
+		bool need_sep = false; // true after the first item, (when we need to print separators)
+		std::string signature;
+		signature.reserve(strlen(significant_attrs) + exattrs.size()*20 + sigset.size()*20); // make a guess as to how much space the signature will take.
+
+		classad::ClassAdUnParser unp;
+		unp.SetOldClassAd( true, true );
+
+		// first put the pre-defined significant attrs in the sig
+		list.rewind();
+		int ix = 0;
+		while ((attr = list.next_string())) {
+			ExprTree * tree = sigset[ix];
+			signature += *attr;
+			signature += " = ";
+			if (tree) { unp.Unparse(signature, tree); }
+			signature += '\n';
+			if (final_list) {
+				if (need_sep) { (*final_list) += ','; }
+				final_list->append(*attr);
+				need_sep = true;
+			}
+			++ix;
+		}
+
+		// now put out the expanded attribs (if any)
+		for (const auto & exattr : exattrs) {
+			ExprTree * tree = sigset[ix];
+			signature += exattr;
+			signature += " = ";
+			if (tree) { unp.Unparse(signature, tree); }
+			signature += '\n';
+			if (final_list) {
+				if (need_sep) { (*final_list) += ','; }
+				final_list->append(exattr);
+				need_sep = true;
+			}
+			++ix;
+		}
+
+		// now check the signature against the current cluster map
+		// and either return the matching cluster id, or a new cluster id.
+		JobSigidMap::iterator it;
+		it = cluster_map.find(signature);
+		if (it != cluster_map.end()) {
+			cur_id = it->second;
+		}
+		else {
+			cur_id = next_id++;
+			cluster_map.insert(JobSigidMap::value_type(signature,cur_id));
+		}
+
+		// remember the values of this cluster, so that the next job like this one
+		// does not need to build a signature.
+		if (sig_hash_of.find(cur_id) == sig_hash_of.end()) {
+			SigHashEntry entry;
+			entry.id = cur_id;
+			entry.exattrs.assign(exattrs.begin(), exattrs.end());
+			entry.values.reserve(sigset.size());
+			for (ExprTree * tree : sigset) {
+				entry.values.emplace_back(tree ? tree->Copy() : nullptr);
+			}
+			sig_hash_map.emplace(sig_hash, std::move(entry));
+			sig_hash_of[cur_id] = sig_hash;
+		}
 	}
 
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
@@ -564,6 +749,7 @@ void AutoCluster::sweep()
 		if (in_use == cluster_in_use.end()) {
 				// found an entry to remove.
 			dprintf(D_FULLDEBUG,"removing auto cluster id %d\n",id);
+			forget_sig_hash(id);
 			cluster_map.erase( it );
 		}
 	}
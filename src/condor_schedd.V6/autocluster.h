@@ -26,6 +26,8 @@
 
 #include "condor_classad.h"
 #include <generic_stats.h>
+#include <memory>
+#include <unordered_map>
 
 class JobIdSet;
 class JobAggregationResults;
@@ -52,6 +54,19 @@ protected:
 	friend class JobAggregationResults;
 	typedef std::map<std::string,int> JobSigidMap;
 	JobSigidMap cluster_map;  // map of signature to a cluster id
+
+	// Cache in front of cluster_map, keyed by a structural hash of the signature
+	// values, so that a job whose values are the same as those of an existing
+	// cluster can be assigned to it without unparsing its signature.
+	struct SigHashEntry {
+		int id;
+		std::vector<std::string> exattrs; // the expanded attributes that follow the significant ones
+		std::vector<std::unique_ptr<classad::ExprTree>> values; // NULL where the attribute is undefined
+	};
+	typedef std::unordered_multimap<size_t, SigHashEntry> SigHashMap;
+	SigHashMap sig_hash_map;
+	std::map<int, size_t> sig_hash_of; // cluster id to its key in sig_hash_map
+	void forget_sig_hash(int id);
 #ifdef USE_AUTOCLUSTER_TO_JOBID_MAP
 	typedef std::map<int, JobIdSet> JobIdSetMap;
 	JobIdSetMap cluster_use; // map clusterId to a set of jobIds
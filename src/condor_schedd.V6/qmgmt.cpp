@@ -287,6 +287,7 @@ static int defer_cleanup_timer_id = -1;
 static std::set<int> ClustersNeedingMaterialize;
 static std::map<int,JobFactory*> JobFactoriesSubmitPending; // job factories that have been submitted, but not yet committed.
 static int job_materialize_timer_id = -1;
+static const int job_materialize_timer_period = 5; // seconds
 
 // if false, we version check and fail attempts by newer clients to set secure attrs via the SetAttribute function
 static bool Ignore_Secure_SetAttr_Attempts = true;
@@ -806,17 +807,18 @@ inline bool HasMaterializePolicy(JobQueueCluster * /*cad*/)
 
 #ifdef USE_MATERIALIZE_POLICY
 // num_pending should be the number of jobs that have been materialized, but not yet committed
-// returns true if materialization of a single job is allowed by policy, if false retry_delay
+// returns the number of jobs that policy allows to be materialized, if 0 retry_delay
 // will be set to a suggested delay before trying again.  a retry_delay > 10 means "wait for a state change before retrying"
-bool CheckMaterializePolicyExpression(JobQueueCluster * cad, int num_pending, int & retry_delay)
+int MaterializePolicyAllowance(JobQueueCluster * cad, int num_pending, int & retry_delay)
 {
 	long long max_idle = -1;
 	if (cad->LookupInteger(ATTR_JOB_MATERIALIZE_MAX_IDLE, max_idle) && max_idle >= 0) {
-		if ((cad->getNumNotRunning() + num_pending) < max_idle) {
-			return true;
+		long long allowed = max_idle - (cad->getNumNotRunning() + num_pending);
+		if (allowed > 0) {
+			return (int)MIN(allowed, (long long)INT_MAX);
 		} else {
 			retry_delay = 20; // don't bother to retry by polling, wait for a job to change state instead.
-			return false;
+			return 0;
 		}
 	}
 
@@ -831,22 +833,88 @@ bool CheckMaterializePolicyExpression(JobQueueCluster * cad, int num_pending, in
 		if (expr) {
 			bool rv = EvalExprBool(&iad, expr);
 			delete expr;
-			if (rv) return true;
+			if (rv) return 1;
 		}
 	}
 
 	retry_delay = 20; // don't bother to retry by polling, wait for a job to change state instead.
-	return false;
+	return 0;
 #endif
-	return true;
+	return INT_MAX;
 }
 #else
-bool CheckMaterializePolicyExpression(JobQueueCluster * /*cad*/, int & /*retry_delay*/)
+int MaterializePolicyAllowance(JobQueueCluster * /*cad*/, int /*num_pending*/, int & /*retry_delay*/)
 {
-	return true;
+	return INT_MAX;
 }
 #endif
 
+// When SCHEDD_MATERIALIZE_RATE is set, late materialization across all of the factories in the schedd
+// is limited by a token bucket that refills at that many jobs per second, and that holds at most
+// one period of the materialize timer worth of jobs, so that each timer pass can use the whole rate.
+static double MaterializeRateTokens = 0;
+static double MaterializeRateLastRefill = 0;
+
+static int MaterializeRateAllowance()
+{
+	double rate = scheduler.getMaterializeRate();
+	if (rate <= 0) {
+		return INT_MAX;
+	}
+	double now = _condor_debug_get_time_double();
+	double burst = MAX(rate * job_materialize_timer_period, 1.0);
+	if (MaterializeRateLastRefill <= 0) {
+		MaterializeRateTokens = burst;
+	} else {
+		MaterializeRateTokens = MIN(burst, MaterializeRateTokens + (now - MaterializeRateLastRefill) * rate);
+	}
+	MaterializeRateLastRefill = now;
+	return (int)MaterializeRateTokens;
+}
+
+// Materialize jobs for a factory cluster into the transaction, a block of up to SCHEDD_MATERIALIZE_BLOCK_SIZE
+// jobs at a time, until the cluster reaches effective_limit or the factory, the materialize policy or
+// SCHEDD_MATERIALIZE_RATE says to stop.  returns the number of jobs materialized, retry_delay is set as
+// for MaterializeNextFactoryJob
+static int MaterializeFactoryJobs(JobQueueCluster * cad, TransactionWatcher & txn, int effective_limit, int & retry_delay)
+{
+	retry_delay = 0;
+	int block_size = MAX(1, scheduler.getMaterializeBlockSize());
+	int num_materialized = 0;
+	int cluster_size = cad->ClusterSize();
+	while ((cluster_size + num_materialized) < effective_limit) {
+		int max_jobs = MIN(block_size, effective_limit - (cluster_size + num_materialized));
+		max_jobs = MIN(max_jobs, MaterializePolicyAllowance(cad, num_materialized, retry_delay));
+		if (max_jobs <= 0) {
+			break;
+		}
+		int rate_allowance = MaterializeRateAllowance();
+		if (rate_allowance <= 0) {
+			// the rate limit is not a state change of this cluster, so poll
+			dprintf(D_MATERIALIZE | D_VERBOSE, "\tcluster %d cannot materialize more jobs now because of SCHEDD_MATERIALIZE_RATE\n", cad->jid.cluster);
+			retry_delay = job_materialize_timer_period;
+			ScheduleClusterForJobMaterializeNow(cad->jid.cluster);
+			break;
+		}
+		max_jobs = MIN(max_jobs, rate_allowance);
+
+		int rv = MaterializeFactoryJobBlock(cad->factory, cad, txn, max_jobs, retry_delay);
+		if (rv < 0) {
+			// the failed block aborted the transaction, which takes the earlier blocks with it
+			MaterializeRateTokens += num_materialized;
+			num_materialized = 0;
+			break;
+		}
+		num_materialized += rv;
+		MaterializeRateTokens -= rv;
+		if (rv < max_jobs) {
+			// either failure, or 'not now' use retry_delay to tell the difference.
+			break;
+		}
+	}
+	return num_materialized;
+}
+
 // This timer is after when we create a job factory, change the pause state of one or more job factories, or
 // remove a job that is part of a cluster with a job factory. What we want to do here
 // is either materialize a new job in that cluster, queue up a read of itemdata for the job factory
@@ -914,26 +982,13 @@ JobMaterializeTimerCallback(int /* tid */)
 						cad->ClusterSize());
 
 					TransactionWatcher txn;
-					int num_materialized = 0;
-					int cluster_size = cad->ClusterSize();
-					while ((cluster_size + num_materialized) < effective_limit) {
-						int retry_delay = 0; // will be set to non-zero when we should try again later.
-						int rv = 0;
-						if (CheckMaterializePolicyExpression(cad, num_materialized, retry_delay)) {
-							rv = MaterializeNextFactoryJob(cad->factory, cad, txn, retry_delay);
-						}
-						if (rv == 1) {
-							num_materialized += 1;
-						} else {
-							// either failure, or 'not now' use retry_delay to tell the difference. 0 means stop materializing
-							// for small non-zero values of retry, just leave this entry in the timer list so we end up polling.
-							// larger retry values indicate that the factory is in a resumable pause state
-							// which we will handle using a catMaterializeState transaction trigger rather than
-							// by polling with this timer callback.
-							if (retry_delay > 0 && retry_delay < 10) { remove_entry = false; }
-							break;
-						}
-					}
+					int retry_delay = 0; // will be set to non-zero when we should try again later.
+					int num_materialized = MaterializeFactoryJobs(cad, txn, effective_limit, retry_delay);
+					// for small non-zero values of retry, just leave this entry in the timer list so we end up polling.
+					// larger retry values indicate that the factory is in a resumable pause state
+					// which we will handle using a catMaterializeState transaction trigger rather than
+					// by polling with this timer callback.
+					if (retry_delay > 0 && retry_delay < 10) { remove_entry = false; }
 
 					if (num_materialized > 0) {
 						// If we materialized any jobs, we may need to commit the transaction now.
@@ -991,7 +1046,7 @@ ScheduleClusterForJobMaterializeNow(int cluster_id)
 	// Start timer to do job materialize if it is not already running.
 	if( job_materialize_timer_id <= 0 ) {
 		dprintf(D_FULLDEBUG, "Starting job materialize timer\n");
-		job_materialize_timer_id = daemonCore->Register_Timer(0, 5, JobMaterializeTimerCallback, "JobMaterializeTimerCallback");
+		job_materialize_timer_id = daemonCore->Register_Timer(0, job_materialize_timer_period, JobMaterializeTimerCallback, "JobMaterializeTimerCallback");
 	}
 }
 
@@ -2827,21 +2882,7 @@ int MaterializeJobs(JobQueueCluster * clusterad, TransactionWatcher &txn, int &
 		scheduler.getMaxMaterializedJobsPerCluster(), scheduler.getMaxJobsPerSubmission(), owner_limit,
 		clusterad->ClusterSize());
 
-	int num_materialized = 0;
-	int cluster_size = clusterad->ClusterSize();
-	while ((cluster_size + num_materialized) < effective_limit) {
-		int retry = 0;
-		if ( ! CheckMaterializePolicyExpression(clusterad, num_materialized, retry)) {
-			retry_delay = retry;
-			break;
-		}
-		if (MaterializeNextFactoryJob(clusterad->factory, clusterad, txn, retry) == 1) {
-			num_materialized += 1;
-		} else {
-			retry_delay = MAX(retry_delay, retry);
-			break;
-		}
-	}
+	int num_materialized = MaterializeFactoryJobs(clusterad, txn, effective_limit, retry_delay);
 
 	return num_materialized;
 }
@@ -7732,6 +7773,42 @@ int QmgmtHandleSendJobsetAd(int cluster_id, ClassAd & ad, int /*flags*/, int & t
 }
 
 
+// The SHADOW_JOB_UPDATE stream applies its updates later, as the schedd.
+// So check each attribute now exactly as SetAttribute() would on the shadow's
+// own qmgmt connection, where it acts as the job's owner, and remove the ones
+// it may not change from the update.
+void
+CheckShadowJobUpdate(ReliSock *sock, PROC_ID job_id, ClassAd &update, std::vector<std::string> &refused)
+{
+	refused.clear();
+
+	std::string owner;
+	JobQueueJob *job = GetJobAd(job_id);
+	if (job) {
+		job->LookupString(USERREC_NAME_IS_FULLY_QUALIFIED ? ATTR_USER : ATTR_OWNER, owner);
+	}
+
+	bool allowed = job && setQSock(sock);
+	if (allowed) {
+		Q_SOCK->initAuthOwner(false);
+		allowed = QmgmtSetEffectiveOwner(owner.c_str()) == 0;
+	}
+	for (const auto & [name, expr] : update) {
+			// SetAttribute() quietly ignores secure attributes from some
+			// peers rather than failing, which would not stop us here
+		if ( ! allowed || secure_attrs.count(name) ||
+			 SetAttribute(job_id.cluster, job_id.proc, name.c_str(), ExprTreeToString(expr),
+			              NONDURABLE | SetAttribute_QueryOnly) < 0) {
+			refused.push_back(name);
+		}
+	}
+	unsetQSock();
+
+	for (const auto & name : refused) {
+		update.Delete(name);
+	}
+}
+
 void
 MarkJobClean(PROC_ID proc_id)
 {
@@ -8817,8 +8894,10 @@ schedd_runtime_probe GetAutoCluster_runtime;
 schedd_runtime_probe GetAutoCluster_hit_runtime;
 schedd_runtime_probe GetAutoCluster_signature_runtime;
 schedd_runtime_probe GetAutoCluster_cchit_runtime;
+schedd_runtime_probe GetAutoCluster_sighash_runtime;
 double last_autocluster_runtime;
 bool   last_autocluster_make_sig;
+bool   last_autocluster_sig_hash_hit;
 int    last_autocluster_type=0;
 int    last_autocluster_classad_cache_hit=0;
 stats_entry_abs<int> SCGetAutoClusterType;
@@ -8855,12 +8934,14 @@ int get_job_prio(JobQueueJob *job, const JOB_ID_KEY & jid, void *)
 	GetAutoCluster_runtime += last_autocluster_runtime;
 	if (last_autocluster_make_sig) { GetAutoCluster_signature_runtime += last_autocluster_runtime; }
 	else { GetAutoCluster_hit_runtime += last_autocluster_runtime; }
+	if (last_autocluster_make_sig && last_autocluster_sig_hash_hit) { GetAutoCluster_sighash_runtime += last_autocluster_runtime; }
 	SCGetAutoClusterType = last_autocluster_type;
 	GetAutoCluster_cchit_runtime += last_autocluster_classad_cache_hit;
 
 	GetAutoCluster_runtime += last_autocluster_runtime;
 	if (last_autocluster_make_sig) { GetAutoCluster_signature_runtime += last_autocluster_runtime; }
 	else { GetAutoCluster_hit_runtime += last_autocluster_runtime; }
+	if (last_autocluster_make_sig && last_autocluster_sig_hash_hit) { GetAutoCluster_sighash_runtime += last_autocluster_runtime; }
 	SCGetAutoClusterType = last_autocluster_type;
 	GetAutoCluster_cchit_runtime += last_autocluster_classad_cache_hit;
 
@@ -556,11 +556,18 @@ void AttachJobFactoryToCluster(JobFactory * factory, JobQueueCluster * cluster);
 // returns < 0 on error.  if return is 0, retry_delay is set to non-zero to indicate the retrying later might yield success
 int MaterializeNextFactoryJob(JobFactory * factory, JobQueueCluster * cluster, TransactionWatcher & trans, int & retry_delay);
 
-// returns true if there is no materialize policy expression, or if the expression evalues to true
-// returns false if there is an expression and it evaluates to false. When false is returned, retry_delay is set
+// Materialize up to max_jobs jobs into the transaction, expanding the rows of the factory's item data in order.
+// returns the number of jobs materialized, which is less than max_jobs when the factory is paused or complete,
+// or itemdata is not yet available, in which case retry_delay is set as for MaterializeNextFactoryJob.
+// returns < 0 on error, in which case the transaction has been aborted, taking with it any jobs
+// materialized into it before the error, in this block or an earlier one.
+int MaterializeFactoryJobBlock(JobFactory * factory, JobQueueCluster * cluster, TransactionWatcher & trans, int max_jobs, int & retry_delay);
+
+// returns the number of jobs that the materialize policy allows to be materialized in addition to num_pending,
+// which should be the number of jobs that have been materialized but not yet committed.
+// returns INT_MAX if there is no materialize policy.  When 0 is returned, retry_delay is set,
 // a value of > 0 for retry_delay indicates that trying again later might give a different answer.
-// num_pending should be the number of jobs that have been materialized but not yet committed
-bool CheckMaterializePolicyExpression(JobQueueCluster * cluster, int num_pending, int & retry_delay);
+int MaterializePolicyAllowance(JobQueueCluster * cluster, int num_pending, int & retry_delay);
 
 int PostCommitJobFactoryProc(JobQueueCluster * cluster, JobQueueJob * job);
 bool CanMaterializeJobs(JobQueueCluster * cluster); // reutrns true if cluster has a non-paused, non-complete factory
@@ -874,6 +881,7 @@ void unsetQSock();
 void MarkJobClean(PROC_ID job_id);
 void MarkJobClean(int cluster_id, int proc_id);
 void MarkJobClean(const char* job_id_str);
+void CheckShadowJobUpdate(ReliSock *sock, PROC_ID job_id, ClassAd &update, std::vector<std::string> &refused);
 
 bool Reschedule();
 
@@ -512,17 +512,22 @@ bool CheckJobFactoryPause(JobFactory * factory, int want_pause)
 // in which case retry_delay is set to indicate how long later should be
 // retry_delay of 0 means we are done, either because of failure or because we ran out of jobs to materialize.
 int  MaterializeNextFactoryJob(JobFactory * factory, JobQueueCluster * ClusterAd, TransactionWatcher & txn, int & retry_delay)
+{
+	return MaterializeFactoryJobBlock(factory, ClusterAd, txn, 1, retry_delay);
+}
+
+int  MaterializeFactoryJobBlock(JobFactory * factory, JobQueueCluster * ClusterAd, TransactionWatcher & txn, int max_jobs, int & retry_delay)
 {
 	retry_delay = 0;
 	if (factory->IsPaused()) {
 		// if the factory is paused but resumable, return a large value for the retry delay.
 		// in practice, this value really means "don't use a timer to retry, use a transaction trigger on the pause state to retry"
 		if (factory->IsResumable()) { retry_delay = 300; }
-		dprintf(D_MATERIALIZE, "in MaterializeNextFactoryJob for cluster=%d, Factory is paused (%d)\n", ClusterAd->jid.cluster, factory->PauseMode());
+		dprintf(D_MATERIALIZE, "in MaterializeFactoryJobBlock for cluster=%d, Factory is paused (%d)\n", ClusterAd->jid.cluster, factory->PauseMode());
 		return 0;
 	}
 
-	dprintf(D_MATERIALIZE | D_VERBOSE, "in MaterializeNextFactoryJob for cluster=%d, Factory is running\n", ClusterAd->jid.cluster);
+	dprintf(D_MATERIALIZE | D_VERBOSE, "in MaterializeFactoryJobBlock for cluster=%d, Factory is running, max_jobs=%d\n", ClusterAd->jid.cluster, max_jobs);
 
 	int step_size = factory->StepSize();
 	if (step_size <= 0) {
@@ -534,29 +539,20 @@ int  MaterializeNextFactoryJob(JobFactory * factory, JobQueueCluster * ClusterAd
 // ATTR_JOB_MATERIALIZE_STEP_SIZE    "JobMaterializeStepSize"
 // ATTR_JOB_MATERIALIZE_NEXT_PROC_ID "JobMaterializeNextProcId"
 
+	// The position of the factory is read from the cluster ad once for the whole block,
+	// and written back once at the end, rather than once per job.
 	int next_proc_id = 0;
 	int rval = GetAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_JOB_MATERIALIZE_NEXT_PROC_ID, &next_proc_id);
 	if (rval < 0 || next_proc_id < 0) {
 		dprintf(D_ALWAYS, "ERROR - " ATTR_JOB_MATERIALIZE_NEXT_PROC_ID " is not set, aborting materalize for cluster %d\n", ClusterAd->jid.cluster);
 		setJobFactoryPauseAndLog(ClusterAd, mmInvalid, 0,  ATTR_JOB_MATERIALIZE_PAUSED " is undefined");
-		//factory->Pause(mmInvalid);
-		//PRAGMA_REMIND("should this be durable?")
-		//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSED, mmInvalid);
-		//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSE_REASON,);
+		if (rval < 0) { txn.AbortIfAny(); }
 		return rval;
 	}
 
-	int step = next_proc_id % step_size;
 	int item_index = 0;
 	bool no_items = factory->NoItems();
-	if (no_items) {
-		if (next_proc_id >= step_size) {
-			dprintf(D_MATERIALIZE | D_VERBOSE, "Materialize for cluster %d is done. has_items=%d, next_proc_id=%d, step=%d\n", ClusterAd->jid.cluster, !no_items, next_proc_id, step_size);
-			// we are done
-			factory->Pause(mmNoMoreItems);
-			return 0;
-		}
-	} else {
+	if ( ! no_items) {
 		// item index is optional, if missing, the value is 0 and the item is the empty string.
 		rval = GetAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_JOB_MATERIALIZE_NEXT_ROW, &item_index);
 		if (rval < 0) {
@@ -565,101 +561,110 @@ int  MaterializeNextFactoryJob(JobFactory * factory, JobQueueCluster * ClusterAd
 				// ATTR_JOB_MATERIALIZE_NEXT_ROW must exist in the cluster ad once we are done with proc 0
 				dprintf(D_ALWAYS, "ERROR - " ATTR_JOB_MATERIALIZE_NEXT_ROW " is not set, aborting materialize for job %d.%d step=%d, row=%d\n", ClusterAd->jid.cluster, next_proc_id, step_size, item_index);
 				setJobFactoryPauseAndLog(ClusterAd, mmInvalid, 0, ATTR_JOB_MATERIALIZE_NEXT_ROW " is undefined");
-				//PRAGMA_REMIND("should this be durable?")
-				//factory->Pause(mmInvalid);
-				//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSED, mmInvalid);
-				//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSE_REASON, ATTR_JOB_MATERIALIZE_NEXT_ROW " is undefined");
 				// we are done
 				return 0;
 			}
 			item_index = factory->FirstSelectedRow();
 		}
 	}
-	if (item_index < 0) {
-		// we are done
-		dprintf(D_MATERIALIZE | D_VERBOSE, "Materialize for cluster %d is done. JobMaterializeNextRow is %d\n", ClusterAd->jid.cluster, item_index);
-		factory->Pause(mmNoMoreItems);
-		return 0; 
-	}
-	int row  = item_index;
-	
-	// if the row data is still loading, return 0 and a small value for the retry delay
-	if (factory->RowDataIsLoading(row)){
-		retry_delay = 1;
-		return 0;
-	}
 
-	JOB_ID_KEY jid(ClusterAd->jid.cluster, next_proc_id);
-	dprintf(D_ALWAYS, "Trying to Materializing new job %d.%d step=%d row=%d\n", jid.cluster, jid.proc, step, row);
+	rval = 0;
+	const int first_proc_id = next_proc_id;
+	int row = item_index;
+	int loaded_row = -1;
+	int num_materialized = 0;
+	while (num_materialized < max_jobs) {
+		int step = next_proc_id % step_size;
+		if (no_items) {
+			if (next_proc_id >= step_size) {
+				dprintf(D_MATERIALIZE | D_VERBOSE, "Materialize for cluster %d is done. has_items=%d, next_proc_id=%d, step=%d\n", ClusterAd->jid.cluster, !no_items, next_proc_id, step_size);
+				factory->Pause(mmNoMoreItems);
+				break;
+			}
+			row = 0;
+		}
+		if (row < 0) {
+			dprintf(D_MATERIALIZE | D_VERBOSE, "Materialize for cluster %d is done. JobMaterializeNextRow is %d\n", ClusterAd->jid.cluster, row);
+			factory->Pause(mmNoMoreItems);
+			break;
+		}
 
-	const bool check_empty = true;
-	const bool fail_empty = false;
-	std::string empty_var_names;
-	int row_num = factory->LoadRowData(row, check_empty ? &empty_var_names : nullptr);
-	if (row_num < row) {
-		// we are done
-		dprintf(D_MATERIALIZE | D_VERBOSE, "Materialize for cluster %d is done. LoadRowData returned %d for row %d\n", ClusterAd->jid.cluster, row_num, row);
-		factory->Pause(mmNoMoreItems);
-		return 0; 
-	}
-	// report empty vars.. do we still want to do this??
-	if ( ! empty_var_names.empty()) {
-		if (fail_empty) {
+		// if the row data is still loading, stop here and return a small value for the retry delay
+		if (factory->RowDataIsLoading(row)) {
+			retry_delay = 1;
+			break;
+		}
+
+		// all of the steps of a row share the loaded row data
+		if (row != loaded_row) {
+			std::string empty_var_names;
+			int row_num = factory->LoadRowData(row, &empty_var_names);
+			if (row_num < row) {
+				dprintf(D_MATERIALIZE | D_VERBOSE, "Materialize for cluster %d is done. LoadRowData returned %d for row %d\n", ClusterAd->jid.cluster, row_num, row);
+				factory->Pause(mmNoMoreItems);
+				break;
+			}
+			loaded_row = row;
+		}
+
+		JOB_ID_KEY jid(ClusterAd->jid.cluster, next_proc_id);
+		dprintf(D_MATERIALIZE, "Trying to Materializing new job %d.%d step=%d row=%d\n", jid.cluster, jid.proc, step, row);
+
+		txn.BeginOrContinue(jid.proc);
+
+		if ( ! num_materialized) {
+			// Calculate total submit procs taking the slice into acount. the refresh_in_ad bool will be set to
+			// true only once in the lifetime of this instance of the factory
+			bool refresh_in_ad = false;
+			int total_procs = factory->TotalProcs(refresh_in_ad);
+			if (refresh_in_ad) {
+				SetSecureAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_TOTAL_SUBMIT_PROCS, total_procs);
+			}
+		}
+
+		// have the factory make a job and give us a pointer to it.
+		// note that this ia not a transfer of ownership, the factory still owns the job and will delete it
+		const classad::ClassAd * job = factory->make_job_ad(jid, row, step, false, false, factory_check_sub_file, nullptr);
+		if ( ! job) {
 			std::string msg;
-			formatstr(msg, "job %d.%d row=%d : %s have empty values", jid.cluster, jid.proc, step, empty_var_names.c_str());
-			dprintf(D_ALWAYS, "Failing Materialize of %s\n", msg.c_str());
-			chomp(msg);
-			setJobFactoryPauseAndLog(ClusterAd, mmInvalid, 0, msg);
-			//factory->Pause(mmInvalid);
-			//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSED, mmInvalid);
-			//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSE_REASON, msg);
-			return -1;
+			std::string txt(factory->error_stack()->getFullText()); if (txt.empty()) { txt = ""; }
+			formatstr(msg, "failed to create ClassAd for Job %d.%d : %s", jid.cluster, jid.proc, txt.c_str());
+			dprintf(D_ALWAYS, "ERROR: %s", msg.c_str());
+			setJobFactoryPauseAndLog(ClusterAd, mmHold, CONDOR_HOLD_CODE::Unspecified, msg);
+			rval = -1; // failed to instantiate.
+		} else {
+			rval = NewProcFromAd(job, jid.proc, ClusterAd, 0);
+			factory->delete_job_ad();
 		}
-	}
 
-	txn.BeginOrContinue(jid.proc);
+		if (rval < 0) {
+			// a half made job must not be committed, nor the factory position past it, so
+			// throw away the whole transaction, the jobs before it in the block included.
+			txn.AbortIfAny();
+			return rval; // failed instantiation
+		}
 
-	SetAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_JOB_MATERIALIZE_NEXT_PROC_ID, next_proc_id+1);
-	if ( ! no_items && (step+1 == step_size)) {
-		int next_row = factory->NextSelectedRow(row);
-		if (next_row != item_index) {
-			SetAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_JOB_MATERIALIZE_NEXT_ROW, next_row);
+		++next_proc_id;
+		if ( ! no_items && (step+1 == step_size)) {
+			row = factory->NextSelectedRow(row);
 		}
+		++num_materialized;
 	}
 
-	// Calculate total submit procs taking the slice into acount. the refresh_in_ad bool will be set to
-	// true only once in the lifetime of this instance of the factory
-	bool refresh_in_ad = false;
-	int total_procs = factory->TotalProcs(refresh_in_ad);
-	if (refresh_in_ad) {
-		SetSecureAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_TOTAL_SUBMIT_PROCS, total_procs);
-	}
-
-	// have the factory make a job and give us a pointer to it.
-	// note that this ia not a transfer of ownership, the factory still owns the job and will delete it
-	const classad::ClassAd * job = factory->make_job_ad(jid, row, step, false, false, factory_check_sub_file, nullptr);
-	if ( ! job) {
-		std::string msg;
-		std::string txt(factory->error_stack()->getFullText()); if (txt.empty()) { txt = ""; }
-		formatstr(msg, "failed to create ClassAd for Job %d.%d : %s", jid.cluster, jid.proc, txt.c_str());
-		dprintf(D_ALWAYS, "ERROR: %s", msg.c_str());
-		setJobFactoryPauseAndLog(ClusterAd, mmHold, CONDOR_HOLD_CODE::Unspecified, msg);
-		//factory->Pause(mmHold);
-		//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSED, mmHold);
-		//ClusterAd->Assign(ATTR_JOB_MATERIALIZE_PAUSE_REASON, msg);
-		rval = -1; // failed to instantiate.
-	} else {
-		rval = NewProcFromAd(job, jid.proc, ClusterAd, 0);
-		factory->delete_job_ad();
-	}
-	if (rval < 0) {
-		txn.AbortIfAny();
-		return rval; // failed instantiation
+	if (next_proc_id != first_proc_id) {
+		SetAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_JOB_MATERIALIZE_NEXT_PROC_ID, next_proc_id);
+		if ( ! no_items && row != item_index) {
+			SetAttributeInt(ClusterAd->jid.cluster, ClusterAd->jid.proc, ATTR_JOB_MATERIALIZE_NEXT_ROW, row);
+		}
+		if (num_materialized > 0) {
+			dprintf(D_ALWAYS, "Materialized %d new job%s %d.%d through %d.%d\n", num_materialized, num_materialized > 1 ? "s" : "",
+				ClusterAd->jid.cluster, first_proc_id, ClusterAd->jid.cluster, first_proc_id + num_materialized - 1);
+		}
 	}
 
 	// our caller will commit the transaction (if any)
 
-	return 1; // successful instantiation.
+	return num_materialized;
 }
 
 #if 0 // this is obsolete
@@ -62,6 +62,8 @@ QmgrJobUpdater::QmgrJobUpdater( ClassAd* job, const char* schedd_address )
 
 	initJobQueueAttrLists();
 
+	m_use_update_stream = param_boolean( "SHADOW_JOB_UPDATE_STREAM", true );
+
 	// finally, clear all the dirty bits on this jobAd, so we only
 	// update the queue with things that have changed after this
 	// point. 
@@ -75,6 +77,11 @@ QmgrJobUpdater::~QmgrJobUpdater()
 		daemonCore->Cancel_Timer( q_update_tid );
 		q_update_tid = -1;
 	}
+	if( m_update_sock ) {
+		daemonCore->Cancel_Socket( m_update_sock );
+		delete m_update_sock;
+		m_update_sock = nullptr;
+	}
 }
 
 
@@ -293,6 +300,7 @@ QmgrJobUpdater::updateAttr( const char *name, const char *expr, bool updateMaste
 	if (log) {
 		flags = SHOULDLOG;
 	}
+	drainUpdateStream();
 	if( ConnectQ(m_schedd_obj,SHADOW_QMGMT_TIMEOUT,false,nullptr,m_owner.c_str()) ) {
 		if( SetAttribute(cluster,p,name,expr,flags) < 0 ) {
 			err_msg = "SetAttribute() failed";
@@ -368,6 +376,15 @@ QmgrJobUpdater::updateJob( update_t type, SetAttributeFlags_t commit_flags )
 		EXCEPT( "QmgrJobUpdater::updateJob: Unknown update type (%d)!", type );
 	}
 
+		// Periodic updates go on the update stream when we can use it,
+		// anything else must not overtake what we already sent there.
+	if( type == U_PERIODIC && m_use_update_stream && m_pull_attrs.empty() ) {
+		if( streamJobUpdate() ) {
+			return true;
+		}
+	}
+	drainUpdateStream();
+
 	if (type == U_HOLD) {
 		if (!ConnectQ(m_schedd_obj, SHADOW_QMGMT_TIMEOUT, false, nullptr, m_owner.c_str()) ) {
 			return false;
@@ -459,6 +476,7 @@ QmgrJobUpdater::retrieveJobUpdates( )
 	ProcIdToStr(cluster, proc, id_str);
 	job_ids.emplace_back(id_str);
 
+	drainUpdateStream();
 	if ( !ConnectQ( m_schedd_obj, SHADOW_QMGMT_TIMEOUT, false ) ) {
 		return false;
 	}
@@ -487,6 +505,150 @@ QmgrJobUpdater::periodicUpdateQ( int /* timerID */ )
 	updateJob( U_PERIODIC, NONDURABLE );
 }
 
+bool
+QmgrJobUpdater::streamJobUpdate( )
+{
+	ClassAd delta;
+	std::vector<std::string> sent;
+
+	for ( auto itr = job_ad->dirtyBegin(); itr != job_ad->dirtyEnd(); itr++ ) {
+		if( ! common_job_queue_attrs.count(*itr) ) {
+			continue;
+		}
+		ExprTree *tree = job_ad->LookupExpr(*itr);
+		if( tree == nullptr ) {
+			continue;
+		}
+		delta.Insert( *itr, tree->Copy() );
+		sent.emplace_back( *itr );
+	}
+	if( sent.empty() ) {
+		return true;
+	}
+	delta.Assign( ATTR_CLUSTER_ID, cluster );
+	delta.Assign( ATTR_PROC_ID, proc );
+
+	if( ! m_update_sock ) {
+		m_update_sock = m_schedd_obj.reliSock( SHADOW_QMGMT_TIMEOUT );
+		if( ! m_update_sock ||
+			! m_schedd_obj.startCommand( SHADOW_JOB_UPDATE, m_update_sock, SHADOW_QMGMT_TIMEOUT ) )
+		{
+				// most likely a schedd that doesn't know the command
+			dprintf( D_ALWAYS, "QmgrJobUpdater: can't open job update stream to the "
+					 "schedd, sending periodic updates with qmgmt\n" );
+			delete m_update_sock;
+			m_update_sock = nullptr;
+			m_use_update_stream = false;
+			return false;
+		}
+		if( daemonCore->Register_Socket( m_update_sock, "<Job Update Stream>",
+				(SocketHandlercpp)&QmgrJobUpdater::updateStreamAckHandler,
+				"QmgrJobUpdater::updateStreamAckHandler", this ) < 0 )
+		{
+			delete m_update_sock;
+			m_update_sock = nullptr;
+			m_use_update_stream = false;
+			return false;
+		}
+		m_update_stream_acked = false;
+	}
+
+	m_update_sock->encode();
+	if( ! putClassAd( m_update_sock, delta ) || ! m_update_sock->end_of_message() ) {
+		dprintf( D_ALWAYS, "QmgrJobUpdater: failed to send job update on update stream\n" );
+		closeUpdateStream();
+		return false;
+	}
+	dprintf( D_FULLDEBUG, "Sent %zu attributes on job update stream\n", sent.size() );
+
+		// Don't resend these next time around, if the schedd doesn't
+		// acknowledge the update they are marked dirty again.
+	for( auto & name : sent ) {
+		job_ad->MarkAttributeClean( name );
+	}
+	m_unacked_updates.emplace_back( std::move(sent) );
+	return true;
+}
+
+bool
+QmgrJobUpdater::readUpdateStreamAck( )
+{
+	int ok = 0;
+	m_update_sock->decode();
+	if( ! m_update_sock->code(ok) || ! m_update_sock->end_of_message() ) {
+		return false;
+	}
+	if( m_unacked_updates.empty() ) {
+		dprintf( D_ALWAYS, "QmgrJobUpdater: unexpected acknowledgement on job update stream\n" );
+		return false;
+	}
+	if( ! ok ) {
+		dprintf( D_ALWAYS, "QmgrJobUpdater: schedd did not apply job update, will send it again\n" );
+		for( auto & name : m_unacked_updates.front() ) {
+			job_ad->MarkAttributeDirty( name );
+		}
+	}
+	m_unacked_updates.pop_front();
+	m_update_stream_acked = true;
+	return true;
+}
+
+int
+QmgrJobUpdater::updateStreamAckHandler( Stream * /*stream*/ )
+{
+	while( m_update_sock ) {
+		if( ! m_update_sock->msgReady() ) {
+			if( ! m_update_sock->clear_read_block_flag() ) {
+					// nothing to read and nothing on the way, the
+					// schedd closed the stream
+				closeUpdateStream();
+			}
+			break;
+		}
+		if( ! readUpdateStreamAck() ) {
+			closeUpdateStream();
+		}
+	}
+		// closeUpdateStream() has already cancelled and deleted the socket
+	return KEEP_STREAM;
+}
+
+void
+QmgrJobUpdater::drainUpdateStream( )
+{
+	while( m_update_sock && ! m_unacked_updates.empty() ) {
+		if( ! readUpdateStreamAck() ) {
+			dprintf( D_ALWAYS, "QmgrJobUpdater: lost job update stream while waiting "
+					 "for the schedd to acknowledge updates\n" );
+			closeUpdateStream();
+		}
+	}
+}
+
+void
+QmgrJobUpdater::closeUpdateStream( )
+{
+	for( auto & update : m_unacked_updates ) {
+		for( auto & name : update ) {
+			job_ad->MarkAttributeDirty( name );
+		}
+	}
+	m_unacked_updates.clear();
+
+	if( m_update_sock ) {
+		if( ! m_update_stream_acked ) {
+				// the schedd dropped the stream without ever taking an
+				// update, don't keep trying
+			dprintf( D_ALWAYS, "QmgrJobUpdater: schedd refused job update stream, "
+					 "sending periodic updates with qmgmt\n" );
+			m_use_update_stream = false;
+		}
+		daemonCore->Cancel_Socket( m_update_sock );
+		delete m_update_sock;
+		m_update_sock = nullptr;
+	}
+}
+
 bool
 QmgrJobUpdater::updateExprTree( const char *name, ExprTree* tree ) const
 {
@@ -28,6 +28,8 @@
 #include "condor_daemon_core.h"
 #include "condor_qmgr.h"
 
+#include <deque>
+
 constexpr bool USERREC_NAME_IS_FULLY_QUALIFIED = true;
 
 // What kind of update to the job queue are we performing?
@@ -112,6 +114,32 @@ private:
 		*/
 	void periodicUpdateQ( int timerID = -1 );
 
+		/** Send the dirty attributes of a periodic update on our
+			SHADOW_JOB_UPDATE stream to the schedd, opening the stream
+			if we don't have one.  The attributes are marked clean
+			when sent, and marked dirty again if the schedd does not
+			acknowledge the update.
+			@return false if the update must go through qmgmt instead
+		*/
+	bool streamJobUpdate( void );
+
+		/// Socket handler for acknowledgements on the update stream
+	int updateStreamAckHandler( Stream *stream );
+
+		/** Wait for the schedd to acknowledge every update we have
+			sent on the update stream, so that a qmgmt update that
+			follows can't be overwritten by an older streamed one.
+		*/
+	void drainUpdateStream( void );
+
+		/// Read one acknowledgement, false if the stream failed
+	bool readUpdateStreamAck( void );
+
+		/** Close the update stream, marking the attributes of any
+			unacknowledged updates dirty again.
+		*/
+	void closeUpdateStream( void );
+
 
 		/** Update a specific attribute from our job ad into the
 			queue.  This checks the type of the given ExprTree and
@@ -149,6 +177,13 @@ private:
 	int proc;
 
 	int q_update_tid;
+
+		// Long-lived SHADOW_JOB_UPDATE stream and the attributes of each
+		// update sent on it that the schedd has yet to acknowledge.
+	ReliSock *m_update_sock{nullptr};
+	std::deque<std::vector<std::string>> m_unacked_updates;
+	bool m_use_update_stream{false};
+	bool m_update_stream_acked{false};
 };	
 
 // usefull if you don't want to update the job queue
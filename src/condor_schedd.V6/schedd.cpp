@@ -332,6 +332,7 @@ schedd_runtime_probe WalkJobQ_check_for_spool_zombies_runtime;
 schedd_runtime_probe WalkJobQ_count_a_job_runtime;
 schedd_runtime_probe WalkJobQ_PeriodicExprEval_runtime;
 schedd_runtime_probe WalkJobQ_clear_autocluster_id_runtime;
+schedd_runtime_probe GetAutoCluster_resignature_runtime;
 schedd_runtime_probe WalkJobQ_add_runnable_local_jobs_runtime;
 schedd_runtime_probe WalkJobQ_fixAttrUser_runtime;
 schedd_runtime_probe WalkJobQ_updateSchedDInterval_runtime;
@@ -765,6 +766,8 @@ Scheduler::Scheduler() :
 	EnablePersistentOwnerInfo = true;
 	EnableJobQueueTimestamps = false;
 	MaxMaterializedJobsPerCluster = INT_MAX;
+	MaterializeBlockSize = 100;
+	MaterializeRate = 0;
 	MaxJobsSubmitted = INT_MAX;
 	MaxJobsPerOwner = INT_MAX;
 	MaxJobsPerSubmission = INT_MAX;
@@ -786,6 +789,7 @@ Scheduler::Scheduler() :
 	RecentlyWarnedMaxJobsRunning = true;
 	m_need_reschedule = false;
 	m_send_reschedule_timer = -1;
+	m_shadow_job_update_tid = -1;
 
 	stats.InitMain();
 
@@ -3277,13 +3281,67 @@ int Scheduler::command_query_job_aggregates(ClassAd &queryAd, Stream* stream)
 
 
 int 
-clear_autocluster_id(JobQueueJob *job, const JOB_ID_KEY & /*jid*/, void *)
+clear_autocluster_id(JobQueueJob *job, const JOB_ID_KEY & jid, void * pv)
 {
 	job->Delete(ATTR_AUTO_CLUSTER_ID);
 	job->autocluster_id = -1;
+	if (pv) {
+		// caller wants the list of jobs to re-signature
+		static_cast<std::vector<JOB_ID_KEY>*>(pv)->push_back(jid);
+	}
 	return 0;
 }
 
+void
+Scheduler::startAutoClusterResignature(std::vector<JOB_ID_KEY> && jobs)
+{
+	m_resignature_jobs = std::move(jobs);
+	m_resignature_next = 0;
+	if (m_resignature_jobs.empty() || param_integer("SCHEDD_AUTOCLUSTER_RESIGNATURE_SLICE", 50) <= 0) {
+		m_resignature_jobs.clear();
+		return;
+	}
+	dprintf(D_FULLDEBUG, "Computing autocluster ids of %zu jobs in the background\n", m_resignature_jobs.size());
+	if (m_resignature_tid < 0) {
+		m_resignature_tid = daemonCore->Register_Timer(0,
+			(TimerHandlercpp)&Scheduler::resignatureAutoClusters,
+			"Scheduler::resignatureAutoClusters", this);
+	}
+}
+
+void
+Scheduler::resignatureAutoClusters( int /* timerID */ )
+{
+	m_resignature_tid = -1;
+
+	_condor_auto_accum_runtime<schedd_runtime_probe> rt(GetAutoCluster_resignature_runtime);
+	double slice = param_integer("SCHEDD_AUTOCLUSTER_RESIGNATURE_SLICE", 50) / 1000.0;
+
+	// jobs that have an autocluster id by now, because the PrioRec array
+	// was built or the job was negotiated for, are cheap to skip.
+	size_t done = 0;
+	while (m_resignature_next < m_resignature_jobs.size()) {
+		JobQueueJob * job = GetJobAd(m_resignature_jobs[m_resignature_next++]);
+		if (job && job->autocluster_id < 0) {
+			autocluster.getAutoClusterid(job);
+		}
+		if ((++done & 0x3F) == 0 && rt.elapsed_runtime() > slice) {
+			break;
+		}
+	}
+
+	if (m_resignature_next < m_resignature_jobs.size()) {
+		m_resignature_tid = daemonCore->Register_Timer(0,
+			(TimerHandlercpp)&Scheduler::resignatureAutoClusters,
+			"Scheduler::resignatureAutoClusters", this);
+	} else {
+		dprintf(D_FULLDEBUG, "Finished computing autocluster ids of %zu jobs in the background\n", m_resignature_jobs.size());
+		m_resignature_jobs.clear();
+		m_resignature_jobs.shrink_to_fit();
+		m_resignature_next = 0;
+	}
+}
+
 	// This function, given a job, calculates the "weight", or cost
 	// of the slot for accounting purposes.  Usually the # of cpus
 double 
@@ -9048,7 +9106,9 @@ PostInitJobQueue()
 		// The below must happen _after_ InitJobQueue is called.
 	if ( scheduler.autocluster.config(scheduler.MinimalSigAttrs) ) {
 		// clear out auto cluster id attributes
-		WalkJobQueue(clear_autocluster_id);
+		std::vector<JOB_ID_KEY> jobs;
+		WalkJobQueue2(clear_autocluster_id, &jobs);
+		scheduler.startAutoClusterResignature(std::move(jobs));
 	}
 
 		//
@@ -13168,6 +13228,7 @@ Scheduler::Init()
 		////////////////////////////////////////////////////////////////////
 
     stats.Reconfig();
+    daemonCore->dc_stats.AddMetricsPool(&stats.Pool); // for the metrics endpoint
 
 	if (first_time_in_init) {
 		if (param_boolean("USE_JOBSETS", false)) {
@@ -13347,6 +13408,8 @@ Scheduler::Init()
 
 	AllowLateMaterialize = param_boolean("SCHEDD_ALLOW_LATE_MATERIALIZE", false);
 	MaxMaterializedJobsPerCluster = param_integer("MAX_MATERIALIZED_JOBS_PER_CLUSTER", MaxMaterializedJobsPerCluster);
+	MaterializeBlockSize = param_integer("SCHEDD_MATERIALIZE_BLOCK_SIZE", 100, 1);
+	MaterializeRate = param_double("SCHEDD_MATERIALIZE_RATE", 0, 0);
 	NonDurableLateMaterialize = param_boolean("SCHEDD_NON_DURABLE_LATE_MATERIALIZE", true);
 
 	m_userRecDefaultsAd.Clear();
@@ -14143,6 +14206,11 @@ Scheduler::Register()
 								  (CommandHandlercpp)&Scheduler::clear_dirty_job_attrs_handler,
 								  "clear_dirty_job_attrs_handler", this, WRITE );
 
+	daemonCore->Register_CommandWithPayload( SHADOW_JOB_UPDATE, "SHADOW_JOB_UPDATE",
+								  (CommandHandlercpp)&Scheduler::shadow_job_update_handler,
+								  "shadow_job_update_handler", this, WRITE,
+								  true /*force authentication*/);
+
 	daemonCore->Register_CommandWithPayload( EXPORT_JOBS, "EXPORT_JOBS",
 								  (CommandHandlercpp)&Scheduler::export_jobs_handler,
 								  "export_jobs_handler", this, WRITE,
@@ -14310,7 +14378,9 @@ void Scheduler::reconfig() {
 
 		// clear out auto cluster id attributes
 	if ( autocluster.config(MinimalSigAttrs) ) {
-		WalkJobQueue(clear_autocluster_id);
+		std::vector<JOB_ID_KEY> jobs;
+		WalkJobQueue2(clear_autocluster_id, &jobs);
+		startAutoClusterResignature(std::move(jobs));
 	}
 
 	timeout();
@@ -17340,6 +17410,258 @@ Scheduler::clear_dirty_job_attrs_handler(int /*cmd*/, Stream *stream)
 	return TRUE;
 }
 
+// SHADOW_JOB_UPDATE is a long-lived stream on which a shadow sends its
+// periodic job updates, each one a ClassAd holding the ClusterId and ProcId
+// of the job and the attributes that changed.  Rather than a qmgmt connection
+// and transaction per update, the updates from all shadows are collected and
+// applied in a single transaction every SCHEDD_JOB_UPDATE_COALESCE_INTERVAL
+// seconds, after which each update is acknowledged in the order received.
+// The acks are written without blocking; a stream whose shadow isn't reading
+// is handed to shadowJobUpdateAckHandler() to finish its ack when it can.
+// A shadow whose stream is refused or closed goes back to sending its updates
+// over qmgmt, so the number of streams is capped to leave file descriptors
+// for everything else.
+int
+Scheduler::shadow_job_update_handler(int /*cmd*/, Stream *stream)
+{
+	ReliSock *rsock = dynamic_cast<ReliSock *>(stream);
+	if ( ! rsock) {
+		return FALSE;
+	}
+
+		// force authentication
+	rsock->decode();
+	if( !rsock->triedAuthentication() ) {
+		CondorError errstack;
+		if( ! SecMan::authenticate_sock(rsock, WRITE, &errstack) ||
+			! rsock->getFullyQualifiedUser() )
+		{
+			dprintf( D_ALWAYS,
+					 "shadow_job_update_handler(): authentication failed: %s\n",
+					 errstack.getFullText().c_str() );
+			return FALSE;
+		}
+	}
+
+		// The updates are applied by the schedd itself, so only a queue
+		// super user (i.e. the shadow) may send them.
+	if ( ! isQueueSuperUser(EffectiveUserRec(rsock))) {
+		dprintf( D_ALWAYS,
+				 "shadow_job_update_handler(): %s is not a queue super user, refusing updates from %s\n",
+				 rsock->getFullyQualifiedUser(), rsock->peer_description() );
+		return FALSE;
+	}
+
+	int max_streams = param_integer("SCHEDD_MAX_JOB_UPDATE_STREAMS",
+			daemonCore->FileDescriptorSafetyLimit() / 2, 0);
+	std::string msg;
+	if ((int)m_shadow_job_update_streams.size() >= max_streams ||
+		daemonCore->TooManyRegisteredSockets(rsock->get_file_desc(), &msg)) {
+		dprintf( D_FULLDEBUG,
+				 "Refusing shadow job update stream from %s, %zu streams open (max %d) %s\n",
+				 rsock->peer_description(), m_shadow_job_update_streams.size(),
+				 max_streams, msg.c_str() );
+		return FALSE;
+	}
+
+	int rval = daemonCore->Register_Socket( rsock, "<Shadow Job Update>",
+			(SocketHandlercpp)&Scheduler::shadowJobUpdateSocketHandler,
+			"shadowJobUpdateSocketHandler", this );
+	if (rval < 0) {
+		dprintf( D_ALWAYS, "Failed to register shadow job update socket from %s\n",
+				 rsock->peer_description() );
+		return FALSE;
+	}
+	m_shadow_job_update_streams.insert(rsock);
+
+		// the first update may already be here
+	if (shadowJobUpdateSocketHandler(rsock) != KEEP_STREAM) {
+		daemonCore->Cancel_Socket(rsock);
+		return FALSE;
+	}
+	return KEEP_STREAM;
+}
+
+// Never blocks: msgReady() only reads what has arrived, and we take updates
+// only once a whole one is here.
+int
+Scheduler::shadowJobUpdateSocketHandler(Stream *stream)
+{
+	ReliSock *rsock = static_cast<ReliSock *>(stream);
+	while (rsock->msgReady()) {
+		if ( ! receiveShadowJobUpdate(rsock)) {
+			forgetShadowJobUpdateStream(rsock);
+			return FALSE;
+		}
+	}
+	if ( ! rsock->clear_read_block_flag()) {
+			// the shadow closed the stream, drop it, daemonCore will
+			// close the socket
+		dprintf( D_FULLDEBUG, "Shadow job update stream from %s closed\n",
+				 rsock->peer_description() );
+		forgetShadowJobUpdateStream(rsock);
+		return FALSE;
+	}
+	return KEEP_STREAM;
+}
+
+bool
+Scheduler::receiveShadowJobUpdate(ReliSock *stream)
+{
+	ClassAd delta;
+	PROC_ID job_id;
+
+	stream->decode();
+	if ( ! getClassAd(stream, delta) || ! stream->end_of_message()) {
+		dprintf( D_ALWAYS, "Failed to read shadow job update from %s, closing stream\n",
+				 stream->peer_description() );
+		return false;
+	}
+	if ( ! delta.LookupInteger(ATTR_CLUSTER_ID, job_id.cluster) ||
+		 ! delta.LookupInteger(ATTR_PROC_ID, job_id.proc)) {
+		dprintf( D_ALWAYS, "Shadow job update from %s has no job id, closing stream\n",
+				 stream->peer_description() );
+		return false;
+	}
+	delta.Delete(ATTR_CLUSTER_ID);
+	delta.Delete(ATTR_PROC_ID);
+
+		// only take updates for jobs that a shadow is running
+	bool accepted = FindSrecByProcID(job_id) != nullptr;
+	if ( ! accepted) {
+		dprintf( D_ALWAYS, "Ignoring shadow job update for job %d.%d, which has no shadow\n",
+				 job_id.cluster, job_id.proc );
+	} else {
+			// the same checks as a SetAttribute() over the shadow's
+			// qmgmt connection, since we will apply these as ourselves
+		std::vector<std::string> refused;
+		CheckShadowJobUpdate(stream, job_id, delta, refused);
+		for (const auto & name : refused) {
+			dprintf( D_ALWAYS, "Ignoring shadow update of attribute %s for job %d.%d\n",
+					 name.c_str(), job_id.cluster, job_id.proc );
+		}
+			// later updates of the same attribute replace earlier ones
+		m_shadow_job_updates[job_id].Update(delta);
+	}
+	m_shadow_job_update_acks.push_back(ShadowJobUpdateAck{ stream, job_id, accepted });
+
+	if (m_shadow_job_update_tid < 0) {
+			// shadows wait for the ack, so keep this well under
+			// SHADOW_QMGMT_TIMEOUT
+		int interval = param_integer("SCHEDD_JOB_UPDATE_COALESCE_INTERVAL", 1, 0, 30);
+		m_shadow_job_update_tid = daemonCore->Register_Timer( interval,
+				(TimerHandlercpp)&Scheduler::commitShadowJobUpdates,
+				"Scheduler::commitShadowJobUpdates", this );
+	}
+	return true;
+}
+
+void
+Scheduler::forgetShadowJobUpdateStream(Stream *stream)
+{
+	m_shadow_job_update_streams.erase(stream);
+		// updates already received are still applied, we just can't
+		// acknowledge them any more
+	std::erase_if(m_shadow_job_update_acks,
+		[stream](const ShadowJobUpdateAck & ack) { return ack.stream == stream; });
+}
+
+void
+Scheduler::commitShadowJobUpdates(int /* timerID */)
+{
+	m_shadow_job_update_tid = -1;
+
+	std::set<PROC_ID> failed;
+	if ( ! m_shadow_job_updates.empty()) {
+		int num_attrs = 0;
+		BeginTransaction();
+		for (const auto & [job_id, delta] : m_shadow_job_updates) {
+			if ( ! GetJobAd(job_id)) {
+				failed.insert(job_id);
+				continue;
+			}
+			for (const auto & [name, expr] : delta) {
+				if (SetAttribute(job_id.cluster, job_id.proc, name.c_str(), ExprTreeToString(expr)) < 0) {
+					dprintf( D_ALWAYS, "Failed to apply shadow update of %s for job %d.%d\n",
+							 name.c_str(), job_id.cluster, job_id.proc );
+					failed.insert(job_id);
+				} else {
+					++num_attrs;
+				}
+			}
+		}
+		CommitNonDurableTransactionOrDieTrying();
+		dprintf( D_FULLDEBUG, "Applied %d attributes from shadow updates of %zu jobs\n",
+				 num_attrs, m_shadow_job_updates.size() );
+		m_shadow_job_updates.clear();
+	}
+
+	std::vector<ShadowJobUpdateAck> unsent;
+	for (const auto & ack : m_shadow_job_update_acks) {
+		if (m_shadow_job_update_backlog.count(ack.stream)) {
+				// still writing an earlier ack, this one goes after it
+			unsent.push_back(ack);
+			continue;
+		}
+		int ok = ack.accepted && ! failed.count(ack.job_id);
+		ReliSock *rsock = static_cast<ReliSock *>(ack.stream);
+		rsock->encode();
+		if ( ! rsock->code(ok) || ! rsock->end_of_message_nonblocking()) {
+				// the socket handler will see the stream is gone
+			dprintf( D_FULLDEBUG, "Failed to acknowledge shadow update for job %d.%d\n",
+					 ack.job_id.cluster, ack.job_id.proc );
+			continue;
+		}
+		if (rsock->clear_backlog_flag()) {
+				// the shadow isn't reading yet; finish the ack when the
+				// stream is writable instead of blocking here
+			void *prev_entry = nullptr;
+			if (daemonCore->Register_Socket( rsock, "<Shadow Job Update>",
+					(SocketHandlercpp)&Scheduler::shadowJobUpdateAckHandler,
+					"shadowJobUpdateAckHandler", this, HANDLE_WRITE, &prev_entry ) < 0) {
+				dprintf( D_ALWAYS, "Failed to register to finish acknowledging shadow update for job %d.%d\n",
+						 ack.job_id.cluster, ack.job_id.proc );
+				continue;
+			}
+			m_shadow_job_update_backlog[rsock] = prev_entry;
+		}
+	}
+	m_shadow_job_update_acks.swap(unsent);
+}
+
+int
+Scheduler::shadowJobUpdateAckHandler(Stream *stream)
+{
+	ReliSock *rsock = static_cast<ReliSock *>(stream);
+	int rval = rsock->finish_end_of_message();
+	if (rsock->clear_backlog_flag()) {
+		return KEEP_STREAM;
+	}
+
+		// done writing, go back to reading updates from this stream
+	auto it = m_shadow_job_update_backlog.find(stream);
+	ASSERT(it != m_shadow_job_update_backlog.end());
+	daemonCore->Cancel_Socket(stream, it->second);
+	m_shadow_job_update_backlog.erase(it);
+
+	if ( ! rval) {
+		dprintf( D_FULLDEBUG, "Failed to acknowledge shadow update to %s, closing stream\n",
+				 rsock->peer_description() );
+		forgetShadowJobUpdateStream(stream);
+		return FALSE;
+	}
+
+		// acks that waited for this one
+	bool waiting = std::any_of(m_shadow_job_update_acks.begin(), m_shadow_job_update_acks.end(),
+		[stream](const ShadowJobUpdateAck & ack) { return ack.stream == stream; });
+	if (waiting && m_shadow_job_update_tid < 0) {
+		m_shadow_job_update_tid = daemonCore->Register_Timer( 0,
+				(TimerHandlercpp)&Scheduler::commitShadowJobUpdates,
+				"Scheduler::commitShadowJobUpdates", this );
+	}
+	return KEEP_STREAM;
+}
+
 int
 Scheduler::receive_startd_update(int /*cmd*/, Stream *stream) {
 	dprintf(D_COMMAND, "Schedd got update ad from local startd\n");
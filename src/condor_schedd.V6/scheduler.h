@@ -511,6 +511,11 @@ class Scheduler : public Service
 	int				release_claim_command_handler(int i, Stream * s) { release_claim(i, s); return 0; }
 
 	AutoCluster		autocluster;
+		// After the significant attributes change, compute the new
+		// autocluster ids of these jobs from a timer, a slice at a time,
+		// rather than all at once the next time the PrioRec array is built.
+	void			startAutoClusterResignature(std::vector<JOB_ID_KEY> && jobs);
+	void			resignatureAutoClusters( int timerID = -1 );
 		// send a reschedule command to the negotiatior unless we
 		// have recently sent one and not yet heard from the negotiator
 	void			sendReschedule( int timerID = -1 );
@@ -661,6 +666,8 @@ class Scheduler : public Service
 	std::string 		accountingDomain() const { return AccountingDomain; };
 	int				getMaxMaterializedJobsPerCluster() const { return MaxMaterializedJobsPerCluster; }
 	bool			getAllowLateMaterialize() const { return AllowLateMaterialize; }
+	int				getMaterializeBlockSize() const { return MaterializeBlockSize; }
+	double			getMaterializeRate() const { return MaterializeRate; }
 	bool			getNonDurableLateMaterialize() const { return NonDurableLateMaterialize; }
 	const ClassAd & getUserRecDefaultsAd() const { return m_userRecDefaultsAd; }
 	const ClassAd * getExtendedSubmitCommands() const { return &m_extendedSubmitCommands; }
@@ -785,6 +792,11 @@ private:
 	uint64_t m_negotiator_seq{0};
 	time_t m_scheduler_startup{0};
 
+	// jobs still waiting for startAutoClusterResignature to compute their autocluster id
+	std::vector<JOB_ID_KEY> m_resignature_jobs;
+	size_t m_resignature_next{0};
+	int m_resignature_tid{-1};
+
 	// We have to evaluate requirements in the listed order to maintain
 	// user sanity, so the submit requirements data structure must ordered.
 	struct SubmitRequirementsEntry {
@@ -834,6 +846,8 @@ private:
 	bool			NonDurableLateMaterialize;	// for testing, use non-durable transactions when materializing new jobs
 	bool			EnableJobQueueTimestamps;	// for testing
 	int				MaxMaterializedJobsPerCluster;
+	int				MaterializeBlockSize;	// max jobs materialized per factory block
+	double			MaterializeRate;		// target jobs per second for late materialization, 0 for no limit
 	char*			StartLocalUniverse; // expression for local jobs
 	char*			StartSchedulerUniverse; // expression for scheduler jobs
 	int				MaxRunningSchedulerJobsPerOwner;
@@ -1077,6 +1091,12 @@ private:
 		// Mark a job as clean
 	int clear_dirty_job_attrs_handler(int, Stream *stream);
 
+		// Periodic job updates streamed from shadows
+	int shadow_job_update_handler(int, Stream *stream);
+	int shadowJobUpdateSocketHandler(Stream *stream);
+	int shadowJobUpdateAckHandler(Stream *stream);
+	void commitShadowJobUpdates(int timerID = -1);
+
 		// command handlers for Lumberjack export and import
 	int export_jobs_handler(int, Stream *stream);
 	int import_exported_job_results_handler(int, Stream *stream);
@@ -1098,6 +1118,22 @@ private:
 
 	bool m_need_reschedule;
 	int m_send_reschedule_timer;
+
+		// Shadow job updates waiting for the next commitShadowJobUpdates()
+	struct ShadowJobUpdateAck {
+		Stream *stream;
+		PROC_ID job_id;
+		bool accepted;
+	};
+	std::map<PROC_ID, ClassAd> m_shadow_job_updates;
+	std::vector<ShadowJobUpdateAck> m_shadow_job_update_acks;
+	std::set<Stream *> m_shadow_job_update_streams;
+		// streams with an ack still being written, and the registration
+		// to go back to for reading updates once it is done
+	std::map<Stream *, void *> m_shadow_job_update_backlog;
+	int m_shadow_job_update_tid;
+	bool receiveShadowJobUpdate(ReliSock *stream);
+	void forgetShadowJobUpdateStream(Stream *stream);
 	Timeslice m_negotiate_timeslice;
 
 	std::vector<std::string> m_job_machine_attrs;
@@ -28,6 +28,16 @@
 #include "condor_email.h"
 #include "algorithm"
 
+	// buckets of the histograms of time spent waiting in the transfer queue
+static const time_t transfer_wait_levels[] = {
+	(time_t) 1,            (time_t)10,            //  1 Sec, 10 Sec
+	(time_t) 1 * 60,       (time_t) 5 * 60,       //  1 Min,  5 Min
+	(time_t)15 * 60,       (time_t)30 * 60,       // 15 Min, 30 Min
+	(time_t) 1 * 60*60,    (time_t) 2 * 60*60,    //  1 Hr,   2 Hr
+	(time_t) 4 * 60*60,    (time_t)12 * 60*60,    //  4 Hr,  12 Hr
+	};
+static const char transfer_wait_levels_set[] = "1Sec, 10Sec, 1Min, 5Min, 15Min, 30Min, 1Hr, 2Hr, 4Hr, 12Hr";
+
 TransferQueueRequest::TransferQueueRequest(ReliSock *sock,filesize_t sandbox_size,char const *fname,char const *jobid,char const *queue_user,bool downloading,time_t max_queue_age):
 	m_sock(sock),
 	m_queue_user(queue_user),
@@ -120,6 +130,11 @@ TransferQueueManager::TransferQueueManager() : m_round_robin_garbage_time(time(n
 	m_stat_pool.AddProbe(ATTR_TRANSFER_QUEUE_NUM_WAITING_TO_DOWNLOAD,&m_waiting_to_download_stat,nullptr,IF_BASICPUB|m_waiting_to_download_stat.PubDefault);
 	m_stat_pool.AddProbe(ATTR_TRANSFER_QUEUE_UPLOAD_WAIT_TIME,&m_upload_wait_time_stat,nullptr,IF_BASICPUB|m_upload_wait_time_stat.PubDefault);
 	m_stat_pool.AddProbe(ATTR_TRANSFER_QUEUE_DOWNLOAD_WAIT_TIME,&m_download_wait_time_stat,nullptr,IF_BASICPUB|m_download_wait_time_stat.PubDefault);
+
+	m_upload_wait_times.set_levels(transfer_wait_levels, COUNTOF(transfer_wait_levels));
+	m_download_wait_times.set_levels(transfer_wait_levels, COUNTOF(transfer_wait_levels));
+	m_stat_pool.AddProbe(ATTR_TRANSFER_QUEUE_UPLOAD_WAIT_TIMES,&m_upload_wait_times,nullptr,IF_BASICPUB|m_upload_wait_times.PubValue);
+	m_stat_pool.AddProbe(ATTR_TRANSFER_QUEUE_DOWNLOAD_WAIT_TIMES,&m_download_wait_times,nullptr,IF_BASICPUB|m_download_wait_times.PubValue);
 	RegisterStats(nullptr,m_iostats);
 }
 
@@ -200,6 +215,21 @@ TransferQueueManager::InitAndReconfig() {
 	m_max_downloads = param_integer("MAX_CONCURRENT_DOWNLOADS",100,0);
 	m_max_uploads = param_integer("MAX_CONCURRENT_UPLOADS",100,0);
 	m_default_max_queue_age = param_integer("MAX_TRANSFER_QUEUE_AGE",3600*2,0);
+	m_fair_share_by_bytes = param_boolean("TRANSFER_QUEUE_FAIR_SHARE_BY_BYTES",false);
+	m_fast_lane_max_MB = param_double("TRANSFER_QUEUE_FAST_LANE_MAX_MB",0,0);
+	m_fast_lane_max_concurrent = param_integer("TRANSFER_QUEUE_FAST_LANE_MAX_CONCURRENT",10,0);
+	if( m_fast_lane_max_concurrent == 0 ) {
+		m_fast_lane_max_MB = 0;
+	}
+
+	if( m_fast_lane_max_MB > 0 ) {
+		m_stat_pool.AddProbe(ATTR_TRANSFER_QUEUE_NUM_FAST_LANE_UPLOADING,&m_fast_lane_uploading_stat,nullptr,IF_BASICPUB|m_fast_lane_uploading_stat.PubDefault);
+		m_stat_pool.AddProbe(ATTR_TRANSFER_QUEUE_NUM_FAST_LANE_DOWNLOADING,&m_fast_lane_downloading_stat,nullptr,IF_BASICPUB|m_fast_lane_downloading_stat.PubDefault);
+	}
+	else {
+		m_stat_pool.RemoveProbe(ATTR_TRANSFER_QUEUE_NUM_FAST_LANE_UPLOADING);
+		m_stat_pool.RemoveProbe(ATTR_TRANSFER_QUEUE_NUM_FAST_LANE_DOWNLOADING);
+	}
 
 	parseThrottleConfig("FILE_TRANSFER_DISK_LOAD_THROTTLE",m_throttle_disk_load,m_disk_load_low_throttle,m_disk_load_high_throttle,m_disk_throttle_short_horizon,m_disk_throttle_long_horizon,m_throttle_disk_load_increment_wait);
 
@@ -432,7 +462,7 @@ TransferQueueManager::HandleReport( Stream *sock )
 }
 
 bool
-TransferQueueRequest::ReadReport(TransferQueueManager *manager) const
+TransferQueueRequest::ReadReport(TransferQueueManager *manager)
 {
 	std::string report;
 	m_sock->decode();
@@ -478,6 +508,8 @@ TransferQueueRequest::ReadReport(TransferQueueManager *manager) const
 	iostats.net_read = (double)recent_usec_net_read     / 1'000'000;
 	iostats.net_write = (double)recent_usec_net_write   / 1'000'000;
 
+	m_MB_transferred += ((double)recent_bytes_sent + (double)recent_bytes_received)/1024.0/1024.0;
+
 	manager->AddRecentIOStats(iostats,m_up_down_queue_user);
 	return true;
 }
@@ -696,6 +728,7 @@ TransferQueueManager::ClearTransferCounts()
 	{
 		m_queue_user.second.running = 0;
 		m_queue_user.second.idle = 0;
+		m_queue_user.second.running_MB = 0;
 		m_queue_user.second.iostats.upload_MB_waiting = 0;
 		m_queue_user.second.iostats.download_MB_waiting = 0;
 	}
@@ -706,7 +739,7 @@ TransferQueueManager::IOStatsChanged() {
 	if( m_throttle_disk_load &&
 		(m_waiting_to_upload > 0 || m_waiting_to_download > 0) &&
 		m_throttle_disk_load &&
-		m_throttle_disk_load_max_concurrency == m_uploading + m_downloading )
+		m_throttle_disk_load_max_concurrency == m_uploading + m_downloading - m_fast_lane_uploading - m_fast_lane_downloading )
 	{
 		TransferQueueChanged();
 	}
@@ -716,20 +749,35 @@ void
 TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 	int downloading = 0;
 	int uploading = 0;
+	int fast_lane_downloading = 0;
+	int fast_lane_uploading = 0;
 	bool clients_waiting = false;
 
 	m_check_queue_timer = -1;
 
 	ClearTransferCounts();
 
+		// transfers on the fast lane do not count against the concurrency limits
 	for (TransferQueueRequest *client : m_xfer_queue) {
 		if( client->m_gave_go_ahead ) {
-			GetUserRec(client->m_up_down_queue_user).running++;
+			TransferQueueUser &user = GetUserRec(client->m_up_down_queue_user);
+			user.running++;
+			user.running_MB += client->MBRemaining();
 			if( client->m_downloading ) {
-				downloading += 1;
+				if( client->m_fast_lane ) {
+					fast_lane_downloading += 1;
+				}
+				else {
+					downloading += 1;
+				}
 			}
 			else {
-				uploading += 1;
+				if( client->m_fast_lane ) {
+					fast_lane_uploading += 1;
+				}
+				else {
+					uploading += 1;
+				}
 			}
 		}
 		else {
@@ -789,14 +837,25 @@ TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 	}
 
 		// schedule new transfers
-	while( uploading < m_max_uploads || m_max_uploads <= 0 ||
-		   downloading < m_max_downloads || m_max_downloads <= 0 )
+	while( true )
 	{
 		TransferQueueRequest *best_client = nullptr;
 		int best_recency = 0;
 		unsigned int best_running_count = 0;
+		double best_running_MB = 0;
+
+		bool disk_full = m_throttle_disk_load && (uploading + downloading >= m_throttle_disk_load_max_concurrency);
+		bool upload_open = !disk_full && (uploading < m_max_uploads || m_max_uploads <= 0);
+		bool download_open = !disk_full && (downloading < m_max_downloads || m_max_downloads <= 0);
+
+			// Small transfers may go ahead past the concurrency and disk
+			// load limits, so that they are not stuck behind large ones.
+			// The disk load they add is bounded by the size of their
+			// sandboxes.  Transfers of unknown size never qualify.
+		bool upload_fast_lane = m_fast_lane_max_MB > 0 && fast_lane_uploading < m_fast_lane_max_concurrent;
+		bool download_fast_lane = m_fast_lane_max_MB > 0 && fast_lane_downloading < m_fast_lane_max_concurrent;
 
-		if( m_throttle_disk_load && (uploading + downloading >= m_throttle_disk_load_max_concurrency) ) {
+		if( !upload_open && !download_open && !upload_fast_lane && !download_fast_lane ) {
 			break;
 		}
 
@@ -804,13 +863,13 @@ TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 			if( client->m_gave_go_ahead ) {
 				continue;
 			}
-			if( (client->m_downloading && 
-				(downloading < m_max_downloads || m_max_downloads <= 0)) ||
-				((!client->m_downloading) &&
-				(uploading < m_max_uploads || m_max_uploads <= 0)) )
+			bool small = client->m_sandbox_size_MB > 0 && client->m_sandbox_size_MB <= m_fast_lane_max_MB;
+			if( (client->m_downloading && (download_open || (download_fast_lane && small))) ||
+				((!client->m_downloading) && (upload_open || (upload_fast_lane && small))) )
 			{
 				TransferQueueUser &this_user = GetUserRec(client->m_up_down_queue_user);
 				unsigned int this_user_active_count = this_user.running;
+				double this_user_active_MB = this_user.running_MB;
 				int this_user_recency = this_user.recency;
 
 				bool this_client_is_better = false;
@@ -823,6 +882,12 @@ TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 						this_client_is_better = true;
 					}
 				}
+				else if( m_fair_share_by_bytes && best_running_MB != this_user_active_MB ) {
+						// prefer users with less data left to move in their active transfers
+					if( best_running_MB > this_user_active_MB ) {
+						this_client_is_better = true;
+					}
+				}
 				else if( best_running_count > this_user_active_count ) {
 						// prefer users with fewer active transfers
 						// (only counting transfers in one direction for this comparison)
@@ -836,6 +901,7 @@ TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 				if( this_client_is_better ) {
 					best_client = client;
 					best_running_count = this_user_active_count;
+					best_running_MB = this_user_active_MB;
 					best_recency = this_user_recency;
 				}
 			}
@@ -847,10 +913,14 @@ TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 			break;
 		}
 
+		client->m_fast_lane = client->m_downloading ? !download_open : !upload_open;
+
 		dprintf(D_FULLDEBUG,
-				"TransferQueueManager: sending GoAhead to %s.\n",
+				"TransferQueueManager: sending GoAhead%s to %s.\n",
+				client->m_fast_lane ? " (fast lane)" : "",
 				client->Description() );
 
+		time_t wait_time = time(nullptr) - client->m_time_born;
 		if( !client->SendGoAhead() ) {
 			dprintf(D_FULLDEBUG,
 					"TransferQueueManager: failed to send GoAhead; "
@@ -867,11 +937,24 @@ TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 			TransferQueueUser &user = GetUserRec(client->m_up_down_queue_user);
 			user.running += 1;
 			user.idle -= 1;
+			user.running_MB += client->MBRemaining();
 			if( client->m_downloading ) {
-				downloading += 1;
+				m_download_wait_times.Add(wait_time);
+				if( client->m_fast_lane ) {
+					fast_lane_downloading += 1;
+				}
+				else {
+					downloading += 1;
+				}
 			}
 			else {
-				uploading += 1;
+				m_upload_wait_times.Add(wait_time);
+				if( client->m_fast_lane ) {
+					fast_lane_uploading += 1;
+				}
+				else {
+					uploading += 1;
+				}
 			}
 		}
 	}
@@ -904,8 +987,10 @@ TransferQueueManager::CheckTransferQueue( int /* timerID */ ) {
 		}
 	}
 
-	m_uploading = uploading;
-	m_downloading = downloading;
+	m_uploading = uploading + fast_lane_uploading;
+	m_downloading = downloading + fast_lane_downloading;
+	m_fast_lane_uploading = fast_lane_uploading;
+	m_fast_lane_downloading = fast_lane_downloading;
 
 
 	if( clients_waiting ) {
@@ -1081,6 +1166,8 @@ TransferQueueManager::UpdateIOStats( int /* timerID */ )
 	m_waiting_to_download_stat = m_waiting_to_download;
 	m_upload_wait_time_stat = m_upload_wait_time;
 	m_download_wait_time_stat = m_download_wait_time;
+	m_fast_lane_uploading_stat = m_fast_lane_uploading;
+	m_fast_lane_downloading_stat = m_fast_lane_downloading;
 	m_disk_throttle_low_stat = m_disk_load_low_throttle;
 	m_disk_throttle_high_stat = m_disk_load_high_throttle;
 	m_disk_throttle_limit_stat = m_throttle_disk_load_max_concurrency;
@@ -1176,6 +1263,7 @@ TransferQueueManager::publish(ClassAd *ad,int pubflags)
 		already_reported_idleness = true;
 	}
 
+	ad->Assign(ATTR_TRANSFER_QUEUE_WAIT_TIMES_BUCKETS, transfer_wait_levels_set);
 	m_stat_pool.Publish(*ad,pubflags);
 
 	CollectUserRecGarbage(ad);
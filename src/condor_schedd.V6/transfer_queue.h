@@ -55,7 +55,10 @@ class TransferQueueRequest {
 
 	bool SendGoAhead(XFER_QUEUE_ENUM go_ahead=XFER_QUEUE_GO_AHEAD,char const *reason=NULL);
 
-	bool ReadReport(class TransferQueueManager *manager) const;
+	bool ReadReport(class TransferQueueManager *manager);
+
+		// MB of the sandbox this transfer has yet to move, going by its I/O reports
+	double MBRemaining() const { return m_sandbox_size_MB > m_MB_transferred ? m_sandbox_size_MB - m_MB_transferred : 0; }
 
 	ReliSock *m_sock;
 	std::string m_queue_user;   // Name of file transfer queue user. (TRANSFER_QUEUE_USER_EXPR)
@@ -68,6 +71,8 @@ class TransferQueueRequest {
 	                    // to a different file without notifying us.
 	bool m_downloading; // true if client wants to download a file; o.w. upload
 	bool m_gave_go_ahead; // true if we told this client to go ahead
+	bool m_fast_lane{false}; // true if the go ahead was given past the concurrency limits
+	double m_MB_transferred{0}; // MB sent or received since the go ahead, from I/O reports
 
 	time_t m_max_queue_age; // clean transfer from queue after this time
 	                        // 0 indicates no limit
@@ -120,6 +125,10 @@ class TransferQueueManager: public Service {
 	int m_max_downloads{0}; // 0 if unlimited
 	time_t m_default_max_queue_age{0}; // 0 if unlimited
 
+	bool m_fair_share_by_bytes{false}; // balance users by MB in flight rather than transfer count
+	double m_fast_lane_max_MB{0};      // 0 if there is no fast lane
+	int m_fast_lane_max_concurrent{0}; // per direction
+
 	bool m_throttle_disk_load{false};
 	double m_disk_load_low_throttle{0};
 	double m_disk_load_high_throttle{0};
@@ -133,6 +142,8 @@ class TransferQueueManager: public Service {
 
 	int m_uploading{0};
 	int m_downloading{0};
+	int m_fast_lane_uploading{0};
+	int m_fast_lane_downloading{0};
 	int m_waiting_to_upload{0};
 	int m_waiting_to_download{0};
 	int m_upload_wait_time{0};
@@ -146,6 +157,10 @@ class TransferQueueManager: public Service {
 	stats_entry_abs<int> m_waiting_to_download_stat;
 	stats_entry_abs<int> m_upload_wait_time_stat;
 	stats_entry_abs<int> m_download_wait_time_stat;
+	stats_entry_abs<int> m_fast_lane_uploading_stat;
+	stats_entry_abs<int> m_fast_lane_downloading_stat;
+	stats_histogram<time_t> m_upload_wait_times;
+	stats_histogram<time_t> m_download_wait_times;
 
 	stats_entry_abs<double> m_disk_throttle_low_stat;
 	stats_entry_abs<double> m_disk_throttle_high_stat;
@@ -157,10 +172,11 @@ class TransferQueueManager: public Service {
 
 	class TransferQueueUser {
 	public:
-		TransferQueueUser(): running(0), idle(0), recency(0) {}
+		TransferQueueUser(): running(0), idle(0), recency(0), running_MB(0) {}
 		bool Stale(unsigned int stale_recency);
 		unsigned int running;
 		unsigned int idle;
+		double running_MB; // MB yet to be moved by running transfers
 		unsigned int recency; // round robin counter at time of last GoAhead
 		IOStats iostats;
 	};
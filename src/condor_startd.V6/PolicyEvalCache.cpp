@@ -0,0 +1,229 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_classad.h"
+#include "compat_classad_util.h"
+#include "PolicyEvalCache.h"
+
+#include <set>
+
+static bool IsLiteral(const classad::ExprTree * tree)
+{
+	switch (tree->GetKind()) {
+	case classad::ExprTree::ERROR_LITERAL:
+	case classad::ExprTree::UNDEFINED_LITERAL:
+	case classad::ExprTree::BOOLEAN_LITERAL:
+	case classad::ExprTree::INTEGER_LITERAL:
+	case classad::ExprTree::REAL_LITERAL:
+	case classad::ExprTree::RELTIME_LITERAL:
+	case classad::ExprTree::ABSTIME_LITERAL:
+	case classad::ExprTree::STRING_LITERAL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// collect the attributes that an expression depends on, following references
+// from attribute to attribute within the slot ad and the job ad.
+class PolicyDependencyWalker
+{
+public:
+	PolicyDependencyWalker(classad::ClassAd * my, classad::ClassAd * target, std::vector<PolicyEvalCache::Input> & inputs)
+		: m_inputs(inputs)
+	{
+		m_ads[0] = my;
+		m_ads[1] = target;
+	}
+
+	bool is_volatile{false};
+
+	// add an attribute of the slot ad (or job ad when in_target) to the inputs, and walk its expression
+	void AddInput(bool in_target, const std::string & attr)
+	{
+		classad::ClassAd * ad = m_ads[in_target ? 1 : 0];
+		if ( ! ad || is_volatile) return;
+
+		std::string key(in_target ? "1" : "0");
+		key += attr;
+		lower_case(key);
+		if ( ! m_seen.insert(key).second) return;
+
+		classad::ExprTree * expr = SkipExprEnvelope(ad->Lookup(attr));
+		PolicyEvalCache::Input input;
+		input.in_target = in_target;
+		input.attr = attr;
+		if (expr) { input.expr.reset(expr->Copy()); }
+		m_inputs.push_back(std::move(input));
+
+		if (expr) { Walk(expr, in_target); }
+	}
+
+	// walk an expression that lives in the slot ad (or the job ad when in_target)
+	void Walk(classad::ExprTree * tree, bool in_target)
+	{
+		if ( ! tree || is_volatile) return;
+		switch (tree->GetKind()) {
+
+		case classad::ExprTree::ERROR_LITERAL:
+		case classad::ExprTree::UNDEFINED_LITERAL:
+		case classad::ExprTree::BOOLEAN_LITERAL:
+		case classad::ExprTree::INTEGER_LITERAL:
+		case classad::ExprTree::REAL_LITERAL:
+		case classad::ExprTree::RELTIME_LITERAL:
+		case classad::ExprTree::ABSTIME_LITERAL:
+		case classad::ExprTree::STRING_LITERAL:
+			break;
+
+		case classad::ExprTree::ATTRREF_NODE: {
+			classad::ExprTree * expr = nullptr;
+			std::string attr, scope;
+			bool absolute = false;
+			((const classad::AttributeReference*)tree)->GetComponents(expr, attr, absolute);
+			if (absolute || MATCH == strcasecmp(attr.c_str(), "CurrentTime")) {
+				is_volatile = true;
+			} else if ( ! expr) {
+				// an unscoped reference resolves in our own ad first, then in the other one
+				AddInput(in_target, attr);
+				AddInput( ! in_target, attr);
+			} else if (ExprTreeIsAttrRef(expr, scope) && MATCH == strcasecmp(scope.c_str(), "MY")) {
+				AddInput(in_target, attr);
+			} else if (ExprTreeIsAttrRef(expr, scope) && MATCH == strcasecmp(scope.c_str(), "TARGET")) {
+				AddInput( ! in_target, attr);
+			} else {
+				// references into nested ads and the like are not worth following
+				is_volatile = true;
+			}
+		}
+		break;
+
+		case classad::ExprTree::OP_NODE: {
+			classad::Operation::OpKind op;
+			classad::ExprTree *t1, *t2, *t3;
+			((const classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+			Walk(t1, in_target);
+			Walk(t2, in_target);
+			Walk(t3, in_target);
+		}
+		break;
+
+		case classad::ExprTree::FN_CALL_NODE: {
+			std::string fnName;
+			std::vector<classad::ExprTree*> args;
+			((const classad::FunctionCall*)tree)->GetComponents(fnName, args);
+			if (classad::FunctionCall::IsVolatileFunction(fnName)) {
+				is_volatile = true;
+				break;
+			}
+			for (auto * arg : args) { Walk(arg, in_target); }
+		}
+		break;
+
+		case classad::ExprTree::EXPR_LIST_NODE: {
+			std::vector<classad::ExprTree*> exprs;
+			((const classad::ExprList*)tree)->GetComponents(exprs);
+			for (auto * expr : exprs) { Walk(expr, in_target); }
+		}
+		break;
+
+		case classad::ExprTree::EXPR_ENVELOPE:
+			Walk(SkipExprEnvelope(tree), in_target);
+			break;
+
+		default:
+			// nested ads (and anything we don't know about) can refer to their parent scopes
+			is_volatile = true;
+			break;
+		}
+	}
+
+private:
+	classad::ClassAd * m_ads[2];
+	std::vector<PolicyEvalCache::Input> & m_inputs;
+	std::set<std::string> m_seen;
+};
+
+
+bool
+PolicyEvalCache::Lookup(const char * expr_name, classad::ClassAd * my, classad::ClassAd * target, int & result) const
+{
+	auto found = m_entries.find(expr_name);
+	if (found == m_entries.end()) return false;
+
+	const Entry & entry = found->second;
+	if (entry.is_volatile || entry.my != my || entry.target != target) return false;
+
+	for (const auto & input : entry.inputs) {
+		classad::ClassAd * ad = input.in_target ? target : my;
+		classad::ExprTree * expr = SkipExprEnvelope(ad->Lookup(input.attr));
+		if ( ! input.expr || ! expr) {
+			if (input.expr || expr) return false;
+		} else if ( ! expr->SameAs(input.expr.get())) {
+			return false;
+		}
+	}
+
+	result = entry.result;
+	return true;
+}
+
+void
+PolicyEvalCache::Store(const char * expr_name, classad::ClassAd * my, classad::ClassAd * target, int result)
+{
+	Entry & entry = m_entries[expr_name];
+
+	// when the only inputs that changed are literals (LoadAvg, KeyboardIdle and so on),
+	// the attributes the expression depends on are the same, so just refresh their values.
+	if ( ! entry.is_volatile && entry.my == my && entry.target == target && ! entry.inputs.empty()) {
+		bool same_inputs = true;
+		for (const auto & input : entry.inputs) {
+			classad::ClassAd * ad = input.in_target ? target : my;
+			classad::ExprTree * expr = SkipExprEnvelope(ad->Lookup(input.attr));
+			if (input.expr && expr && input.expr->SameAs(expr)) continue;
+			if ( ! input.expr || ! expr || ! IsLiteral(input.expr.get()) || ! IsLiteral(expr)) {
+				same_inputs = false;
+				break;
+			}
+		}
+		if (same_inputs) {
+			for (auto & input : entry.inputs) {
+				classad::ClassAd * ad = input.in_target ? target : my;
+				classad::ExprTree * expr = SkipExprEnvelope(ad->Lookup(input.attr));
+				if ( ! input.expr->SameAs(expr)) { input.expr.reset(expr->Copy()); }
+			}
+			entry.result = result;
+			return;
+		}
+	}
+
+	entry.my = my;
+	entry.target = target;
+	entry.result = result;
+	entry.inputs.clear();
+
+	// expr_name itself is the first input, it resolves just like an unscoped reference
+	PolicyDependencyWalker walker(my, target, entry.inputs);
+	walker.AddInput(false, expr_name);
+	walker.AddInput(true, expr_name);
+	entry.is_volatile = walker.is_volatile;
+	if (entry.is_volatile) {
+		entry.inputs.clear();
+	}
+}
@@ -0,0 +1,70 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _POLICY_EVAL_CACHE_H
+#define _POLICY_EVAL_CACHE_H
+
+#include "condor_classad.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+  Remembers the result of a slot's policy expressions (START, PREEMPT, KILL, ...)
+  along with the attributes each result was computed from.  The inputs of an
+  expression are every attribute it references, directly or through other
+  attributes, in the slot ad and in the job ad.  A cached result is used for as
+  long as every input has the same expression that it had when the result was
+  computed.  Expressions that call time(), random() and the like, or that use
+  references we can't follow, are never cached.
+*/
+class PolicyEvalCache
+{
+public:
+	// returns true and sets result if expr_name has a cached result
+	// that was computed against the same ads, and none of its inputs have changed.
+	bool Lookup(const char * expr_name, classad::ClassAd * my, classad::ClassAd * target, int & result) const;
+
+	// remember the result of evaluating expr_name in the context of the given ads
+	void Store(const char * expr_name, classad::ClassAd * my, classad::ClassAd * target, int result);
+
+	void Clear() { m_entries.clear(); }
+
+private:
+	friend class PolicyDependencyWalker;
+
+	struct Input {
+		bool in_target;   // attribute of the job ad rather than the slot ad
+		std::string attr;
+		std::unique_ptr<classad::ExprTree> expr; // copy of the value when cached, NULL if the attribute was undefined
+	};
+	struct Entry {
+		classad::ClassAd * my{nullptr};
+		classad::ClassAd * target{nullptr};
+		bool is_volatile{false};
+		int result{0};
+		std::vector<Input> inputs;
+	};
+
+	std::map<std::string, Entry, classad::CaseIgnLTStr> m_entries;
+};
+
+#endif /* _POLICY_EVAL_CACHE_H */
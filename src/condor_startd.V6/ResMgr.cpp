@@ -227,6 +227,9 @@ ResMgr::init_config_classad( void )
 	if( config_classad ) delete config_classad;
 	config_classad = new ClassAd();
 
+	m_policy_eval_cache = param_boolean("STARTD_POLICY_EVAL_CACHE", true);
+	m_advertise_slot_base_ad = param_boolean("STARTD_ADVERTISE_SLOT_BASE_AD", false);
+
 		// First, bring in everything we know we need
 	configInsert( config_classad, "START", true );
 	configInsert( config_classad, "SUSPEND", true );
@@ -374,6 +377,57 @@ ResMgr::publish_daemon_ad(ClassAd & ad)
 
 }
 
+// identifies the slot base ads of this instance of the startd to the collector
+static std::string slot_base_ad_key()
+{
+	std::string key;
+	formatstr(key, "%s %lld", daemonCore->InfoCommandSinfulString(), (long long)daemonCore->getStartTime());
+	return key;
+}
+
+// The slot base ad as it is sent to the collector.  Dynamic slot ads that refer to it
+// leave out the attributes that have the same value in the base, the collector chains
+// them to the base ad so that it is held once per startd rather than once per slot.
+void
+ResMgr::publish_slot_base_ad(ClassAd & ad)
+{
+	ad.Update(*m_slot_base_ad);
+	SetMyTypeName(ad, STARTD_SLOT_BASE_ADTYPE);
+	if (Name) { ad.Assign(ATTR_NAME, Name); }
+	else { ad.Assign(ATTR_NAME, get_local_fqdn()); }
+	ad.Assign(ATTR_MY_ADDRESS, daemonCore->publicNetworkIpAddr());
+	ad.Assign(ATTR_SLOT_BASE_AD, slot_base_ad_key());
+	ad.Assign(ATTR_SLOT_BASE_AD_SEQUENCE, m_slot_base_ad_seq);
+}
+
+// remove the attributes of a slot update ad that the collector will get from the slot base ad.
+// returns false and leaves the ad alone if the base would add attributes the slot doesn't have.
+bool
+ResMgr::prune_slot_update_ad(ClassAd & ad) const
+{
+	if ( ! m_slot_base_ad) {
+		return false;
+	}
+
+	std::vector<std::string> same;
+	for (const auto & [attr, expr] : *m_slot_base_ad) {
+		ExprTree * tree = ad.LookupIgnoreChain(attr);
+		if ( ! tree) {
+			return false;
+		}
+		if (tree->SameAs(expr)) {
+			same.push_back(attr);
+		}
+	}
+
+	for (const auto & attr : same) {
+		ad.Delete(attr);
+	}
+	ad.Assign(ATTR_SLOT_BASE_AD, slot_base_ad_key());
+	ad.Assign(ATTR_SLOT_BASE_AD_SEQUENCE, m_slot_base_ad_seq);
+	return true;
+}
+
 #if HAVE_BACKFILL
 
 void
@@ -1146,12 +1200,24 @@ void ResMgr::send_updates_and_clear_dirty(int /*timerID = -1*/)
 		}
 	}
 
+	// the slot base ad is sent ahead of the first dynamic slot ad that refers to it,
+	// so a collector that restarts has it again by the next update of any d-slot
+	bool slot_base_ad_sent = false;
+
 	for(Resource* rip : slots) {
 		if ( ! rip) continue;
 		if (rip->update_is_needed() ||
 			(send_backfill_slots && rip->is_partitionable_slot() && rip->r_backfill_slot)) {
 			public_ad.Clear(); private_ad.Clear();
 			rip->get_update_ads(public_ad, private_ad); // this clears update_is_needed
+			if (m_advertise_slot_base_ad && rip->is_dynamic_slot() && prune_slot_update_ad(public_ad)) {
+				if ( ! slot_base_ad_sent) {
+					ClassAd base_ad;
+					publish_slot_base_ad(base_ad);
+					send_update(UPDATE_STARTD_AD, &base_ad, nullptr, true);
+					slot_base_ad_sent = true;
+				}
+			}
 			send_update(UPDATE_STARTD_AD, &public_ad, &private_ad, true);
 		}
 	}
@@ -1379,6 +1445,24 @@ void ResMgr::compute_static()
 			rip->r_reqexp->config();
 		}
 	}
+
+	// The machine-wide attributes are the same for every slot, so slot ads chain to
+	// a shared base ad rather than each holding a copy. The base is replaced rather than
+	// modified, so slots that have not been re-initialized yet keep the one they were built with.
+	auto base = std::make_shared<ClassAd>();
+	m_attr->publish_static(base.get());
+	publish_static(base.get());
+
+	bool same = m_slot_base_ad && m_slot_base_ad->size() == base->size();
+	for (auto it = base->begin(); same && it != base->end(); ++it) {
+		ExprTree * expr = m_slot_base_ad->LookupIgnoreChain(it->first);
+		same = expr && expr->SameAs(it->second);
+	}
+	if ( ! same) {
+		m_slot_base_ad = base;
+		++m_slot_base_ad_seq;
+		dprintf(D_FULLDEBUG, "Slot base ad %d has %d attributes\n", m_slot_base_ad_seq, (int)base->size());
+	}
 }
 
 // Called to refresh dynamic slot attributes
@@ -79,6 +79,8 @@ public:
 	stats_entry_recent<int>	total_claim_requests;
 	stats_entry_recent<int>	total_activation_requests;
 	stats_entry_recent<int> total_new_dslot_unwilling;
+	stats_entry_recent<int> policy_evals;
+	stats_entry_recent<int> policy_evals_skipped;
 	stats_entry_recent<Probe> job_busy_time;
 	stats_entry_recent<Probe> job_duration;
 
@@ -101,6 +103,8 @@ public:
 		pool.AddProbe("ClaimRequests", &total_claim_requests);
 		pool.AddProbe("ActivationRequests", &total_activation_requests);
 		pool.AddProbe("NewDSlotNotMatch", &total_new_dslot_unwilling);
+		pool.AddProbe("PolicyEvaluations", &policy_evals);
+		pool.AddProbe("PolicyEvaluationsSkipped", &policy_evals_skipped);
 
 		// publish two Miron probes, showing only XXXCount if count is zero, and
 		// also XXXMin, XXXMax and XXXAvg if count is non-zero
@@ -154,6 +158,8 @@ public:
 	void	reconfig_resources( void );
 
 	void	compute_static();
+	// machine-wide static attributes that every slot publishes, built by compute_static
+	std::shared_ptr<ClassAd> slotBaseAd() const { return m_slot_base_ad; }
 	// recompute and refresh dynamic attrs for all slots before update or policy evaluation
 	void	compute_dynamic(bool for_update);
 	// recompute and re-publish dynamic attrs on d-slot create or on any slot Activation
@@ -182,6 +188,9 @@ public:
 		// Evaluate and send updates for all resources.
 	void	eval_and_update_all( int timerID = -1 );
 
+		// Reuse the results of policy expressions whose inputs haven't changed
+	bool	policyEvalCacheEnabled() const { return m_policy_eval_cache; }
+
 		// The first one is special, since we already computed
 		// everything and we don't need to recompute anything.
 	void	update_all( int timerID = -1 );
@@ -223,6 +232,10 @@ public:
 	}
 
 private:
+	bool	m_policy_eval_cache{true};	// STARTD_POLICY_EVAL_CACHE
+	bool	m_advertise_slot_base_ad{false};	// STARTD_ADVERTISE_SLOT_BASE_AD
+	std::shared_ptr<ClassAd> m_slot_base_ad;
+	int		m_slot_base_ad_seq{0};	// incremented each time the contents of m_slot_base_ad change
 	int in_walk = 0;
 
 	// This function walks through the array of rip pointers and
@@ -292,6 +305,8 @@ public:
 	void		init_config_classad( void );
 	void		updateExtrasClassAd( ClassAd * cap );
 	void		publish_daemon_ad(ClassAd & ad);
+	void		publish_slot_base_ad(ClassAd & ad);
+	bool		prune_slot_update_ad(ClassAd & ad) const;
 	void		final_update_daemon_ad();
 
 	void		addResource( Resource* );
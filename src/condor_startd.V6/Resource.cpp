@@ -1217,6 +1217,14 @@ Resource::init_classad()
 	this->reconfig_latches();
 #endif
 
+	// keep only the attributes that differ from the machine-wide base ad that all slots share
+	r_base_ad = resmgr->slotBaseAd();
+	if (r_base_ad) {
+		r_config_classad->ChainToAd(r_base_ad.get());
+		int pruned = r_config_classad->PruneChildAd();
+		dprintf(D_FULLDEBUG, "%s shares %d attributes with the slot base ad\n", r_name, pruned);
+	}
+
 	// TODO: remove publish_dynamic here, it should happen later?
 	// Publish everything we know about.
 	this->publish_dynamic(r_classad);
@@ -1316,6 +1324,7 @@ void
 Resource::reconfig( void )
 {
 	r_attr->reconfig_DevIds(resmgr->m_attr, r_id, r_sub_id);
+	r_policy_cache.Clear();
 #if HAVE_JOB_HOOKS
 	if (m_hook_keyword) {
 		free(m_hook_keyword);
@@ -2231,8 +2240,16 @@ Resource::eval_expr( const char* expr_name, bool fatal, bool check_vanilla )
 		}
 			// otherwise, fall through and try the non-vm version
 	}
+	ClassAd * job_ad = r_cur ? r_cur->ad() : NULL;
+	if (resmgr->policyEvalCacheEnabled()) {
+		if (r_policy_cache.Lookup(expr_name, r_classad, job_ad, tmp)) {
+			resmgr->startd_stats.policy_evals_skipped += 1;
+			return tmp;
+		}
+		resmgr->startd_stats.policy_evals += 1;
+	}
 	bool btmp;
-	if( (EvalBool(expr_name, r_classad, r_cur ? r_cur->ad() : NULL , btmp) ) == 0 ) {
+	if( (EvalBool(expr_name, r_classad, job_ad, btmp) ) == 0 ) {
 		
 		char *p = param(expr_name);
 
@@ -2254,10 +2271,12 @@ Resource::eval_expr( const char* expr_name, bool fatal, bool check_vanilla )
 			EXCEPT( "Invalid evaluation of %s was marked as fatal", expr_name );
 		} else {
 				// anything else for here?
+			if (resmgr->policyEvalCacheEnabled()) { r_policy_cache.Store(expr_name, r_classad, job_ad, -1); }
 			return -1;
 		}
 	}
 		// EvalBool returned success, we can just return the value
+	if (resmgr->policyEvalCacheEnabled()) { r_policy_cache.Store(expr_name, r_classad, job_ad, (int)btmp); }
 	return (int)btmp;
 }
 
@@ -3412,7 +3431,7 @@ const char * Resource::analyze_match(
 		anaFormattingOptions fmt = { 100,
 			detail_analyze_each_sub_expr | detail_inline_std_slot_exprs | detail_smart_unparse_expr
 			| detail_suppress_tall_heading | detail_append_to_buf /* | detail_show_all_subexprs */,
-			"Requirements", "Slot", "Job" };
+			"Requirements", "Slot", "Job", 0 };
 		AnalyzeRequirementsForEachTarget(r_classad, ATTR_REQUIREMENTS, inline_attrs, jobs, buf, fmt);
 		chomp(buf); buf += "\n--------------------------\n";
 
@@ -28,6 +28,7 @@
 #include "LoadQueue.h"
 #include "cod_mgr.h"
 #include "IdDispenser.h"
+#include "PolicyEvalCache.h"
 
 #include <set>
 
@@ -409,6 +410,7 @@ public:
 	ResState*		r_state;	// Startd state object, contains state and activity
 	ClassAd*		r_config_classad; // Static/Base Resource classad (contains everything in config file)
 	ClassAd*		r_classad;  // Chained child of r_config_classad, cleaned out and rebuild frequently, publish writes into this one
+	std::shared_ptr<ClassAd> r_base_ad; // machine-wide attributes shared by all slots, parent of r_config_classad
 	Claim*			r_cur;		// Info about the current claim
 	Claim*			r_pre;		// Info about the possibly preempting claim
 	Claim*			r_pre_pre;	// Info about the preempting preempting claim
@@ -515,6 +517,7 @@ private:
 	void 	startTimerToEndCODLoadHack();
 	void	endCODLoadHack( int timerID = -1 );
 	int		eval_expr( const char* expr_name, bool fatal, bool check_vanilla );
+	PolicyEvalCache	r_policy_cache;	// results of eval_expr, reused until their inputs change
 
 	std::string m_execute_dir;
 	std::string m_execute_partition_id;
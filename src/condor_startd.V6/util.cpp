@@ -561,7 +561,11 @@ void caDeleteThruParent(ClassAd* target, const char * attr, const char * prefix)
 	target->Unchain();
 	target->Delete(new_attr);
 	if (parent) {
+		// and the parent may itself be chained to the slot base ad
+		ClassAd * base = parent->GetChainedParentAd();
+		parent->Unchain();
 		parent->Delete(new_attr);
+		if (base) { parent->ChainToAd(base); }
 		target->ChainToAd(parent);
 	}
 }
@@ -141,7 +141,11 @@ void StarterStatistics::Publish(ClassAd& ad, int flags) const {
 VanillaProc::VanillaProc(ClassAd* jobAd) : OsProc(jobAd),
 	m_memory_limit(-1),
 	isCheckpointing(false),
-	isSoftKilling(false)
+	isSoftKilling(false),
+	m_event_monitor_pid(-1),
+	m_last_event_update(0),
+	m_pending_events(0),
+	m_event_update_tid(-1)
 {
     m_statistics.Init();
 #if !defined(WIN32)
@@ -149,7 +153,15 @@ VanillaProc::VanillaProc(ClassAd* jobAd) : OsProc(jobAd),
 #endif
 }
 
-VanillaProc::~VanillaProc() {}
+VanillaProc::~VanillaProc()
+{
+	if (m_event_monitor_pid > 0) {
+		daemonCore->Monitor_Family_Events(m_event_monitor_pid, nullptr, nullptr);
+	}
+	if (m_event_update_tid != -1) {
+		daemonCore->Cancel_Timer(m_event_update_tid);
+	}
+}
 
 #ifdef LINUX
 static bool cgroup_controller_is_writeable(const std::string &controller, std::string relative_cgroup) {
@@ -740,6 +752,16 @@ VanillaProc::StartJob()
 		setupOOMScore(0,0);
 	}
 
+	// Have the job's cgroup tell us when it runs into its memory limit or
+	// stalls, instead of waiting for the next update to notice.
+	if (m_event_monitor_pid > 0) {
+		daemonCore->Monitor_Family_Events(m_event_monitor_pid, nullptr, nullptr);
+		m_event_monitor_pid = -1;
+	}
+	if (retval && daemonCore->Monitor_Family_Events(JobPid, &VanillaProc::familyEventHandler, this)) {
+		m_event_monitor_pid = JobPid;
+	}
+
 #endif
 
 	return retval;
@@ -1050,11 +1072,89 @@ VanillaProc::outOfMemoryEvent() {
 	return 0;
 }
 
+/*
+ * Called by DaemonCore when the job's cgroup has memory or cpu events.
+ * An OOM kill takes down the whole cgroup, so the reaper will follow and
+ * put the job on hold; here we just note it.  Pressure stalls are only
+ * logged, a busy machine would have every job reporting them.  When the
+ * job runs into its memory limit, which is what comes before an OOM kill,
+ * send an update now, so that the shadow and startd (and their policies)
+ * see the job's memory usage while it is happening.  Limit events that
+ * come within STARTER_EVENT_UPDATE_MIN_INTERVAL of the last such update
+ * are collected and sent in one update at the end of the interval.
+ */
+void
+VanillaProc::familyEventHandler(void *me, int pid, int events)
+{
+	VanillaProc *proc = (VanillaProc *)me;
+	if (proc->m_proc_exited || pid != proc->JobPid) {
+		return;
+	}
+
+	if (events & ProcFamilyInterface::FAMILY_EVENT_OOM_KILL) {
+		dprintf(D_ALWAYS, "The OOM killer fired in the cgroup of job pid %d\n", pid);
+		return;
+	}
+	if (events & ProcFamilyInterface::FAMILY_EVENT_MEMORY_PRESSURE) {
+		dprintf(D_FULLDEBUG, "Job pid %d is stalling on memory\n", pid);
+	}
+	if (events & ProcFamilyInterface::FAMILY_EVENT_CPU_PRESSURE) {
+		dprintf(D_FULLDEBUG, "Job pid %d is stalling on cpu\n", pid);
+	}
+	if ( ! (events & ProcFamilyInterface::FAMILY_EVENT_MEMORY_LIMIT)) {
+		return;
+	}
+
+	proc->m_pending_events |= ProcFamilyInterface::FAMILY_EVENT_MEMORY_LIMIT;
+	if (proc->m_event_update_tid != -1) {
+		// already waiting to send them
+		return;
+	}
+
+	time_t now = time(nullptr);
+	int min_interval = param_integer("STARTER_EVENT_UPDATE_MIN_INTERVAL", 60, 0);
+	time_t wait = proc->m_last_event_update + min_interval - now;
+	if (wait > 0) {
+		dprintf(D_FULLDEBUG, "Job pid %d has cgroup events, deferring the update for %d seconds\n", pid, (int)wait);
+		proc->m_event_update_tid = daemonCore->Register_Timer((int)wait, 0,
+			(TimerHandlercpp)&VanillaProc::sendEventUpdate,
+			"VanillaProc::sendEventUpdate", proc);
+		return;
+	}
+	proc->sendEventUpdate(-1);
+}
+
+void
+VanillaProc::sendEventUpdate(int /* timerID */)
+{
+	m_event_update_tid = -1;
+	int events = m_pending_events;
+	m_pending_events = 0;
+	if ( ! events || m_proc_exited) {
+		return;
+	}
+	m_last_event_update = time(nullptr);
+
+	dprintf(D_FULLDEBUG, "Job pid %d has cgroup events: memory-limit, sending an update\n", JobPid);
+	Starter->jic->periodicJobUpdate(nullptr);
+}
+
 bool
 VanillaProc::JobReaper(int pid, int status)
 {
 	dprintf(D_FULLDEBUG,"Inside VanillaProc::JobReaper()\n");
 
+	if (pid == m_event_monitor_pid) {
+		daemonCore->Monitor_Family_Events(m_event_monitor_pid, nullptr, nullptr);
+		m_event_monitor_pid = -1;
+		// the final update carries the usage the deferred one would have
+		if (m_event_update_tid != -1) {
+			daemonCore->Cancel_Timer(m_event_update_tid);
+			m_event_update_tid = -1;
+		}
+		m_pending_events = 0;
+	}
+
 	// If cgroup v2 is enabled, we'll get this high bit set in exit_status
 #ifdef LINUX
 	if (status & DC_STATUS_OOM_KILLED) {
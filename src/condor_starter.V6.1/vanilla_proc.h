@@ -145,6 +145,14 @@ private:
 
 	bool isCheckpointing;
 	bool isSoftKilling;
+
+		// memory and cpu events from the job's cgroup
+	static void familyEventHandler(void *me, int pid, int events);
+	void sendEventUpdate(int timerID = -1);
+	pid_t m_event_monitor_pid;
+	time_t m_last_event_update;
+	int m_pending_events;		// FAMILY_EVENT_* mask not sent yet
+	int m_event_update_tid;		// timer for the deferred update
 };
 
 #endif
@@ -0,0 +1,87 @@
+#!/usr/bin/env pytest
+
+#   test_collector_slot_base_ad
+#   A startd with STARTD_ADVERTISE_SLOT_BASE_AD leaves the machine-wide
+#   attributes out of its dynamic slot ads and sends them once in a slot
+#   base ad.  Check that the collector ignores a pruned slot ad whose base
+#   ad it doesn't have, rather than store it without those attributes,
+#   and that it stores the slot ad complete once the base ad has come.
+
+from ornithology import *
+import time
+
+SLOT_NAME = "slot1_1@slotbase.test"
+BASE_KEY = "<127.0.0.1:1> 1700000000"
+
+BASE_AD = f"""MyType = "Slot.Base"
+Name = "slotbase.test"
+MyAddress = "<127.0.0.1:1>"
+SlotBaseAd = "{BASE_KEY}"
+SlotBaseAdSequence = 1
+OpSys = "SLOTBASETEST"
+"""
+
+SLOT_AD = f"""MyType = "Machine"
+Name = "{SLOT_NAME}"
+Machine = "slotbase.test"
+MyAddress = "<127.0.0.1:1>"
+StartdIpAddr = "<127.0.0.1:1>"
+SlotID = 1
+SlotDynamic = true
+Cpus = 1
+SlotBaseAd = "{BASE_KEY}"
+SlotBaseAdSequence = 1
+"""
+
+#--------------------------------------------------------------------------------------------
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", config={
+        "COLLECTOR_DEBUG": "D_FULLDEBUG",
+    }) as condor:
+        yield condor
+
+def advertise(condor, path, text):
+    path.write_text(text)
+    return condor.run_command(["condor_advertise", "-multiple", "UPDATE_STARTD_AD", path.as_posix()])
+
+def slot_ads(condor):
+    return condor.status(ad_type=htcondor.AdTypes.Startd, constraint=f'Name == "{SLOT_NAME}"')
+
+@action
+def pruned_without_base(condor, test_dir):
+    start = time.time()
+    p = advertise(condor, test_dir / "pruned.ad", SLOT_AD)
+    assert p.returncode == 0
+    deadline = time.time() + 20
+    while True:
+        messages = [entry.message for entry in condor.collector_log.open().read()
+                    if entry.timestamp.timestamp() >= int(start)]
+        if any("is unknown, ignoring the slot ad" in m for m in messages) or time.time() > deadline:
+            return (messages, slot_ads(condor))
+        time.sleep(1)
+
+@action
+def slot_ad_after_base(condor, test_dir, pruned_without_base):
+    p = advertise(condor, test_dir / "base_and_slot.ad", BASE_AD + "\n" + SLOT_AD)
+    assert p.returncode == 0
+    deadline = time.time() + 20
+    while True:
+        ads = slot_ads(condor)
+        if ads or time.time() > deadline:
+            return ads
+        time.sleep(1)
+
+#--------------------------------------------------------------------------------------------
+class TestCollectorSlotBaseAd:
+    def test_pruned_ad_without_base_is_ignored(self, pruned_without_base):
+        messages, ads = pruned_without_base
+        assert any("is unknown, ignoring the slot ad" in m for m in messages)
+        assert len(ads) == 0
+
+    def test_slot_ad_after_base_is_complete(self, slot_ad_after_base):
+        assert len(slot_ad_after_base) == 1
+        ad = slot_ad_after_base[0]
+        assert ad["OpSys"] == "SLOTBASETEST"
+        assert ad["Cpus"] == 1
+        assert "SlotBaseAd" not in ad
@@ -0,0 +1,61 @@
+#!/usr/bin/env pytest
+
+#   test_command_keep_alive
+#   A client that asks for it can send another command on the same TCP
+#   connection once its command is done.  Check that such a connection
+#   is reused, and that the daemon hangs up rather than handle a command
+#   on it that does not establish its own security session, so that it
+#   can't run as whoever sent the command before it.
+
+from ornithology import *
+import time
+
+#--------------------------------------------------------------------------------------------
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", config={
+        "COMMAND_CONNECTION_IDLE_TIMEOUT": 60,
+        "COLLECTOR_DEBUG": "D_COMMAND D_FULLDEBUG",
+    }) as condor:
+        yield condor
+
+@action
+def reuse(condor):
+    return condor.run_command(["x_command_keep_alive.exe", "reuse"])
+
+@action
+def bare(condor):
+    start = time.time()
+    p = condor.run_command(["x_command_keep_alive.exe", "bare"])
+    return (p, start)
+
+@action
+def collector_messages(condor, bare):
+    _, start = bare
+    # the collector may still be logging why it hung up
+    deadline = time.time() + 20
+    while True:
+        messages = [entry.message for entry in condor.collector_log.open().read()
+                    if entry.timestamp.timestamp() >= int(start)]
+        if any("does not start a security session" in m for m in messages) or time.time() > deadline:
+            return messages
+        time.sleep(1)
+
+#--------------------------------------------------------------------------------------------
+class TestCommandKeepAlive:
+
+    def test_connection_reused(self, reuse):
+        print(reuse.stdout)
+        assert reuse.returncode == 0
+        assert "PASS" in reuse.stdout
+
+    def test_bare_command_closes_connection(self, bare):
+        p, _ = bare
+        print(p.stdout)
+        assert p.returncode == 0
+        assert "PASS" in p.stdout
+
+    def test_bare_command_not_handled(self, collector_messages):
+        assert any("does not start a security session" in m for m in collector_messages)
+        assert not any(m.startswith("Calling HandleReq") and "(DC_NOP_ADMINISTRATOR)" in m
+                       for m in collector_messages)
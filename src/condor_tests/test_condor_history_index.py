@@ -0,0 +1,132 @@
+#!/usr/bin/env pytest
+
+#   test_condor_history_index
+#   The schedd writes a sidecar index (.<history>.idx) next to its history
+#   file, and condor_history uses it to seek straight to the ads of the
+#   jobs or owners a query asks for.  This test has the schedd write some
+#   history, then checks that condor_history gives exactly the same output
+#   with the index as without it, in particular for -since and -scanlimit,
+#   which count every ad in the file and not just the ones the index picks.
+
+from ornithology import *
+import os
+import time
+
+CLUSTERS = [ (1, 1), (2, 3), (3, 1), (4, 2), (5, 5) ] # (Beers, number of procs)
+
+#--------------------------------------------------------------------------------------------
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", config={"ENABLE_HISTORY_INDEX": True}) as condor:
+        yield condor
+
+#--------------------------------------------------------------------------------------------
+# Submit held jobs and remove them, so the schedd writes them to its history
+@action
+def history_file(condor, path_to_sleep):
+    clusters = []
+    for beers, procs in CLUSTERS:
+        handle = condor.submit(
+            {
+                "executable": path_to_sleep,
+                "arguments": "0",
+                "hold": "true",
+                "+Beers": str(beers),
+            },
+            count=procs,
+        )
+        clusters.append(handle.clusterid)
+        handle.remove()
+
+    deadline = time.time() + 60
+    while time.time() < deadline:
+        if len(condor.query(projection=["ClusterId"])) == 0:
+            break
+        time.sleep(1)
+
+    history = condor.run_command(["condor_config_val", "HISTORY"]).stdout.strip()
+    return (history, clusters)
+
+@action
+def index_file(history_file):
+    history, _ = history_file
+    return os.path.join(os.path.dirname(history), "." + os.path.basename(history) + ".idx")
+
+# condor_history arguments, {cN} is the Nth cluster submitted
+QUERIES = {
+    "cluster"        : "{c1}",
+    "job"            : "{c4}.3",
+    "jobs"           : "{c0} {c3}.1",
+    "constraint"     : "-const ClusterId=={c1}||ClusterId=={c3}",
+    "constraint_mix" : "-const ClusterId=={c1}&&Beers>=2",
+    "forwards"       : "{c1} -forwards",
+    "match"          : "{c4} -match 2",
+    # -since stops at an ad the index would not have read
+    "since"          : "{c1} -since {c3}.0",
+    "since_expr"     : "{c1} -since Beers==3",
+    "since_forwards" : "{c4} -forwards -since {c2}.0",
+    # -scanlimit counts ads read, wanted or not
+    "scanlimit"      : "{c1} -scanlimit 4",
+    "scanlimit_all"  : "{c1} -scanlimit 100",
+    "scanlimit_const": "-const ClusterId=={c0} -scanlimit 6",
+    "completedsince" : "{c1} -completedsince 1",
+}
+
+@action
+def queries(history_file):
+    _, clusters = history_file
+    ids = {f"c{ix}": cid for ix, cid in enumerate(clusters)}
+    return {name: args.format(**ids) for name, args in QUERIES.items()}
+
+def run_history(condor, history, args):
+    cmd = ["condor_history"] + args.split() + ["-file", history, "-af", "ClusterId", "ProcId", "Beers"]
+    p = condor.run_command(cmd)
+    return p.stdout + p.stderr
+
+# Run every query with the index, then again without it
+@action
+def outputs(condor, history_file, index_file, queries):
+    history, _ = history_file
+    results = {}
+    for name, args in queries.items():
+        results[name] = [run_history(condor, history, args)]
+    os.rename(index_file, index_file + ".hidden")
+    try:
+        for name, args in queries.items():
+            results[name].append(run_history(condor, history, args))
+    finally:
+        os.rename(index_file + ".hidden", index_file)
+    return results
+
+@action(params={name: name for name in QUERIES})
+def query_name(request):
+    return request.param
+
+#--------------------------------------------------------------------------------------------
+class TestCondorHistoryIndex:
+
+    def test_index_written(self, history_file, index_file):
+        num_ads = sum(procs for _, procs in CLUSTERS)
+        assert os.path.exists(index_file)
+        with open(index_file, "r") as f:
+            lines = f.readlines()
+        # a header line, then a record per ad
+        assert lines[0].startswith("# HTCondor history index")
+        assert len(lines) == num_ads + 1
+
+    def test_index_output_matches_scan(self, outputs, queries, query_name):
+        indexed, scanned = outputs[query_name]
+        print(f"\ncondor_history {queries[query_name]}\nindexed:\n{indexed}\nscanned:\n{scanned}")
+        assert "Error" not in scanned
+        assert indexed == scanned
+
+    def test_since_stops_at_ad_outside_query(self, outputs):
+        # the -since job is newer than the queried cluster, so nothing is printed
+        indexed, scanned = outputs["since"]
+        assert indexed.strip() == ""
+        assert scanned.strip() == ""
+
+    def test_scanlimit_counts_every_ad(self, outputs):
+        # the last four ads in the file belong to the last cluster
+        indexed, _ = outputs["scanlimit"]
+        assert indexed.strip() == ""
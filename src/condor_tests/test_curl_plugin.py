@@ -15,8 +15,13 @@
 
 import logging
 import os
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
 from pathlib import Path
 
+import classad
+import htcondor
 from pytest_httpserver import HTTPServer
 
 from ornithology import (
@@ -25,6 +30,7 @@ from ornithology import (
     action,
     JobStatus,
     ClusterState,
+    SetEnv,
 )
 
 
@@ -170,6 +176,147 @@ def job_with_multiple_bad_urls(default_condor, multiple_bad_urls, test_dir, path
     return job
 
 
+# A keep-alive HTTP/1.1 server for running the plugin against directly.  It
+# keeps track of how many requests are in flight at once, which connections
+# they came in on, and the Range of each request, by path.  /resume/ paths
+# send half of the file and drop the connection the first time they are
+# asked for the whole file, so that the plugin has to retry and resume.
+class PluginTestHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):
+        pass
+
+    def do_GET(self):
+        server = self.server
+        body = server.content(self.path)
+        range_header = self.headers.get("Range")
+        with server.lock:
+            server.connections.setdefault(self.path, set()).add(self.client_address)
+            server.ranges.setdefault(self.path, []).append(range_header)
+            server.active += 1
+            server.peak_active[self.path.split("/")[1]] = max(
+                server.peak_active.get(self.path.split("/")[1], 0), server.active
+            )
+            first_try = self.path not in server.tried
+            server.tried.add(self.path)
+        try:
+            if range_header is not None:
+                first, _, last = range_header[len("bytes="):].partition("-")
+                last = int(last) if last else len(body) - 1
+                self.send_response(206)
+                self.send_header("Content-Range", "bytes {}-{}/{}".format(first, last, len(body)))
+                body = body[int(first):last + 1]
+            else:
+                self.send_response(200)
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.flush()
+
+            # Hold the transfer open long enough for the plugin to start others.
+            time.sleep(0.5)
+            if self.path.startswith("/resume/") and range_header is None and first_try:
+                self.wfile.write(body[:len(body) // 2])
+                self.wfile.flush()
+                self.close_connection = True
+                return
+            self.wfile.write(body)
+        finally:
+            with server.lock:
+                server.active -= 1
+
+
+class PluginTestServer(ThreadingHTTPServer):
+    daemon_threads = True
+
+    def __init__(self):
+        super().__init__(("127.0.0.1", 0), PluginTestHandler)
+        self.lock = threading.Lock()
+        self.active = 0
+        self.peak_active = {}
+        self.connections = {}
+        self.ranges = {}
+        self.tried = set()
+
+    @staticmethod
+    def content(path):
+        return (path * 512).encode()
+
+    def url(self, path):
+        return "http://127.0.0.1:{}{}".format(self.server_address[1], path)
+
+
+@action
+def plugin_server():
+    server = PluginTestServer()
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+    yield server
+    server.shutdown()
+    server.server_close()
+
+
+@action
+def curl_plugin_path(default_condor):
+    with default_condor.use_config():
+        return Path(htcondor.param["LIBEXEC"]) / "curl_plugin"
+
+
+# Download the given paths from the test server in one run of the plugin,
+# and return its exit code, the downloaded files and its stats ads.
+def run_curl_plugin(condor, plugin, server, test_dir, name, paths, max_concurrent):
+    run_dir = test_dir / name
+    run_dir.mkdir()
+    infile = run_dir / "infile"
+    outfile = run_dir / "outfile"
+    ads = []
+    for ix, path in enumerate(paths):
+        ad = classad.ClassAd()
+        ad["Url"] = server.url(path)
+        ad["LocalFileName"] = (run_dir / "file{}".format(ix)).as_posix()
+        ads.append(str(ad))
+    infile.write_text("".join(ads))
+
+    with SetEnv({"CONDOR_CURL_MAX_CONCURRENT_TRANSFERS": str(max_concurrent)}):
+        rv = condor.run_command([plugin, "-infile", infile, "-outfile", outfile], timeout=120)
+    files = [(run_dir / "file{}".format(ix)) for ix in range(len(paths))]
+    stats = list(classad.parseAds(outfile.read_text(), classad.ParserType.New))
+    return rv.returncode, files, stats
+
+
+@action
+def concurrent_paths():
+    return ["/concurrent/file{}".format(ix) for ix in range(8)]
+
+
+@action
+def concurrent_run(default_condor, curl_plugin_path, plugin_server, test_dir, concurrent_paths):
+    return run_curl_plugin(default_condor, curl_plugin_path, plugin_server, test_dir,
+                           "concurrent", concurrent_paths, 4)
+
+
+@action
+def serial_paths():
+    return ["/serial/file{}".format(ix) for ix in range(3)]
+
+
+@action
+def serial_run(default_condor, curl_plugin_path, plugin_server, test_dir, serial_paths):
+    return run_curl_plugin(default_condor, curl_plugin_path, plugin_server, test_dir,
+                           "serial", serial_paths, 1)
+
+
+@action
+def resume_paths():
+    return ["/resume/file0", "/resume-others/file1", "/resume-others/file2"]
+
+
+@action
+def resume_run(default_condor, curl_plugin_path, plugin_server, test_dir, resume_paths):
+    return run_curl_plugin(default_condor, curl_plugin_path, plugin_server, test_dir,
+                           "resume", resume_paths, 4)
+
+
 class TestCurlPlugin:
     def test_job_with_good_url_succeeds(self, job_with_good_url):
         assert job_with_good_url.state[0] == JobStatus.COMPLETED
@@ -193,6 +340,13 @@ class TestCurlPlugin:
     def test_job_with_multiple_good_urls_succeeds(self, job_with_multiple_good_urls):
         assert job_with_multiple_good_urls.state[0] == JobStatus.COMPLETED
 
+    # The plugin downloads these concurrently, make sure each landed in its own file
+    def test_job_with_multiple_good_urls_file_contents_are_correct(
+        self, job_with_multiple_good_urls, test_dir
+    ):
+        for name in ["goodurl1", "goodurl2", "goodurl3"]:
+            assert Path(name).read_text() == name
+
     def test_job_with_multiple_good_urls_invokes_plugin_once(self, job_with_multiple_good_urls, slot2_starter_log):
         plugin_invocations = 0
         for line in slot2_starter_log:
@@ -202,3 +356,56 @@ class TestCurlPlugin:
 
     def test_job_with_multiple_bad_urls_holds(self, job_with_multiple_bad_urls):
         assert job_with_multiple_bad_urls.state[0] == JobStatus.HELD
+
+    def test_concurrent_run_succeeds(self, concurrent_run, concurrent_paths):
+        rv, files, stats = concurrent_run
+        assert rv == 0
+        for path, f in zip(concurrent_paths, files):
+            assert f.read_bytes() == PluginTestServer.content(path)
+
+    # Stats come back one per file, in the order the files were requested
+    def test_concurrent_run_stats_in_request_order(self, concurrent_run):
+        rv, files, stats = concurrent_run
+        assert [ad["TransferFileName"] for ad in stats] == [f.as_posix() for f in files]
+        for ad in stats:
+            assert ad["TransferSuccess"] == True
+            assert ad["DeveloperData"]["TransferTries"] == 1
+
+    def test_concurrent_run_limits_concurrency(self, concurrent_run, plugin_server):
+        assert 1 < plugin_server.peak_active["concurrent"] <= 4
+
+    def test_concurrent_run_reuses_connections(self, concurrent_run, plugin_server, concurrent_paths):
+        rv, files, stats = concurrent_run
+        for ad in stats:
+            assert ad["DeveloperData"]["HttpVersion"] == "1.1"
+        # eight files over at most four connections
+        assert any(ad["DeveloperData"]["ConnectionReused"] for ad in stats)
+        connections = set()
+        for path in concurrent_paths:
+            connections |= plugin_server.connections[path]
+        assert len(connections) <= 4
+
+    def test_serial_run_transfers_one_at_a_time(self, serial_run, plugin_server, serial_paths):
+        rv, files, stats = serial_run
+        assert rv == 0
+        for path, f in zip(serial_paths, files):
+            assert f.read_bytes() == PluginTestServer.content(path)
+        assert plugin_server.peak_active["serial"] == 1
+
+    def test_resume_run_succeeds(self, resume_run, resume_paths):
+        rv, files, stats = resume_run
+        assert rv == 0
+        for path, f in zip(resume_paths, files):
+            assert f.read_bytes() == PluginTestServer.content(path)
+
+    # The dropped download is retried from where it left off, after the
+    # plugin checks that the server supports Range requests.
+    def test_resume_run_resumes_partial_download(self, resume_run, plugin_server, resume_paths):
+        rv, files, stats = resume_run
+        half = len(PluginTestServer.content(resume_paths[0])) // 2
+        assert plugin_server.ranges[resume_paths[0]] == [None, "bytes=0-0", "bytes={}-".format(half)]
+        assert stats[0]["TransferSuccess"] == True
+        assert stats[0]["DeveloperData"]["TransferTries"] == 2
+        for ad in stats[1:]:
+            assert ad["TransferSuccess"] == True
+            assert ad["DeveloperData"]["TransferTries"] == 1
@@ -0,0 +1,95 @@
+#!/usr/bin/env pytest
+
+#   test_dagman_batch_direct_submit
+#   With DAGMAN_BATCH_DIRECT_SUBMIT, DAGMan queues all of the nodes that
+#   are ready in a submit cycle in a single schedd transaction.  Check
+#   that when one node fails to queue, or the schedd rejects the whole
+#   transaction because of one node, the other nodes of the batch are
+#   still submitted and run, and only the bad node fails.
+
+from ornithology import *
+import htcondor
+import os
+
+#--------------------------------------------------------------------------
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", config={
+            "DAGMAN_USE_DIRECT_SUBMIT" : True,
+            "DAGMAN_BATCH_DIRECT_SUBMIT" : True,
+            "DAGMAN_PROHIBIT_MULTI_JOBS" : True,
+            "DAGMAN_MAX_SUBMIT_ATTEMPTS" : 1,
+            "SUBMIT_REQUIREMENT_NAMES" : "NoBad",
+            "SUBMIT_REQUIREMENT_NoBad" : "Bad =!= true"}) as condor:
+        yield condor
+
+#--------------------------------------------------------------------------
+def write_dag(test_dir, name, path_to_sleep, bad_node):
+    dag_dir = test_dir / name
+    dag_dir.mkdir()
+    write_file(dag_dir / "good.sub", f"""
+executable = {path_to_sleep}
+arguments  = 0
+log        = $(JOB).log
+queue
+""")
+    write_file(dag_dir / "bad.sub", f"""
+executable = {path_to_sleep}
+arguments  = 0
+log        = $(JOB).log
+{bad_node}
+""")
+    # A and B are ready before C, so they are queued in the batch first
+    return write_file(dag_dir / f"{name}.dag", """
+JOB A good.sub
+JOB B good.sub
+JOB C bad.sub
+""")
+
+def run_dag(condor, dag_file):
+    cwd = os.getcwd()
+    os.chdir(dag_file.parent)
+    try:
+        dag = htcondor.Submit.from_dag(dag_file.name)
+        dagman_job = condor.submit(dag)
+    finally:
+        os.chdir(cwd)
+    assert dagman_job.wait(condition=ClusterState.all_complete, timeout=90)
+    return dag_file
+
+def done_nodes(dag_file):
+    rescue_file = dag_file.parent / (dag_file.name + ".rescue001")
+    assert rescue_file.exists()
+    return {line.split()[1] for line in rescue_file.read_text().splitlines()
+            if line.startswith("DONE ")}
+
+def dagman_out(dag_file):
+    return (dag_file.parent / (dag_file.name + ".dagman.out")).read_text()
+
+#--------------------------------------------------------------------------
+@action
+def queue_failure_dag(condor, test_dir, path_to_sleep):
+    # Two procs, which DAGMAN_PROHIBIT_MULTI_JOBS fails after the node's
+    # cluster is already part of the batch transaction
+    dag_file = write_dag(test_dir, "queue_failure", path_to_sleep, "queue 2")
+    return run_dag(condor, dag_file)
+
+@action
+def rejected_dag(condor, test_dir, path_to_sleep):
+    # Queues fine, but the schedd's submit requirement rejects the commit
+    dag_file = write_dag(test_dir, "rejected", path_to_sleep, "My.Bad = true\nqueue")
+    return run_dag(condor, dag_file)
+
+#==========================================================================
+class TestDAGManBatchDirectSubmit:
+    def test_queue_failure_falls_back(self, queue_failure_dag):
+        assert "Node C failed to queue in the submit batch, submitting the 2 nodes queued before it one at a time" in dagman_out(queue_failure_dag)
+
+    def test_queue_failure_other_nodes_run(self, queue_failure_dag):
+        assert done_nodes(queue_failure_dag) == {"A", "B"}
+
+    def test_rejected_batch_falls_back(self, rejected_dag):
+        assert "Schedd rejected batched submission" in dagman_out(rejected_dag)
+
+    def test_rejected_batch_other_nodes_run(self, rejected_dag):
+        assert done_nodes(rejected_dag) == {"A", "B"}
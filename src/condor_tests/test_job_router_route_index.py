@@ -0,0 +1,126 @@
+#!/usr/bin/env pytest
+
+#   test_job_router_route_index
+#   The job router indexes the Attr == "value" and bare Attr conjuncts of
+#   each route's Requirements, so that a job those rule out is never
+#   tested against the route, and remembers which routes jobs with the
+#   same values matched.  Check with condor_job_router_info that jobs
+#   still go to the right routes, that MY-scoped conjuncts are indexed,
+#   that jobs with the same values reuse the decisions, and that a route
+#   calling time() is evaluated for every job.
+
+from ornithology import *
+
+import re
+import logging
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+ROUTE_CONFIG = """
+JOB_ROUTER_ROUTE_NAMES = Alpha Beta Gamma
+
+JOB_ROUTER_ROUTE_Alpha @=rt
+  UNIVERSE vanilla
+  REQUIREMENTS Owner == "alice" && WantJobRouter
+  SET RouteName "Alpha"
+@rt
+
+JOB_ROUTER_ROUTE_Beta @=rt
+  UNIVERSE vanilla
+  REQUIREMENTS MY.AcctGroup == "physics" && WantJobRouter
+  SET RouteName "Beta"
+@rt
+
+JOB_ROUTER_ROUTE_Gamma @=rt
+  UNIVERSE vanilla
+  REQUIREMENTS WantJobRouter && time() > 0
+  SET RouteName "Gamma"
+@rt
+"""
+
+JOBS = [
+    ("1.0", 'Owner = "alice"'),
+    ("1.1", 'Owner = "alice"'),
+    ("2.0", 'Owner = "bob"\nAcctGroup = "physics"'),
+    ("3.0", 'Owner = "carol"'),
+    ("3.1", 'Owner = "carol"'),
+]
+
+
+#--------------------------------------------------------------------------------------------
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", raw_config=ROUTE_CONFIG) as condor:
+        yield condor
+
+@action
+def job_ads_file(test_dir):
+    ads = []
+    for job_id, attrs in JOBS:
+        cluster, proc = job_id.split(".")
+        ads.append(f"""ClusterId = {cluster}
+ProcId = {proc}
+JobStatus = 1
+JobUniverse = 5
+WantJobRouter = true
+{attrs}
+""")
+    return write_file(test_dir / "jobs.ads", "\n".join(ads))
+
+@action
+def router_output(condor, job_ads_file):
+    p = condor.run_command(["condor_job_router_info", "-match-jobs", "-diagnostic",
+                            "-jobads", job_ads_file.as_posix()])
+    logger.debug(p.stdout)
+    return p.stdout
+
+@action
+def matched_routes(router_output):
+    matches = {}
+    job = None
+    for line in router_output.splitlines():
+        m = re.search(r"Checking Job src=(\S+)", line)
+        if m:
+            job = m.group(1)
+            continue
+        m = re.search(r"Route Matches: (\S+)", line)
+        if m and job is not None:
+            matches.setdefault(job, []).append(m.group(1))
+    return matches
+
+@action
+def pass_stats(router_output):
+    m = re.search(r"(\d+) jobs tested, (\d+) with known route decisions, "
+                  r"(\d+) route evaluations, (\d+) routes ruled out by the index", router_output)
+    assert m is not None
+    tested, known, evaluated, skipped = (int(g) for g in m.groups())
+    return {"tested": tested, "known": known, "evaluated": evaluated, "skipped": skipped}
+
+#--------------------------------------------------------------------------------------------
+class TestJobRouterRouteIndex:
+
+    def test_jobs_match_expected_routes(self, matched_routes):
+        assert matched_routes == {
+            "1.0": ["Alpha"],
+            "1.1": ["Alpha"],
+            "2.0": ["Beta"],
+            "3.0": ["Gamma"],
+            "3.1": ["Gamma"],
+        }
+
+    def test_every_job_tested(self, pass_stats):
+        assert pass_stats["tested"] == len(JOBS)
+
+    def test_decisions_reused(self, pass_stats):
+        # 1.1 and 3.1 have the same values as 1.0 and 3.0
+        assert pass_stats["known"] == 2
+
+    def test_index_rules_out_routes(self, pass_stats):
+        # Alpha for 2.0, and Alpha and the MY-scoped Beta for 3.0
+        assert pass_stats["skipped"] == 3
+
+    def test_volatile_route_always_evaluated(self, pass_stats):
+        # Alpha for 1.0, Beta for 2.0, and Gamma for both 3.0 and 3.1
+        assert pass_stats["evaluated"] == 4
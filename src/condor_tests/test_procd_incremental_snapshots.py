@@ -0,0 +1,132 @@
+#!/usr/bin/env pytest
+
+#   test_procd_incremental_snapshots
+#   With PROCD_FULL_SNAPSHOT_INTERVAL set, the procd's snapshots between
+#   full scans only look at the processes in the families it tracks and
+#   their children.  Check that it takes such snapshots, that a job's
+#   processes are still tracked by them, and that removing the job still
+#   kills a process that has left the job's process tree, which only a
+#   full scan can find.
+
+from ornithology import *
+
+import os
+import time
+import logging
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+def pid_alive(pid):
+    try:
+        os.kill(pid, 0)
+    except ProcessLookupError:
+        return False
+    except PermissionError:
+        return True
+    return True
+
+
+def read_pid(path):
+    try:
+        return int(path.read_text().strip())
+    except (OSError, ValueError):
+        return None
+
+
+#--------------------------------------------------------------------------------------------
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", config={
+        # track the job with the procd rather than a cgroup
+        "BASE_CGROUP": "",
+        "PROCD_LOG": "$(LOG)/ProcLog",
+        "PROCD_MAX_SNAPSHOT_INTERVAL": 2,
+        "PROCD_FULL_SNAPSHOT_INTERVAL": 600,
+    }) as condor:
+        yield condor
+
+@action
+def job_dir(test_dir):
+    d = test_dir / "job"
+    d.mkdir()
+    return d
+
+@action
+def job_script(job_dir):
+    # the subshell exits right away, leaving its sleep a child of init
+    return write_file(job_dir / "job.sh", """#!/bin/sh
+( sleep 1000 & echo $! > orphan.pid.tmp; mv orphan.pid.tmp orphan.pid )
+sleep 1000 &
+echo $! > child.pid.tmp; mv child.pid.tmp child.pid
+wait
+""")
+
+@action
+def job_pids(condor, job_dir, job_script):
+    os.chmod(job_script, 0o755)
+    handle = condor.submit(
+        description={
+            "executable": job_script.as_posix(),
+            "initialdir": job_dir.as_posix(),
+            "should_transfer_files": "NO",
+            "log": (job_dir / "job.log").as_posix(),
+        },
+        count=1,
+    )
+    assert handle.wait(
+        timeout=60,
+        condition=ClusterState.all_running,
+        fail_condition=ClusterState.any_held,
+    )
+
+    deadline = time.time() + 30
+    while time.time() < deadline:
+        child = read_pid(job_dir / "child.pid")
+        orphan = read_pid(job_dir / "orphan.pid")
+        if child and orphan:
+            break
+        time.sleep(1)
+
+    # let the procd take some snapshots of the running job
+    time.sleep(10)
+    return (handle, child, orphan)
+
+@action
+def removed_pids(condor, job_pids):
+    handle, child, orphan = job_pids
+    handle.remove()
+    assert handle.wait(
+        timeout=60,
+        condition=ClusterState.all_terminal,
+    )
+
+    deadline = time.time() + 30
+    while time.time() < deadline and (pid_alive(child) or pid_alive(orphan)):
+        time.sleep(1)
+    return (child, orphan)
+
+@action
+def proc_log(test_dir, removed_pids):
+    return (test_dir / "condor" / "log" / "ProcLog").read_text()
+
+#--------------------------------------------------------------------------------------------
+class TestProcdIncrementalSnapshots:
+
+    def test_job_started_children(self, job_pids):
+        _, child, orphan = job_pids
+        assert child is not None and orphan is not None
+        assert pid_alive(child)
+        assert pid_alive(orphan)
+
+    def test_incremental_snapshots_taken(self, proc_log):
+        assert "incremental snapshot complete" in proc_log
+
+    def test_child_killed(self, removed_pids):
+        child, _ = removed_pids
+        assert not pid_alive(child)
+
+    def test_escaped_process_killed(self, removed_pids):
+        _, orphan = removed_pids
+        assert not pid_alive(orphan)
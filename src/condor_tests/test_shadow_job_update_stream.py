@@ -0,0 +1,107 @@
+#!/usr/bin/env pytest
+
+#   test_shadow_job_update_stream
+#   The shadow sends its periodic job updates to the schedd on a stream
+#   that it keeps open, and the schedd applies the updates from all of
+#   its shadows together.  Check that the updates are applied, and that
+#   when the schedd has no room for another stream the shadow goes back
+#   to sending its updates over qmgmt.
+
+from ornithology import *
+
+import logging
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+UPDATE_CONFIG = {
+    "SCHEDD_DEBUG": "D_FULLDEBUG",
+    "SHADOW_DEBUG": "D_FULLDEBUG",
+    "STARTER_UPDATE_INTERVAL": 2,
+    "SHADOW_QUEUE_UPDATE_INTERVAL": 2,
+    "SCHEDD_JOB_UPDATE_COALESCE_INTERVAL": 1,
+}
+
+
+def run_job(condor, test_dir, path_to_sleep):
+    handle = condor.submit(
+        description={
+            "executable": path_to_sleep,
+            "arguments": 20,
+            "log": (test_dir / "job.log").as_posix(),
+            "leave_in_queue": "true",
+        },
+        count=1,
+    )
+    assert handle.wait(
+        timeout=120,
+        condition=ClusterState.all_complete,
+        fail_condition=ClusterState.any_held,
+    )
+    return handle
+
+
+def log_messages(log):
+    return [entry.message for entry in log.open().read()]
+
+
+#--------------------------------------------------------------------------------------------
+@action
+def streamed_condor(test_dir):
+    with Condor(local_dir=test_dir / "streamed", config=UPDATE_CONFIG) as condor:
+        yield condor
+
+@action
+def streamed_job(streamed_condor, test_dir, path_to_sleep):
+    return run_job(streamed_condor, test_dir / "streamed", path_to_sleep)
+
+@action
+def streamed_schedd_messages(streamed_condor, streamed_job):
+    return log_messages(streamed_condor.schedd_log)
+
+@action
+def capped_condor(test_dir):
+    with Condor(local_dir=test_dir / "capped", config={
+        **UPDATE_CONFIG,
+        "SCHEDD_MAX_JOB_UPDATE_STREAMS": 0,
+    }) as condor:
+        yield condor
+
+@action
+def capped_job(capped_condor, test_dir, path_to_sleep):
+    return run_job(capped_condor, test_dir / "capped", path_to_sleep)
+
+@action
+def capped_schedd_messages(capped_condor, capped_job):
+    return log_messages(capped_condor.schedd_log)
+
+@action
+def capped_shadow_messages(capped_condor, capped_job):
+    return log_messages(capped_condor.shadow_log)
+
+#--------------------------------------------------------------------------------------------
+class TestShadowJobUpdateStream:
+
+    def test_streamed_updates_applied(self, streamed_schedd_messages):
+        assert any(m.startswith("Applied ") and "from shadow updates" in m
+                   for m in streamed_schedd_messages)
+
+    def test_streamed_updates_not_refused(self, streamed_schedd_messages):
+        assert not any(m.startswith("Ignoring shadow update") for m in streamed_schedd_messages)
+
+    def test_streamed_job_updated(self, streamed_job):
+        ad = streamed_job.query(projection=["RemoteWallClockTime", "ExitCode"])[0]
+        assert ad["ExitCode"] == 0
+        assert ad["RemoteWallClockTime"] > 0
+
+    def test_capped_stream_refused(self, capped_schedd_messages):
+        assert any(m.startswith("Refusing shadow job update stream") for m in capped_schedd_messages)
+        assert not any("from shadow updates" in m for m in capped_schedd_messages)
+
+    def test_capped_shadow_uses_qmgmt(self, capped_shadow_messages):
+        assert any("schedd refused job update stream" in m for m in capped_shadow_messages)
+
+    def test_capped_job_completes(self, capped_job):
+        ad = capped_job.query(projection=["ExitCode"])[0]
+        assert ad["ExitCode"] == 0
@@ -0,0 +1,114 @@
+#!/usr/bin/env pytest
+
+#   test_startd_policy_eval_cache
+#   The startd reuses the result of a slot policy expression until one of
+#   the attributes it references, directly or through other attributes,
+#   changes.  Run a job on a slot whose PREEMPT refers to StopNow through
+#   another attribute, check that the cached result is reused while
+#   nothing changes, then have a startd cron job flip StopNow and check
+#   that the job is evicted, and not started again.
+
+from ornithology import *
+import htcondor
+
+import time
+import logging
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+STOP_FLAG_SCRIPT = """#!/usr/bin/env python3
+import os
+import sys
+print("StopNow = " + ("true" if os.path.exists(sys.argv[1]) else "false"))
+"""
+
+
+#--------------------------------------------------------------------------------------------
+@standup
+def stop_flag(test_dir):
+    script = write_file(test_dir / "stop_flag.py", STOP_FLAG_SCRIPT)
+    script.chmod(0o755)
+    return test_dir / "stop"
+
+@standup
+def condor(test_dir, stop_flag):
+    with Condor(local_dir=test_dir / "condor", config={
+        "STARTD_POLICY_EVAL_CACHE": True,
+        "POLLING_INTERVAL": 1,
+        "UPDATE_INTERVAL": 2,
+        "STARTD_CRON_JOBLIST": "STOPFLAG",
+        "STARTD_CRON_STOPFLAG_EXECUTABLE": (test_dir / "stop_flag.py").as_posix(),
+        "STARTD_CRON_STOPFLAG_ARGS": stop_flag.as_posix(),
+        "STARTD_CRON_STOPFLAG_MODE": "Periodic",
+        "STARTD_CRON_STOPFLAG_PERIOD": 2,
+        "WantStop": "StopNow =?= true",
+        "STARTD_ATTRS": "$(STARTD_ATTRS) WantStop",
+        "START": "StopNow =!= true",
+        "PREEMPT": "WantStop",
+        "WANT_SUSPEND": False,
+        "MAXJOBRETIREMENTTIME": 0,
+    }) as condor:
+        yield condor
+
+@action
+def running_job(condor, test_dir, path_to_sleep):
+    handle = condor.submit(
+        description={
+            "executable": path_to_sleep,
+            "arguments": 600,
+            "log": (test_dir / "job.log").as_posix(),
+        },
+        count=1,
+    )
+    assert handle.wait(
+        timeout=60,
+        condition=ClusterState.all_running,
+        fail_condition=ClusterState.any_held,
+    )
+    return handle
+
+def slot_ads(condor):
+    return condor.status(ad_type=htcondor.AdTypes.Startd,
+                         projection=["Name", "State", "PolicyEvaluations", "PolicyEvaluationsSkipped"])
+
+@action
+def skipped_while_running(condor, running_job):
+    # give the startd some polling intervals with nothing changing
+    deadline = time.time() + 30
+    while True:
+        skipped = max(ad.get("PolicyEvaluationsSkipped", 0) for ad in slot_ads(condor))
+        if skipped > 0 or time.time() > deadline:
+            return skipped
+        time.sleep(2)
+
+@action
+def evicted(condor, test_dir, stop_flag, running_job, skipped_while_running):
+    write_file(stop_flag, "")
+    deadline = time.time() + 60
+    while time.time() < deadline:
+        with htcondor.JobEventLog((test_dir / "job.log").as_posix()) as log:
+            if any(e.type == htcondor.JobEventType.JOB_EVICTED for e in log.events(stop_after=0)):
+                return True
+        time.sleep(1)
+    return False
+
+@action
+def restarted(condor, running_job, evicted):
+    # START is now false as well, so the job must stay idle
+    time.sleep(10)
+    ad = running_job.query(projection=["JobStatus"])[0]
+    return ad["JobStatus"] == 2 # running
+
+#--------------------------------------------------------------------------------------------
+class TestStartdPolicyEvalCache:
+
+    def test_cached_result_reused(self, skipped_while_running):
+        assert skipped_while_running > 0
+
+    def test_changed_input_evicts_job(self, evicted):
+        assert evicted
+
+    def test_changed_input_blocks_start(self, restarted):
+        assert not restarted
@@ -0,0 +1,99 @@
+#!/usr/bin/env pytest
+
+#   test_starter_cgroup_events
+#   When a job runs in a cgroup v2 cgroup, the starter watches it for
+#   memory limit and pressure events and sends an update when they
+#   happen, at most once every STARTER_EVENT_UPDATE_MIN_INTERVAL seconds.
+#   Run a job that keeps running into its memory limit, and check that
+#   the events that come too soon after an update are sent at the end of
+#   the interval rather than dropped, and that the job's memory usage is
+#   still reported once it has gone idle.
+
+from ornithology import *
+
+import os
+import re
+import pytest
+import logging
+
+logger = logging.getLogger(__name__)
+logger.setLevel(logging.DEBUG)
+
+
+def have_cgroup_v2():
+    return os.geteuid() == 0 and os.path.exists("/sys/fs/cgroup/cgroup.controllers")
+
+
+#--------------------------------------------------------------------------------------------
+@standup
+def condor(test_dir):
+    with Condor(local_dir=test_dir / "condor", config={
+        "STARTER_DEBUG": "D_FULLDEBUG",
+        "STARTER_UPDATE_INTERVAL": 5,
+        "CGROUP_MONITOR_EVENTS": True,
+        "CGROUP_MEMORY_LIMIT_POLICY": "hard",
+        "STARTER_EVENT_UPDATE_MIN_INTERVAL": 10,
+    }) as condor:
+        yield condor
+
+@action
+def job_script(test_dir):
+    # Page cache counts against the limit, and is reclaimed rather than
+    # OOM killed, so writing well past it bumps the memory.max count over
+    # and over.  Then stay idle long enough for a deferred update.
+    script = write_file(test_dir / "job.sh", """#!/bin/sh
+for i in 1 2 3 4 5; do
+    dd if=/dev/zero of=fill bs=1M count=200 2>/dev/null
+    rm -f fill
+    sleep 1
+done
+sleep 30
+""")
+    script.chmod(0o755)
+    return script
+
+@action
+def job(condor, test_dir, job_script):
+    handle = condor.submit(
+        description={
+            "executable": job_script.as_posix(),
+            "request_memory": 64,
+            "log": (test_dir / "job.log").as_posix(),
+            "leave_in_queue": "true",
+        },
+        count=1,
+    )
+    assert handle.wait(
+        timeout=180,
+        condition=ClusterState.all_complete,
+        fail_condition=ClusterState.any_held,
+    )
+    return handle
+
+@action
+def starter_log(condor, job):
+    log_dir = condor.local_dir / "log"
+    return "".join((log_dir / name).read_text()
+                   for name in sorted(os.listdir(log_dir)) if name.startswith("StarterLog"))
+
+#--------------------------------------------------------------------------------------------
+@pytest.mark.skipif(not have_cgroup_v2(), reason="Needs root and cgroup v2")
+class TestStarterCgroupEvents:
+
+    def test_events_monitored(self, starter_log):
+        assert "monitoring events of cgroup" in starter_log
+
+    def test_event_update_sent(self, starter_log):
+        assert re.search(r"has cgroup events:.*memory-limit.*, sending an update", starter_log)
+
+    def test_events_deferred_not_dropped(self, starter_log):
+        # every deferral is followed by the update it was waiting for
+        deferred = starter_log.count("deferring the update")
+        sent = len(re.findall(r"has cgroup events:.*, sending an update", starter_log))
+        assert deferred > 0
+        assert sent > deferred
+
+    def test_idle_memory_reported(self, job):
+        ad = job.query(projection=["ExitCode", "ResidentSetSize_RAW"])[0]
+        assert ad["ExitCode"] == 0
+        assert ad["ResidentSetSize_RAW"] > 0
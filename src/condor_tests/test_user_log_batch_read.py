@@ -0,0 +1,20 @@
+#!/usr/bin/env pytest
+
+#   test_user_log_batch_read
+#   DAGMan reads its nodes log in batches (DAGMAN_LOG_READ_BATCH_SIZE).
+#   Check that batched reads of a real job event log return the same
+#   events as reading it one event at a time, including while it grows,
+#   and that the fields parsed from the common events match those written.
+
+import subprocess
+
+
+def test_batch_read_matches_single_reads(tmp_path):
+    rv = subprocess.run(["x_read_joblog_batch.exe", str(tmp_path)],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        universal_newlines=True,
+        timeout=120)
+    print(rv.stdout)
+    assert rv.returncode == 0
+    assert "All tests passed." in rv.stdout
@@ -0,0 +1,135 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Sends commands to the local collector on kept-alive command connections.
+//
+//   x_command_keep_alive.exe reuse
+//      Sends two DC_NOP_READ commands through the connection pool and
+//      checks that the second one reused the first one's connection.
+//
+//   x_command_keep_alive.exe bare
+//      Sends a DC_NOP_READ asking the collector to keep the connection,
+//      then a DC_NOP_ADMINISTRATOR on the same connection without a
+//      DC_AUTHENTICATE of its own, and checks that the collector hangs up.
+//      Whether the collector handled the second command is for the
+//      caller to check in its log.
+
+#include "condor_common.h"
+#include "condor_config.h"
+#include "condor_debug.h"
+#include "condor_commands.h"
+#include "daemon.h"
+#include "reli_sock.h"
+#include "command_connection_pool.h"
+
+static int send_nop(Daemon &collector, Sock *&sock)
+{
+	CondorError errstack;
+	sock = collector.startCommand(DC_NOP_READ, Stream::reli_sock, 20, &errstack);
+	if ( ! sock) {
+		printf("FAIL: could not send DC_NOP_READ: %s\n", errstack.getFullText().c_str());
+		return 1;
+	}
+	if ( ! sock->end_of_message()) {
+		printf("FAIL: could not finish DC_NOP_READ\n");
+		delete sock;
+		sock = NULL;
+		return 1;
+	}
+	return 0;
+}
+
+static int test_reuse(Daemon &collector)
+{
+	Sock *sock = NULL;
+	for (int i = 0; i < 2; ++i) {
+		if (send_nop(collector, sock)) {
+			return 1;
+		}
+			// give the collector time to finish the command and decide
+			// to keep the connection before we offer it to the pool
+		sleep(1);
+		collector.releaseCommandSocket(sock);
+	}
+
+	const CommandConnectionPool::Stats &stats = CommandConnectionPool::global().stats();
+	printf("hits %ld misses %ld returned %ld expired %ld failed %ld\n",
+		stats.hits, stats.misses, stats.returned, stats.expired, stats.failed);
+	if (stats.hits != 1) {
+		printf("FAIL: second command did not reuse the connection\n");
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
+
+static int test_bare(Daemon &collector)
+{
+	Sock *sock = NULL;
+	if (send_nop(collector, sock)) {
+		return 1;
+	}
+
+		// Send a command with nothing but our socket's state to vouch
+	sock->clearSecurityState();
+	sock->encode();
+	int cmd = DC_NOP_ADMINISTRATOR;
+	if ( ! sock->code(cmd) || ! sock->end_of_message()) {
+		printf("PASS: collector closed the connection before the second command\n");
+		delete sock;
+		return 0;
+	}
+
+		// handle_nop() doesn't reply, so all we should ever see is EOF
+	sock->decode();
+	sock->timeout(20);
+	int reply = 0;
+	bool got_reply = sock->code(reply);
+	delete sock;
+	if (got_reply) {
+		printf("FAIL: collector replied to the second command\n");
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 2 || (strcmp(argv[1], "reuse") != 0 && strcmp(argv[1], "bare") != 0)) {
+		fprintf(stderr, "Usage: %s reuse|bare\n", argv[0]);
+		return 2;
+	}
+
+	set_priv_initialize();
+	config();
+	dprintf_set_tool_debug("TOOL", 0);
+
+	Daemon collector(DT_COLLECTOR);
+	if ( ! collector.locate()) {
+		printf("FAIL: could not locate the collector\n");
+		return 1;
+	}
+	collector.setUseConnectionPool(true);
+
+	if (strcmp(argv[1], "reuse") == 0) {
+		return test_reuse(collector);
+	}
+	return test_bare(collector);
+}
@@ -0,0 +1,286 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Checks that reading a job event log in batches, with
+// ReadUserLog::readEvents() and ReadMultipleUserLogs, returns exactly the
+// events that reading it one event at a time does, including when the
+// log grows between reads.  Also checks that the values parsed back out
+// of the common events match the values that were written.
+//
+//   x_read_joblog_batch.exe <directory>
+
+#include "condor_common.h"
+#include "condor_config.h"
+#include "condor_debug.h"
+#include "write_user_log.h"
+#include "read_user_log.h"
+#include "read_multiple_logs.h"
+#include "CondorError.h"
+
+#include <string>
+#include <vector>
+
+struct EventId {
+	int type;
+	int cluster;
+	int proc;
+	bool operator==(const EventId &rhs) const {
+		return type == rhs.type && cluster == rhs.cluster && proc == rhs.proc;
+	}
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+	if ( ! ok) {
+		printf("FAILED: %s\n", what);
+		++failures;
+	}
+}
+
+// Write submit, execute and terminated events for jobs first..last,
+// interleaved so that neighbouring events belong to different jobs.
+static void write_events(const std::string &path, int first, int last, std::vector<EventId> &written)
+{
+	for (int step = 0; step < 3; ++step) {
+		for (int cluster = first; cluster <= last; ++cluster) {
+			WriteUserLog log;
+			log.initialize(path.c_str(), cluster, cluster % 3, 0);
+			bool ok = false;
+			if (step == 0) {
+				SubmitEvent submit;
+				submit.setSubmitHost("<127.0.0.1:9618>");
+				submit.submitEventLogNotes = "batch read test";
+				ok = log.writeEvent(&submit);
+				written.push_back({ULOG_SUBMIT, cluster, cluster % 3});
+			} else if (step == 1) {
+				ExecuteEvent execute;
+				execute.setExecuteHost("<127.0.0.1:9618>");
+				ok = log.writeEvent(&execute);
+				written.push_back({ULOG_EXECUTE, cluster, cluster % 3});
+			} else {
+				JobTerminatedEvent term;
+				term.normal = true;
+				term.returnValue = cluster % 7;
+				ok = log.writeEvent(&term);
+				written.push_back({ULOG_JOB_TERMINATED, cluster, cluster % 3});
+			}
+			if ( ! ok) {
+				printf("FAILED: could not write event to %s\n", path.c_str());
+				exit(1);
+			}
+		}
+	}
+}
+
+static EventId event_id(const ULogEvent *event)
+{
+	return {(int)event->eventNumber, event->cluster, event->proc};
+}
+
+static void read_one_at_a_time(ReadUserLog &reader, std::vector<EventId> &read)
+{
+	ULogEvent *event = NULL;
+	while (reader.readEvent(event) == ULOG_OK) {
+		read.push_back(event_id(event));
+		delete event;
+		event = NULL;
+	}
+}
+
+// Returns the number of readEvents() calls that returned events
+static int read_batches(ReadUserLog &reader, size_t batch_size, std::vector<EventId> &read)
+{
+	int calls = 0;
+	while (true) {
+		std::vector<std::unique_ptr<ULogEvent>> batch;
+		ULogEventOutcome outcome = reader.readEvents(batch, batch_size);
+		if (outcome != ULOG_OK) {
+			check(outcome == ULOG_NO_EVENT, "batch read ends with ULOG_NO_EVENT");
+			check(batch.empty(), "no events returned with a failed batch read");
+			break;
+		}
+		check( ! batch.empty() && batch.size() <= batch_size, "batch size within limit");
+		for (auto &event : batch) {
+			read.push_back(event_id(event.get()));
+		}
+		++calls;
+	}
+	return calls;
+}
+
+static void read_multiple(ReadMultipleUserLogs &reader, std::vector<EventId> &read)
+{
+	ULogEvent *event = NULL;
+	while (reader.readEvent(event) == ULOG_OK) {
+		read.push_back(event_id(event));
+		delete event;
+		event = NULL;
+	}
+}
+
+// Write one each of the submit, execute and terminated events and check
+// that reading them back recovers the values written, including the event
+// times, the rusage and the transfer byte counts of the terminated event.
+static void check_parsed_values(const std::string &path)
+{
+	unlink(path.c_str());
+
+	SubmitEvent submit;
+	submit.setSubmitHost("<127.0.0.1:9618?addrs=127.0.0.1-9618>");
+	ExecuteEvent execute;
+	execute.setExecuteHost("<127.0.0.2:9618>");
+	JobTerminatedEvent term;
+	term.normal = true;
+	term.returnValue = 42;
+	term.run_remote_rusage.ru_utime.tv_sec = 3*24*3600 + 4*3600 + 5*60 + 6;
+	term.run_remote_rusage.ru_stime.tv_sec = 61;
+	term.total_local_rusage.ru_utime.tv_sec = 59;
+	term.sent_bytes = 1234567;
+	term.recvd_bytes = 89;
+	term.total_sent_bytes = 2468;
+	term.total_recvd_bytes = 0;
+
+	WriteUserLog log;
+	log.initialize(path.c_str(), 7, 1, 0);
+	ULogEvent *written[] = { &submit, &execute, &term };
+	for (ULogEvent *event : written) {
+		if ( ! log.writeEvent(event)) {
+			printf("FAILED: could not write event to %s\n", path.c_str());
+			exit(1);
+		}
+	}
+
+	ReadUserLog reader(path.c_str());
+	std::vector<std::unique_ptr<ULogEvent>> read;
+	ULogEvent *event = NULL;
+	while (reader.readEvent(event) == ULOG_OK) {
+		read.emplace_back(event);
+		event = NULL;
+	}
+	check(read.size() == 3, "read back the three written events");
+	if (read.size() != 3) {
+		return;
+	}
+	for (size_t ix = 0; ix < 3; ++ix) {
+		check(read[ix]->eventNumber == written[ix]->eventNumber, "event type read back");
+		check(read[ix]->GetEventclock() == written[ix]->GetEventclock(), "event time read back");
+	}
+
+	auto *rsubmit = dynamic_cast<SubmitEvent *>(read[0].get());
+	check(rsubmit && strcmp(rsubmit->getSubmitHost(), submit.getSubmitHost()) == 0, "submit host read back");
+	auto *rexecute = dynamic_cast<ExecuteEvent *>(read[1].get());
+	check(rexecute && strcmp(rexecute->getExecuteHost(), execute.getExecuteHost()) == 0, "execute host read back");
+	auto *rterm = dynamic_cast<JobTerminatedEvent *>(read[2].get());
+	check(rterm != NULL, "terminated event read back");
+	if (rterm) {
+		check(rterm->normal && rterm->returnValue == 42, "return value read back");
+		check(rterm->run_remote_rusage.ru_utime.tv_sec == term.run_remote_rusage.ru_utime.tv_sec &&
+			rterm->run_remote_rusage.ru_stime.tv_sec == term.run_remote_rusage.ru_stime.tv_sec &&
+			rterm->total_local_rusage.ru_utime.tv_sec == term.total_local_rusage.ru_utime.tv_sec,
+			"rusage read back");
+		check(rterm->sent_bytes == term.sent_bytes && rterm->recvd_bytes == term.recvd_bytes &&
+			rterm->total_sent_bytes == term.total_sent_bytes &&
+			rterm->total_recvd_bytes == term.total_recvd_bytes,
+			"transfer byte counts read back");
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <directory>\n", argv[0]);
+		return 2;
+	}
+	config();
+
+	std::string whole = std::string(argv[1]) + "/whole.log";
+	std::string growing = std::string(argv[1]) + "/growing.log";
+	unlink(whole.c_str());
+	unlink(growing.c_str());
+
+	check_parsed_values(std::string(argv[1]) + "/values.log");
+
+	// A complete log, read every way
+	std::vector<EventId> written;
+	write_events(whole, 1, 200, written);
+
+	{
+		ReadUserLog reader(whole.c_str());
+		std::vector<EventId> read;
+		read_one_at_a_time(reader, read);
+		check(read == written, "one at a time reads every event in order");
+	}
+
+	for (size_t batch_size : {1, 7, 100, 1000}) {
+		ReadUserLog reader(whole.c_str());
+		std::vector<EventId> read;
+		int calls = read_batches(reader, batch_size, read);
+		std::string what;
+		formatstr(what, "batches of %zu read every event in order", batch_size);
+		check(read == written, what.c_str());
+		formatstr(what, "batches of %zu took %d calls", batch_size, calls);
+		check(calls == (int)((written.size() + batch_size - 1) / batch_size), what.c_str());
+	}
+
+	// A log that grows between reads, with a reader that stops at the
+	// end each time and must pick up where it left off
+	{
+		std::vector<EventId> grown;
+		std::vector<EventId> single, batched, multi;
+		ReadUserLog single_reader;
+		ReadUserLog batch_reader;
+		ReadMultipleUserLogs multi_reader;
+		multi_reader.setReadBatchSize(16);
+
+		int first = 1;
+		for (int round = 0; round < 5; ++round) {
+			int last = first + 10 * round + 3;
+			write_events(growing, first, last, grown);
+			first = last + 1;
+
+			if (round == 0) {
+				check(single_reader.initialize(growing.c_str()), "initialize one at a time reader");
+				check(batch_reader.initialize(growing.c_str()), "initialize batch reader");
+				CondorError errstack;
+				check(multi_reader.monitorLogFile(growing, false, errstack), "monitor log file");
+			}
+
+			read_one_at_a_time(single_reader, single);
+			read_batches(batch_reader, 16, batched);
+			read_multiple(multi_reader, multi);
+
+			std::string what;
+			formatstr(what, "round %d: one at a time reader caught up", round);
+			check(single == grown, what.c_str());
+			formatstr(what, "round %d: batch reader caught up", round);
+			check(batched == grown, what.c_str());
+			formatstr(what, "round %d: multiple log reader caught up", round);
+			check(multi == grown, what.c_str());
+		}
+	}
+
+	if (failures) {
+		printf("%d checks FAILED\n", failures);
+		return 1;
+	}
+	printf("All tests passed.\n");
+	return 0;
+}
@@ -36,12 +36,17 @@
 #include "match_prefix.h"
 #include "subsystem_info.h"
 #include "historyFileFinder.h"
+#include "history_index.h"
 #include "condor_id.h"
 #include "userlog_to_classads.h"
 #include "setenv.h"
 #include "condor_daemon_core.h" // for extractInheritedSocks
 #include "console-utils.h"
 #include <algorithm> //for std::reverse
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <utility> // for std::move
 
 #include "classad_helpers.h"
@@ -115,6 +120,9 @@ static void readHistoryFromDirectory(const char* searchDirectory, const char* co
 static void readHistoryFromSingleFile(bool fileisuserlog, const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr);
 static void readHistoryFromFileOld(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr);
 static void readHistoryFromFileEx(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards);
+static bool readHistoryFromIndex(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards);
+static bool readHistoryParallel(const std::vector<std::string> &files, ExprTree *constraintExpr, bool read_backwards);
+static void initHistoryIndexKeys(ExprTree *constraintExpr);
 static void printJobAds(ClassAdList & jobs);
 static void printJob(ClassAd & ad);
 
@@ -176,6 +184,7 @@ static bool want_startd_history = false;
 static bool delete_epoch_ads = false;
 static std::deque<ClusterMatchInfo> jobIdFilterInfo;
 static std::deque<std::string> ownersList;
+static time_t completedSince = -1; // -completedsince time, when it is a literal
 static std::set<std::string> filterAdTypes; // Allow filter of Ad types specified in history banner (different from MyType)
 static HistoryRecordSource recordSrc = HRS_AUTO;
 
@@ -550,6 +559,7 @@ main(int argc, const char* argv[])
 			exit(1);
 		}
 		delete sinceExpr; sinceExpr = NULL;
+		completedSince = -1;
 
 		++i;
 
@@ -590,6 +600,9 @@ main(int argc, const char* argv[])
 			fprintf( stderr, "Error: '%s' not valid parameter for -completedsince ", argv[i]);
 			exit(1);
 		}
+		char *pend = nullptr;
+		long long since_time = strtoll(argv[i], &pend, 10);
+		completedSince = (pend && ! *pend && since_time > 0) ? (time_t)since_time : -1;
     }
 
     else if (sscanf (argv[i], "%d.%d", &cluster, &proc) == 2) {
@@ -705,6 +718,7 @@ main(int argc, const char* argv[])
   }
 
   if(readfromfile == true) {
+      initHistoryIndexKeys(constraintExpr);
       // Set Default expected Ad type to be filtered for display per history source
       if (filterAdTypes.empty()) {
           switch(recordSrc) {
@@ -1057,8 +1071,10 @@ static void readHistoryFromFiles(const char* matchFileName, const char* constrai
 	//for(auto file : historyFiles) { fprintf(stdout, "%s\n",file.c_str()); }
 
 	// Read files for Ads in order
-	for(auto file : historyFiles) {
-		readHistoryFromFileEx(file.c_str(), constraint, constraintExpr, backwards);
+	if ( ! readHistoryParallel(historyFiles, constraintExpr, backwards)) {
+		for(auto file : historyFiles) {
+			readHistoryFromFileEx(file.c_str(), constraint, constraintExpr, backwards);
+		}
 	}
 
 	printFooter();
@@ -1484,6 +1500,11 @@ static void readHistoryFromFileEx(const char *JobHistoryFileName, const char* co
 		return;
 	}
 
+	// read only the ads that can match if the file has an index
+	if (readHistoryFromIndex(JobHistoryFileName, constraint, constraintExpr, read_backwards)) {
+		return;
+	}
+
 	// the old function doesn't work for backwards, but it does work for forwards so go ahead and call it.
 	//
 	if ( ! read_backwards) {
@@ -1571,6 +1592,416 @@ static void readHistoryFromFileEx(const char *JobHistoryFileName, const char* co
 	reader.Close();
 }
 
+// Job ids and owners that an ad must have to match the query, used to pick
+// ads out of a history file index.  An ad matches if it has any of them.
+struct HistoryIndexKeys {
+	std::vector<JOB_ID_KEY> jobs; // proc is -1 to match the whole cluster
+	std::vector<std::string> owners;
+	bool empty() const { return jobs.empty() && owners.empty(); }
+};
+static HistoryIndexKeys indexKeys;
+
+// Find a ClusterId/ProcId or Owner comparison that every ad matching the
+// expression must satisfy.
+static void findIndexKeysInExpr(classad::ExprTree *expr, HistoryIndexKeys &keys)
+{
+	if ( ! expr) { return; }
+
+	int jid_cluster = -1, jid_proc = -1;
+	bool cluster_only = false;
+	if (ExprTreeIsJobIdConstraint(expr, jid_cluster, jid_proc, cluster_only)) {
+		if (jid_cluster > 0 && ! cluster_only) { keys.jobs.emplace_back(jid_cluster, jid_proc); }
+		return;
+	}
+
+	classad::Operation::OpKind op;
+	std::string attr, owner;
+	classad::Value value;
+	if (ExprTreeIsAttrCmpLiteral(expr, op, attr, value)) {
+		if ((op == classad::Operation::EQUAL_OP || op == classad::Operation::META_EQUAL_OP) &&
+			strcasecmp(attr.c_str(), ATTR_OWNER) == MATCH && value.IsStringValue(owner)) {
+			keys.owners.push_back(owner);
+		}
+		return;
+	}
+
+	// an ad that matches a conjunction matches both sides of it
+	expr = SkipExprParens(expr);
+	if (expr->GetKind() == classad::ExprTree::OP_NODE) {
+		classad::ExprTree *t1, *t2, *t3;
+		((const classad::Operation*)expr)->GetComponents(op, t1, t2, t3);
+		if (op == classad::Operation::LOGICAL_AND_OP) {
+			findIndexKeysInExpr(t1, keys);
+			if (keys.empty()) { findIndexKeysInExpr(t2, keys); }
+		}
+	}
+}
+
+static void initHistoryIndexKeys(ExprTree *constraintExpr)
+{
+	indexKeys = HistoryIndexKeys();
+	if ( ! jobIdFilterInfo.empty() || ! ownersList.empty()) {
+		// job ids and owners on the command line are or'ed together
+		for (const auto &match : jobIdFilterInfo) { indexKeys.jobs.push_back(match.jid); }
+		for (const auto &name : ownersList) { indexKeys.owners.push_back(name); }
+	} else {
+		findIndexKeysInExpr(constraintExpr, indexKeys);
+	}
+}
+
+static bool indexRecordMayMatch(const HistoryFileIndex::Record &rec)
+{
+	for (const auto &jid : indexKeys.jobs) {
+		if (rec.cluster <= 0) { return true; } // no ClusterId in the banner
+		if (rec.cluster == jid.cluster && (jid.proc < 0 || rec.proc < 0 || rec.proc == jid.proc)) { return true; }
+	}
+	for (const auto &name : indexKeys.owners) {
+		if (rec.owner == "?" || strcasecmp(rec.owner.c_str(), name.c_str()) == MATCH) { return true; }
+	}
+	return false;
+}
+
+static bool historyScanDone()
+{
+	return (specifiedMatch > 0 && matchCount >= specifiedMatch) || (maxAds > 0 && adCount >= maxAds) || abort_transfer;
+}
+
+// Read the ad (and its banner) that starts at the current position of fp.
+// Returns false at the end of the file.  Malformed ads are reported by
+// setting *malformed when it is given, and by printing a warning when not.
+static bool readHistoryAd(FILE *fp, ClassAd &ad, BannerInfo &banner, bool &wanted, bool *malformed = nullptr)
+{
+	bool EndFlag = false;
+	int ErrorFlag = 0;
+	CondorClassAdFileParseHelper helper("***");
+	int c_attrs = InsertFromFile(fp, ad, EndFlag, ErrorFlag, &helper);
+	wanted = false;
+	if (ErrorFlag) {
+		if (malformed) {
+			*malformed = true;
+		} else {
+			printf( "\t*** Warning: Bad history file; skipping malformed ad(s)\n" );
+		}
+		return ! EndFlag;
+	}
+	if (c_attrs > 0) {
+		wanted = parseBanner(banner, helper.getDelimitorLine());
+	}
+	return c_attrs > 0 || ! EndFlag;
+}
+
+// Read the ads of a history file that can match the query using the file's
+// index.  Returns false if the file has no usable index, in which case the
+// caller should scan the file.
+static bool readHistoryFromIndex(const char *JobHistoryFileName, const char* constraint, ExprTree *constraintExpr, bool read_backwards)
+{
+	if ( ! hasOneJobInstInFile()) { return false; }
+	bool use_since = read_backwards && completedSince > 0;
+	// -since and -scanlimit count and stop on every ad in the file, not just
+	// the ones the index would have us read, so they need a full scan.
+	bool use_keys = ! indexKeys.empty() && ! sinceExpr && maxAds <= 0;
+	if ( ! use_keys && ! use_since) { return false; }
+
+	HistoryFileIndex index;
+	if ( ! index.Load(JobHistoryFileName)) { return false; }
+
+	// If every ad in the file completed by the -completedsince time, the first
+	// ad we read would end the search, so end it without reading the file.
+	// An ad without a CompletionDate doesn't end the search.
+	if (use_since && ! index.Records().empty() && index.IndexedEnd() == index.FileSize() &&
+		index.NumWithoutCompletion() == 0 && index.MaxCompletion() <= completedSince) {
+		++adCount;
+		maxAds = adCount;
+		return true;
+	}
+	if ( ! use_keys) { return false; }
+
+	FILE *fp = safe_fopen_wrapper_follow(JobHistoryFileName, "r");
+	if ( ! fp) { return false; }
+
+	std::vector<const HistoryFileIndex::Record *> candidates;
+	for (const auto &rec : index.Records()) {
+		if (indexRecordMayMatch(rec)) { candidates.push_back(&rec); }
+	}
+	if (read_backwards) { std::reverse(candidates.begin(), candidates.end()); }
+
+	// Ads written after the last index update are not indexed, so they
+	// are read the slow way.  They are the newest ads in the file.
+	std::vector<std::pair<ClassAd *, BannerInfo>> tail;
+	if (index.IndexedEnd() < index.FileSize() && fseek(fp, (long)index.IndexedEnd(), SEEK_SET) == 0) {
+		bool more = true;
+		while (more) {
+			ClassAd *ad = new ClassAd;
+			BannerInfo banner;
+			bool wanted = false;
+			more = readHistoryAd(fp, *ad, banner, wanted);
+			if (wanted) {
+				tail.emplace_back(ad, banner);
+			} else {
+				delete ad;
+			}
+		}
+		if (read_backwards) { std::reverse(tail.begin(), tail.end()); }
+	}
+
+	bool done = false;
+	auto print_tail = [&]() {
+		for (auto &[ad, banner] : tail) {
+			if ( ! done && ! historyScanDone()) {
+				done = printJobIfConstraint(*ad, constraint, constraintExpr, banner);
+			}
+			delete ad;
+		}
+		tail.clear();
+	};
+
+	if (read_backwards) { print_tail(); }
+	for (const auto *rec : candidates) {
+		if (done || historyScanDone()) { break; }
+		if (fseek(fp, (long)rec->offset, SEEK_SET) != 0) { break; }
+		ClassAd ad;
+		BannerInfo banner;
+		bool wanted = false;
+		readHistoryAd(fp, ad, banner, wanted);
+		if (wanted) {
+			done = printJobIfConstraint(ad, constraint, constraintExpr, banner);
+		}
+	}
+	print_tail();
+
+	fclose(fp);
+	return true;
+}
+
+// A piece of a history file that is parsed and filtered by one of the
+// threads of readHistoryParallel().  Pieces begin just after a banner line,
+// and hold the ads that start before the next piece.
+struct HistoryScanUnit {
+	struct Item {
+		ClassAd *ad;     // a matching ad, or nullptr if this ad ended the -since scan
+		long long pos;   // position of the ad among the ads scanned in this unit
+		bool malformed{false}; // no ad, just a bad history file warning to print here
+	};
+	std::string file;
+	long begin{0};
+	long end{0};
+	std::vector<Item> items; // in file order
+	long long scanned{0};
+	bool done{false};
+};
+
+struct HistoryScan {
+	std::vector<std::unique_ptr<HistoryScanUnit>> units; // in output order
+	ExprTree *constraintExpr{nullptr};
+	size_t next_unit{0};   // next unit for a thread to scan
+	size_t next_print{0};  // next unit for the main thread to print
+	size_t window{0};      // how far the threads may get ahead of printing
+	std::atomic<bool> stop{false};
+	std::mutex mutex;
+	std::condition_variable cv;
+};
+
+static const long HistoryScanChunkSize = 16 * 1024 * 1024;
+
+// Split a history file into units at banner lines roughly every
+// HistoryScanChunkSize bytes, returns false if the file can't be read.
+static bool splitHistoryFile(const std::string &file, std::vector<std::unique_ptr<HistoryScanUnit>> &units)
+{
+	FILE *fp = safe_fopen_wrapper_follow(file.c_str(), "r");
+	if ( ! fp) { return false; }
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+
+	std::vector<long> bounds{0};
+	std::string line;
+	for (long pt = HistoryScanChunkSize; pt < size; pt += HistoryScanChunkSize) {
+		if (pt <= bounds.back() || fseek(fp, pt, SEEK_SET) != 0) { continue; }
+		readLine(line, fp, false); // probably the middle of a line
+		long boundary = -1;
+		while (readLine(line, fp, false)) {
+			if (starts_with(line.c_str(), "*** ")) {
+				boundary = ftell(fp);
+				break;
+			}
+		}
+		if (boundary < 0 || boundary >= size) { break; }
+		bounds.push_back(boundary);
+	}
+	fclose(fp);
+
+	for (size_t ix = 0; ix < bounds.size(); ++ix) {
+		auto unit = std::make_unique<HistoryScanUnit>();
+		unit->file = file;
+		unit->begin = bounds[ix];
+		unit->end = (ix + 1 < bounds.size()) ? bounds[ix+1] : size;
+		units.push_back(std::move(unit));
+	}
+	return true;
+}
+
+static void scanHistoryUnit(HistoryScanUnit &unit, ExprTree *constraintExpr, ExprTree *stopExpr, const std::atomic<bool> &stop)
+{
+	FILE *fp = safe_fopen_wrapper_follow(unit.file.c_str(), "r");
+	if ( ! fp) { return; }
+	if (fseek(fp, unit.begin, SEEK_SET) == 0) {
+		bool more = true;
+		while (more && ! stop && ftell(fp) < unit.end) {
+			ClassAd *ad = new ClassAd;
+			BannerInfo banner;
+			bool wanted = false;
+			bool malformed = false;
+			more = readHistoryAd(fp, *ad, banner, wanted, &malformed);
+			if (malformed) {
+				// printed by the main thread so it lands among the ads in file order
+				unit.items.push_back({nullptr, unit.scanned, true});
+			}
+			if (wanted) {
+				++unit.scanned;
+				if (stopExpr && EvalExprBool(ad, stopExpr)) {
+					unit.items.push_back({nullptr, unit.scanned});
+				} else if ( ! constraintExpr || EvalExprBool(ad, constraintExpr)) {
+					unit.items.push_back({ad, unit.scanned});
+					continue;
+				}
+			}
+			delete ad;
+		}
+	}
+	fclose(fp);
+}
+
+static void historyScanThread(HistoryScan *scan)
+{
+	// each thread evaluates its own copy of the expressions
+	ExprTree *constraintExpr = scan->constraintExpr ? scan->constraintExpr->Copy() : nullptr;
+	ExprTree *stopExpr = sinceExpr ? sinceExpr->Copy() : nullptr;
+
+	while (true) {
+		size_t ix;
+		{
+			std::unique_lock<std::mutex> lock(scan->mutex);
+			scan->cv.wait(lock, [scan]() {
+				return scan->stop || scan->next_unit >= scan->units.size() ||
+				       scan->next_unit < scan->next_print + scan->window;
+			});
+			if (scan->stop || scan->next_unit >= scan->units.size()) { break; }
+			ix = scan->next_unit++;
+		}
+		HistoryScanUnit &unit = *scan->units[ix];
+		scanHistoryUnit(unit, constraintExpr, stopExpr, scan->stop);
+		{
+			std::lock_guard<std::mutex> lock(scan->mutex);
+			unit.done = true;
+		}
+		scan->cv.notify_all();
+	}
+
+	delete constraintExpr;
+	delete stopExpr;
+}
+
+// Parse and filter history files on several threads, printing the matching
+// ads in the same order, and with the same -limit, -scanlimit and -since
+// behavior, as reading the files one ad at a time.  Returns false if the
+// query should be done by the single threaded readers instead.
+static bool readHistoryParallel(const std::vector<std::string> &files, ExprTree *constraintExpr, bool read_backwards)
+{
+	if ((specifiedMatch > 0 && matchCount >= specifiedMatch) || (maxAds > 0 && adCount >= maxAds)) {
+		return false;
+	}
+	// job id queries stop early and index queries read little, so neither gains from threads
+	if ( ! jobIdFilterInfo.empty() || ! indexKeys.empty() || delete_epoch_ads) {
+		return false;
+	}
+	int num_threads = param_integer("HISTORY_READER_THREADS", 0, 0);
+	if (num_threads == 0) {
+		num_threads = std::min(8, (int)std::thread::hardware_concurrency());
+	}
+	if (num_threads < 2) {
+		return false;
+	}
+
+	HistoryScan scan;
+	for (const auto &file : files) {
+		size_t first = scan.units.size();
+		if ( ! splitHistoryFile(file, scan.units)) {
+			fprintf(stderr,"Error opening history file %s: %s\n", file.c_str(), strerror(errno));
+			exit(1);
+		}
+		if (read_backwards) { std::reverse(scan.units.begin() + first, scan.units.end()); }
+	}
+	if (scan.units.size() < 2) {
+		return false;
+	}
+	num_threads = std::min(num_threads, (int)scan.units.size());
+	scan.constraintExpr = constraintExpr;
+	scan.window = 2 * num_threads;
+
+	std::vector<std::thread> threads;
+	for (int ix = 0; ix < num_threads; ++ix) {
+		threads.emplace_back(historyScanThread, &scan);
+	}
+
+	bool finished = false;
+	long long scanned = adCount;
+	for (size_t ix = 0; ix < scan.units.size() && ! finished; ++ix) {
+		HistoryScanUnit &unit = *scan.units[ix];
+		{
+			std::unique_lock<std::mutex> lock(scan.mutex);
+			scan.cv.wait(lock, [&unit]() { return unit.done; });
+		}
+
+		if (read_backwards) { std::reverse(unit.items.begin(), unit.items.end()); }
+		for (auto &item : unit.items) {
+			if (item.malformed) {
+				printf( "\t*** Warning: Bad history file; skipping malformed ad(s)\n" );
+				continue;
+			}
+			long long pos = scanned + (read_backwards ? unit.scanned - item.pos + 1 : item.pos);
+			if (maxAds > 0 && pos > maxAds) {
+				finished = true;
+				break;
+			}
+			adCount = (int)pos;
+			if ( ! item.ad) {
+				maxAds = adCount; // -since matched, this will force us to stop scanning
+				finished = true;
+				break;
+			}
+			printJob(*item.ad);
+			matchCount++;
+			if ((specifiedMatch > 0 && matchCount >= specifiedMatch) || abort_transfer) {
+				finished = true;
+				break;
+			}
+		}
+		if ( ! finished) {
+			scanned += unit.scanned;
+			adCount = (int)scanned;
+			finished = maxAds > 0 && adCount >= maxAds;
+		}
+
+		for (auto &item : unit.items) { delete item.ad; }
+		unit.items.clear();
+		{
+			std::lock_guard<std::mutex> lock(scan.mutex);
+			scan.next_print = ix + 1;
+		}
+		scan.cv.notify_all();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(scan.mutex);
+		scan.stop = true;
+	}
+	scan.cv.notify_all();
+	for (auto &thread : threads) { thread.join(); }
+	for (auto &unit : scan.units) {
+		for (auto &item : unit->items) { delete item.ad; }
+	}
+	return true;
+}
+
 //PRAGMA_REMIND("tj: TODO fix to handle summary print format")
 static int set_print_mask_from_stream(
 	AttrListPrintMask & print_mask,
@@ -1742,7 +2173,10 @@ static void readHistoryFromSingleFile(bool fileisuserlog, const char *JobHistory
 		jobs.Clear();
 	} else {
 		// If the user specified the name of the file to read, we read that file only.
-		readHistoryFromFileEx(JobHistoryFileName, constraint, constraintExpr, backwards);
+		std::vector<std::string> files{JobHistoryFileName};
+		if ( ! readHistoryParallel(files, constraintExpr, backwards)) {
+			readHistoryFromFileEx(JobHistoryFileName, constraint, constraintExpr, backwards);
+		}
 	}
 
 	printFooter();
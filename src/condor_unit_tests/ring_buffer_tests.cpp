@@ -373,6 +373,39 @@ BOOST_AUTO_TEST_CASE(SetSize_random) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(loglinear_histogram) {
+    stats_histogram_loglinear h;
+
+    BOOST_CHECK_EQUAL(h.Count(), 0u);
+    BOOST_CHECK(h.Quantile(0.99) <= 0.0);
+
+    // bucket bounds are contiguous and each bucket is within 1/16 of its value
+    for (int ix = 1; ix < stats_histogram_loglinear::NumBuckets; ++ix) {
+        uint64_t lo = stats_histogram_loglinear::BucketUpperBound(ix - 1);
+        BOOST_CHECK_EQUAL(stats_histogram_loglinear::BucketIndex(lo), ix);
+        BOOST_CHECK(stats_histogram_loglinear::BucketUpperBound(ix) - lo <= lo / 16 + 1);
+    }
+
+    // 1ms..1000ms, so the percentiles are easy to know
+    for (int ms = 1; ms <= 1000; ++ms) {
+        h.Add(ms / 1000.0);
+    }
+    BOOST_CHECK_EQUAL(h.Count(), 1000u);
+    BOOST_CHECK(h.Sum() > 500.4 && h.Sum() < 500.6);
+
+    double p50 = h.Quantile(0.5), p99 = h.Quantile(0.99);
+    BOOST_CHECK(p50 >= 0.500 && p50 <= 0.500 * 1.07);
+    BOOST_CHECK(p99 >= 0.990 && p99 <= 0.990 * 1.07);
+
+    // huge values are clamped rather than lost
+    h.Add(1e9);
+    BOOST_CHECK_EQUAL(h.Count(), 1001u);
+    BOOST_CHECK(h.Quantile(1.0) > 3600.0);
+
+    h.Clear();
+    BOOST_CHECK_EQUAL(h.Count(), 0u);
+}
+
 #if 1 // no boost
 int main( int /*argc*/, const char ** /*argv*/) {
 
@@ -389,6 +422,7 @@ int main( int /*argc*/, const char ** /*argv*/) {
 	test_ring_buffer_SetSize_larger();
 	test_ring_buffer_SetSize_smaller();
 	test_ring_buffer_SetSize_random();
+	test_ring_buffer_loglinear_histogram();
 	return fail_count;
 }
 #endif
@@ -29,6 +29,7 @@
 #include "condor_email.h"
 
 #include "classadHistory.h"
+#include "history_index.h"
 
 static FILE *HistoryFile_fp = NULL;
 static int HistoryFile_RefCount = 0;
@@ -36,8 +37,10 @@ static int HistoryFile_RefCount = 0;
 char* JobHistoryFileName = NULL;
 char* JobHistoryParamName = NULL;
 bool        DoHistoryRotation = true;
+bool        DoHistoryIndex = true;
 char*       PerJobHistoryDir = NULL;
 static HistoryFileRotationInfo hri;
+static HistoryIndexWriter HistoryIndex;
 
 static void RemoveExtraHistoryFiles(int max_backups, const char* filename);
 static int MaybeDeleteOneHistoryBackup(int max_backups, const char* original_filename);
@@ -71,6 +74,7 @@ InitJobHistoryFile(const char *history_param, const char *per_job_history_param)
     hri.DoDailyHistoryRotation = param_boolean("ROTATE_HISTORY_DAILY", false);
     hri.DoMonthlyHistoryRotation = param_boolean("ROTATE_HISTORY_MONTHLY", false);
     hri.IsStandardHistory = true;
+    DoHistoryIndex = param_boolean("ENABLE_HISTORY_INDEX", true);
 
 	long long default_history = 20 * 1024 * 1024;
 	long long history_filesize = 0;
@@ -150,6 +154,7 @@ AppendHistory(ClassAd* ad)
 	  failed = true;
   } else {
 	  int offset = findHistoryOffset(LogFile);
+	  long ad_start = ftell(LogFile);
 	  if (fputs(ad_string.c_str(), LogFile) == EOF) {
 		  dprintf(D_ALWAYS, 
 				  "ERROR: failed to write job class ad to history file %s\n",
@@ -175,6 +180,12 @@ AppendHistory(ClassAd* ad)
                       "*** Offset = %d ClusterId = %d ProcId = %d Owner = \"%s\" CompletionDate = %d\n",
 				  offset, cluster, proc, owner.c_str(), completion);
 		  fflush( LogFile );
+
+		  long ad_end = ftell(LogFile);
+		  if (DoHistoryIndex && ad_start >= 0 && ad_end > ad_start) {
+			  HistoryIndex.Append(JobHistoryFileName, fileno(LogFile), ad_start, ad_end - ad_start,
+			                      cluster, proc, completion, owner.c_str());
+		  }
       }
   }
 
@@ -344,6 +355,7 @@ CloseJobHistoryFile() {
 		fclose( HistoryFile_fp );
 		HistoryFile_fp = NULL;
 	}
+	HistoryIndex.Close();
 }
 
 // --------------------------------------------------------------------------
@@ -484,6 +496,10 @@ MaybeDeleteOneHistoryBackup(int max_backups, const char* original_filename)
 			if (!dir.Remove_Current_File()) {
 				dprintf(D_ALWAYS, "Failed to delete %s\n", oldest_history_filename);
 				num_backups = 0; // prevent looping forever
+			} else {
+				std::string oldest_path;
+				dircat(history_dir.c_str(), oldest_history_filename, oldest_path);
+				HistoryFileIndex::Remove(oldest_path.c_str());
 			}
 		} else {
 			dprintf(D_ALWAYS, "Failed to find/delete %s\n", oldest_history_filename);
@@ -569,6 +585,8 @@ RotateHistory(bool isHistory, const char* filename, const char* new_path)
         dprintf(D_ALWAYS, "Failed to rotate history file to %s\n",
                 rotated_history_name.c_str());
         dprintf(D_ALWAYS, "Because rotation failed, the history file may get very large.\n");
+    } else {
+        HistoryFileIndex::Rename(filename, rotated_history_name.c_str());
     }
 
     return;
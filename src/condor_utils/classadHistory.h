@@ -23,6 +23,7 @@
 #include "condor_classad.h"
 
 extern bool        DoHistoryRotation;
+extern bool        DoHistoryIndex;
 extern char*       PerJobHistoryDir;
 extern char* JobHistoryFileName;
 
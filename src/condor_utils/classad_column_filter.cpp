@@ -0,0 +1,529 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_classad.h"
+#include "compat_classad_util.h"
+#include "classad_column_filter.h"
+
+using classad::Operation;
+
+// ads are filtered this many at a time, so the columns stay in cache
+static const size_t BATCH_SIZE = 1024;
+
+static bool IsEvalAttrName(const std::string & attr)
+{
+	// names that the evaluator treats specially when the ad doesn't define them
+	static const char * const special_names[] = {
+		"toplevel", "root", "self", "parent", "my", "CurrentTime",
+	};
+	for (const char * name : special_names) {
+		if (MATCH == strcasecmp(name, attr.c_str())) return true;
+	}
+	return false;
+}
+
+// the comparison operators, applied to two values of the same type
+template <class T>
+static inline bool CompareValues(Operation::OpKind op, T a, T b)
+{
+	switch (op) {
+	case Operation::LESS_THAN_OP:        return a < b;
+	case Operation::LESS_OR_EQUAL_OP:    return a <= b;
+	case Operation::EQUAL_OP:            return a == b;
+	case Operation::META_EQUAL_OP:       return a == b;
+	case Operation::NOT_EQUAL_OP:        return a != b;
+	case Operation::META_NOT_EQUAL_OP:   return a != b;
+	case Operation::GREATER_THAN_OP:     return a > b;
+	case Operation::GREATER_OR_EQUAL_OP: return a >= b;
+	default:                             return false;
+	}
+}
+
+// compare whole columns of numbers of the same type.  kept free of
+// branches inside the loops so the compiler can vectorize them.
+#define COMPARE_COLUMNS(OPER) \
+	if (a_const && b_const) { \
+		long long v = a[0] OPER b[0]; \
+		for (size_t r = 0; r < rows; ++r) { out[r] = v; } \
+	} else if (a_const) { \
+		T x = a[0]; \
+		for (size_t r = 0; r < rows; ++r) { out[r] = x OPER b[r]; } \
+	} else if (b_const) { \
+		T y = b[0]; \
+		for (size_t r = 0; r < rows; ++r) { out[r] = a[r] OPER y; } \
+	} else { \
+		for (size_t r = 0; r < rows; ++r) { out[r] = a[r] OPER b[r]; } \
+	}
+
+template <class T>
+static void CompareColumns(Operation::OpKind op, const T * a, bool a_const, const T * b, bool b_const, long long * out, size_t rows)
+{
+	switch (op) {
+	case Operation::LESS_THAN_OP:        COMPARE_COLUMNS(<);  break;
+	case Operation::LESS_OR_EQUAL_OP:    COMPARE_COLUMNS(<=); break;
+	case Operation::EQUAL_OP:
+	case Operation::META_EQUAL_OP:       COMPARE_COLUMNS(==); break;
+	case Operation::NOT_EQUAL_OP:
+	case Operation::META_NOT_EQUAL_OP:   COMPARE_COLUMNS(!=); break;
+	case Operation::GREATER_THAN_OP:     COMPARE_COLUMNS(>);  break;
+	case Operation::GREATER_OR_EQUAL_OP: COMPARE_COLUMNS(>=); break;
+	default: break;
+	}
+}
+
+#undef COMPARE_COLUMNS
+
+
+void
+ClassAdColumnFilter::Column::resize(size_t rows)
+{
+	kind.resize(rows);
+	ival.resize(rows);
+	rval.resize(rows);
+	sval.resize(rows);
+}
+
+void
+ClassAdColumnFilter::Column::set(size_t row, const classad::Value & val, std::deque<std::string> & strings)
+{
+	bool bval = false;
+	switch (val.GetType()) {
+	case classad::Value::UNDEFINED_VALUE: kind[row] = K_UNDEF; break;
+	case classad::Value::ERROR_VALUE:     kind[row] = K_ERROR; break;
+	case classad::Value::BOOLEAN_VALUE:
+		val.IsBooleanValue(bval);
+		setBool(row, bval);
+		break;
+	case classad::Value::INTEGER_VALUE:
+		kind[row] = K_INT;
+		val.IsIntegerValue(ival[row]);
+		break;
+	case classad::Value::REAL_VALUE:
+		kind[row] = K_REAL;
+		val.IsRealValue(rval[row]);
+		break;
+	case classad::Value::STRING_VALUE:
+		kind[row] = K_STRING;
+		strings.emplace_back();
+		val.IsStringValue(strings.back());
+		sval[row] = strings.back().c_str();
+		break;
+	default:
+		kind[row] = K_OTHER;
+		break;
+	}
+}
+
+void
+ClassAdColumnFilter::Column::findUniform()
+{
+	uniform = kind.empty() ? (unsigned char)K_MIXED : kind[0];
+	for (unsigned char k : kind) {
+		if (k != uniform) { uniform = K_MIXED; break; }
+	}
+}
+
+
+int
+ClassAdColumnFilter::Compile(classad::ExprTree * tree)
+{
+	Node node;
+	node.type = N_EVAL;
+	node.tree = tree;
+
+	tree = SkipExprEnvelope(tree);
+	switch (tree->GetKind()) {
+	case classad::ExprTree::ERROR_LITERAL:
+	case classad::ExprTree::UNDEFINED_LITERAL:
+	case classad::ExprTree::BOOLEAN_LITERAL:
+	case classad::ExprTree::INTEGER_LITERAL:
+	case classad::ExprTree::REAL_LITERAL:
+	case classad::ExprTree::STRING_LITERAL:
+		node.type = N_LITERAL;
+		((classad::Literal*)tree)->GetValue(node.lit);
+		break;
+
+	case classad::ExprTree::ATTRREF_NODE: {
+		classad::ExprTree * scope = nullptr;
+		std::string attr;
+		bool absolute = false;
+		((classad::AttributeReference*)tree)->GetComponents(scope, attr, absolute);
+		if ( ! scope && ! absolute && ! IsEvalAttrName(attr)) {
+			node.type = N_ATTR;
+			node.attr = attr;
+		}
+	}
+	break;
+
+	case classad::ExprTree::OP_NODE: {
+		Operation::OpKind op;
+		classad::ExprTree *t1, *t2, *t3;
+		((Operation*)tree)->GetComponents(op, t1, t2, t3);
+		if (op == Operation::PARENTHESES_OP) {
+			return Compile(t1);
+		}
+		if (op >= Operation::__COMPARISON_START__ && op <= Operation::__COMPARISON_END__) {
+			node.type = N_CMP;
+		} else if (op == Operation::LOGICAL_AND_OP) {
+			node.type = N_AND;
+		} else if (op == Operation::LOGICAL_OR_OP) {
+			node.type = N_OR;
+		} else if (op == Operation::LOGICAL_NOT_OP) {
+			node.type = N_NOT;
+		} else {
+			break;
+		}
+		node.op = op;
+		node.left = Compile(t1);
+		if (node.type != N_NOT) {
+			node.right = Compile(t2);
+		}
+	}
+	break;
+
+	default:
+		break;
+	}
+
+	m_nodes.push_back(std::move(node));
+	return (int)m_nodes.size() - 1;
+}
+
+bool
+ClassAdColumnFilter::Init(classad::ExprTree * constraint)
+{
+	m_constraint = constraint;
+	m_nodes.clear();
+	m_columns.clear();
+	if ( ! constraint) {
+		return false;
+	}
+
+	Compile(constraint);
+	if (m_nodes.back().type == N_EVAL) {
+		// nothing to gain over evaluating the whole thing
+		m_nodes.clear();
+		return false;
+	}
+	m_columns.resize(m_nodes.size());
+	return true;
+}
+
+
+void
+ClassAdColumnFilter::EvalAttr(const Node & node, Column & col, const std::vector<ClassAd *> & ads, size_t begin, size_t rows)
+{
+	for (size_t r = 0; r < rows; ++r) {
+		ClassAd * ad = ads[begin + r];
+		classad::ExprTree * expr = ad->Lookup(node.attr);
+		if ( ! expr) {
+			// unless the ad has an alternate scope to look in, the reference is undefined
+			col.setKind(r, ad->alternateScope ? K_OTHER : K_UNDEF);
+			continue;
+		}
+
+		expr = SkipExprEnvelope(expr);
+		switch (expr->GetKind()) {
+		case classad::ExprTree::UNDEFINED_LITERAL:
+			col.setKind(r, K_UNDEF);
+			break;
+		case classad::ExprTree::ERROR_LITERAL:
+			col.setKind(r, K_ERROR);
+			break;
+		case classad::ExprTree::BOOLEAN_LITERAL:
+			col.setBool(r, ((classad::BooleanLiteral*)expr)->getBool());
+			break;
+		case classad::ExprTree::INTEGER_LITERAL:
+			col.kind[r] = K_INT;
+			col.ival[r] = ((classad::IntegerLiteral*)expr)->getInteger();
+			break;
+		case classad::ExprTree::REAL_LITERAL:
+			col.kind[r] = K_REAL;
+			col.rval[r] = ((classad::RealLiteral*)expr)->getReal();
+			break;
+		case classad::ExprTree::STRING_LITERAL:
+			col.kind[r] = K_STRING;
+			col.sval[r] = ((classad::StringLiteral*)expr)->getCString();
+			break;
+		default: {
+			// an expression, which evaluates the same here as it does
+			// when the constraint refers to it
+			classad::Value val;
+			if (ad->EvaluateAttr(node.attr, val)) {
+				col.set(r, val, m_strings);
+			} else {
+				col.setKind(r, K_OTHER);
+			}
+		}
+		break;
+		}
+	}
+}
+
+void
+ClassAdColumnFilter::EvalCompare(const Node & node, Column & out, const Column & a, const Column & b, size_t rows)
+{
+	const Operation::OpKind op = node.op;
+	const bool meta = (op == Operation::META_EQUAL_OP || op == Operation::META_NOT_EQUAL_OP);
+
+	if ((a.uniform == K_INT && b.uniform == K_INT) || (a.uniform == K_REAL && b.uniform == K_REAL)) {
+		if (a.uniform == K_INT) {
+			CompareColumns(op, a.ival.data(), a.constant, b.ival.data(), b.constant, out.ival.data(), rows);
+		} else {
+			CompareColumns(op, a.rval.data(), a.constant, b.rval.data(), b.constant, out.ival.data(), rows);
+		}
+		memset(out.kind.data(), K_BOOL, rows);
+		return;
+	}
+
+	for (size_t r = 0; r < rows; ++r) {
+		size_t ra = a.constant ? 0 : r;
+		size_t rb = b.constant ? 0 : r;
+		unsigned char ka = a.kind[ra], kb = b.kind[rb];
+
+		if (ka == K_OTHER || kb == K_OTHER) {
+			out.setKind(r, K_OTHER);
+			continue;
+		}
+
+		if (meta) {
+			// =?= and =!= want the same type and value, with no promotions
+			bool same;
+			if (ka != kb) {
+				out.setBool(r, op == Operation::META_NOT_EQUAL_OP);
+				continue;
+			}
+			switch (ka) {
+			case K_UNDEF:
+			case K_ERROR:
+				out.setBool(r, op == Operation::META_EQUAL_OP);
+				continue;
+			case K_STRING:
+				out.setBool(r, CompareValues(op, strcmp(a.sval[ra], b.sval[rb]), 0));
+				continue;
+			case K_REAL:
+				out.setBool(r, CompareValues(op, a.rval[ra], b.rval[rb]));
+				continue;
+			default: // int or bool
+				same = a.ival[ra] == b.ival[rb];
+				out.setBool(r, (op == Operation::META_EQUAL_OP) == same);
+				continue;
+			}
+		}
+
+		// the other comparisons are strict
+		if (ka == K_ERROR || kb == K_ERROR) {
+			out.setKind(r, K_ERROR);
+		} else if (ka == K_UNDEF || kb == K_UNDEF) {
+			out.setKind(r, K_UNDEF);
+		} else if (ka == K_STRING || kb == K_STRING) {
+			if (ka == K_STRING && kb == K_STRING) {
+				out.setBool(r, CompareValues(op, strcasecmp(a.sval[ra], b.sval[rb]), 0));
+			} else {
+				out.setKind(r, K_ERROR);
+			}
+		} else if (ka != K_REAL && kb != K_REAL) {
+			// booleans compare as integers
+			out.setBool(r, CompareValues(op, a.ival[ra], b.ival[rb]));
+		} else {
+			double x = (ka == K_REAL) ? a.rval[ra] : (double)a.ival[ra];
+			double y = (kb == K_REAL) ? b.rval[rb] : (double)b.ival[rb];
+			out.setBool(r, CompareValues(op, x, y));
+		}
+	}
+}
+
+// numbers are as good as booleans to the logical operators
+unsigned char
+ClassAdColumnFilter::AsLogical(unsigned char k, long long ival, double rval, bool & b)
+{
+	switch (k) {
+	case K_BOOL:
+	case K_INT:  b = ival != 0; return K_BOOL;
+	case K_REAL: b = rval != 0; return K_BOOL;
+	default:     return k;
+	}
+}
+
+void
+ClassAdColumnFilter::EvalLogic(const Node & node, Column & out, const Column & a, const Column & b, size_t rows)
+{
+	const bool is_and = (node.type == N_AND);
+
+	if (a.uniform == K_BOOL && b.uniform == K_BOOL && ! a.constant && ! b.constant) {
+		const long long * x = a.ival.data();
+		const long long * y = b.ival.data();
+		long long * z = out.ival.data();
+		if (is_and) {
+			for (size_t r = 0; r < rows; ++r) { z[r] = x[r] & y[r]; }
+		} else {
+			for (size_t r = 0; r < rows; ++r) { z[r] = x[r] | y[r]; }
+		}
+		memset(out.kind.data(), K_BOOL, rows);
+		return;
+	}
+
+	for (size_t r = 0; r < rows; ++r) {
+		size_t ra = a.constant ? 0 : r;
+		size_t rb = b.constant ? 0 : r;
+		bool ba = false, bb = false;
+		unsigned char ka = AsLogical(a.kind[ra], a.ival[ra], a.rval[ra], ba);
+		unsigned char kb = AsLogical(b.kind[rb], b.ival[rb], b.rval[rb], bb);
+
+		// the right side isn't even evaluated when the left decides it
+		if (ka == K_BOOL && ba != is_and) {
+			out.setBool(r, ba);
+			continue;
+		}
+		if (ka == K_OTHER || kb == K_OTHER) {
+			out.setKind(r, K_OTHER);
+			continue;
+		}
+		if ((ka != K_UNDEF && ka != K_ERROR && ka != K_BOOL) ||
+			(kb != K_UNDEF && kb != K_ERROR && kb != K_BOOL) ||
+			ka == K_ERROR) {
+			out.setKind(r, K_ERROR);
+		} else if (ka == K_BOOL) {
+			// true && b, false || b
+			if (kb == K_BOOL) { out.setBool(r, bb); } else { out.setKind(r, (Kind)kb); }
+		} else if (kb != K_BOOL) {
+			// undefined && undefined, undefined || error and so on
+			out.setKind(r, (Kind)kb);
+		} else if (bb != is_and) {
+			// undefined && false, undefined || true
+			out.setBool(r, bb);
+		} else {
+			out.setKind(r, K_UNDEF);
+		}
+	}
+}
+
+void
+ClassAdColumnFilter::EvalNot(Column & out, const Column & a, size_t rows)
+{
+	for (size_t r = 0; r < rows; ++r) {
+		size_t ra = a.constant ? 0 : r;
+		bool ba = false;
+		unsigned char ka = AsLogical(a.kind[ra], a.ival[ra], a.rval[ra], ba);
+		switch (ka) {
+		case K_BOOL:  out.setBool(r, ! ba); break;
+		case K_UNDEF:
+		case K_ERROR:
+		case K_OTHER: out.setKind(r, (Kind)ka); break;
+		default:      out.setKind(r, K_ERROR); break;
+		}
+	}
+}
+
+void
+ClassAdColumnFilter::EvalNode(int ix, const std::vector<ClassAd *> & ads, size_t begin, size_t rows)
+{
+	const Node & node = m_nodes[ix];
+	Column & col = m_columns[ix];
+
+	if (node.type == N_LITERAL) {
+		col.constant = true;
+		col.resize(1);
+		col.set(0, node.lit, m_strings);
+		col.uniform = col.kind[0];
+		return;
+	}
+
+	col.constant = false;
+	col.resize(rows);
+	switch (node.type) {
+	case N_ATTR:
+		EvalAttr(node, col, ads, begin, rows);
+		break;
+	case N_EVAL:
+		for (size_t r = 0; r < rows; ++r) {
+			classad::Value val;
+			if (EvalExprTree(node.tree, ads[begin + r], NULL, val, classad::Value::ValueType::SAFE_VALUES)) {
+				col.set(r, val, m_strings);
+			} else {
+				col.setKind(r, K_OTHER);
+			}
+		}
+		m_stats.subtree_evals += rows;
+		break;
+	case N_CMP:
+		EvalCompare(node, col, m_columns[node.left], m_columns[node.right], rows);
+		break;
+	case N_AND:
+	case N_OR:
+		EvalLogic(node, col, m_columns[node.left], m_columns[node.right], rows);
+		break;
+	case N_NOT:
+		EvalNot(col, m_columns[node.left], rows);
+		break;
+	case N_LITERAL:
+		break;
+	}
+
+	for (size_t r = 0; r < rows; ++r) {
+		if (col.kind[r] == K_OTHER) { m_fallback[r] = true; }
+	}
+	col.findUniform();
+}
+
+void
+ClassAdColumnFilter::Filter(const std::vector<ClassAd *> & ads, std::vector<bool> & matched)
+{
+	matched.assign(ads.size(), false);
+	m_stats.ads += ads.size();
+
+	classad::Value result;
+	bool val = false;
+
+	if (m_nodes.empty()) {
+		for (size_t ix = 0; ix < ads.size(); ++ix) {
+			matched[ix] = EvalExprToBool(m_constraint, ads[ix], NULL, result) &&
+				result.IsBooleanValueEquiv(val) && val;
+		}
+		m_stats.fallback_ads += ads.size();
+		return;
+	}
+
+	for (size_t begin = 0; begin < ads.size(); begin += BATCH_SIZE) {
+		size_t rows = std::min(BATCH_SIZE, ads.size() - begin);
+		m_fallback.assign(rows, false);
+		m_strings.clear();
+
+		for (int ix = 0; ix < (int)m_nodes.size(); ++ix) {
+			EvalNode(ix, ads, begin, rows);
+		}
+
+		const Column & root = m_columns.back();
+		for (size_t r = 0; r < rows; ++r) {
+			if (m_fallback[r]) {
+				matched[begin + r] = EvalExprToBool(m_constraint, ads[begin + r], NULL, result) &&
+					result.IsBooleanValueEquiv(val) && val;
+				m_stats.fallback_ads++;
+				continue;
+			}
+			switch (root.kind[r]) {
+			case K_BOOL:
+			case K_INT:  matched[begin + r] = root.ival[r] != 0; break;
+			case K_REAL: matched[begin + r] = root.rval[r] != 0; break;
+			default:     matched[begin + r] = false; break;
+			}
+		}
+	}
+}
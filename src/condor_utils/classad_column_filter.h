@@ -0,0 +1,117 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _CLASSAD_COLUMN_FILTER_H
+#define _CLASSAD_COLUMN_FILTER_H
+
+#include "condor_classad.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+/*
+ Evaluates a constraint against many ads at once, the way a query does
+ when it filters a table of ads.
+
+ Rather than walk the expression tree once per ad, the attributes the
+ constraint refers to are copied out of a batch of ads into typed
+ columns, and each comparison, &&, || and ! in the constraint is then
+ applied to whole columns with simple loops, which are much faster when
+ every ad has the same type of value for an attribute.
+
+ The result for each ad is the same as EvalExprToBool(constraint, ad, NULL)
+ followed by IsBooleanValueEquiv().  Parts of the constraint that aren't
+ comparisons or logic over unscoped attributes and literals (function
+ calls, arithmetic, MY.x and so on) are evaluated for each ad on their own
+ and fed into the columns.  An ad whose attribute values are lists,
+ ClassAds or times is evaluated in full the old way.
+*/
+class ClassAdColumnFilter
+{
+public:
+	struct Stats {
+		long ads{0};           // ads filtered
+		long fallback_ads{0};  // ads evaluated with the tree evaluator
+		long subtree_evals{0}; // evaluations of unsupported parts of the constraint
+	};
+
+		// Prepare to filter with constraint, which must outlive the filter.
+		// Returns false when no part of the constraint can be done by
+		// columns, in which case Filter() just evaluates it for each ad.
+	bool Init(classad::ExprTree *constraint);
+
+		// Set matched[i] to true if the constraint is true for ads[i].
+	void Filter(const std::vector<ClassAd *> &ads, std::vector<bool> &matched);
+
+	bool IsColumnar() const { return ! m_nodes.empty(); }
+	const Stats & stats() const { return m_stats; }
+
+private:
+	enum Kind : unsigned char {
+		K_UNDEF, K_ERROR, K_BOOL, K_INT, K_REAL, K_STRING,
+		K_OTHER, // something we don't handle, the ad is evaluated in full
+		K_MIXED, // only as Column::uniform
+	};
+
+	enum NodeType { N_LITERAL, N_ATTR, N_EVAL, N_CMP, N_AND, N_OR, N_NOT };
+
+	struct Node {
+		NodeType type;
+		classad::Operation::OpKind op{classad::Operation::__NO_OP__};
+		int left{-1}, right{-1};        // child nodes
+		std::string attr;               // for N_ATTR
+		classad::ExprTree *tree{nullptr}; // for N_EVAL
+		classad::Value lit;             // for N_LITERAL
+	};
+
+		// the values of one node of the constraint for a batch of ads.
+		// booleans are kept in ival.  a constant column has only one row.
+	struct Column {
+		std::vector<unsigned char> kind;
+		std::vector<long long> ival;
+		std::vector<double> rval;
+		std::vector<const char *> sval;
+		unsigned char uniform{K_MIXED};
+		bool constant{false};
+
+		void resize(size_t rows);
+		void set(size_t row, const classad::Value &val, std::deque<std::string> &strings);
+		void setKind(size_t row, Kind k) { kind[row] = k; }
+		void setBool(size_t row, bool b) { kind[row] = K_BOOL; ival[row] = b; }
+		void findUniform();
+	};
+
+	static unsigned char AsLogical(unsigned char k, long long ival, double rval, bool &b);
+
+	int Compile(classad::ExprTree *tree);
+	void EvalNode(int ix, const std::vector<ClassAd *> &ads, size_t begin, size_t rows);
+	void EvalAttr(const Node &node, Column &col, const std::vector<ClassAd *> &ads, size_t begin, size_t rows);
+	void EvalCompare(const Node &node, Column &out, const Column &a, const Column &b, size_t rows);
+	void EvalLogic(const Node &node, Column &out, const Column &a, const Column &b, size_t rows);
+	void EvalNot(Column &out, const Column &a, size_t rows);
+
+	classad::ExprTree *m_constraint{nullptr};
+	std::vector<Node> m_nodes;     // children before parents, the root is last
+	std::vector<Column> m_columns; // one per node
+	std::vector<bool> m_fallback;  // per row of the batch
+	std::deque<std::string> m_strings; // string values computed for the batch
+	Stats m_stats;
+};
+
+#endif
@@ -603,14 +603,11 @@ int _putClassAd( Stream *sock, const classad::ClassAd& ad, int options,
 
 	int numExprs=0;
 
-	classad::AttrList::const_iterator itor;
-	classad::AttrList::const_iterator itor_end;
-
-	bool haveChainedAd = false;
-
-	const classad::ClassAd *chainedAd = ad.GetChainedParentAd();
-	if(chainedAd){
-		haveChainedAd = true;
+	// the ad and its chained parents, outermost parent first, so that
+	// when there are duplicates, the attributes of the child override them
+	std::vector<const classad::ClassAd *> chain;
+	for (const classad::ClassAd * parent = &ad; parent; parent = parent->GetChainedParentAd()) {
+		chain.insert(chain.begin(), parent);
 	}
 
 	bool crypto_is_noop = sock->prepare_crypto_for_secret_is_noop();
@@ -619,26 +616,13 @@ int _putClassAd( Stream *sock, const classad::ClassAd& ad, int options,
 	// where we care (when selectively encrypting them or when excluding
 	// them).
 	int private_count = 0;
-	for(int pass = 0; pass < 2; pass++){
+	for (const classad::ClassAd * link : chain) {
 
 		/*
-		* Count the number of chained attributes on the first
-		*   pass (if any!), then the number of attrs in this classad on
-		*   pass number 2.
+		* Count the number of attributes of each chained parent,
+		*   then the number of attrs in this classad.
 		*/
-		if(pass == 0){
-			if(!haveChainedAd){
-				continue;
-			}
-			itor = chainedAd->begin();
-			itor_end = chainedAd->end();
-		}
-		else {
-			itor = ad.begin();
-			itor_end = ad.end();
-		}
-
-		for(;itor != itor_end; itor++) {
+		for (auto itor = link->begin(); itor != link->end(); itor++) {
 			std::string const &attr = itor->first;
 
 			// This logic is paralleled below when sending the attributes.
@@ -675,24 +659,12 @@ int _putClassAd( Stream *sock, const classad::ClassAd& ad, int options,
 		return false;
 	}
 
-	for(int pass = 0; pass < 2; pass++){
-		if(pass == 0) {
-			/* need to copy the chained attrs first, so if
-				*  there are duplicates, the non-chained attrs
-				*  will override them
-				*/
-			if(!haveChainedAd){
-				continue;
-			}
-			itor = chainedAd->begin();
-			itor_end = chainedAd->end();
-		} 
-		else {
-			itor = ad.begin();
-			itor_end = ad.end();
-		}
-
-		for(;itor != itor_end; itor++) {
+	for (const classad::ClassAd * link : chain) {
+		/* need to copy the chained attrs first, so if
+			*  there are duplicates, the non-chained attrs
+			*  will override them
+			*/
+		for (auto itor = link->begin(); itor != link->end(); itor++) {
 			std::string const &attr = itor->first;
 			classad::ExprTree const *expr = itor->second;
 
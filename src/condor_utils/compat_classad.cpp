@@ -183,6 +183,11 @@ void releaseTheMatchAd()
 	the_match_ad_in_use = false;
 }
 
+void setTheMatchAdEvalCache( classad::EvalCache *cache )
+{
+	the_match_ad.SetEvalCache( cache );
+}
+
 
 static
 bool stringListSize_func( const char * /*name*/,
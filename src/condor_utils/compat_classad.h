@@ -409,6 +409,11 @@ classad::MatchClassAd *getTheMatchAd( classad::ClassAd *source,
                                       const std::string &source_alias = "",
                                       const std::string &target_alias = "" );
 void releaseTheMatchAd();
+	/** Have evaluations in the ad returned by getTheMatchAd() reuse values
+	 *  that depend only on one side of the match (see classad::EvalCache).
+	 *  Pass NULL to stop.  The caller owns the cache.
+	 */
+void setTheMatchAdEvalCache( classad::EvalCache *cache );
 
 
 const char *ConvertEscapingOldToNew( const char *str );
@@ -471,6 +471,41 @@ const char* ULogEvent::eventName(void) const
 }
 
 
+// Turn the broken down time of an event header into a time_t.  mktime()
+// consults the time zone rules on every call, which makes it one of the
+// more expensive parts of reading an event, and neighbouring events in a
+// log are nearly always stamped within the same minute.  So we remember
+// the start of the last minute converted and just add the seconds when the
+// next event falls in the same minute.
+static time_t
+header_time_to_clock(struct tm & dt, bool is_utc)
+{
+	thread_local struct {
+		int year = -1, mon = -1, mday = -1, hour = -1, min = -1;
+		bool utc = false;
+		time_t minute_clock = 0;
+	} last;
+
+	if (dt.tm_year < 0 || dt.tm_min < 0 || dt.tm_sec < 0 || dt.tm_sec > 59) {
+		return is_utc ? timegm(&dt) : mktime(&dt);
+	}
+	if (dt.tm_min == last.min && dt.tm_hour == last.hour && dt.tm_mday == last.mday &&
+		dt.tm_mon == last.mon && dt.tm_year == last.year && is_utc == last.utc) {
+		return last.minute_clock + dt.tm_sec;
+	}
+
+	struct tm minute = dt;
+	minute.tm_sec = 0;
+	time_t minute_clock = is_utc ? timegm(&minute) : mktime(&minute);
+	if (minute_clock == (time_t)-1) {
+		return is_utc ? timegm(&dt) : mktime(&dt);
+	}
+	last.year = dt.tm_year; last.mon = dt.tm_mon; last.mday = dt.tm_mday;
+	last.hour = dt.tm_hour; last.min = dt.tm_min; last.utc = is_utc;
+	last.minute_clock = minute_clock;
+	return minute_clock + dt.tm_sec;
+}
+
 #if 1
 
 // 000 (16091.000.000) 01/22 12:09:19 Job submitted from host: 
@@ -566,11 +601,7 @@ const char * ULogEvent::readHeader(const char * p)
 
 	// Need to set eventclock here, otherwise eventclock and
 	// eventTime will not match!!  (See gittrac #5468.)
-	if (is_utc) {
-		eventclock = timegm(&dt);
-	} else {
-		eventclock = mktime(&dt);
-	}
+	eventclock = header_time_to_clock(dt, is_utc);
 
 	if (datend && datend[0] == ' ') ++datend;
 	return datend;
@@ -2562,6 +2593,41 @@ TerminatedEvent::formatBody( std::string &out, const char *header )
 }
 
 
+// Scan a "\t<bytes>  -  Run Bytes Sent By Job" line of a terminated event
+// into its four fields, returning the number of fields scanned as sscanf
+// would.  The lines we write are matched by hand, anything else is left to
+// sscanf. srun, sdir and sjob must hold 6, 9 and 22 characters.
+static int
+scan_bytes_line(const char * sz, float & val, char * srun, char * sdir, char * sjob)
+{
+	if (sz[0] == '\t') {
+		char * endp = nullptr;
+		double bytes = strtod(sz+1, &endp);
+		const char * p = endp;
+		const char * run = nullptr;
+		const char * dir = nullptr;
+		if (p != sz+1 && strncmp(p, "  -  ", 5) == 0) {
+			p += 5;
+			if (strncmp(p, "Run Bytes ", 10) == 0) { run = "Run"; p += 10; }
+			else if (strncmp(p, "Total Bytes ", 12) == 0) { run = "Total"; p += 12; }
+		}
+		if (run) {
+			if (strncmp(p, "Sent By ", 8) == 0) { dir = "Sent"; p += 8; }
+			else if (strncmp(p, "Received By ", 12) == 0) { dir = "Received"; p += 12; }
+		}
+		size_t len = strcspn(p, " \t\r\n");
+		if (dir && len > 0 && len < 22) {
+			val = (float)bytes;
+			strcpy(srun, run);
+			strcpy(sdir, dir);
+			memcpy(sjob, p, len);
+			sjob[len] = 0;
+			return 4;
+		}
+	}
+	return sscanf(sz, "\t%f  -  %5s Bytes %8s By %21s", &val, srun, sdir, sjob);
+}
+
 int
 TerminatedEvent::readEventBody( ULogFile& file, bool & got_sync_line, const char* header )
 {
@@ -2650,7 +2716,7 @@ TerminatedEvent::readEventBody( ULogFile& file, bool & got_sync_line, const char
 		// where "Run" "Sent" and "Job" can all vary. 
 		float val; srun[0] = sdir[0] = sjob[0] = 0;
 		bool fOK = false;
-		if (4 == sscanf(sz, "\t%f  -  %5s Bytes %8s By %21s", &val, srun, sdir, sjob)) {
+		if (4 == scan_bytes_line(sz, val, srun, sdir, sjob)) {
 			if (!strcmp(sjob,header)) {
 				if (!strcmp(srun,"Run")) {
 					if (!strcmp(sdir,"Sent")) {
@@ -3586,12 +3652,41 @@ ULogEvent::readRusageLine (std::string &line, ULogFile& file, bool & got_sync_li
 		return false;
 	}
 
-	retval = sscanf (line.c_str(), "\tUsr %d %d:%d:%d, Sys %d %d:%d:%d%n",
-					&usr_days, &usr_hours, &usr_minutes, &usr_secs,
-					&sys_days, &sys_hours, &sys_minutes, &sys_secs,
-					&remain);
-	if (retval < 8) {
-		return false;
+	// Parse the line as we write it by hand, and fall back to sscanf
+	// for anything that doesn't match exactly.
+	int vals[8] = {};
+	const char * p = line.c_str();
+	if (strncmp(p, "\tUsr ", 5) == 0) {
+		p += 5;
+		for (int ix = 0; ix < 8 && p; ++ix) {
+			if (ix == 4) {
+				p = (strncmp(p, ", Sys ", 6) == 0) ? p + 6 : nullptr;
+				if ( ! p) break;
+			}
+			if (*p < '0' || *p > '9') { p = nullptr; break; }
+			int val = 0;
+			while (*p >= '0' && *p <= '9') { val = val*10 + (*p++ - '0'); }
+			vals[ix] = val;
+			char sep = (ix == 0 || ix == 4) ? ' ' : ':';
+			if (ix != 3 && ix != 7) {
+				p = (*p == sep) ? p + 1 : nullptr;
+			}
+		}
+	} else {
+		p = nullptr;
+	}
+	if (p) {
+		usr_days = vals[0]; usr_hours = vals[1]; usr_minutes = vals[2]; usr_secs = vals[3];
+		sys_days = vals[4]; sys_hours = vals[5]; sys_minutes = vals[6]; sys_secs = vals[7];
+		remain = (int)(p - line.c_str());
+	} else {
+		retval = sscanf (line.c_str(), "\tUsr %d %d:%d:%d, Sys %d %d:%d:%d%n",
+						&usr_days, &usr_hours, &usr_minutes, &usr_secs,
+						&sys_days, &sys_hours, &sys_minutes, &sys_secs,
+						&remain);
+		if (retval < 8) {
+			return false;
+		}
 	}
 
 	usage.ru_utime.tv_sec = usr_secs + usr_minutes*minutes + usr_hours*hours +
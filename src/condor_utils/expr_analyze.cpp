@@ -29,6 +29,7 @@
 
 #include <map>
 #include <vector>
+#include <thread>
 #include "classad/classadCache.h" // for CachedExprEnvelope
 #include "expr_analyze.h"
 
@@ -690,6 +691,162 @@ const char * PrettyPrintExprTree(classad::ExprTree *tree, std::string & temp_buf
 	return temp_buffer.c_str();
 }
 
+// collects the names of the attributes an expression refers to, whatever their scope.
+// references we can't resolve to an attribute of one of the two ads, and calls to
+// functions that are not a pure function of their arguments make it volatile.
+class AnalRefCollector
+{
+public:
+	classad::References names;
+	bool is_volatile{false};
+
+	// walk an expression, appending the names it refers to that we have not seen before to added
+	void Walk(classad::ExprTree * tree, std::vector<std::string> & added)
+	{
+		if ( ! tree || is_volatile) return;
+		switch (tree->GetKind()) {
+
+		case classad::ExprTree::ATTRREF_NODE: {
+			classad::ExprTree * expr = nullptr;
+			std::string attr, scope;
+			bool absolute = false;
+			((const classad::AttributeReference*)tree)->GetComponents(expr, attr, absolute);
+			if (absolute || MATCH == strcasecmp(attr.c_str(), "CurrentTime")) {
+				is_volatile = true;
+			} else if ( ! expr || (ExprTreeIsAttrRef(expr, scope) &&
+				(MATCH == strcasecmp(scope.c_str(), "MY") || MATCH == strcasecmp(scope.c_str(), "TARGET")))) {
+				if (names.insert(attr).second) { added.push_back(attr); }
+			} else {
+				is_volatile = true;
+			}
+		}
+		break;
+
+		case classad::ExprTree::OP_NODE: {
+			classad::Operation::OpKind op;
+			classad::ExprTree *t1, *t2, *t3;
+			((const classad::Operation*)tree)->GetComponents(op, t1, t2, t3);
+			Walk(t1, added);
+			Walk(t2, added);
+			Walk(t3, added);
+		}
+		break;
+
+		case classad::ExprTree::FN_CALL_NODE: {
+			std::string fnName;
+			std::vector<classad::ExprTree*> args;
+			((const classad::FunctionCall*)tree)->GetComponents(fnName, args);
+			if (classad::FunctionCall::IsVolatileFunction(fnName)) { is_volatile = true; }
+			for (auto * arg : args) { Walk(arg, added); }
+		}
+		break;
+
+		case classad::ExprTree::EXPR_LIST_NODE: {
+			std::vector<classad::ExprTree*> exprs;
+			((const classad::ExprList*)tree)->GetComponents(exprs);
+			for (auto * expr : exprs) { Walk(expr, added); }
+		}
+		break;
+
+		case classad::ExprTree::EXPR_ENVELOPE:
+			Walk(SkipExprEnvelope(tree), added);
+			break;
+
+		case classad::ExprTree::ERROR_LITERAL:
+		case classad::ExprTree::UNDEFINED_LITERAL:
+		case classad::ExprTree::BOOLEAN_LITERAL:
+		case classad::ExprTree::INTEGER_LITERAL:
+		case classad::ExprTree::REAL_LITERAL:
+		case classad::ExprTree::RELTIME_LITERAL:
+		case classad::ExprTree::ABSTIME_LITERAL:
+		case classad::ExprTree::STRING_LITERAL:
+			break;
+
+		default:
+			// nested ads can refer to anything
+			is_volatile = true;
+			break;
+		}
+	}
+};
+
+// A group of targets that agree on the value of every attribute the analyzed expression
+// can reach, through the request ad or through their own attributes.  Every sub-expression
+// evaluates the same against all of them, so only the first of each group is evaluated.
+struct AnalTargetGroup {
+	ClassAd * target{nullptr};
+	int count{0};
+	std::vector<classad::ExprTree*> values; // of the attributes in the key, NULL when undefined
+	std::vector<char> matched; // result for each sub-expression that is evaluated
+};
+
+// Make the grouping key of a target, the unparsed values of the attributes the expression
+// can reach in it.  request_refs are the attributes reachable through the request ad alone.
+// returns false if the target should not share its results with any other target.
+static bool MakeTargetGroupKey(
+	ClassAd * request,
+	ClassAd * target,
+	const AnalRefCollector & request_refs,
+	std::string & key,
+	std::vector<classad::ExprTree*> & values)
+{
+	AnalRefCollector refs(request_refs);
+	std::vector<std::string> pending(request_refs.names.begin(), request_refs.names.end());
+	classad::ClassAdUnParser unparser;
+	key.clear();
+	values.clear();
+	for (size_t ix = 0; ix < pending.size(); ++ix) {
+		classad::ExprTree * expr = SkipExprEnvelope(target->Lookup(pending[ix]));
+		values.push_back(expr);
+		if (expr) {
+			unparser.Unparse(key, expr);
+			refs.Walk(expr, pending);
+		}
+		key += '\n';
+		if (ix >= request_refs.names.size()) {
+			// an attribute of the request ad that the target refers to
+			refs.Walk(request->Lookup(pending[ix]), pending);
+		}
+		if (refs.is_volatile) return false;
+	}
+	return true;
+}
+
+// Evaluate the sub-expressions in to_eval against every step'th group, starting at first.
+// Evaluation sets the parent scope of the expression and of both ads, so each thread
+// works on its own copies of the request ad and of the expressions.
+static void EvalSubExprsForTargetGroups(
+	ClassAd * request,
+	const std::vector<AnalSubExpr> & subs,
+	const std::vector<int> & to_eval,
+	std::vector<AnalTargetGroup> & groups,
+	size_t first,
+	size_t step)
+{
+	ClassAd my(*request);
+	std::vector<std::unique_ptr<classad::ExprTree>> trees;
+	for (int ix : to_eval) {
+		trees.emplace_back(subs[ix].tree->Copy());
+		trees.back()->SetParentScope(&my);
+	}
+
+	classad::MatchClassAd mad;
+	mad.ReplaceLeftAd(&my);
+	for (size_t ig = first; ig < groups.size(); ig += step) {
+		AnalTargetGroup & group = groups[ig];
+		mad.ReplaceRightAd(group.target);
+		group.matched.resize(trees.size());
+		for (size_t ii = 0; ii < trees.size(); ++ii) {
+			classad::Value eval_result;
+			bool bool_val = false;
+			group.matched[ii] = my.EvaluateExpr(trees[ii].get(), eval_result, classad::Value::ValueType::NUMBER_VALUES) &&
+				eval_result.IsBooleanValue(bool_val) && bool_val;
+		}
+		mad.RemoveRightAd();
+	}
+	mad.RemoveLeftAd();
+}
+
 // This is the function you probably want to call.
 // It does match analysis of all of the clauses in the given attribute of the request ad
 // against all of the target ads and appends the analysis to the given return_buf.
@@ -882,6 +1039,74 @@ void AnalyzeRequirementsForEachTarget(
 		printf(" Step  %8ss  Condition\n", fmt.target_type_name);
 	}
 
+	// The loop below only changes the pruning of sub-expressions it has already counted,
+	// so we know up front which ones it will count.  Evaluate those against one target
+	// of each group of equivalent targets, on as many threads as we are allowed.
+	std::vector<int> to_eval;
+	std::vector<int> eval_slot(subs.size(), -1);
+	for (int ix = 0; ix < (int)subs.size(); ++ix) {
+		if (subs[ix].ix_effective >= 0 || subs[ix].dont_care)
+			continue;
+		if (subs[ix].constant && ( ! count_soft_matches || ! subs[ix].variable))
+			continue;
+		eval_slot[ix] = (int)to_eval.size();
+		to_eval.push_back(ix);
+	}
+
+	std::vector<AnalTargetGroup> groups;
+	if ( ! to_eval.empty()) {
+		AnalRefCollector request_refs;
+		std::vector<std::string> pending;
+		request_refs.Walk(exprReq, pending);
+		for (size_t ix = 0; ix < pending.size() && ! request_refs.is_volatile; ++ix) {
+			request_refs.Walk(request->Lookup(pending[ix]), pending);
+		}
+
+		std::map<std::string, std::vector<size_t>> groups_by_key;
+		std::string key;
+		std::vector<classad::ExprTree*> values;
+		for (ClassAd * target : targets) {
+			if (request_refs.is_volatile || ! MakeTargetGroupKey(request, target, request_refs, key, values)) {
+				groups.emplace_back();
+				groups.back().target = target;
+				groups.back().count = 1;
+				continue;
+			}
+			std::vector<size_t> & candidates = groups_by_key[key];
+			bool found = false;
+			for (size_t ig : candidates) {
+				AnalTargetGroup & group = groups[ig];
+				bool same = group.values.size() == values.size();
+				for (size_t ii = 0; same && ii < values.size(); ++ii) {
+					same = (values[ii] == group.values[ii]) || (values[ii] && group.values[ii] && values[ii]->SameAs(group.values[ii]));
+				}
+				if (same) {
+					group.count += 1;
+					found = true;
+					break;
+				}
+			}
+			if ( ! found) {
+				candidates.push_back(groups.size());
+				groups.emplace_back();
+				groups.back().target = target;
+				groups.back().count = 1;
+				groups.back().values = values;
+			}
+		}
+
+		int num_threads = MIN(fmt.threads, (int)(groups.size() / 64));
+		if (num_threads < 2) {
+			EvalSubExprsForTargetGroups(request, subs, to_eval, groups, 0, 1);
+		} else {
+			std::vector<std::thread> threads;
+			for (int it = 0; it < num_threads; ++it) {
+				threads.emplace_back(EvalSubExprsForTargetGroups, request, std::cref(subs), std::cref(to_eval), std::ref(groups), it, num_threads);
+			}
+			for (auto & thread : threads) { thread.join(); }
+		}
+	}
+
 	std::string linebuf;
 	for (int ix = 0; ix < (int)subs.size(); ++ix) {
 		if (subs[ix].ix_effective >= 0 || subs[ix].dont_care)
@@ -957,15 +1182,10 @@ void AnalyzeRequirementsForEachTarget(
 			}
 		}
 
-		for (size_t ixt = 0; ixt < targets.size(); ++ixt) {
-			ClassAd *target = targets[ixt];
-
-			classad::Value eval_result;
-			bool bool_val;
-			if (EvalExprToBool(subs[ix].tree, request, target, eval_result) && 
-				eval_result.IsBooleanValue(bool_val) && 
-				bool_val) {
-				subs[ix].matches += 1;
+		ASSERT(eval_slot[ix] >= 0);
+		for (const auto & group : groups) {
+			if (group.matched[eval_slot[ix]]) {
+				subs[ix].matches += group.count;
 			}
 		}
 
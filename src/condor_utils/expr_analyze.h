@@ -46,6 +46,7 @@ typedef struct {
 	const char * expr_label;
 	const char * request_type_name;
 	const char * target_type_name;
+	int threads; // evaluate against the target ads on up to this many threads, 0 or 1 for none
 } anaFormattingOptions;
 
 // This is the function you probably want to call.  
@@ -27,6 +27,7 @@
 
 #if defined( LINUX )
 #include <sys/inotify.h>
+#include <sys/vfs.h>
 #endif /* defined( LINUX ) */
 
 #ifndef WIN32
@@ -40,7 +41,7 @@
 FileModifiedTrigger::FileModifiedTrigger( const std::string & f ) :
 	filename( f ), initialized( false ), dont_close_statfd(false), statfd_is_pipe(false),
 #ifdef LINUX
-	inotify_fd(-1), inotify_initialized( false ),
+	inotify_fd(-1), inotify_initialized( false ), inotify_unavailable( false ),
 #endif
 	statfd( -1 ), lastSize( 0 )
 {
@@ -101,8 +102,93 @@ FileModifiedTrigger::releaseResources() {
 // fd for the next time.
 //
 
+#ifdef WIN32
+static int ms_sleep(int ms) { Sleep(ms); return 0; }
+#else
+static int ms_sleep(int ms) { return usleep((useconds_t)ms * 1000); }
+#endif
+
 #if defined( LINUX )
 
+// Filesystems on which inotify never (or only sometimes) sees writes made
+// by other machines.  From statfs(2) and the respective filesystems.
+static bool
+is_remote_filesystem( int fd ) {
+	struct statfs buf;
+	if( fstatfs( fd, & buf ) != 0 ) {
+		return false;
+	}
+	switch( (unsigned long)buf.f_type ) {
+		case 0x6969:		// NFS
+		case 0x517B:		// SMB
+		case 0xFE534D42:	// SMB2
+		case 0xFF534D42:	// CIFS
+		case 0x5346414F:	// AFS
+		case 0x6B414653:	// kAFS
+		case 0x65735546:	// FUSE
+		case 0x0BD00BD0:	// Lustre
+		case 0x47504653:	// GPFS
+		case 0x00C36400:	// CephFS
+		case 0x01021997:	// 9P
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool
+FileModifiedTrigger::init_inotify( void ) {
+	if( inotify_initialized ) { return true; }
+	if( inotify_unavailable ) { return false; }
+
+	if( ! dont_close_statfd && is_remote_filesystem( statfd ) ) {
+		dprintf( D_FULLDEBUG, "FileModifiedTrigger( %s ): not using inotify for this file, will poll.\n", filename.c_str() );
+		inotify_unavailable = true;
+		return false;
+	}
+
+#if defined( IN_NONBLOCK )
+	inotify_fd = inotify_init1( IN_NONBLOCK );
+#else
+	inotify_fd = inotify_init();
+	int flags = fcntl(inotify_fd, F_GETFL, 0);
+	fcntl(inotify_fd, F_SETFL, flags | O_NONBLOCK);
+#endif /* defined( IN_NONBLOCK ) */
+	if( inotify_fd == -1 ) {
+		dprintf( D_ALWAYS, "FileModifiedTrigger( %s ): inotify_init() failed: %s (%d), will poll.\n", filename.c_str(), strerror(errno), errno );
+		inotify_unavailable = true;
+		return false;
+	}
+
+	int wd = inotify_add_watch( inotify_fd, filename.c_str(), IN_MODIFY );
+	if( wd == -1 ) {
+		dprintf( D_ALWAYS, "FileModifiedTrigger( %s ): inotify_add_watch() failed: %s (%d), will poll.\n", filename.c_str(), strerror( errno ), errno );
+		close(inotify_fd);
+		inotify_fd = -1;
+		inotify_unavailable = true;
+		return false;
+	}
+
+	inotify_initialized = true;
+	return true;
+}
+
+int
+FileModifiedTrigger::getNotifyFd( void ) {
+	if( ! initialized || ! init_inotify() ) {
+		return -1;
+	}
+	return inotify_fd;
+}
+
+int
+FileModifiedTrigger::drainNotifications( void ) {
+	if( ! inotify_initialized ) {
+		return -1;
+	}
+	return read_inotify_events();
+}
+
 int
 FileModifiedTrigger::read_inotify_events( void ) {
 	// Magic from 'man inotify'.
@@ -143,27 +229,11 @@ FileModifiedTrigger::read_inotify_events( void ) {
 
 int
 FileModifiedTrigger::notify_or_sleep( int timeout_in_ms ) {
-	if(! inotify_initialized) {
-#if defined( IN_NONBLOCK )
-		inotify_fd = inotify_init1( IN_NONBLOCK );
-#else
-		inotify_fd = inotify_init();
-		int flags = fcntl(inotify_fd, F_GETFL, 0);
-		fcntl(inotify_fd, F_SETFL, flags | O_NONBLOCK);
-#endif /* defined( IN_NONBLOCK ) */
-		if( inotify_fd == -1 ) {
-			dprintf( D_ALWAYS, "FileModifiedTrigger( %s ): inotify_init() failed: %s (%d).\n", filename.c_str(), strerror(errno), errno );
-			return -1;
-		}
-
-		int wd = inotify_add_watch( inotify_fd, filename.c_str(), IN_MODIFY );
-		if( wd == -1 ) {
-			dprintf( D_ALWAYS, "FileModifiedTrigger( %s ): inotify_add_watch() failed: %s (%d).\n", filename.c_str(), strerror( errno ), errno );
-			close(inotify_fd);
-			return -1;
-		}
-
-		inotify_initialized = true;
+	if(! init_inotify()) {
+		// there's nothing to poll when watching stdin
+		if( dont_close_statfd ) { return -1; }
+		// fall back to polling, wait() will fstat() after we sleep
+		return ms_sleep( timeout_in_ms );
 	}
 
 	struct pollfd pollfds[1];
@@ -191,11 +261,15 @@ FileModifiedTrigger::notify_or_sleep( int timeout_in_ms ) {
 
 #else
 
-#ifdef WIN32
-int ms_sleep(int ms) { Sleep(ms); return 0; }
-#else
-int ms_sleep(int ms) { return usleep((useconds_t)ms * 1000); }
-#endif
+int
+FileModifiedTrigger::getNotifyFd( void ) {
+	return -1;
+}
+
+int
+FileModifiedTrigger::drainNotifications( void ) {
+	return -1;
+}
 
 int
 FileModifiedTrigger::notify_or_sleep( int timeout_in_ms ) {
@@ -31,6 +31,17 @@ class FileModifiedTrigger {
 		// Returns -1 if invalid, 0 if timed out, 1 if file has changed.
 		int wait( int timeout_in_ms = -1 );
 
+		// For callers with their own event loop.  Returns an fd which
+		// becomes readable when the file is modified, or -1 if change
+		// notification isn't available for this file (the platform lacks
+		// it, or the file is on a network filesystem), in which case the
+		// caller must keep polling.
+		int getNotifyFd( void );
+
+		// Clear pending notifications from the notify fd.
+		// Returns -1 on error, 1 otherwise.
+		int drainNotifications( void );
+
 	private:
 		// Only needed for better log messages.
 		std::string filename;
@@ -46,8 +57,11 @@ class FileModifiedTrigger {
 
 #if defined( LINUX )
 		int read_inotify_events( void );
+		bool init_inotify( void );
 		int inotify_fd;
 		bool inotify_initialized;
+		// inotify doesn't work here; sleep between fstat()s instead.
+		bool inotify_unavailable;
 #endif
 		int statfd;
 		off_t lastSize;
@@ -57,6 +57,7 @@
 #include "fcloser.h"
 
 #include <algorithm>
+#include <map>
 #include <numeric>
 #include <string>
 #include <unordered_set>
@@ -287,6 +288,130 @@ dPrintFileTransferList( int flags, const FileTransferList & list, const std::str
 	dprintf( flags, "%s\n", message.c_str() );
 }
 
+// Files of an upload that are opened ahead of sending them, and that the
+// kernel has been asked to start reading into the page cache, so that the
+// disk reads overlap sending the files before them.  Over a high latency
+// link a sandbox of many small files otherwise spends much of its time
+// waiting on one file read after another.  The descriptor is handed to
+// put_file() when the file's turn comes, so each file is opened only once.
+class UploadReadahead {
+public:
+	UploadReadahead() = default;
+	UploadReadahead(const UploadReadahead &) = delete;
+	UploadReadahead & operator=(const UploadReadahead &) = delete;
+	~UploadReadahead() {
+		for (auto & [index, file] : m_files) {
+			close(file.fd);
+		}
+	}
+
+	// Read ahead up to window files past filelist[current].  Returns the
+	// number of files newly read ahead.
+	int fill( const FileTransferList & filelist, size_t current, size_t window,
+	          const std::unordered_set<std::string> & skip_files, const char * iwd );
+
+	// The open descriptor for filelist[index] if it was read ahead as
+	// fullname, which the caller must close, or -1.
+	int take( size_t index, const std::string & fullname );
+
+private:
+	struct File {
+		std::string path;
+		int fd;
+	};
+	std::map<size_t, File> m_files;
+	size_t m_next{0};
+};
+
+int
+UploadReadahead::fill( const FileTransferList & filelist, size_t current, size_t window,
+                       const std::unordered_set<std::string> & skip_files, const char * iwd )
+{
+		// files we passed over without sending
+	while( ! m_files.empty() && m_files.begin()->first < current ) {
+		close(m_files.begin()->second.fd);
+		m_files.erase(m_files.begin());
+	}
+
+	if( m_next <= current ) {
+		m_next = current + 1;
+	}
+		// top up the window in batches, not one file per file sent
+	if( window == 0 || m_next > current + window / 2 ) {
+		return 0;
+	}
+	size_t until = MIN(current + 1 + window, filelist.size());
+
+	int prefetched = 0;
+#if defined(POSIX_FADV_WILLNEED)
+		// only the head of a large file, the rest is left to the
+		// sequential readahead in put_file()
+	const filesize_t max_hint_bytes = 8 * 1024 * 1024;
+
+	for( ; m_next < until; ++m_next ) {
+		const FileTransferItem & item = filelist[m_next];
+		if( item.isSrcUrl() || item.isDestUrl() || item.isDirectory() ||
+			item.isDomainSocket() || item.isSymlink() || item.fileSize() <= 0 ) {
+			continue;
+		}
+		if( skip_files.find(item.srcName()) != skip_files.end() ) {
+			continue;
+		}
+
+		std::string path;
+		if( fullpath(item.srcName().c_str()) ) {
+			path = item.srcName();
+		}
+		else {
+			formatstr(path, "%s%c%s", iwd, DIR_DELIM_CHAR, item.srcName().c_str());
+		}
+			// put_file() would refuse it, and will report that when
+			// it gets there
+		if( ! allow_shadow_access(path.c_str()) ) {
+			continue;
+		}
+
+			// don't wait on anything that isn't a plain file
+		int fd = safe_open_wrapper_follow(path.c_str(), O_RDONLY | O_LARGEFILE | O_NONBLOCK);
+		if( fd < 0 ) {
+			continue;
+		}
+		struct stat st;
+		if( fstat(fd, &st) != 0 || ! S_ISREG(st.st_mode) ||
+			fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK) < 0 ) {
+			close(fd);
+			continue;
+		}
+
+		off_t len = (off_t)MIN(item.fileSize(), max_hint_bytes);
+		(void)posix_fadvise(fd, 0, len, POSIX_FADV_WILLNEED);
+		m_files[m_next] = File{path, fd};
+		++prefetched;
+	}
+#else
+	(void)skip_files; (void)iwd;
+#endif
+	m_next = until;
+	return prefetched;
+}
+
+int
+UploadReadahead::take( size_t index, const std::string & fullname )
+{
+	auto it = m_files.find(index);
+	if( it == m_files.end() ) {
+		return -1;
+	}
+	int fd = it->second.fd;
+	bool same = it->second.path == fullname;
+	m_files.erase(it);
+	if( ! same ) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
 const int GO_AHEAD_FAILED = -1; // failed to contact transfer queue manager
 const int GO_AHEAD_UNDEFINED = 0;
 //const int GO_AHEAD_ONCE = 1;    // send one file and ask again
@@ -4963,11 +5088,19 @@ FileTransfer::uploadFileList(
 		saved_priv = set_priv( desired_priv_state );
 	}
 
+	size_t readahead_files = param_integer("FILE_TRANSFER_READAHEAD_FILES", 16, 0);
+	UploadReadahead readahead;
+	int num_prefetched = 0;
+
 	*total_bytes_ptr = 0;
-	for (auto &fileitem : filelist)
+	for (size_t file_index = 0; file_index < filelist.size(); ++file_index)
 	{
+		auto &fileitem = filelist[file_index];
 		auto &filename = fileitem.srcName();
 		auto &dest_dir = fileitem.destDir();
+
+		num_prefetched += readahead.fill(filelist, file_index, readahead_files, skip_files, Iwd);
+
 			// Anything the remote side was able to reuse we do not send again.
 		if (skip_files.find(filename) != skip_files.end()) {
 			dprintf(D_FULLDEBUG, "Skipping file %s as it was reused.\n", filename.c_str());
@@ -5444,6 +5577,13 @@ FileTransfer::uploadFileList(
 				rc = PUT_FILE_OPEN_FAILED;
 				errno = EISDIR;
 			}
+		} else if ( int fd = readahead.take( file_index, fullname ); fd >= 0 ) {
+			if ( TransferFilePermissions ) {
+				rc = s->put_file_with_permissions( &bytes, fd, fullname.c_str(), this_file_max_bytes, &xfer_queue );
+			} else {
+				rc = s->put_file( &bytes, fd, 0, this_file_max_bytes, &xfer_queue );
+			}
+			close( fd );
 		} else if ( TransferFilePermissions ) {
 			rc = s->put_file_with_permissions( &bytes, fullname.c_str(), this_file_max_bytes, &xfer_queue );
 		} else {
@@ -5563,6 +5703,9 @@ FileTransfer::uploadFileList(
 			Info.addSpooledFile( dest_filename.c_str() );
 		}
 	}
+	if (num_prefetched > 0) {
+		Info.stats.InsertAttr("CedarFilesPrefetched", num_prefetched);
+	}
 	// Release transfer queue slot if we haven't sent a protected URL for
 	// the remote side to download. Currently the remote side (likely starter)
 	// collects all passed URLs for download and then downloads post main loop
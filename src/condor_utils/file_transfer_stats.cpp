@@ -36,6 +36,7 @@ void FileTransferStats::Init() {
 	TransferStartTime = 0;
 	TransferFileBytes = 0;
     LibcurlReturnCode = -1;
+    ConnectionReused = false;
 }
 
 void FileTransferStats::Publish(classad::ClassAd &ad) const {
@@ -109,6 +110,15 @@ void FileTransferStats::Publish(classad::ClassAd &ad) const {
         developerAd->InsertAttr("TransferTries", TransferTries);
     }
 
+    // Whether the last try went over a connection left open by an earlier
+    // transfer, and the HTTP version it spoke.
+    if (TransferTries > 0) {
+        developerAd->InsertAttr("ConnectionReused", ConnectionReused);
+    }
+    if (!HttpVersion.empty()) {
+        developerAd->InsertAttr("HttpVersion", HttpVersion);
+    }
+
     if(developerAd->size() != 0) {
         ad.Insert( "DeveloperData", developerAd );
     }
@@ -41,9 +41,11 @@
 		long TransferHTTPStatusCode;
 		long long TransferTotalBytes;
 		long TransferTries;
+		bool ConnectionReused;
 		
 		std::string HttpCacheHitOrMiss;
 		std::string HttpCacheHost;
+		std::string HttpVersion;
 		std::string TransferError;
 		std::string TransferFileName;
 		std::string TransferHostName;
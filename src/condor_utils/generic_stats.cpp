@@ -339,6 +339,79 @@ void stats_recent_counter_timer::PublishDebug(ClassAd & ad, const char * pattr,
    this->runtime.PublishDebug(ad, attr.c_str(), flags);
 }
 
+//----------------------------------------------------------------------------------------------
+//
+int stats_histogram_loglinear::BucketIndex(uint64_t usec)
+{
+   if (usec < (uint64_t)SubBuckets) {
+      return (int)usec;
+   }
+   int msb = 63;
+   while ( ! (usec & ((uint64_t)1 << msb))) { --msb; }
+   if (msb >= MaxBits) {
+      return NumBuckets - 1;
+   }
+   int shift = msb - SubBucketBits;
+   int sub = (int)((usec >> shift) & (SubBuckets - 1));
+   return SubBuckets + shift * SubBuckets + sub;
+}
+
+uint64_t stats_histogram_loglinear::BucketUpperBound(int index)
+{
+   if (index < SubBuckets) {
+      return (uint64_t)index + 1;
+   }
+   int shift = (index - SubBuckets) / SubBuckets;
+   int sub = (index - SubBuckets) % SubBuckets;
+   return (uint64_t)(SubBuckets + sub + 1) << shift;
+}
+
+void stats_histogram_loglinear::Add(double sec)
+{
+   uint64_t usec = (sec > 0.0) ? (uint64_t)(sec * 1e6) : 0;
+   buckets[BucketIndex(usec)].fetch_add(1, std::memory_order_relaxed);
+   sum_usec.fetch_add(usec, std::memory_order_relaxed);
+   count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void stats_histogram_loglinear::Clear()
+{
+   for (auto & bucket : buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+   }
+   count.store(0, std::memory_order_relaxed);
+   sum_usec.store(0, std::memory_order_relaxed);
+}
+
+double stats_histogram_loglinear::Quantile(double q) const
+{
+   // other threads may add to the buckets while we read them, so take one
+   // snapshot of them and compute both the total and the rank from it,
+   // rather than using the separately updated count.
+   uint64_t snapshot[NumBuckets];
+   uint64_t total = 0;
+   for (int ix = 0; ix < NumBuckets; ++ix) {
+      snapshot[ix] = buckets[ix].load(std::memory_order_relaxed);
+      total += snapshot[ix];
+   }
+   if ( ! total) {
+      return 0.0;
+   }
+
+   uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+   if (rank < 1) rank = 1;
+   if (rank > total) rank = total;
+
+   uint64_t seen = 0;
+   for (int ix = 0; ix < NumBuckets; ++ix) {
+      seen += snapshot[ix];
+      if (seen >= rank) {
+         return BucketUpperBound(ix) / 1e6;
+      }
+   }
+   return BucketUpperBound(NumBuckets - 1) / 1e6;
+}
+
 template <class T>
 void stats_entry_probe<T>::Publish(ClassAd & ad, const char * pattr, int flags) const
 {
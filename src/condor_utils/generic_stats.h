@@ -1028,6 +1028,7 @@ public:
 #endif // _timed_queue_h_
 
 #include <limits>
+#include <atomic>
 
 // stats_entry_probe is derived from Miron Livny's Probe class,
 // it counts and sums samples as they arrive and can publish
@@ -1510,6 +1511,42 @@ public:
    static void Delete(stats_recent_counter_timer * pthis);
 };
 
+//-----------------------------------------------------------------------------
+// A log-linear (HDR style) histogram of latencies, for computing percentiles.
+// Values are recorded in microseconds, in buckets that are exact below 16us
+// and above that split each power of two into 16 buckets, so the value of any
+// percentile is within about 6% of the true value.  Add() only does atomic
+// increments, so a histogram may be recorded into from more than one thread.
+//
+class stats_histogram_loglinear {
+public:
+   static const int SubBucketBits = 4;
+   static const int SubBuckets = 1 << SubBucketBits;
+   static const int MaxBits = 36;   // about 19 hours in microseconds, larger values are clamped
+   static const int NumBuckets = SubBuckets + (MaxBits - SubBucketBits) * SubBuckets;
+
+   stats_histogram_loglinear() { Clear(); }
+   stats_histogram_loglinear(const stats_histogram_loglinear&) = delete;
+   stats_histogram_loglinear& operator=(const stats_histogram_loglinear&) = delete;
+
+   void Add(double sec);
+   void Clear();
+
+   uint64_t Count() const { return count.load(std::memory_order_relaxed); }
+   double   Sum() const { return sum_usec.load(std::memory_order_relaxed) / 1e6; }
+
+   // value in seconds below which the fraction q of the recorded values fall
+   double Quantile(double q) const;
+
+   static int BucketIndex(uint64_t usec);
+   static uint64_t BucketUpperBound(int index);
+
+private:
+   std::atomic<uint64_t> buckets[NumBuckets];
+   std::atomic<uint64_t> count;
+   std::atomic<uint64_t> sum_usec;
+};
+
 //-----------------------------------------------------------------------------------
 // a helper function for determining if enough time has passed so that we
 // should Advance the recent buffers.  returns an Advance count that you
@@ -0,0 +1,221 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "condor_common.h"
+#include "condor_debug.h"
+#include "basename.h"
+#include "directory_util.h"
+#include "stat_wrapper.h"
+#include "util_lib_proto.h" // for rotate_file
+#include "history_index.h"
+
+// First line of the index, followed by the inode of the history file
+static const char IndexHeader[] = "# HTCondor history index 1";
+
+std::string
+HistoryFileIndex::IndexPath(const char *history_file)
+{
+	std::string dir = condor_dirname(history_file);
+	std::string name(".");
+	name += condor_basename(history_file);
+	name += ".idx";
+
+	std::string path;
+	dircat(dir.c_str(), name.c_str(), path);
+	return path;
+}
+
+bool
+HistoryFileIndex::Load(const char *history_file)
+{
+	m_records.clear();
+	m_end = m_file_size = 0;
+	m_min_completion = m_max_completion = 0;
+	m_no_completion = 0;
+	bool have_completion = false;
+
+	StatWrapper swrap(history_file);
+	if (swrap.GetRc()) {
+		return false;
+	}
+	m_file_size = (int64_t)swrap.GetBuf()->st_size;
+	unsigned long long inode = (unsigned long long)swrap.GetBuf()->st_ino;
+
+	std::string idx_path = IndexPath(history_file);
+	FILE *fp = safe_fopen_wrapper_follow(idx_path.c_str(), "r");
+	if ( ! fp) {
+		return false;
+	}
+
+	char line[1024];
+	const size_t hdr_len = sizeof(IndexHeader) - 1;
+	bool valid = fgets(line, sizeof(line), fp) &&
+	             strncmp(line, IndexHeader, hdr_len) == 0 &&
+	             strtoull(line + hdr_len, nullptr, 10) == inode;
+
+	while (valid && fgets(line, sizeof(line), fp)) {
+		size_t len = strlen(line);
+		if (len == 0 || line[len-1] != '\n') {
+			// a record that is still being written (or absurdly long), whatever
+			// follows it is treated as unindexed
+			break;
+		}
+		line[len-1] = 0;
+
+		Record rec;
+		char *p = line;
+		rec.offset = strtoll(p, &p, 10);
+		rec.length = strtoll(p, &p, 10);
+		rec.cluster = (int)strtol(p, &p, 10);
+		rec.proc = (int)strtol(p, &p, 10);
+		rec.completion = (time_t)strtoll(p, &p, 10);
+		while (*p == ' ') ++p;
+		rec.owner = p;
+
+		// the records must cover the file from the start without gaps
+		if (rec.offset != m_end || rec.length <= 0 || rec.offset + rec.length > m_file_size) {
+			valid = false;
+			break;
+		}
+		m_end = rec.offset + rec.length;
+		if (rec.completion < 0) {
+			++m_no_completion;
+		} else {
+			if ( ! have_completion || rec.completion < m_min_completion) { m_min_completion = rec.completion; }
+			if ( ! have_completion || rec.completion > m_max_completion) { m_max_completion = rec.completion; }
+			have_completion = true;
+		}
+		m_records.push_back(std::move(rec));
+	}
+	fclose(fp);
+
+	if ( ! valid) {
+		dprintf(D_FULLDEBUG, "Ignoring history index %s, it does not match %s\n",
+		        idx_path.c_str(), history_file);
+		m_records.clear();
+		m_end = 0;
+		m_min_completion = m_max_completion = 0;
+		m_no_completion = 0;
+		return false;
+	}
+	return true;
+}
+
+void
+HistoryFileIndex::Rename(const char *old_history_file, const char *new_history_file)
+{
+	std::string old_idx = IndexPath(old_history_file);
+	if (access(old_idx.c_str(), F_OK) != 0) {
+		return;
+	}
+	std::string new_idx = IndexPath(new_history_file);
+	if (rotate_file(old_idx.c_str(), new_idx.c_str())) {
+		dprintf(D_ALWAYS, "Failed to rotate history index %s to %s, removing it\n",
+		        old_idx.c_str(), new_idx.c_str());
+		unlink(old_idx.c_str());
+	}
+}
+
+void
+HistoryFileIndex::Remove(const char *history_file)
+{
+	std::string idx = IndexPath(history_file);
+	if (unlink(idx.c_str()) != 0 && errno != ENOENT) {
+		dprintf(D_ALWAYS, "Failed to delete history index %s: %s\n", idx.c_str(), strerror(errno));
+	}
+}
+
+void
+HistoryIndexWriter::Append(const char *history_file, int history_fd, int64_t offset, int64_t length,
+                           int cluster, int proc, time_t completion, const char *owner)
+{
+	if (m_abandoned) {
+		return;
+	}
+
+	if ( ! m_fp) {
+		std::string idx_path = HistoryFileIndex::IndexPath(history_file);
+		if (offset == 0) {
+			// first ad in a new history file, start a new index
+			struct stat st;
+			if (fstat(history_fd, &st) != 0) {
+				Abandon(history_file);
+				return;
+			}
+			m_fp = safe_fopen_wrapper_follow(idx_path.c_str(), "w", 0644);
+			if ( ! m_fp || fprintf(m_fp, "%s %llu\n", IndexHeader, (unsigned long long)st.st_ino) < 0) {
+				Abandon(history_file);
+				return;
+			}
+			m_end = 0;
+		} else {
+			// pick up the index of the history file we were writing before
+			// a restart or reconfig, as long as it covers every ad so far
+			HistoryFileIndex index;
+			if ( ! index.Load(history_file) || index.IndexedEnd() != offset) {
+				Abandon(history_file);
+				return;
+			}
+			m_fp = safe_fopen_wrapper_follow(idx_path.c_str(), "a", 0644);
+			if ( ! m_fp) {
+				Abandon(history_file);
+				return;
+			}
+			m_end = offset;
+		}
+	}
+
+	if (offset != m_end) {
+		Abandon(history_file);
+		return;
+	}
+
+	if (fprintf(m_fp, "%lld %lld %d %d %lld %s\n", (long long)offset, (long long)length,
+	            cluster, proc, (long long)completion, (owner && *owner) ? owner : "?") < 0 ||
+	    fflush(m_fp) != 0) {
+		Abandon(history_file);
+		return;
+	}
+	m_end = offset + length;
+}
+
+void
+HistoryIndexWriter::Close()
+{
+	if (m_fp) {
+		fclose(m_fp);
+		m_fp = nullptr;
+	}
+	m_end = 0;
+	m_abandoned = false;
+}
+
+// An incomplete index is worse than none, since readers would miss ads,
+// so delete it and stop indexing this history file.
+void
+HistoryIndexWriter::Abandon(const char *history_file)
+{
+	if (m_fp) {
+		fclose(m_fp);
+		m_fp = nullptr;
+	}
+	dprintf(D_ALWAYS, "Not indexing history file %s, index could not be kept complete\n", history_file);
+	HistoryFileIndex::Remove(history_file);
+	m_abandoned = true;
+}
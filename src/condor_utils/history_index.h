@@ -0,0 +1,116 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef _CONDOR_HISTORY_INDEX_H
+#define _CONDOR_HISTORY_INDEX_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** Sidecar index of a job history file.
+
+	For each ad in a history file the index has one line giving the byte
+	offset and length of the ad (including its "***" banner), and the
+	ClusterId, ProcId, CompletionDate and Owner from the banner.  With it
+	condor_history can seek straight to the ads of a job or an owner
+	instead of parsing the whole file.
+
+	The sidecar for <dir>/<base> is <dir>/.<base>.idx, so that it is not
+	mistaken for a rotated history file, and it is renamed and deleted
+	along with the history file.  The index is only written for history
+	files that it covers from the first ad; it records the inode of the
+	history file so an index left behind by a file that was replaced is
+	ignored.  Any ads past the end of the index (the writer appends to the
+	index after the history file) must be scanned by the reader.
+*/
+class HistoryFileIndex
+{
+  public:
+	struct Record {
+		int64_t		offset;		// start of the ad in the history file
+		int64_t		length;		// length of the ad and its banner
+		int			cluster;
+		int			proc;
+		time_t		completion;
+		std::string	owner;
+	};
+
+	static std::string IndexPath(const char *history_file);
+
+	/** Load the index of a history file
+		@return false if there is no index, or it does not describe the file
+	*/
+	bool Load(const char *history_file);
+
+	const std::vector<Record> & Records() const { return m_records; }
+
+	// offset in the history file just past the last indexed ad
+	int64_t IndexedEnd() const { return m_end; }
+	// size of the history file when the index was loaded
+	int64_t FileSize() const { return m_file_size; }
+
+	// CompletionDate range of the indexed ads that have one
+	time_t MinCompletion() const { return m_min_completion; }
+	time_t MaxCompletion() const { return m_max_completion; }
+	// number of indexed ads with no CompletionDate (written as -1)
+	size_t NumWithoutCompletion() const { return m_no_completion; }
+
+	// Move or delete the index along with its history file
+	static void Rename(const char *old_history_file, const char *new_history_file);
+	static void Remove(const char *history_file);
+
+  private:
+	std::vector<Record> m_records;
+	int64_t		m_end{0};
+	int64_t		m_file_size{0};
+	time_t		m_min_completion{0};
+	time_t		m_max_completion{0};
+	size_t		m_no_completion{0};
+};
+
+/** Appends to the index of the history file being written.  Append()
+	is called after each ad is written to the history file, with the ad's
+	offset and length.  If the index can't be kept complete, it is deleted
+	and nothing more is written until the history file is rotated.
+*/
+class HistoryIndexWriter
+{
+  public:
+	HistoryIndexWriter() = default;
+	~HistoryIndexWriter() { Close(); }
+
+	HistoryIndexWriter(const HistoryIndexWriter&) = delete;
+	HistoryIndexWriter& operator=(const HistoryIndexWriter&) = delete;
+
+	void Append(const char *history_file, int history_fd, int64_t offset, int64_t length,
+	            int cluster, int proc, time_t completion, const char *owner);
+
+	// Call when the history file is closed or rotated
+	void Close();
+
+  private:
+	void Abandon(const char *history_file);
+
+	FILE *		m_fp{nullptr};
+	int64_t		m_end{0};
+	bool		m_abandoned{false};
+};
+
+#endif
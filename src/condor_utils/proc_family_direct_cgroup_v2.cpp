@@ -19,6 +19,7 @@
 
 
 #include "condor_common.h"
+#include "condor_config.h"
 #include "condor_daemon_core.h"
 #include "condor_uid.h"
 #include "directory.h"
@@ -36,6 +37,10 @@
 // for major/minor
 #include <sys/sysmacros.h>
 
+// for event monitoring
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+
 #ifdef HAS_CGROUP_DEVICE
 // The missing bpf syscall wrapper
 static int bpf(enum bpf_cmd cmd, union bpf_attr *attr, unsigned int size)
@@ -49,6 +54,40 @@ namespace stdfs = std::filesystem;
 static std::map<pid_t, std::string> cgroup_map;
 static std::vector<pid_t> lifetime_extended_pids;
 
+// Counts from a cgroup's memory.events, which include its children
+struct CgroupMemoryEvents {
+	uint64_t high{0};
+	uint64_t max{0};
+	uint64_t oom_kill{0};
+	uint64_t oom_group_kill{0};
+};
+
+// The families we report events for, see monitor_family_events()
+struct CgroupFamilyEvents {
+	void (*notify)(void *me, int pid, int events){nullptr};
+	void *me{nullptr};
+	int memory_events_wd{-1};   // inotify watch on memory.events
+	int memory_pressure_fd{-1}; // armed PSI trigger on memory.pressure
+	int cpu_pressure_fd{-1};    // armed PSI trigger on cpu.pressure
+	CgroupMemoryEvents counts;
+
+	// What get_usage() last read from the memory files, when, and the cpu
+	// time the family had used at that point.  changed is set by any event.
+	bool have_usage{false};
+	bool changed{false};
+	time_t usage_time{0};
+	uint64_t cpu_usec{0};
+	int num_procs{0};
+	uint64_t memory_current{0};
+	uint64_t memory_peak{0};
+};
+static std::map<pid_t, CgroupFamilyEvents> cgroup_events_map;
+
+// The kernel ages and reclaims a family's pages without the family using
+// any cpu, so even an idle family's memory files are read this often
+static const time_t idle_usage_max_age = 60;
+static void stop_family_events(pid_t pid);
+
 static stdfs::path cgroup_mount_point() {
 	return "/sys/fs/cgroup";
 }
@@ -580,6 +619,87 @@ ProcFamilyDirectCgroupV2::track_family_via_cgroup(pid_t pid, FamilyInfo *fi) {
 
 }
 
+// Read the number of processes, and the current (less inactive pages) and
+// peak memory usage in bytes of a cgroup
+static bool
+read_family_memory(const stdfs::path &leaf, int &num_procs, uint64_t &memory_current_value, uint64_t &memory_peak_value)
+{
+	stdfs::path cgroup_procs   = leaf / "cgroup.procs";
+
+	FILE *f = fopen(cgroup_procs.c_str(), "r");
+	if (!f) {
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", cgroup_procs.c_str(), errno, strerror(errno));
+		return false;
+	}
+	char pidstr[64]; // Far beyond max size of a pid
+	num_procs = 0;
+	while (fscanf(f, "%s\n", pidstr) == 1) {
+		num_procs++;
+	}
+	fclose(f);
+
+	stdfs::path memory_current = leaf / "memory.current";
+	stdfs::path memory_peak    = leaf / "memory.peak";
+	stdfs::path memory_stat    = leaf / "memory.stat";
+
+	f = fopen(memory_current.c_str(), "r");
+	if (!f) {
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", memory_current.c_str(), errno, strerror(errno));
+		return false;
+	}
+
+	memory_current_value = 0;
+	if (fscanf(f, "%ld", &memory_current_value) != 1) {
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot read %s: %d %s\n", memory_current.c_str(), errno, strerror(errno));
+		fclose(f);
+		return false;
+	}
+	fclose(f);
+
+	f = fopen(memory_stat.c_str(), "r");
+	if (!f) {
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", memory_stat.c_str(), errno, strerror(errno));
+		return false;
+	}
+
+	uint64_t memory_inactive_anon_value = 0;
+	uint64_t memory_inactive_file_value = 0;
+	char line[256];
+	size_t total_read = 0;
+	while (fgets(line, 256, f)) {
+		total_read += sscanf(line, "inactive_file %ld", &memory_inactive_file_value);
+		total_read += sscanf(line, "inactive_anon %ld", &memory_inactive_anon_value);
+		if (total_read == 2) {
+			break;
+		}
+	}
+	fclose(f);
+	if (total_read != 2) {
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot read inactive_file or inactive_anon from %s: %d %s\n", memory_stat.c_str(), errno, strerror(errno));
+		return false;
+	}
+	memory_current_value -= memory_inactive_anon_value + memory_inactive_file_value;
+
+	memory_peak_value = 0;
+
+	f = fopen(memory_peak.c_str(), "r");
+	if (!f) {
+		// Some cgroup v2 versions don't have this file
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", memory_peak.c_str(), errno, strerror(errno));
+	} else {
+		if (fscanf(f, "%ld", &memory_peak_value) != 1) {
+
+			// But this error should never happen
+			dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot read %s: %d %s\n", memory_peak.c_str(), errno, strerror(errno));
+			fclose(f);
+			return false;
+		}
+		fclose(f);
+	}
+
+	return true;
+}
+
 	bool
 ProcFamilyDirectCgroupV2::get_usage(pid_t pid, ProcFamilyUsage& usage, bool /*full*/)
 {
@@ -647,78 +767,34 @@ ProcFamilyDirectCgroupV2::get_usage(pid_t pid, ProcFamilyUsage& usage, bool /*fu
 	usage.user_cpu_time = user_usec / 1'000'000; // usage.user_cpu_times in seconds, ugh
 	usage.sys_cpu_time  =  sys_usec / 1'000'000; //  usage.sys_cpu_times in seconds, ugh
 
-	stdfs::path cgroup_procs   = leaf / "cgroup.procs";
-
-	f = fopen(cgroup_procs.c_str(), "r");
-	if (!f) {
-		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", cgroup_procs.c_str(), errno, strerror(errno));
-		return false;
-	}
-	char pidstr[64]; // Far beyond max size of a pid
-	usage.num_procs = 0;
-	while (fscanf(f, "%s\n", pidstr) == 1) {
-		usage.num_procs++;
-	}
-	fclose(f);
-
-	stdfs::path memory_current = leaf / "memory.current";
-	stdfs::path memory_peak    = leaf / "memory.peak";
-	stdfs::path memory_stat    = leaf / "memory.stat";
-
-	f = fopen(memory_current.c_str(), "r");
-	if (!f) {
-		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", memory_current.c_str(), errno, strerror(errno));
-		return false;
-	}
+	// A family that has used no cpu since we last read its memory files, and that
+	// has had no memory events, can't have forked or grown, so skip the rest
+	// unless what we read has gotten old.
+	time_t now = time(nullptr);
+	auto events = cgroup_events_map.find(pid);
+	bool idle = events != cgroup_events_map.end() && events->second.have_usage &&
+		! events->second.changed && events->second.cpu_usec == user_usec + sys_usec &&
+		now >= events->second.usage_time && now - events->second.usage_time < idle_usage_max_age;
 
 	uint64_t memory_current_value = 0;
-	if (fscanf(f, "%ld", &memory_current_value) != 1) {
-		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot read %s: %d %s\n", memory_current.c_str(), errno, strerror(errno));
-		fclose(f);
-		return false;
-	}
-	fclose(f);
-
-	f = fopen(memory_stat.c_str(), "r");
-	if (!f) {
-		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", memory_stat.c_str(), errno, strerror(errno));
-		return false;
-	}
-
-	uint64_t memory_inactive_anon_value = 0;
-	uint64_t memory_inactive_file_value = 0;
-	char line[256];
-	size_t total_read = 0;
-	while (fgets(line, 256, f)) {
-		total_read += sscanf(line, "inactive_file %ld", &memory_inactive_file_value);
-		total_read += sscanf(line, "inactive_anon %ld", &memory_inactive_anon_value);
-		if (total_read == 2) {
-			break;
-		}
-	}
-	fclose(f);
-	if (total_read != 2) {
-		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot read inactive_file or inactive_anon from %s: %d %s\n", memory_stat.c_str(), errno, strerror(errno));
-		fclose(f);
-		return false;
-	}
-	memory_current_value -= memory_inactive_anon_value + memory_inactive_file_value;
-
 	uint64_t memory_peak_value = 0;
-
-	f = fopen(memory_peak.c_str(), "r");
-	if (!f) {
-		// Some cgroup v2 versions don't have this file
-		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot open %s: %d %s\n", memory_peak.c_str(), errno, strerror(errno));
+	if (idle) {
+		usage.num_procs = events->second.num_procs;
+		memory_current_value = events->second.memory_current;
+		memory_peak_value = events->second.memory_peak;
 	} else {
-		if (fscanf(f, "%ld", &memory_peak_value) != 1) {
-
-			// But this error should never happen
-			dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2::get_usage cannot read %s: %d %s\n", memory_peak.c_str(), errno, strerror(errno));
-			fclose(f);
+		if ( ! read_family_memory(leaf, usage.num_procs, memory_current_value, memory_peak_value)) {
 			return false;
 		}
-		fclose(f);
+		if (events != cgroup_events_map.end()) {
+			events->second.have_usage = true;
+			events->second.changed = false;
+			events->second.usage_time = now;
+			events->second.cpu_usec = user_usec + sys_usec;
+			events->second.num_procs = usage.num_procs;
+			events->second.memory_current = memory_current_value;
+			events->second.memory_peak = memory_peak_value;
+		}
 	}
 
 	// usage is in kbytes.  cgroups reports in bytes
@@ -846,6 +922,8 @@ ProcFamilyDirectCgroupV2::unregister_family(pid_t pid)
 		return true;
 	}
 
+	stop_family_events(pid);
+
 	std::string cgroup_name = cgroup_map[pid];
 
 	dprintf(D_FULLDEBUG, "ProcFamilyDirectCgroupV2::unregister_family for pid %u\n", pid);
@@ -860,6 +938,12 @@ bool
 ProcFamilyDirectCgroupV2::has_been_oom_killed(pid_t pid) {
 	bool killed = false;
 
+	// If we have already been told, don't bother reading it again
+	auto events = cgroup_events_map.find(pid);
+	if (events != cgroup_events_map.end() && events->second.counts.oom_group_kill > 0) {
+		return true;
+	}
+
 	std::string cgroup_name = cgroup_map[pid];
 
 	stdfs::path cgroup_root_dir = cgroup_mount_point();
@@ -894,6 +978,243 @@ ProcFamilyDirectCgroupV2::has_been_oom_killed(pid_t pid) {
 	return killed;
 }
 
+//
+// Event monitoring.  Rather than waiting for the next poll to notice that
+// a job has hit its memory limit or is stalling, we watch memory.events with
+// inotify and arm pressure stall (PSI) triggers on memory.pressure and
+// cpu.pressure.  PSI triggers signal with POLLPRI, which DaemonCore's select
+// loop doesn't wait for, so all of these fds go into one epoll fd, and it is
+// the epoll fd that DaemonCore watches as a pipe.
+//
+
+static int cgroup_event_epoll_fd = -1;
+static int cgroup_inotify_fd = -1;
+static int cgroup_event_pipe = -1;
+
+// epoll data is the pid shifted left 2, or'ed with one of these
+enum { CGROUP_EVENT_INOTIFY = 0, CGROUP_EVENT_MEMORY_PRESSURE = 1, CGROUP_EVENT_CPU_PRESSURE = 2 };
+
+static bool
+read_memory_events(const stdfs::path &leaf, CgroupMemoryEvents &counts)
+{
+	stdfs::path memory_events = leaf / "memory.events";
+	FILE *f = fopen(memory_events.c_str(), "r");
+	if (!f) {
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2 cannot open %s: %d %s\n", memory_events.c_str(), errno, strerror(errno));
+		return false;
+	}
+	char word[128];
+	uint64_t value = 0;
+	while (fscanf(f, "%127s %lu", word, &value) == 2) {
+		if (strcmp(word, "high") == 0) { counts.high = value; }
+		else if (strcmp(word, "max") == 0) { counts.max = value; }
+		else if (strcmp(word, "oom_kill") == 0) { counts.oom_kill = value; }
+		else if (strcmp(word, "oom_group_kill") == 0) { counts.oom_group_kill = value; }
+	}
+	fclose(f);
+	return true;
+}
+
+static void
+stop_family_events(pid_t pid)
+{
+	auto it = cgroup_events_map.find(pid);
+	if (it == cgroup_events_map.end()) {
+		return;
+	}
+	CgroupFamilyEvents &events = it->second;
+	if (events.memory_events_wd >= 0) {
+		inotify_rm_watch(cgroup_inotify_fd, events.memory_events_wd);
+	}
+	// closing the fd also takes it out of the epoll set
+	if (events.memory_pressure_fd >= 0) { close(events.memory_pressure_fd); }
+	if (events.cpu_pressure_fd >= 0) { close(events.cpu_pressure_fd); }
+	cgroup_events_map.erase(it);
+}
+
+// Look at memory.events of a family whose inotify watch fired, and return
+// the FAMILY_EVENT_* mask for the counts that went up.
+static int
+check_memory_events(pid_t pid, CgroupFamilyEvents &events)
+{
+	CgroupMemoryEvents counts;
+	if ( ! read_memory_events(cgroup_mount_point() / cgroup_map[pid], counts)) {
+		return 0;
+	}
+	int mask = 0;
+	if (counts.oom_kill > events.counts.oom_kill || counts.oom_group_kill > events.counts.oom_group_kill) {
+		mask |= ProcFamilyInterface::FAMILY_EVENT_OOM_KILL;
+	}
+	if (counts.max > events.counts.max || counts.high > events.counts.high) {
+		mask |= ProcFamilyInterface::FAMILY_EVENT_MEMORY_LIMIT;
+	}
+	events.counts = counts;
+	return mask;
+}
+
+static int
+cgroup_event_handler(int /* pipe */)
+{
+	struct epoll_event ready[16];
+	int num_ready = 0;
+	while ((num_ready = epoll_wait(cgroup_event_epoll_fd, ready, 16, 0)) > 0) {
+		std::map<pid_t, int> fired;
+		for (int ix = 0; ix < num_ready; ++ix) {
+			int kind = (int)(ready[ix].data.u64 & 3);
+			pid_t pid = (pid_t)(ready[ix].data.u64 >> 2);
+
+			if (kind == CGROUP_EVENT_INOTIFY) {
+				char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+				ssize_t len;
+				while ((len = read(cgroup_inotify_fd, buf, sizeof(buf))) > 0) {
+					for (char *ptr = buf; ptr < buf + len; ptr += sizeof(struct inotify_event) + ((struct inotify_event *)ptr)->len) {
+						int wd = ((struct inotify_event *)ptr)->wd;
+						for (auto &[epid, events] : cgroup_events_map) {
+							if (events.memory_events_wd == wd) {
+								fired[epid] |= check_memory_events(epid, events);
+								events.changed = true;
+							}
+						}
+					}
+				}
+				continue;
+			}
+
+			auto it = cgroup_events_map.find(pid);
+			if (it == cgroup_events_map.end()) {
+				continue;
+			}
+			int &fd = (kind == CGROUP_EVENT_MEMORY_PRESSURE) ? it->second.memory_pressure_fd : it->second.cpu_pressure_fd;
+			if (ready[ix].events & EPOLLERR) {
+				// the cgroup has gone away
+				if (fd >= 0) { close(fd); }
+				fd = -1;
+				continue;
+			}
+			it->second.changed = true;
+			fired[pid] |= (kind == CGROUP_EVENT_MEMORY_PRESSURE) ?
+				ProcFamilyInterface::FAMILY_EVENT_MEMORY_PRESSURE : ProcFamilyInterface::FAMILY_EVENT_CPU_PRESSURE;
+		}
+
+		for (auto [pid, mask] : fired) {
+			// look it up again, a notify may have stopped monitoring of any family
+			auto it = cgroup_events_map.find(pid);
+			if (mask && it != cgroup_events_map.end() && it->second.notify) {
+				dprintf(D_FULLDEBUG, "ProcFamilyDirectCgroupV2: events 0x%x for pid %d\n", mask, pid);
+				it->second.notify(it->second.me, pid, mask);
+			}
+		}
+	}
+	return TRUE;
+}
+
+static bool
+init_cgroup_event_monitor()
+{
+	if (cgroup_event_pipe != -1) {
+		return true;
+	}
+	if ( ! daemonCore) {
+		return false;
+	}
+
+	cgroup_event_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	cgroup_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.u64 = CGROUP_EVENT_INOTIFY;
+	if (cgroup_event_epoll_fd < 0 || cgroup_inotify_fd < 0 ||
+		epoll_ctl(cgroup_event_epoll_fd, EPOLL_CTL_ADD, cgroup_inotify_fd, &ev) < 0)
+	{
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2: cannot set up event monitoring: %d %s\n", errno, strerror(errno));
+	} else {
+		cgroup_event_pipe = daemonCore->Inherit_Pipe(cgroup_event_epoll_fd, false, true, true);
+		if (cgroup_event_pipe != -1 &&
+			daemonCore->Register_Pipe(cgroup_event_pipe, "cgroup events", cgroup_event_handler, "cgroup_event_handler") < 0)
+		{
+			daemonCore->Close_Pipe(cgroup_event_pipe); // closes the epoll fd
+			cgroup_event_pipe = -1;
+			cgroup_event_epoll_fd = -1;
+		}
+		if (cgroup_event_pipe != -1) {
+			return true;
+		}
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2: cannot register cgroup event pipe\n");
+	}
+
+	if (cgroup_event_epoll_fd >= 0) { close(cgroup_event_epoll_fd); }
+	if (cgroup_inotify_fd >= 0) { close(cgroup_inotify_fd); }
+	cgroup_event_epoll_fd = cgroup_inotify_fd = -1;
+	return false;
+}
+
+// Arm a PSI trigger such as "some 150000 1000000" (stalled for 150ms in any 1s window)
+// on a pressure file, and add it to the epoll set.  Returns the fd, or -1.
+static int
+arm_pressure_trigger(const stdfs::path &pressure_file, const std::string &trigger, pid_t pid, int kind)
+{
+	TemporaryPrivSentry sentry(PRIV_ROOT);
+	int fd = open(pressure_file.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) {
+		dprintf(D_FULLDEBUG, "ProcFamilyDirectCgroupV2: cannot open %s: %d %s\n", pressure_file.c_str(), errno, strerror(errno));
+		return -1;
+	}
+	struct epoll_event ev = {};
+	ev.events = EPOLLPRI;
+	ev.data.u64 = ((uint64_t)pid << 2) | kind;
+	if (write(fd, trigger.c_str(), trigger.size() + 1) < 0 ||
+		epoll_ctl(cgroup_event_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+	{
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2: cannot arm trigger '%s' on %s: %d %s\n",
+			trigger.c_str(), pressure_file.c_str(), errno, strerror(errno));
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+bool
+ProcFamilyDirectCgroupV2::monitor_family_events(pid_t pid, void(*notify)(void*me, int pid, int events), void*me)
+{
+	stop_family_events(pid);
+	if ( ! notify) {
+		return true;
+	}
+
+	auto found = cgroup_map.find(pid);
+	if (found == cgroup_map.end() || ! param_boolean("CGROUP_MONITOR_EVENTS", true) || ! init_cgroup_event_monitor()) {
+		return false;
+	}
+	stdfs::path leaf = cgroup_mount_point() / found->second;
+
+	CgroupFamilyEvents &events = cgroup_events_map[pid];
+	events.notify = notify;
+	events.me = me;
+	read_memory_events(leaf, events.counts);
+	{
+		TemporaryPrivSentry sentry(PRIV_ROOT);
+		events.memory_events_wd = inotify_add_watch(cgroup_inotify_fd, (leaf / "memory.events").c_str(), IN_MODIFY);
+	}
+	if (events.memory_events_wd < 0) {
+		dprintf(D_ALWAYS, "ProcFamilyDirectCgroupV2: cannot watch %s: %d %s\n",
+			(leaf / "memory.events").c_str(), errno, strerror(errno));
+		cgroup_events_map.erase(pid);
+		return false;
+	}
+
+	// Pressure triggers are a bonus, kernels built without PSI just don't have them
+	std::string trigger;
+	if (param(trigger, "CGROUP_MEMORY_PRESSURE_TRIGGER") && ! trigger.empty()) {
+		events.memory_pressure_fd = arm_pressure_trigger(leaf / "memory.pressure", trigger, pid, CGROUP_EVENT_MEMORY_PRESSURE);
+	}
+	if (param(trigger, "CGROUP_CPU_PRESSURE_TRIGGER") && ! trigger.empty()) {
+		events.cpu_pressure_fd = arm_pressure_trigger(leaf / "cpu.pressure", trigger, pid, CGROUP_EVENT_CPU_PRESSURE);
+	}
+
+	dprintf(D_FULLDEBUG, "ProcFamilyDirectCgroupV2: monitoring events of cgroup %s for pid %d\n", found->second.c_str(), pid);
+	return true;
+}
+
 // Returns true if cgroup v2 is mounted
 bool 
 ProcFamilyDirectCgroupV2::has_cgroup_v2() {
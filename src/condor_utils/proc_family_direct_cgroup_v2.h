@@ -105,6 +105,9 @@ public:
 	// Have we seen an oom kill event in this cgroup;
 	bool has_been_oom_killed(pid_t pid);
 
+	// Watch memory.events and arm pressure triggers on the family's cgroup
+	bool monitor_family_events(pid_t pid, void(*notify)(void*me, int pid, int events), void*me);
+
 	// We don't need these, cgroups just works
 	bool track_family_via_environment(pid_t, PidEnvID&) {return true;}
 	bool track_family_via_login(pid_t, const char*) {return true;}
@@ -75,6 +75,20 @@ public:
 	// Have we seen an oom kill event, only implemented
 	// for cgroups
 	virtual bool has_been_oom_killed(pid_t) { return false;} // meaning "don't know for sure"
+
+	// Events that a family can report as they happen, rather than
+	// waiting to be polled.  Only implemented for cgroup v2.
+	enum {
+		FAMILY_EVENT_OOM_KILL        = 0x01, // the OOM killer killed a process of the family
+		FAMILY_EVENT_MEMORY_LIMIT    = 0x02, // the family hit its memory limit and was throttled or reclaimed
+		FAMILY_EVENT_MEMORY_PRESSURE = 0x04, // the family stalled on memory for longer than the trigger allows
+		FAMILY_EVENT_CPU_PRESSURE    = 0x08, // the family stalled waiting for cpu longer than the trigger allows
+	};
+
+	// Call notify from DaemonCore with a mask of the above when the family of pid
+	// has events.  A NULL notify stops monitoring.  Returns false if the family
+	// can't report events, in which case the caller has to poll.
+	virtual bool monitor_family_events(pid_t, void(* /*notify*/)(void*me, int pid, int events), void* /*me*/) { return false; }
 																 //
 	// call prior to destroying the ProcFamily class to insure that cleanup happens before we exit.
 	virtual bool quit(void(*notify)(void*me, int pid, int status),void*me) = 0;
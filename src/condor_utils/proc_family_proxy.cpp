@@ -468,6 +468,17 @@ ProcFamilyProxy::start_procd()
 		free(max_snapshot_interval);
 	}
 
+#if defined(LINUX)
+	// (optional) only look at the processes in tracked families between
+	// full snapshots of the system
+	//
+	int full_snapshot_interval = param_integer("PROCD_FULL_SNAPSHOT_INTERVAL", 0, 0);
+	if (full_snapshot_interval > 0) {
+		args.AppendArg("-I");
+		args.AppendArg(std::to_string(full_snapshot_interval));
+	}
+#endif
+
 	// (optional) make the procd sleep on startup so a
 	// debugger can attach
 	//
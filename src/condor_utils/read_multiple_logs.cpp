@@ -239,10 +239,26 @@ ReadMultipleUserLogs::readEventFromLog( LogFileMonitor *monitor )
 	dprintf( D_FULLDEBUG, "ReadMultipleUserLogs::readEventFromLog(%s)\n",
 				monitor->logFile.c_str() );
 
-	ULogEventOutcome	result =
-				monitor->readUserLog->readEvent( monitor->lastLogEvent );
+	if ( readBatchSize <= 1 && monitor->readAhead.empty() ) {
+		return monitor->readUserLog->readEvent( monitor->lastLogEvent );
+	}
 
-	return result;
+	if ( monitor->readAhead.empty() ) {
+		std::vector<std::unique_ptr<ULogEvent>> batch;
+		ULogEventOutcome result =
+					monitor->readUserLog->readEvents( batch, readBatchSize );
+		if ( result != ULOG_OK ) {
+			return result;
+		}
+		for ( auto &event : batch ) {
+			monitor->readAhead.emplace_back( std::move( event ) );
+		}
+	}
+
+	monitor->lastLogEvent = monitor->readAhead.front().release();
+	monitor->readAhead.pop_front();
+
+	return ULOG_OK;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
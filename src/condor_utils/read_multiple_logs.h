@@ -34,6 +34,7 @@
 #include <iosfwd>
 #include <string>
 #include <vector>
+#include <deque>
 #include <map>
 
 class MultiLogFiles
@@ -199,6 +200,15 @@ public:
 		 */
 	size_t activeLogFileCount() const { return activeLogFiles.size(); }
 
+		/** Set the number of events to read from a log file at a time.
+			Events beyond the one returned by readEvent() are held by the
+			log's monitor until they are consumed.  The default of 1
+			reads events one at a time.
+			@param the maximum number of events to read per call
+		*/
+	void setReadBatchSize( size_t batch_size )
+			{ readBatchSize = batch_size ? batch_size : 1; }
+
 		/** Print information about all LogMonitor objects.
 			@param the stream to print to.  If NULL, do dprintf().
 		*/
@@ -258,8 +268,14 @@ private:
 
 			// The last event we read from this log.
 		ULogEvent	*lastLogEvent;
+
+			// Events read in a batch that haven't been consumed yet.
+		std::deque<std::unique_ptr<ULogEvent>> readAhead;
 	};
 
+		// Max number of events to read from a log at a time.
+	size_t readBatchSize{1};
+
 		// allLogFiles contains pointers to all of the LogFileMonitors we know
 		// about; 
 		// activeLogFiles contains just the active ones (to make it
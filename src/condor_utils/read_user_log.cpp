@@ -287,7 +287,9 @@ bool ReadUserLog::Lock() {
 	if (m_lock->isUnlocked()) { m_lock->obtain(WRITE_LOCK); }
 	return m_lock->isLocked();
 }
-bool ReadUserLog::Unlock() {
+bool ReadUserLog::Unlock( bool force ) {
+	// readEvents() holds the lock across the whole batch
+	if (m_batch_lock && !force) { return m_lock->isLocked(); }
 	if (m_lock->isLocked()) { m_lock->release(); }
 	return m_lock->isUnlocked();
 }
@@ -1021,6 +1023,78 @@ ReadUserLog::internalReadEvent (ULogEvent *& event, bool store_state )
 
 }
 
+ULogEventOutcome
+ReadUserLog::readEvents( std::vector<std::unique_ptr<ULogEvent>> &events,
+						 size_t max_events )
+{
+	if ( 0 == max_events ) {
+		return ULOG_NO_EVENT;
+	}
+
+	// The first event goes through the normal path, which takes care
+	// of reopening the file and moving on to the next rotation.
+	ULogEvent *event = NULL;
+	ULogEventOutcome outcome = internalReadEvent( event, true );
+	if ( ULOG_OK != outcome ) {
+		return outcome;
+	}
+	events.emplace_back( event );
+	size_t num_read = 1;
+
+	// If the file is closed between operations there is nothing to be
+	// gained by batching, just read the rest one at a time.
+	if ( !m_fp || m_close_file ) {
+		while ( num_read < max_events ) {
+			event = NULL;
+			if ( ULOG_OK != internalReadEvent( event, true ) ) {
+				delete event;
+				break;
+			}
+			events.emplace_back( event );
+			++num_read;
+		}
+		return ULOG_OK;
+	}
+
+	// Fast path: read straight from the open file, holding the lock
+	// for the whole batch and storing the state only once at the end.
+	size_t batch_start = num_read;
+	m_batch_lock = true;
+	Lock();
+	while ( num_read < max_events ) {
+		long pos = ftell( m_fp );
+		if ( pos < 0 ) {
+			break;
+		}
+		event = NULL;
+		if ( ULOG_OK != rawReadEvent( event, nullptr ) ) {
+			// Leave the file where this event starts, so that the next
+			// call reads it again and reports the outcome properly.
+			delete event;
+			clearerr( m_fp );
+			if ( fseek( m_fp, pos, SEEK_SET ) ) {
+				dprintf( D_ALWAYS, "fseek() failed in ReadUserLog::readEvents\n" );
+			}
+			break;
+		}
+		m_state->EventNumInc();
+		events.emplace_back( event );
+		++num_read;
+	}
+	m_batch_lock = false;
+	Unlock();
+
+	if ( num_read > batch_start ) {
+		long pos = ftell( m_fp );
+		if ( pos > 0 ) {
+			m_state->Offset( pos );
+		}
+		m_state->StatFile( m_fd );
+	}
+
+	return ULOG_OK;
+}
+
 ULogEventOutcome
 ReadUserLog::rawReadEvent( ULogEvent *& event, bool *try_again )
 {
@@ -1290,7 +1364,7 @@ ULogEventOutcome ReadUserLog::readEventNormal( ULogEvent *& event )
 		// NOTE: this code is important, so don't remove or "fix"
 		// it unless you *really* know what you're doing and test it
 		// extermely well
-		Unlock();
+		Unlock( true );
 		sleep( 1 );
 		Lock();
 		if( fseek( m_fp, filepos, SEEK_SET)) {
@@ -1517,6 +1591,7 @@ ReadUserLog::clear( void )
 	m_fp = NULL;
 	m_lock = NULL;
 	m_lock_rot = -1;
+	m_batch_lock = false;
 
 	m_close_file = false;
 	m_read_only = false;
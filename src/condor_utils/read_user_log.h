@@ -24,6 +24,8 @@
 /* Since this is a Condor API header file, we want to minimize our
    reliance on other Condor files to ease distribution.  -Jim B. */
 #include "condor_event.h"
+#include <memory>
+#include <vector>
 
 /* Predeclare some classes */
 class FileLockBase;
@@ -170,6 +172,22 @@ class ReadUserLog
     */
 	ULogEventOutcome readEvent (ULogEvent * & event) { return internalReadEvent( event, true ); }
 
+    /** Read up to max_events events from the log file in one call.
+		The first event is read exactly as readEvent() reads it (so file
+		reopens and rotations are handled there); the rest of the batch
+		is read from the open file while holding the file lock, and the
+		reader state is stored once at the end of the batch rather than
+		after every event.  The batch stops early at the end of the
+		current file or at the first event that does not read cleanly;
+		that outcome is returned by the next call.
+        @param events vector the new events are appended to
+		@param max_events maximum number of events to read
+        @return ULOG_OK if at least one event was read, otherwise the
+		 outcome of attempting to read the first event
+    */
+	ULogEventOutcome readEvents (std::vector<std::unique_ptr<ULogEvent>> &events,
+								 size_t max_events);
+
     /** Synchronize the log file if the last event read was an error.  This
         safe guard function should be called if there is some error reading an
         event, but there are events after it in the file.  Will skip over the
@@ -351,7 +369,7 @@ class ReadUserLog
 	/** Internal lock/unlock methods
 	 */
 	bool Lock();
-	bool Unlock();
+	bool Unlock( bool force = false );
 
 	/** Set all members to their cleared values.
 	*/
@@ -456,6 +474,7 @@ class ReadUserLog
 	bool				 m_lock_enable;	  /** Should we lock the file? */
     FileLockBase		*m_lock;		  /** The log file lock */
 	int					 m_lock_rot;	  /** Lock managing what rotation #? */
+	bool				 m_batch_lock;	  /** Hold the lock across a batch? */
 
 	/* Error history data */
 	mutable ErrorType	 m_error;		/** Type of latest error (think errno) */
@@ -0,0 +1,206 @@
+/***************************************************************
+ *
+ * Copyright (C) 1990-2024, Condor Team, Computer Sciences Department,
+ * University of Wisconsin-Madison, WI.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Checks that ClassAdColumnFilter gets the same answers as evaluating a
+// constraint against each ad in turn, the way the collector does when it
+// walks its hash tables, and reports how long each one takes.
+//
+//   test_classad_column_filter [-v] [-n <ads>] [-r <repeats>] [<constraint> ...]
+
+#include "condor_common.h"
+#include "condor_classad.h"
+#include "compat_classad_util.h"
+#include "utc_time.h"
+#include "classad_column_filter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static const char * default_constraints[] = {
+	"Memory > 2048",
+	"Cpus >= 4 && Memory >= 8192",
+	"State == \"Unclaimed\" && Activity == \"Idle\"",
+	"State =?= \"unclaimed\"",
+	"OpSys == \"LINUX\" && Arch == \"X86_64\" && Disk > 100000 && HasDocker",
+	"LoadAvg < 0.5 || TotalSlotCpus > 16",
+	"!IsDynamic && (PartitionableSlot =!= true)",
+	"Memory > 1024.5",
+	"Cpus > 2 && regexp(\"^slot1\", Name)",
+	"Memory - 512 > 2048",
+	"HasGPU =?= undefined",
+	"HasGPU || Cpus > 8",
+	"Rank > 0",
+	"TARGET.Memory > 2048",
+	"KFlops > 1000000 && size(Extras) > 1",
+	"Memory >= RequestedMemory",
+	"Machine == Name",
+	"State",
+};
+
+// Synthetic startd slot ads, mostly alike but with the odd mistyped,
+// missing or computed attribute so that the slow paths get used too.
+static ClassAd * MakeSlotAd(int i)
+{
+	ClassAd * ad = new ClassAd();
+	std::string name;
+	formatstr(name, "slot%d@exec%04d.example.org", i % 32, i / 32);
+
+	ad->InsertAttr("MyType", "Machine");
+	ad->InsertAttr("Name", name);
+	ad->InsertAttr("Machine", name.substr(name.find('@') + 1));
+	ad->InsertAttr("OpSys", (i % 11) ? "LINUX" : "WINDOWS");
+	ad->InsertAttr("Arch", (i % 13) ? "X86_64" : "aarch64");
+	ad->InsertAttr("State", (i % 3) ? "Claimed" : "Unclaimed");
+	ad->InsertAttr("Activity", (i % 5) ? "Busy" : "Idle");
+	ad->InsertAttr("Cpus", 1 + (i % 16));
+	ad->InsertAttr("TotalSlotCpus", 1 + (i % 64));
+	ad->InsertAttr("Disk", (long long)(i % 7) * 50000);
+	ad->InsertAttr("LoadAvg", (i % 10) / 9.0);
+	ad->InsertAttr("KFlops", 500000 + (i % 1000) * 1000);
+	ad->InsertAttr("IsDynamic", (i % 4) == 0);
+	ad->InsertAttr("Rank", 0);
+	ad->AssignExpr("RequestedMemory", "Cpus * 1024");
+
+	if (i % 97 == 0) {
+		ad->InsertAttr("Memory", 1024.0 * (i % 9));
+	} else if (i % 89 == 0) {
+		ad->InsertAttr("Memory", "lots");
+	} else if (i % 83 != 0) {
+		ad->InsertAttr("Memory", 1024 * (1 + (i % 16)));
+	}
+	if (i % 2) {
+		ad->InsertAttr("HasDocker", (i % 6) != 1);
+	}
+	if (i % 17 == 0) {
+		ad->InsertAttr("HasGPU", true);
+	} else if (i % 19 == 0) {
+		ad->AssignExpr("HasGPU", "Cpus > 4");
+	}
+	if (i % 4 == 0) {
+		ad->AssignExpr("PartitionableSlot", "true");
+	}
+	if (i % 31 == 0) {
+		ad->AssignExpr("Extras", "{ \"a\", \"b\", \"c\" }");
+	}
+	return ad;
+}
+
+static bool EvalOne(classad::ExprTree * constraint, ClassAd * ad)
+{
+	classad::Value result;
+	bool val = false;
+	return EvalExprToBool(constraint, ad, NULL, result) && result.IsBooleanValueEquiv(val) && val;
+}
+
+int main(int argc, const char ** argv)
+{
+	bool verbose = false;
+	int num_ads = 50000;
+	int repeats = 5;
+	std::vector<const char *> constraints;
+
+	for (int i = 1; i < argc; ++i) {
+		if (MATCH == strcmp(argv[i], "-v")) {
+			verbose = true;
+		} else if (MATCH == strcmp(argv[i], "-n") && i+1 < argc) {
+			num_ads = atoi(argv[++i]);
+		} else if (MATCH == strcmp(argv[i], "-r") && i+1 < argc) {
+			repeats = atoi(argv[++i]);
+		} else {
+			constraints.push_back(argv[i]);
+		}
+	}
+	if (constraints.empty()) {
+		for (const char * str : default_constraints) { constraints.push_back(str); }
+	}
+	if (repeats < 1) { repeats = 1; }
+
+	std::vector<ClassAd *> ads;
+	for (int i = 0; i < num_ads; ++i) {
+		ads.push_back(MakeSlotAd(i));
+	}
+
+	int failures = 0;
+	double total_tree = 0, total_columns = 0;
+	printf("%d ads, best of %d runs\n", num_ads, repeats);
+	printf("%10s %10s %8s %8s  %s\n", "per-ad", "columns", "matched", "fallback", "constraint");
+
+	for (const char * str : constraints) {
+		classad::ExprTree * constraint = NULL;
+		if (ParseClassAdRvalExpr(str, constraint)) {
+			printf("FAILED to parse: %s\n", str);
+			++failures;
+			continue;
+		}
+
+		std::vector<bool> expected(ads.size());
+		std::vector<bool> matched;
+		ClassAdColumnFilter filter;
+		filter.Init(constraint);
+
+		double best_tree = 1e9, best_columns = 1e9;
+		for (int run = 0; run < repeats; ++run) {
+			double begin = condor_gettimestamp_double();
+			for (size_t ix = 0; ix < ads.size(); ++ix) {
+				expected[ix] = EvalOne(constraint, ads[ix]);
+			}
+			double mid = condor_gettimestamp_double();
+			filter.Filter(ads, matched);
+			double end = condor_gettimestamp_double();
+			best_tree = MIN(best_tree, mid - begin);
+			best_columns = MIN(best_columns, end - mid);
+		}
+		total_tree += best_tree;
+		total_columns += best_columns;
+
+		long num_matched = 0, mismatches = 0;
+		for (size_t ix = 0; ix < ads.size(); ++ix) {
+			if (expected[ix]) { ++num_matched; }
+			if (expected[ix] != matched[ix]) {
+				if (verbose || mismatches == 0) {
+					printf("MISMATCH for %s: expected %d, got %d for ad\n", str, (int)expected[ix], (int)matched[ix]);
+					fPrintAd(stdout, *ads[ix]);
+				}
+				++mismatches;
+			}
+		}
+		if (mismatches) {
+			printf("FAILED: %ld of %d ads differ for %s\n", mismatches, num_ads, str);
+			++failures;
+		}
+
+		printf("%9.2fms %9.2fms %8ld %8ld  %s%s\n", best_tree * 1000, best_columns * 1000,
+			num_matched, filter.stats().fallback_ads / repeats, str,
+			filter.IsColumnar() ? "" : " (not columnar)");
+		delete constraint;
+	}
+
+	printf("total: per-ad %.2fms, columns %.2fms\n", total_tree * 1000, total_columns * 1000);
+
+	for (ClassAd * ad : ads) { delete ad; }
+
+	if (failures) {
+		printf("FAILED\n");
+		return 1;
+	}
+	printf("All tests passed.\n");
+	return 0;
+}
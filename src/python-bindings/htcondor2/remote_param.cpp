@@ -1,38 +1,38 @@
-bool
-start_config_command( int cmd, ReliSock & sock, const ClassAd & location ) {
+// Idle connections to the daemon are pooled, since RemoteParam sends one
+// command per parameter.  On success, hand the socket back with
+// d->releaseCommandSocket() once the reply has been read.
+Sock *
+start_config_command( int cmd, const ClassAd & location, std::unique_ptr<Daemon> & d ) {
     std::string address;
     if(! location.EvaluateAttrString( ATTR_MY_ADDRESS, address )) {
         // This was HTCondorValueError in version 1.
         PyErr_SetString( PyExc_ValueError, "Address not available in location ClassAd." );
-        return false;
+        return NULL;
     }
 
     // Not sure we actually need to make this copy, but version 1 did.
     ClassAd copy;
     copy.CopyFrom(location);
 
-    Daemon d( &copy, DT_GENERIC, NULL );
+    d.reset( new Daemon( &copy, DT_GENERIC, NULL ) );
+    d->setUseConnectionPool( true );
 
     CondorError errorStack;
-    bool result = sock.connect( d.addr(), 0, false, & errorStack );
-    if(! result) {
-        dprintf( D_NETWORK | D_VERBOSE, "start_config_command(): sock.connect() failed: %s\n", errorStack.getFullText().c_str() );
-
-        // This was HTCondorValueError in version 1.
-        PyErr_SetString( PyExc_IOError, "Failed to connect to daemon." );
-        return false;
-    }
-
-    result = d.startCommand( cmd, & sock, 0, & errorStack );
-    if(! result) {
+    Sock * sock = d->startCommand( cmd, Stream::reli_sock, 0, & errorStack );
+    if(! sock) {
         dprintf( D_NETWORK | D_VERBOSE, "start_config_command(): d.startCommand() failed: %s\n", errorStack.getFullText().c_str() );
 
-        // This was HTCondorIOError in version 1.
-        PyErr_SetString( PyExc_IOError, "Failed to start command." );
-        return false;
+        if( errorStack.code() == CEDAR_ERR_CONNECT_FAILED ) {
+            // This was HTCondorValueError in version 1.
+            PyErr_SetString( PyExc_IOError, "Failed to connect to daemon." );
+        } else {
+            // This was HTCondorIOError in version 1.
+            PyErr_SetString( PyExc_IOError, "Failed to start command." );
+        }
+        return NULL;
     }
 
-    return true;
+    return sock;
 }
 
 
@@ -48,38 +48,38 @@ _remote_param_keys( PyObject *, PyObject * args ) {
 
     auto * location = (ClassAd * )handle->t;
 
-    ReliSock sock;
-    bool result = start_config_command( DC_CONFIG_VAL, sock, * location );
-    if(! result) {
+    std::unique_ptr<Daemon> d;
+    std::unique_ptr<Sock> sock( start_config_command( DC_CONFIG_VAL, * location, d ) );
+    if(! sock) {
         // start_config_command() has already set an exception for us.
         return NULL;
     }
 
-    sock.encode();
+    sock->encode();
 
     std::string payload = "?names";
-    if(! sock.put(payload)) {
+    if(! sock->put(payload)) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to send request for parameter names." );
         return NULL;
     }
-    if(! sock.end_of_message()) {
+    if(! sock->end_of_message()) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to send EOM for parameter names." );
         return NULL;
     }
 
-    sock.decode();
+    sock->decode();
 
     std::string reply;
-    if(! sock.code(reply)) {
+    if(! sock->code(reply)) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to receive reply for parameter names." );
         return NULL;
     }
 
     if( reply == "Not defined" ) {
-        if(! sock.end_of_message()) {
+        if(! sock->end_of_message()) {
             // This was HTCondorIOError in version 1.
             PyErr_SetString( PyExc_IOError, "Failed to receive EOM from remote daemon (unsupported version)." );
             return NULL;
@@ -94,7 +94,7 @@ _remote_param_keys( PyObject *, PyObject * args ) {
         return NULL;
     }
     if( reply[0] == '!' ) {
-        sock.end_of_message();
+        sock->end_of_message();
 
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Remote daemon failed to get parameter names." );
@@ -107,8 +107,8 @@ _remote_param_keys( PyObject *, PyObject * args ) {
     }
 
     std::string key;
-    while(! sock.peek_end_of_message()) {
-        if(! sock.code(key)) {
+    while(! sock->peek_end_of_message()) {
+        if(! sock->code(key)) {
             // This was HTCondorIOError in version 1.
             PyErr_SetString( PyExc_IOError, "Failed to read parameter name." );
             return NULL;
@@ -117,12 +117,13 @@ _remote_param_keys( PyObject *, PyObject * args ) {
         keys.push_back(key.c_str());
     }
 
-    if(! sock.end_of_message()) {
+    if(! sock->end_of_message()) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to receive final EOM for parameter names." );
         return NULL;
     }
 
+    d->releaseCommandSocket( sock.release() );
     return PyUnicode_FromString(join(keys, ",").c_str());
 }
 
@@ -140,43 +141,44 @@ _remote_param_get( PyObject *, PyObject * args ) {
 
     auto * location = (ClassAd * )handle->t;
 
-    ReliSock sock;
-    bool result = start_config_command( CONFIG_VAL, sock, * location );
-    if(! result) {
+    std::unique_ptr<Daemon> d;
+    std::unique_ptr<Sock> sock( start_config_command( CONFIG_VAL, * location, d ) );
+    if(! sock) {
         // start_config_command() has already set an exception for us.
         return NULL;
     }
 
 
-    sock.encode();
+    sock->encode();
 
-    if(! sock.put(key)) {
+    if(! sock->put(key)) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Can't send requested param name." );
         return NULL;
     }
-    if(! sock.end_of_message()) {
+    if(! sock->end_of_message()) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Can't send EOM for param name." );
         return NULL;
     }
 
 
-    sock.decode();
+    sock->decode();
 
     std::string value;
-    if(! sock.code(value)) {
+    if(! sock->code(value)) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to receive reply from daemon for param value." );
         return NULL;
     }
-    if(! sock.end_of_message()) {
+    if(! sock->end_of_message()) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to receive EOM from daemon for param value." );
         return NULL;
     }
 
 
+    d->releaseCommandSocket( sock.release() );
     return PyUnicode_FromString(value.c_str());
 }
 
@@ -195,42 +197,42 @@ _remote_param_set( PyObject *, PyObject * args ) {
 
     auto * location = (ClassAd * )handle->t;
 
-    ReliSock sock;
-    bool result = start_config_command( DC_CONFIG_RUNTIME, sock, * location );
-    if(! result) {
+    std::unique_ptr<Daemon> d;
+    std::unique_ptr<Sock> sock( start_config_command( DC_CONFIG_RUNTIME, * location, d ) );
+    if(! sock) {
         // start_config_command() has already set an exception for us.
         return NULL;
     }
 
-    sock.encode();
+    sock->encode();
 
-    if(! sock.put(key)) {
+    if(! sock->put(key)) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Can't send requested param name." );
         return NULL;
     }
     std::string wtaf;
     formatstr( wtaf, "%s = %s", key, value );
-    if(! sock.code(wtaf)) {
+    if(! sock->code(wtaf)) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Can't send requested param value." );
         return NULL;
     }
-    if(! sock.end_of_message()) {
+    if(! sock->end_of_message()) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Can't send EOM for param name." );
         return NULL;
     }
 
-    sock.decode();
+    sock->decode();
 
     int rval = 0;
-    if(! sock.code(rval)) {
+    if(! sock->code(rval)) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to receive reply from daemon after setting param." );
         return NULL;
     }
-    if(! sock.end_of_message()) {
+    if(! sock->end_of_message()) {
         // This was HTCondorIOError in version 1.
         PyErr_SetString( PyExc_IOError, "Failed to receive EOM from daemon after setting param value." );
         return NULL;
@@ -241,5 +243,6 @@ _remote_param_set( PyObject *, PyObject * args ) {
         return NULL;
     }
 
+    d->releaseCommandSocket( sock.release() );
     Py_RETURN_NONE;
 }